@@ -112,6 +112,14 @@ SOURCE=..\..\src\audio\SDL_audio.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\audio\SDL_audioring.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\src\audio\SDL_audioqueue.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\audio\SDL_audio_c.h
 # End Source File
 # Begin Source File
@@ -344,6 +352,10 @@ SOURCE=..\..\src\video\dummy\SDL_nullvideo.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\video\dummy\SDL_nullcapture.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\video\dummy\SDL_nullvideo.h
 # End Source File
 # Begin Source File
@@ -396,6 +408,10 @@ SOURCE=..\..\src\stdlib\SDL_string.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\stdlib\SDL_memcpy.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\video\SDL_surface.c
 # End Source File
 # Begin Source File
@@ -416,6 +432,10 @@ SOURCE=..\..\src\thread\generic\SDL_syscond.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\thread\generic\SDL_sysrwlock.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\video\wincommon\SDL_sysevents.c
 # End Source File
 # Begin Source File
@@ -484,6 +504,10 @@ SOURCE=..\..\src\thread\SDL_thread.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\thread\SDL_atomic.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\thread\SDL_thread_c.h
 # End Source File
 # Begin Source File
@@ -500,6 +524,10 @@ SOURCE=..\..\src\video\SDL_video.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\video\SDL_videostats.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\video\windib\SDL_vkeys.h
 # End Source File
 # Begin Source File
@@ -528,6 +556,10 @@ SOURCE=..\..\src\video\SDL_yuv_sw.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\video\SDL_yuv_simd.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\video\SDL_yuv_sw_c.h
 # End Source File
 # Begin Source File
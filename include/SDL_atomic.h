@@ -0,0 +1,172 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+#ifndef _SDL_atomic_h
+#define _SDL_atomic_h
+
+/** @file SDL_atomic.h
+ *  Atomic operations and spinlocks
+ *
+ *  These are implemented with the compiler's atomic builtins where
+ *  available, and fall back to a global SDL_mutex on other platforms.
+ *  They are meant for simple counters, flags and pointer hand-offs;
+ *  anything more complicated should use the functions in SDL_mutex.h.
+ *
+ *  @note These are independent of the other SDL routines.
+ */
+
+#include "SDL_stdinc.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/** @name Memory barriers                                        */ /*@{*/
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/** Prevent the compiler from reordering reads and writes across this point.
+ *  This does not emit any instructions and does not order the accesses
+ *  as seen by other processors.
+ */
+#if defined(__GNUC__)
+#define SDL_CompilerBarrier()	__asm__ __volatile__ ("" : : : "memory")
+#else
+#define SDL_CompilerBarrier()	SDL_MemoryBarrier()
+#endif
+
+/** Full memory barrier: no load or store may be reordered across it */
+extern DECLSPEC void SDLCALL SDL_MemoryBarrier(void);
+
+/*@}*/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/** @name Spinlock functions                                     */ /*@{*/
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/** The SDL spinlock, 0 when unlocked.
+ *  Spinlocks are not recursive, and should only be held for a few
+ *  instructions.  Initialize with SDL_SPINLOCK_INIT or 0.
+ */
+typedef int SDL_SpinLock;
+
+#define SDL_SPINLOCK_INIT	0
+
+/** Try to lock a spinlock without blocking.
+ *  @return SDL_TRUE if the lock was acquired, SDL_FALSE otherwise.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicTryLock(SDL_SpinLock *lock);
+
+/** Lock a spinlock, spinning (and eventually yielding) until it is free */
+extern DECLSPEC void SDLCALL SDL_AtomicLock(SDL_SpinLock *lock);
+
+/** Unlock a spinlock, with release semantics */
+extern DECLSPEC void SDLCALL SDL_AtomicUnlock(SDL_SpinLock *lock);
+
+/*@}*/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/** @name Atomic integer functions                               */ /*@{*/
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/** An atomic integer.
+ *  The value should only be accessed through the functions below.
+ */
+typedef struct SDL_AtomicInt {
+	int value;
+} SDL_AtomicInt;
+
+/** Set the value to 'newval' if it is currently 'oldval'.
+ *  This is a full memory barrier.
+ *  @return SDL_TRUE if the value was changed, SDL_FALSE otherwise.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicCAS(SDL_AtomicInt *a, int oldval, int newval);
+
+/** Set the value and return the previous one.
+ *  This is a full memory barrier.
+ */
+extern DECLSPEC int SDLCALL SDL_AtomicSwap(SDL_AtomicInt *a, int value);
+
+/** Add to the value and return the previous one.
+ *  This is a full memory barrier.
+ */
+extern DECLSPEC int SDLCALL SDL_AtomicAdd(SDL_AtomicInt *a, int value);
+
+/** Read the value with acquire semantics: no later load or store
+ *  is performed before it.
+ */
+extern DECLSPEC int SDLCALL SDL_AtomicLoad(SDL_AtomicInt *a);
+
+/** Write the value with release semantics: no earlier load or store
+ *  is performed after it.
+ */
+extern DECLSPEC void SDLCALL SDL_AtomicStore(SDL_AtomicInt *a, int value);
+
+/** Increment an atomic reference count */
+#define SDL_AtomicIncRef(a)	SDL_AtomicAdd(a, 1)
+
+/** Decrement an atomic reference count
+ *  @return SDL_TRUE if the count reached zero.
+ */
+#define SDL_AtomicDecRef(a)	(SDL_AtomicAdd(a, -1) == 1)
+
+/*@}*/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/** @name Atomic pointer functions                               */ /*@{*/
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/** An atomic pointer.
+ *  The value should only be accessed through the functions below.
+ */
+typedef struct SDL_AtomicPointer {
+	void *value;
+} SDL_AtomicPointer;
+
+/** Set the pointer to 'newval' if it is currently 'oldval'.
+ *  This is a full memory barrier.
+ *  @return SDL_TRUE if the pointer was changed, SDL_FALSE otherwise.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicCASPtr(SDL_AtomicPointer *a, void *oldval, void *newval);
+
+/** Set the pointer and return the previous one.
+ *  This is a full memory barrier.
+ */
+extern DECLSPEC void * SDLCALL SDL_AtomicSwapPtr(SDL_AtomicPointer *a, void *value);
+
+/** Read the pointer with acquire semantics */
+extern DECLSPEC void * SDLCALL SDL_AtomicLoadPtr(SDL_AtomicPointer *a);
+
+/** Write the pointer with release semantics */
+extern DECLSPEC void SDLCALL SDL_AtomicStorePtr(SDL_AtomicPointer *a, void *value);
+
+/*@}*/
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* _SDL_atomic_h */
@@ -65,6 +65,8 @@ extern "C" {
  *     This function usually runs in a separate thread, and so you should
  *     protect data structures that it accesses by calling SDL_LockAudio()
  *     and SDL_UnlockAudio() in your code.
+ *     If it is NULL, the application pushes audio with SDL_QueueAudio()
+ *     instead.
  * - 'desired->userdata' is passed as the first parameter to your callback
  *     function.
  *
@@ -137,6 +139,9 @@ typedef struct SDL_AudioCVT {
 	int filter_index;		/**< Current audio conversion function */
 } SDL_AudioCVT;
 
+/** One of the audio conversion filters in SDL_AudioCVT */
+typedef void (SDLCALL *SDL_AudioFilter)(SDL_AudioCVT *cvt, Uint16 format);
+
 
 /* Function prototypes */
 
@@ -186,6 +191,17 @@ typedef enum {
 /** Get the current audio state */
 extern DECLSPEC SDL_audiostatus SDLCALL SDL_GetAudioStatus(void);
 
+/**
+ * Get the output latency the audio driver settled on when the device was
+ * opened: the number of sample frames buffered between the callback and
+ * the sound card.  This can be far more than the 'samples' of the
+ * obtained spec, which is only the size of each callback.
+ *
+ * @return The latency in sample frames, or -1 if the device isn't open or
+ *         the driver can't tell.
+ */
+extern DECLSPEC int SDLCALL SDL_GetAudioLatency(void);
+
 /**
  * This function pauses and unpauses the audio callback processing.
  * It should be called with a parameter of 0 after opening the audio
@@ -246,6 +262,22 @@ extern DECLSPEC int SDLCALL SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
  */
 extern DECLSPEC int SDLCALL SDL_ConvertAudio(SDL_AudioCVT *cvt);
 
+/**
+ * Get the name of one of SDL's audio conversion filters, like the ones
+ * SDL_BuildAudioCVT() puts in cvt->filters, for example "SDL_RateMUL2_c2".
+ * This function returns NULL if 'filter' isn't one of SDL's.
+ */
+extern DECLSPEC const char * SDLCALL SDL_GetAudioFilterName(SDL_AudioFilter filter);
+
+/**
+ * Look up one of SDL's audio conversion filters by name, so that it can
+ * be run or timed on its own.  The filter is called with the format of
+ * the data in cvt->buf and converts cvt->len_cvt bytes of it in place,
+ * updating cvt->len_cvt, then runs the next filter in cvt->filters.
+ * This function returns NULL if there is no filter with that name.
+ */
+extern DECLSPEC SDL_AudioFilter SDLCALL SDL_GetAudioFilter(const char *name);
+
 
 #define SDL_MIX_MAXVOLUME 128
 /**
@@ -271,9 +303,76 @@ extern DECLSPEC void SDLCALL SDL_UnlockAudio(void);
 
 /**
  * This function shuts down audio processing and closes the audio device.
+ * An open capture device keeps recording; it is closed with
+ * SDL_CloseAudioCapture() or when the audio subsystem is shut down.
  */
 extern DECLSPEC void SDLCALL SDL_CloseAudio(void);
 
+/**
+ * @name Audio Queue
+ * When SDL_OpenAudio() is passed a NULL callback, the application pushes
+ * its audio to the device instead of having it pulled from a callback.
+ * The audio is kept in a queue that the audio thread drains as the device
+ * needs it, converting it to the hardware format if necessary, and the
+ * device plays silence whenever the queue runs dry.  Nothing is drained
+ * while the device is paused.
+ *
+ * SDL_QueueAudio() copies 'len' bytes of audio, in the format the device
+ * was opened with, onto the end of the queue.  It never waits for the
+ * device and may be called from any thread; the audio thread never takes
+ * a lock to read the queue, so queueing doesn't need SDL_LockAudio().
+ * SDL_GetQueuedAudioSize() returns the number of bytes that haven't been
+ * handed to the device yet, and SDL_ClearQueuedAudio() throws them away.
+ *
+ * @return SDL_QueueAudio() returns 0, or -1 if the device isn't open
+ *         without a callback or there wasn't enough memory.
+ */
+/*@{*/
+extern DECLSPEC int SDLCALL SDL_QueueAudio(const void *data, Uint32 len);
+extern DECLSPEC Uint32 SDLCALL SDL_GetQueuedAudioSize(void);
+extern DECLSPEC void SDLCALL SDL_ClearQueuedAudio(void);
+/*@}*/
+
+/**
+ * @name Audio Capture
+ * Recording works alongside the output device and is opened on its own.
+ *
+ * SDL_OpenAudioCapture() takes the same arguments as SDL_OpenAudio().
+ * If 'desired->callback' is set, it is called from a separate thread with
+ * each 'desired->size' bytes of recorded audio, in 'stream'.  Otherwise
+ * the application polls for the audio with SDL_ReadAudioCapture().
+ * The device records on a thread of its own into a ring buffer of a few
+ * buffers, and drops audio when nobody keeps up with it, so a slow
+ * callback or reader never makes the device overrun.
+ *
+ * The capture device is paused when it is opened: call
+ * SDL_PauseAudioCapture(0) to start recording.  Audio recorded while it is
+ * paused is thrown away.  SDL_GetAudioCaptureStatus() returns
+ * SDL_AUDIO_PLAYING while it is recording.
+ *
+ * It uses the output driver if that can record, or the first one that can.
+ * The SDL_AUDIO_CAPTURE_DRIVER environment variable picks another one.
+ *
+ * @return SDL_OpenAudioCapture() returns 0, or -1 if there is no device
+ *         that can record or it couldn't be opened.
+ */
+/*@{*/
+extern DECLSPEC int SDLCALL SDL_OpenAudioCapture(SDL_AudioSpec *desired, SDL_AudioSpec *obtained);
+extern DECLSPEC SDL_audiostatus SDLCALL SDL_GetAudioCaptureStatus(void);
+extern DECLSPEC void SDLCALL SDL_PauseAudioCapture(int pause_on);
+
+/**
+ * Copy up to 'len' bytes of recorded audio into 'data', without waiting.
+ * This only returns whole sample frames.
+ *
+ * @return The number of bytes copied, which may be 0, or -1 if the capture
+ *         device isn't open or its audio goes to a callback.
+ */
+extern DECLSPEC int SDLCALL SDL_ReadAudioCapture(void *data, int len);
+
+extern DECLSPEC void SDLCALL SDL_CloseAudioCapture(void);
+/*@}*/
+
 
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
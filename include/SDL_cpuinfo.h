@@ -57,9 +57,54 @@ extern DECLSPEC SDL_bool SDLCALL SDL_HasSSE(void);
 /** This function returns true if the CPU has SSE2 features */
 extern DECLSPEC SDL_bool SDLCALL SDL_HasSSE2(void);
 
+/** This function returns true if the CPU has SSE3 features */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasSSE3(void);
+
+/** This function returns true if the CPU has SSSE3 features */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasSSSE3(void);
+
+/** This function returns true if the CPU has SSE4.1 features */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasSSE41(void);
+
+/** This function returns true if the CPU has SSE4.2 features */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasSSE42(void);
+
+/**
+ * This function returns true if the CPU has AVX features and the
+ * operating system saves the AVX registers
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasAVX(void);
+
+/** This function returns true if the CPU has AVX2 features usable by the OS */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasAVX2(void);
+
+/** This function returns true if the CPU has AVX-512F features usable by the OS */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasAVX512F(void);
+
 /** This function returns true if the CPU has AltiVec features */
 extern DECLSPEC SDL_bool SDLCALL SDL_HasAltiVec(void);
 
+/** This function returns true if the CPU has ARM SIMD (ARMv6) features */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasARMSIMD(void);
+
+/** This function returns true if the CPU has ARM NEON features */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasNEON(void);
+
+/** This function returns the number of CPU cores available */
+extern DECLSPEC int SDLCALL SDL_GetCPUCount(void);
+
+/**
+ * This function returns the size of a CPU cache line in bytes, or a
+ * safe guess if it can't be found out
+ */
+extern DECLSPEC int SDLCALL SDL_GetCPUCacheLineSize(void);
+
+/**
+ * This function returns the size in bytes of the level 1 (data), 2 or 3
+ * CPU cache, or 0 if there is no such cache or its size is unknown
+ */
+extern DECLSPEC int SDLCALL SDL_GetCPUCacheSize(int level);
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
@@ -0,0 +1,115 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/** @file SDL_dummycapture.h
+ *  Layout of the frames published by the dummy video driver
+ *
+ *  When SDL_VIDEODRIVER=dummy, the display surface can be exported so
+ *  that headless programs can be watched or recorded.  The driver
+ *  reads these environment variables when the video mode is set:
+ *
+ *  - SDL_VIDEO_DUMMY_SHM: name of a POSIX shared memory object, such
+ *    as "/myapp-frames", that receives a ring of the latest frames.
+ *  - SDL_VIDEO_DUMMY_SHM_FRAMES: number of frames in the ring (default 3)
+ *  - SDL_VIDEO_DUMMY_OUTPUT: file that every frame is appended to, or
+ *    "-" for standard output, or "|command" to pipe the frames into
+ *    a command where popen() is available.
+ *  - SDL_VIDEO_DUMMY_FORMAT: "ppm" (the default) writes each frame as
+ *    a binary PPM image, "raw" writes the pixels exactly as they are
+ *    laid out in the display surface.
+ *  - SDL_VIDEO_DUMMY_FPS: publish at most this many frames per second,
+ *    by making SDL_UpdateRects() and SDL_Flip() wait.
+ *
+ *  A frame is published by every SDL_UpdateRects() or SDL_Flip().
+ *  The shared memory object starts with an SDL_DummyCaptureHeader,
+ *  followed by the frame slots.  To read the latest frame:
+ *
+ *  @code
+ *  seq = header->sequence;
+ *  frame = (SDL_DummyCaptureFrame *)((Uint8 *)header +
+ *          header->frame_offset + (seq % header->nframes) * header->frame_size);
+ *  if ( frame->sequence == seq ) {
+ *      ... copy the pixels following the frame structure ...
+ *      if ( frame->sequence == seq ) the copy is good
+ *  }
+ *  @endcode
+ *
+ *  The object is unlinked when the video mode changes or SDL quits,
+ *  and the magic is cleared first, so readers should check it and
+ *  reopen when it goes to zero.
+ */
+
+#ifndef _SDL_dummycapture_h
+#define _SDL_dummycapture_h
+
+#include "SDL_stdinc.h"
+#include "SDL_video.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SDL_DUMMYCAPTURE_MAGIC		0x50414353	/* "SCAP" */
+#define SDL_DUMMYCAPTURE_VERSION	1
+
+/** The most damage rectangles recorded for a frame */
+#define SDL_DUMMYCAPTURE_MAXRECTS	16
+
+/** Found at the start of the shared memory object */
+typedef struct SDL_DummyCaptureHeader {
+	Uint32 magic;		/**< SDL_DUMMYCAPTURE_MAGIC, or 0 when closed */
+	Uint32 version;		/**< SDL_DUMMYCAPTURE_VERSION */
+	Uint32 nframes;		/**< Number of frame slots in the ring */
+	Uint32 frame_offset;	/**< Offset of the first slot */
+	Uint32 frame_size;	/**< Offset from one slot to the next */
+	Uint32 w, h;		/**< Size of the display surface */
+	Uint32 pitch;		/**< Bytes per row of pixels */
+	Uint32 BitsPerPixel;
+	Uint32 Rmask, Gmask, Bmask, Amask;
+	Uint32 fps;		/**< The SDL_VIDEO_DUMMY_FPS limit, or 0 */
+	volatile Uint32 sequence;	/**< Latest complete frame, 0 if none */
+	Uint32 reserved;
+	SDL_Color palette[256];	/**< The colors of an 8-bit display */
+} SDL_DummyCaptureHeader;
+
+/** The start of a frame slot, followed by h rows of pitch bytes */
+typedef struct SDL_DummyCaptureFrame {
+	/** Sequence number of the frame, 0 while it is being written */
+	volatile Uint32 sequence;
+	Uint32 ticks;		/**< SDL_GetTicks() when it was published */
+	/** Areas that changed since the previous frame, or 0 if the
+	 *  whole frame should be considered changed.
+	 */
+	Uint32 numrects;
+	Uint32 reserved;
+	SDL_Rect rects[SDL_DUMMYCAPTURE_MAXRECTS];
+} SDL_DummyCaptureFrame;
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* _SDL_dummycapture_h */
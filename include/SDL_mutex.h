@@ -167,6 +167,68 @@ extern DECLSPEC int SDLCALL SDL_CondWaitTimeout(SDL_cond *cond, SDL_mutex *mutex
 
 /*@}*/
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/** @name Reader-writer lock functions                           */ /*@{*/
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/** The SDL reader-writer lock structure, defined in SDL_sysrwlock.c
+ *
+ *  Any number of threads may hold the lock for reading at the same time,
+ *  but a writer holds it alone.  Where the platform allows it, waiting
+ *  writers are given priority over new readers, so reader-writer locks
+ *  are not recursive: a thread that already holds the lock must not
+ *  lock it again.
+ */
+struct SDL_RWLock;
+typedef struct SDL_RWLock SDL_RWLock;
+
+/** Create a reader-writer lock, initialized unlocked */
+extern DECLSPEC SDL_RWLock * SDLCALL SDL_CreateRWLock(void);
+
+/** Destroy a reader-writer lock */
+extern DECLSPEC void SDLCALL SDL_DestroyRWLock(SDL_RWLock *rwlock);
+
+/** Lock for shared read access, waiting for any writer to finish.
+ *  @return 0, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_RWLockRead(SDL_RWLock *rwlock);
+
+/** Non-blocking variant of SDL_RWLockRead().
+ *  @return 0 if the lock was taken,
+ *  SDL_MUTEX_TIMEDOUT if it would block, and -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_RWLockTryRead(SDL_RWLock *rwlock);
+
+/** Variant of SDL_RWLockRead() with a timeout in milliseconds.
+ *  @return 0 if the lock was taken,
+ *  SDL_MUTEX_TIMEDOUT if it wasn't in the allotted time, and -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_RWLockReadTimeout(SDL_RWLock *rwlock, Uint32 ms);
+
+/** Lock for exclusive write access, waiting for all other holders.
+ *  @return 0, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_RWLockWrite(SDL_RWLock *rwlock);
+
+/** Non-blocking variant of SDL_RWLockWrite().
+ *  @return 0 if the lock was taken,
+ *  SDL_MUTEX_TIMEDOUT if it would block, and -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_RWLockTryWrite(SDL_RWLock *rwlock);
+
+/** Variant of SDL_RWLockWrite() with a timeout in milliseconds.
+ *  @return 0 if the lock was taken,
+ *  SDL_MUTEX_TIMEDOUT if it wasn't in the allotted time, and -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_RWLockWriteTimeout(SDL_RWLock *rwlock, Uint32 ms);
+
+/** Release a read or write lock held by the current thread.
+ *  @return 0, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_RWLockUnlock(SDL_RWLock *rwlock);
+
+/*@}*/
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
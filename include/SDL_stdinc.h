@@ -385,6 +385,21 @@ do {							\
 } while(0)
 #endif
 
+/** Copy 'h' rows of 'w' bytes between buffers with the given pitches.
+ *  Copies too big to stay in the CPU cache use non-temporal stores if
+ *  the CPU has them, so they don't evict everything else on the way.
+ *  SDL_SetBlitFeatures() can rule those out, as they use SSE2 or AVX2.
+ *  The buffers must not overlap.
+ */
+extern DECLSPEC void SDLCALL SDL_memcpy2D(void *dst, int dpitch, const void *src, int spitch, int w, int h);
+
+/** Fill 'h' rows of 'w' bytes with the 32-bit 'val' repeated in its
+ *  native byte order from the start of each row, the way SDL_memset4()
+ *  would, except that 'w' doesn't have to be a multiple of 4.  Fills
+ *  bigger than the CPU cache use non-temporal stores like SDL_memcpy2D().
+ */
+extern DECLSPEC void SDLCALL SDL_memset2D(void *dst, int dpitch, Uint32 val, int w, int h);
+
 #ifdef HAVE_MEMCMP
 #define SDL_memcmp      memcmp
 #else
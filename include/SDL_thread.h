@@ -45,6 +45,39 @@ extern "C" {
 struct SDL_Thread;
 typedef struct SDL_Thread SDL_Thread;
 
+/** Thread scheduling priorities */
+typedef enum {
+	SDL_THREAD_PRIORITY_LOW,
+	SDL_THREAD_PRIORITY_NORMAL,
+	SDL_THREAD_PRIORITY_HIGH,
+	/** Real-time scheduling (SCHED_FIFO on POSIX systems), if the
+	 *  process is permitted to use it.
+	 */
+	SDL_THREAD_PRIORITY_REALTIME
+} SDL_ThreadPriority;
+
+/** Optional settings for SDL_CreateThreadEx().
+ *  Initialize this with SDL_InitThreadAttr() before changing any
+ *  fields, so new fields added later get sensible defaults.
+ */
+typedef struct SDL_ThreadAttr {
+	/** Thread name shown by debuggers and system tools, or NULL.
+	 *  Some systems truncate this to 15 characters.
+	 */
+	const char *name;
+	/** Stack size in bytes, or 0 for the system default */
+	Uint32 stacksize;
+	/** Scheduling priority, SDL_THREAD_PRIORITY_NORMAL by default,
+	 *  which leaves the thread with the scheduling it inherited.
+	 */
+	SDL_ThreadPriority priority;
+	/** Mask of the first 32 CPUs the thread may run on, or 0 for any */
+	Uint32 affinity;
+} SDL_ThreadAttr;
+
+/** Fill in the default thread settings */
+extern DECLSPEC void SDLCALL SDL_InitThreadAttr(SDL_ThreadAttr *attr);
+
 /** Create a thread */
 #if ((defined(__WIN32__) && !defined(HAVE_LIBC)) || defined(__OS2__)) &&  !defined(__SYMBIAN32__)
 /**
@@ -79,18 +112,36 @@ typedef void (__cdecl *pfnSDL_CurrentEndThread)(unsigned code);
 #endif
 
 extern DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *data, pfnSDL_CurrentBeginThread pfnBeginThread, pfnSDL_CurrentEndThread pfnEndThread);
+extern DECLSPEC SDL_Thread * SDLCALL SDL_CreateThreadEx(int (SDLCALL *fn)(void *), void *data, const SDL_ThreadAttr *attr, pfnSDL_CurrentBeginThread pfnBeginThread, pfnSDL_CurrentEndThread pfnEndThread);
 
 #ifdef __OS2__
 #define SDL_CreateThread(fn, data) SDL_CreateThread(fn, data, _beginthread, _endthread)
+#define SDL_CreateThreadEx(fn, data, attr) SDL_CreateThreadEx(fn, data, attr, _beginthread, _endthread)
 #elif defined(_WIN32_WCE)
 #define SDL_CreateThread(fn, data) SDL_CreateThread(fn, data, NULL, NULL)
+#define SDL_CreateThreadEx(fn, data, attr) SDL_CreateThreadEx(fn, data, attr, NULL, NULL)
 #else
 #define SDL_CreateThread(fn, data) SDL_CreateThread(fn, data, _beginthreadex, _endthreadex)
+#define SDL_CreateThreadEx(fn, data, attr) SDL_CreateThreadEx(fn, data, attr, _beginthreadex, _endthreadex)
 #endif
 #else
 extern DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *data);
+
+/** Create a thread with the given name, stack size, priority and CPU
+ *  affinity.  If attr is NULL this is the same as SDL_CreateThread().
+ *
+ *  Settings the system doesn't support are ignored.  If a priority
+ *  can't be set because of missing privileges, the thread is still
+ *  created and runs at the priority it inherited.
+ */
+extern DECLSPEC SDL_Thread * SDLCALL SDL_CreateThreadEx(int (SDLCALL *fn)(void *), void *data, const SDL_ThreadAttr *attr);
 #endif
 
+/** Set the scheduling priority of the current thread.
+ *  @return 0, or -1 if the priority couldn't be changed.
+ */
+extern DECLSPEC int SDLCALL SDL_SetThreadPriority(SDL_ThreadPriority priority);
+
 /** Get the 32-bit thread identifier for the current thread */
 extern DECLSPEC Uint32 SDLCALL SDL_ThreadID(void);
 
@@ -414,6 +414,139 @@ extern DECLSPEC void SDLCALL SDL_UpdateRect
  */
 extern DECLSPEC int SDLCALL SDL_Flip(SDL_Surface *screen);
 
+/** Presentation statistics for SDL_Flip(), counted from SDL_SetVideoMode() */
+typedef struct SDL_FlipStats {
+	Uint32 frames_queued;	/**< Frames passed to SDL_Flip() */
+	Uint32 frames_shown;	/**< Frames that reached the screen */
+	Uint32 frames_dropped;	/**< Frames replaced by a newer one before being shown */
+	Uint32 frames_pending;	/**< Frames queued but not shown yet */
+	Uint32 last_frame;	/**< Number of the last frame shown, counting from 1 */
+	Uint32 last_present;	/**< SDL_GetTicks() when that frame was shown */
+} SDL_FlipStats;
+
+/**
+ * Get the presentation statistics for the display surface, so that an
+ * application can tell when its frames reach the screen and pace itself.
+ * With SDL_TRIPLEBUF, SDL_Flip() queues the frame and returns at once,
+ * and the frame is shown at the next vertical retrace.  A frame that is
+ * still waiting when the next one is flipped is dropped.
+ * This function returns 0 if successful, or -1 if the video driver
+ * doesn't report presentation.
+ */
+extern DECLSPEC int SDLCALL SDL_GetFlipStats(SDL_FlipStats *stats);
+
+/** Statistics for SDL_UpdateRects(), counted from SDL_SetVideoMode() */
+typedef struct SDL_UpdateStats {
+	Uint32 updates;		/**< Calls to SDL_UpdateRects() */
+	Uint32 rects;		/**< Non-empty rectangles passed in */
+	Uint32 requests;	/**< Rectangles sent to the display after merging */
+	Uint32 flushes;		/**< Times the queued requests were sent off */
+	Uint32 pixels_asked;	/**< Pixels in the rectangles passed in */
+	Uint32 pixels_sent;	/**< Pixels in the rectangles sent */
+} SDL_UpdateStats;
+
+/**
+ * Get the screen update statistics for the display surface.
+ * Drivers may merge nearby rectangles into fewer, larger requests,
+ * sending some pixels that didn't change to save per-request overhead.
+ * The counters wrap around, so compare the differences between calls.
+ * This function returns 0 if successful, or -1 if the video driver
+ * doesn't report updates.
+ */
+extern DECLSPEC int SDLCALL SDL_GetUpdateStats(SDL_UpdateStats *stats);
+
+/** Number of blit routines SDL_GetVideoStats() keeps apart */
+#define SDL_MAX_BLITTER_STATS	32
+
+/** Blits done by one software blit routine */
+typedef struct SDL_BlitterStats {
+	const char *name;	/**< Name of the blit routine */
+	Uint32 blits;		/**< Blits done with it */
+	Uint32 pixels;		/**< Pixels blitted with it */
+} SDL_BlitterStats;
+
+/** Work done by the video core, counted while statistics are enabled */
+typedef struct SDL_VideoStats {
+	Uint32 frames;		/**< SDL_Flip() and SDL_UpdateRects() calls on the screen */
+	Uint32 blits;		/**< Blits done, after clipping */
+	Uint32 blit_pixels;	/**< Pixels blitted */
+	Uint32 fills;		/**< Rectangles filled, after clipping */
+	Uint32 fill_pixels;	/**< Pixels filled */
+	Uint32 updates;		/**< SDL_UpdateRects() calls on the screen */
+	Uint32 update_rects;	/**< Rectangles passed to SDL_UpdateRects() */
+	Uint32 update_pixels;	/**< Pixels in those rectangles */
+	Uint32 locks;		/**< SDL_LockSurface() calls */
+	Uint32 unlocks;		/**< SDL_UnlockSurface() calls */
+	Uint32 convert_usec;	/**< Microseconds spent copying the shadow surface to the screen */
+	Uint32 present_usec;	/**< Microseconds spent in the driver updating or flipping the screen */
+	int num_blitters;	/**< Number of entries used in blitters, the last is "other" once full */
+	SDL_BlitterStats blitters[SDL_MAX_BLITTER_STATS];
+} SDL_VideoStats;
+
+/**
+ * Enable or disable the video statistics returned by SDL_GetVideoStats().
+ * They are off by default, and cost very little until enabled.
+ * If 'enable' is -1, the current state is not changed.
+ * Setting the environment variable SDL_VIDEO_STATS to a number of frames
+ * enables statistics and prints the average per frame to stderr every
+ * that many frames.
+ * This function returns the previous state: 1 if enabled, 0 if disabled.
+ */
+extern DECLSPEC int SDLCALL SDL_EnableVideoStats(int enable);
+
+/**
+ * Copy the video statistics counted since the last reset into 'stats'.
+ * If 'reset' is non-zero, the counters start again from zero, so calling
+ * this once per frame with 'reset' set gives the figures for each frame.
+ * The counters aren't locked, so blits done from other threads while
+ * this is called may be lost.
+ */
+extern DECLSPEC void SDLCALL SDL_GetVideoStats(SDL_VideoStats *stats, int reset);
+
+/** @name Blit features
+ *  Instruction sets the software blitters, YUV conversion and
+ *  SDL_memcpy2D() / SDL_memset2D() may use
+ */
+/*@{*/
+#define SDL_BLIT_C		0x00000000	/**< Plain C only */
+#define SDL_BLIT_MMX		0x00000001
+#define SDL_BLIT_3DNOW		0x00000002
+#define SDL_BLIT_SSE		0x00000004
+#define SDL_BLIT_SSE2		0x00000008
+#define SDL_BLIT_AVX2		0x00000010
+#define SDL_BLIT_ALTIVEC	0x00000020
+#define SDL_BLIT_ARMSIMD	0x00000040
+#define SDL_BLIT_NEON		0x00000080
+#define SDL_BLIT_ALL		0xFFFFFFFF	/**< Whatever the CPU has */
+/*@}*/
+
+/**
+ * Restrict the instruction sets the software blitters may use, for
+ * comparing the blit routines against each other.
+ * 'features' is a mask of SDL_BLIT_* values, SDL_BLIT_C for plain C only
+ * or SDL_BLIT_ALL to use everything the CPU has, which is the default.
+ * The environment variable SDL_BLIT_FEATURES sets the starting mask as a
+ * list of names, for example "c", "mmx,sse" or "neon".
+ * Blits already set up keep their routine until their mapping is
+ * recalculated, for example by SDL_SetColorKey() or SDL_SetAlpha().
+ * This function returns the instruction sets that will be used.
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_SetBlitFeatures(Uint32 features);
+
+/**
+ * Get the instruction sets the software blitters may use: the ones the
+ * CPU has, less any left out with SDL_SetBlitFeatures().
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_GetBlitFeatures(void);
+
+/**
+ * Get the name of the blit routine SDL_BlitSurface() would use to blit
+ * 'src' onto 'dst', setting up the blit mapping if needed.
+ * The name is "hardware" for accelerated blits.
+ * This function returns NULL if the surfaces can't be blitted.
+ */
+extern DECLSPEC const char * SDLCALL SDL_GetBlitterName(SDL_Surface *src, SDL_Surface *dst);
+
 /**
  * Set the gamma correction for each of the color channels.
  * The gamma values range (approximately) between 0.1 and 10.0
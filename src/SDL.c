@@ -47,6 +47,7 @@ extern void SDL_StartTicks(void);
 extern int  SDL_TimerInit(void);
 extern void SDL_TimerQuit(void);
 #endif
+extern void SDL_AtomicQuit(void);
 
 /* The current SDL version */
 static SDL_version version = 
@@ -239,6 +240,9 @@ void SDL_Quit(void)
 	/* Uninstall any parachute signal handlers */
 	SDL_UninstallParachute();
 
+	/* Free the lock behind the atomic operations, if any */
+	SDL_AtomicQuit();
+
 #if !SDL_THREADS_DISABLED && SDL_THREAD_PTH
 	pth_kill();
 #endif
@@ -26,6 +26,8 @@
 #include "SDL.h"
 #include "SDL_audio_c.h"
 #include "SDL_audiomem.h"
+#include "SDL_audioqueue_c.h"
+#include "SDL_audioring_c.h"
 #include "SDL_sysaudio.h"
 
 /* Available audio drivers */
@@ -114,10 +116,31 @@ static AudioBootStrap *bootstrap[] = {
 };
 SDL_AudioDevice *current_audio = NULL;
 
+/* The audio pushed with SDL_QueueAudio(), when there's no callback */
+static SDL_AudioQueue *audio_queue = NULL;
+
+/* The audio capture device, and how its audio reaches the application */
+static SDL_AudioDevice *current_capture = NULL;
+static SDL_AudioSpec capture_spec;	/* the format the application gets */
+static SDL_AudioRing *capture_ring = NULL;
+static SDL_sem *capture_ready = NULL;
+static SDL_Thread *capture_thread = NULL;
+static Uint8 *capture_buf = NULL;
+
+/* How many capture buffers the ring holds before recording is dropped */
+#define CAPTURE_RING_BUFFERS	8
+
 /* Various local functions */
 int SDL_AudioInit(const char *driver_name);
 void SDL_AudioQuit(void);
 
+/* The callback for queued audio: it goes straight into the stream,
+   and whatever the queue is short of stays silent */
+static void SDLCALL SDL_DrainAudioQueue(void *userdata, Uint8 *stream, int len)
+{
+	SDL_ReadAudioQueue((SDL_AudioQueue *)userdata, stream, (Uint32)len);
+}
+
 /* The general mixing thread function */
 int SDLCALL SDL_RunAudio(void *audiop)
 {
@@ -151,7 +174,7 @@ int SDLCALL SDL_RunAudio(void *audiop)
 	}
 
 	/* Loop, filling the audio buffers */
-	while ( audio->enabled ) {
+	while ( SDL_AtomicLoad(&audio->enabled) ) {
 
 		/* Fill the current buffer with sound */
 		if ( audio->convert.needed ) {
@@ -169,7 +192,7 @@ int SDLCALL SDL_RunAudio(void *audiop)
 
 		SDL_memset(stream, silence, stream_len);
 
-		if ( ! audio->paused ) {
+		if ( ! SDL_AtomicLoad(&audio->paused) ) {
 			SDL_mutexP(audio->mixer_lock);
 			(*fill)(udata, stream, stream_len);
 			SDL_mutexV(audio->mixer_lock);
@@ -373,26 +396,11 @@ char *SDL_AudioDriverName(char *namebuf, int maxlen)
 	return(NULL);
 }
 
-int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
+/* Fill in the parts of an audio specification the application left out */
+static int SDL_DefaultAudioSpec(SDL_AudioSpec *desired)
 {
-	SDL_AudioDevice *audio;
 	const char *env;
 
-	/* Start up the audio driver, if necessary */
-	if ( ! current_audio ) {
-		if ( (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) ||
-		     (current_audio == NULL) ) {
-			return(-1);
-		}
-	}
-	audio = current_audio;
-
-	if (audio->opened) {
-		SDL_SetError("Audio device is already opened");
-		return(-1);
-	}
-
-	/* Verify some parameters */
 	if ( desired->freq == 0 ) {
 		env = SDL_getenv("SDL_AUDIO_FREQUENCY");
 		if ( env ) {
@@ -448,11 +456,45 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 		}
 		desired->samples = power2;
 	}
-	if ( desired->callback == NULL ) {
-		SDL_SetError("SDL_OpenAudio() passed a NULL callback");
+	return(0);
+}
+
+int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
+{
+	SDL_AudioDevice *audio;
+
+	/* Start up the audio driver, if necessary.  SDL_CloseAudio() frees
+	   the output device without quitting while capture is open. */
+	if ( ! current_audio ) {
+		if ( SDL_WasInit(SDL_INIT_AUDIO) ) {
+			SDL_AudioInit(SDL_getenv("SDL_AUDIODRIVER"));
+		} else if ( SDL_InitSubSystem(SDL_INIT_AUDIO) < 0 ) {
+			return(-1);
+		}
+		if ( current_audio == NULL ) {
+			return(-1);
+		}
+	}
+	audio = current_audio;
+
+	if (audio->opened) {
+		SDL_SetError("Audio device is already opened");
 		return(-1);
 	}
 
+	/* Verify some parameters */
+	if ( SDL_DefaultAudioSpec(desired) < 0 ) {
+		return(-1);
+	}
+
+	/* Without a callback, the application queues its audio */
+	if ( desired->callback == NULL ) {
+		audio_queue = SDL_CreateAudioQueue();
+		if ( audio_queue == NULL ) {
+			return(-1);
+		}
+	}
+
 #if SDL_THREADS_DISABLED
 	/* Uses interrupt driven audio, without thread */
 #else
@@ -470,9 +512,13 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 
 	/* Open the audio subsystem */
 	SDL_memcpy(&audio->spec, desired, sizeof(audio->spec));
+	if ( audio_queue ) {
+		audio->spec.callback = SDL_DrainAudioQueue;
+		audio->spec.userdata = audio_queue;
+	}
 	audio->convert.needed = 0;
-	audio->enabled = 1;
-	audio->paused  = 1;
+	SDL_AtomicStore(&audio->enabled, 1);
+	SDL_AtomicStore(&audio->paused, 1);
 
 	audio->opened = audio->OpenAudio(audio, &audio->spec)+1;
 
@@ -498,6 +544,8 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 	/* See if we need to do any conversion */
 	if ( obtained != NULL ) {
 		SDL_memcpy(obtained, &audio->spec, sizeof(audio->spec));
+		obtained->callback = desired->callback;
+		obtained->userdata = desired->userdata;
 	} else if ( desired->freq != audio->spec.freq ||
 		    desired->format != audio->spec.format ||
 		    desired->channels != audio->spec.channels ) {
@@ -525,13 +573,20 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 
 	/* Start the audio thread if necessary */
 	switch (audio->opened) {
-		case  1:
-			/* Start the audio thread */
+		case  1: {
+			SDL_ThreadAttr attr;
+
+			/* Start the audio thread, ahead of the application's
+			   threads so the device doesn't underrun under load.
+			 */
+			SDL_InitThreadAttr(&attr);
+			attr.name = "SDLAudio";
+			attr.priority = SDL_THREAD_PRIORITY_HIGH;
 #if (defined(__WIN32__) && !defined(_WIN32_WCE)) && !defined(HAVE_LIBC) && !defined(__SYMBIAN32__)
-#undef SDL_CreateThread
-			audio->thread = SDL_CreateThread(SDL_RunAudio, audio, NULL, NULL);
+#undef SDL_CreateThreadEx
+			audio->thread = SDL_CreateThreadEx(SDL_RunAudio, audio, &attr, NULL, NULL);
 #else
-			audio->thread = SDL_CreateThread(SDL_RunAudio, audio);
+			audio->thread = SDL_CreateThreadEx(SDL_RunAudio, audio, &attr);
 #endif
 			if ( audio->thread == NULL ) {
 				SDL_CloseAudio();
@@ -539,6 +594,7 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 				return(-1);
 			}
 			break;
+		}
 
 		default:
 			/* The audio is now playing */
@@ -554,8 +610,8 @@ SDL_audiostatus SDL_GetAudioStatus(void)
 	SDL_audiostatus status;
 
 	status = SDL_AUDIO_STOPPED;
-	if ( audio && audio->enabled ) {
-		if ( audio->paused ) {
+	if ( audio && SDL_AtomicLoad(&audio->enabled) ) {
+		if ( SDL_AtomicLoad(&audio->paused) ) {
 			status = SDL_AUDIO_PAUSED;
 		} else {
 			status = SDL_AUDIO_PLAYING;
@@ -564,12 +620,27 @@ SDL_audiostatus SDL_GetAudioStatus(void)
 	return(status);
 }
 
+int SDL_GetAudioLatency(void)
+{
+	SDL_AudioDevice *audio = current_audio;
+
+	if ( !audio || !audio->opened ) {
+		SDL_SetError("Audio device is not opened");
+		return(-1);
+	}
+	if ( !audio->GetLatency ) {
+		SDL_Unsupported();
+		return(-1);
+	}
+	return audio->GetLatency(audio);
+}
+
 void SDL_PauseAudio (int pause_on)
 {
 	SDL_AudioDevice *audio = current_audio;
 
 	if ( audio ) {
-		audio->paused = pause_on;
+		SDL_AtomicStore(&audio->paused, pause_on);
 	}
 }
 
@@ -593,20 +664,46 @@ void SDL_UnlockAudio (void)
 	}
 }
 
-void SDL_CloseAudio (void)
+int SDL_QueueAudio(const void *data, Uint32 len)
 {
-	SDL_QuitSubSystem(SDL_INIT_AUDIO);
+	if ( audio_queue == NULL ) {
+		SDL_SetError("Audio device is not opened for queueing");
+		return(-1);
+	}
+	return SDL_WriteAudioQueue(audio_queue, (const Uint8 *)data, len);
 }
 
-void SDL_AudioQuit(void)
+Uint32 SDL_GetQueuedAudioSize(void)
+{
+	if ( audio_queue == NULL ) {
+		return(0);
+	}
+	return SDL_AudioQueueSize(audio_queue);
+}
+
+void SDL_ClearQueuedAudio(void)
+{
+	if ( audio_queue ) {
+		SDL_ClearAudioQueue(audio_queue);
+	}
+}
+
+/* Shut down and free the output device, leaving any recording alone */
+static void SDL_CloseAudioOutput(void)
 {
 	SDL_AudioDevice *audio = current_audio;
 
 	if ( audio ) {
-		audio->enabled = 0;
+		SDL_AtomicStore(&audio->enabled, 0);
 		if ( audio->thread != NULL ) {
 			SDL_WaitThread(audio->thread, NULL);
 		}
+		/* Drivers without an audio thread mix from their own callbacks,
+		   so close them before the mixer lock and buffers go away. */
+		if ( audio->opened ) {
+			audio->CloseAudio(audio);
+			audio->opened = 0;
+		}
 		if ( audio->mixer_lock != NULL ) {
 			SDL_DestroyMutex(audio->mixer_lock);
 		}
@@ -617,14 +714,389 @@ void SDL_AudioQuit(void)
 			SDL_FreeAudioMem(audio->convert.buf);
 
 		}
-		if ( audio->opened ) {
-			audio->CloseAudio(audio);
-			audio->opened = 0;
-		}
 		/* Free the driver data */
 		audio->free(audio);
 		current_audio = NULL;
 	}
+	if ( audio_queue != NULL ) {
+		SDL_FreeAudioQueue(audio_queue);
+		audio_queue = NULL;
+	}
+}
+
+void SDL_CloseAudio (void)
+{
+	/* Recording is opened on its own, so keep the subsystem up for it */
+	if ( current_capture ) {
+		SDL_CloseAudioOutput();
+	} else {
+		SDL_QuitSubSystem(SDL_INIT_AUDIO);
+	}
+}
+
+void SDL_AudioQuit(void)
+{
+	SDL_CloseAudioCapture();
+	SDL_CloseAudioOutput();
+}
+
+/* The capture thread function: record from the driver into the ring.
+   It never waits for the application; if the ring is full, the buffer
+   that was just recorded is dropped.
+ */
+static int SDLCALL SDL_RunAudioCapture(void *audiop)
+{
+	SDL_AudioDevice *audio = (SDL_AudioDevice *)audiop;
+	Uint8 *stream;
+	int    stream_len;
+
+	/* Perform any thread setup */
+	if ( audio->ThreadInit ) {
+		audio->ThreadInit(audio);
+	}
+	audio->threadid = SDL_ThreadID();
+
+	if ( audio->convert.needed ) {
+		stream = audio->convert.buf;
+	} else {
+		stream = audio->fake_stream;
+	}
+
+	while ( SDL_AtomicLoad(&audio->enabled) ) {
+		stream_len = audio->CaptureAudio(audio, stream, audio->spec.size);
+		if ( stream_len < 0 ) {
+			SDL_AtomicStore(&audio->enabled, 0);
+			break;
+		}
+		if ( (stream_len == 0) || SDL_AtomicLoad(&audio->paused) ) {
+			continue;
+		}
+
+		/* Convert the audio if necessary */
+		if ( audio->convert.needed ) {
+			audio->convert.len = stream_len;
+			SDL_ConvertAudio(&audio->convert);
+			stream_len = audio->convert.len_cvt;
+		}
+
+		if ( SDL_AudioRingSpace(capture_ring) >= (Uint32)stream_len ) {
+			SDL_WriteAudioRing(capture_ring, stream, stream_len);
+			if ( capture_ready ) {
+				SDL_SemPost(capture_ready);
+			}
+		}
+	}
+
+	/* Wake up the callback thread so it can see we're done */
+	if ( capture_ready ) {
+		SDL_SemPost(capture_ready);
+	}
+	return(0);
+}
+
+/* Hand the recorded audio to the application callback */
+static int SDLCALL SDL_RunAudioCaptureCallback(void *audiop)
+{
+	SDL_AudioDevice *audio = (SDL_AudioDevice *)audiop;
+	Uint32 len = capture_spec.size;
+
+	while ( SDL_AtomicLoad(&audio->enabled) ) {
+		SDL_SemWait(capture_ready);
+		while ( SDL_AtomicLoad(&audio->enabled) &&
+		        (SDL_AudioRingAvailable(capture_ring) >= len) ) {
+			SDL_ReadAudioRing(capture_ring, capture_buf, len);
+			(*capture_spec.callback)(capture_spec.userdata,
+			                         capture_buf, len);
+		}
+	}
+	return(0);
+}
+
+/* Find a driver that can record, preferring the one used for output */
+static SDL_AudioDevice *SDL_CreateCaptureDevice(void)
+{
+	SDL_AudioDevice *audio;
+	const char *driver_name;
+	int i;
+
+	audio = NULL;
+	driver_name = SDL_getenv("SDL_AUDIO_CAPTURE_DRIVER");
+	if ( (driver_name == NULL) && current_audio ) {
+		driver_name = current_audio->name;
+	}
+	if ( driver_name != NULL ) {
+		for ( i=0; bootstrap[i]; ++i ) {
+			if ( SDL_strcasecmp(bootstrap[i]->name, driver_name) != 0 ) {
+				continue;
+			}
+			/* The output device may be holding it open already */
+			if ( (current_audio &&
+			      current_audio->name == bootstrap[i]->name) ||
+			     bootstrap[i]->available() ) {
+				audio = bootstrap[i]->create(0);
+			}
+			break;
+		}
+		if ( audio && !audio->OpenCapture ) {
+			audio->free(audio);
+			audio = NULL;
+		}
+	}
+	if ( audio == NULL ) {
+		for ( i=0; bootstrap[i]; ++i ) {
+			if ( bootstrap[i]->available() ) {
+				audio = bootstrap[i]->create(0);
+				if ( audio && audio->OpenCapture ) {
+					break;
+				}
+				if ( audio ) {
+					audio->free(audio);
+					audio = NULL;
+				}
+			}
+		}
+	}
+	if ( audio == NULL ) {
+		SDL_SetError("No available audio capture device");
+		return(NULL);
+	}
+	audio->name = bootstrap[i]->name;
+	return(audio);
+}
+
+#if !SDL_THREADS_DISABLED
+static SDL_Thread *SDL_CreateCaptureThread(int (SDLCALL *fn)(void *),
+                                           const char *name,
+                                           SDL_ThreadPriority priority)
+{
+	SDL_ThreadAttr attr;
+
+	SDL_InitThreadAttr(&attr);
+	attr.name = name;
+	attr.priority = priority;
+#if (defined(__WIN32__) && !defined(_WIN32_WCE)) && !defined(HAVE_LIBC) && !defined(__SYMBIAN32__)
+#undef SDL_CreateThreadEx
+	return SDL_CreateThreadEx(fn, current_capture, &attr, NULL, NULL);
+#else
+	return SDL_CreateThreadEx(fn, current_capture, &attr);
+#endif
+}
+#endif /* !SDL_THREADS_DISABLED */
+
+int SDL_OpenAudioCapture(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
+{
+	SDL_AudioDevice *audio;
+	Uint32 ring_len;
+
+	/* Start up the audio subsystem, if necessary */
+	if ( ! SDL_WasInit(SDL_INIT_AUDIO) ) {
+		if ( SDL_InitSubSystem(SDL_INIT_AUDIO) < 0 ) {
+			return(-1);
+		}
+	}
+	if ( current_capture ) {
+		SDL_SetError("Audio capture device is already opened");
+		return(-1);
+	}
+
+#if SDL_THREADS_DISABLED
+	SDL_SetError("Audio capture needs threads");
+	return(-1);
+#else
+	/* Verify some parameters */
+	if ( SDL_DefaultAudioSpec(desired) < 0 ) {
+		return(-1);
+	}
+	SDL_CalculateAudioSpec(desired);
+
+	audio = SDL_CreateCaptureDevice();
+	if ( audio == NULL ) {
+		return(-1);
+	}
+	current_capture = audio;
+
+	/* Open the recording device */
+	SDL_memcpy(&audio->spec, desired, sizeof(audio->spec));
+	audio->convert.needed = 0;
+	SDL_AtomicStore(&audio->enabled, 1);
+	SDL_AtomicStore(&audio->paused, 1);
+
+	if ( audio->OpenCapture(audio, &audio->spec) < 0 ) {
+		SDL_CloseAudioCapture();
+		return(-1);
+	}
+	audio->opened = 1;
+
+	/* If the audio driver changes the buffer size, accept it */
+	if ( audio->spec.samples != desired->samples ) {
+		desired->samples = audio->spec.samples;
+		SDL_CalculateAudioSpec(desired);
+	}
+
+	/* See if we need to do any conversion */
+	if ( obtained != NULL ) {
+		SDL_memcpy(obtained, &audio->spec, sizeof(audio->spec));
+		SDL_memcpy(&capture_spec, &audio->spec, sizeof(capture_spec));
+	} else {
+		SDL_memcpy(&capture_spec, desired, sizeof(capture_spec));
+		if ( SDL_BuildAudioCVT(&audio->convert,
+			audio->spec.format, audio->spec.channels,
+					audio->spec.freq,
+			desired->format, desired->channels,
+					desired->freq) < 0 ) {
+			SDL_CloseAudioCapture();
+			return(-1);
+		}
+	}
+	if ( audio->convert.needed ) {
+		audio->convert.len = audio->spec.size;
+		audio->convert.buf = (Uint8 *)SDL_AllocAudioMem(
+			audio->convert.len*audio->convert.len_mult);
+		if ( audio->convert.buf == NULL ) {
+			SDL_CloseAudioCapture();
+			SDL_OutOfMemory();
+			return(-1);
+		}
+		ring_len = (Uint32)(audio->spec.size * audio->convert.len_ratio);
+	} else {
+		audio->fake_stream = SDL_AllocAudioMem(audio->spec.size);
+		if ( audio->fake_stream == NULL ) {
+			SDL_CloseAudioCapture();
+			SDL_OutOfMemory();
+			return(-1);
+		}
+		ring_len = audio->spec.size;
+	}
+
+	/* Room for a few of the driver's and the application's buffers */
+	ring_len = SDL_max(ring_len, capture_spec.size) * CAPTURE_RING_BUFFERS;
+	capture_ring = SDL_CreateAudioRing(ring_len);
+	if ( capture_ring == NULL ) {
+		SDL_CloseAudioCapture();
+		return(-1);
+	}
+
+	/* Without a callback, the application reads with SDL_ReadAudioCapture() */
+	if ( capture_spec.callback ) {
+		capture_buf = (Uint8 *)SDL_AllocAudioMem(capture_spec.size);
+		capture_ready = SDL_CreateSemaphore(0);
+		if ( (capture_buf == NULL) || (capture_ready == NULL) ) {
+			SDL_CloseAudioCapture();
+			SDL_OutOfMemory();
+			return(-1);
+		}
+		capture_thread = SDL_CreateCaptureThread(
+			SDL_RunAudioCaptureCallback, "SDLCaptureFeed",
+			SDL_THREAD_PRIORITY_NORMAL);
+		if ( capture_thread == NULL ) {
+			SDL_CloseAudioCapture();
+			SDL_SetError("Couldn't create audio capture thread");
+			return(-1);
+		}
+	}
+
+	/* Start the recording thread, which should never be kept waiting */
+	audio->thread = SDL_CreateCaptureThread(SDL_RunAudioCapture,
+		"SDLAudioCapture", SDL_THREAD_PRIORITY_HIGH);
+	if ( audio->thread == NULL ) {
+		SDL_CloseAudioCapture();
+		SDL_SetError("Couldn't create audio capture thread");
+		return(-1);
+	}
+
+	return(0);
+#endif /* SDL_THREADS_DISABLED */
+}
+
+SDL_audiostatus SDL_GetAudioCaptureStatus(void)
+{
+	SDL_AudioDevice *audio = current_capture;
+	SDL_audiostatus status;
+
+	status = SDL_AUDIO_STOPPED;
+	if ( audio && SDL_AtomicLoad(&audio->enabled) ) {
+		if ( SDL_AtomicLoad(&audio->paused) ) {
+			status = SDL_AUDIO_PAUSED;
+		} else {
+			status = SDL_AUDIO_PLAYING;
+		}
+	}
+	return(status);
+}
+
+void SDL_PauseAudioCapture(int pause_on)
+{
+	SDL_AudioDevice *audio = current_capture;
+
+	if ( audio ) {
+		SDL_AtomicStore(&audio->paused, pause_on);
+	}
+}
+
+int SDL_ReadAudioCapture(void *data, int len)
+{
+	int frame_size;
+
+	if ( current_capture == NULL ) {
+		SDL_SetError("Audio capture device is not opened");
+		return(-1);
+	}
+	if ( capture_spec.callback ) {
+		SDL_SetError("Audio capture is delivered to a callback");
+		return(-1);
+	}
+
+	/* Only hand out whole sample frames */
+	frame_size = ((capture_spec.format & 0xFF) / 8) * capture_spec.channels;
+	len -= (len % frame_size);
+	if ( len <= 0 ) {
+		return(0);
+	}
+	return (int)SDL_ReadAudioRing(capture_ring, (Uint8 *)data, (Uint32)len);
+}
+
+void SDL_CloseAudioCapture(void)
+{
+	SDL_AudioDevice *audio = current_capture;
+
+	if ( audio == NULL ) {
+		return;
+	}
+
+	SDL_AtomicStore(&audio->enabled, 0);
+	if ( audio->thread != NULL ) {
+		SDL_WaitThread(audio->thread, NULL);
+	}
+	if ( capture_thread != NULL ) {
+		SDL_SemPost(capture_ready);
+		SDL_WaitThread(capture_thread, NULL);
+		capture_thread = NULL;
+	}
+	if ( audio->opened ) {
+		audio->CloseAudio(audio);
+		audio->opened = 0;
+	}
+	if ( capture_ready != NULL ) {
+		SDL_DestroySemaphore(capture_ready);
+		capture_ready = NULL;
+	}
+	if ( capture_buf != NULL ) {
+		SDL_FreeAudioMem(capture_buf);
+		capture_buf = NULL;
+	}
+	if ( capture_ring != NULL ) {
+		SDL_FreeAudioRing(capture_ring);
+		capture_ring = NULL;
+	}
+	if ( audio->fake_stream != NULL ) {
+		SDL_FreeAudioMem(audio->fake_stream);
+	}
+	if ( audio->convert.needed ) {
+		SDL_FreeAudioMem(audio->convert.buf);
+	}
+	/* Free the driver data */
+	audio->free(audio);
+	current_capture = NULL;
 }
 
 #define NUM_FORMATS	6
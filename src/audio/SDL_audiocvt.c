@@ -1508,3 +1508,55 @@ int SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
 	}
 	return(cvt->needed);
 }
+
+#define AUDIO_FILTER(filter)	{ filter, #filter }
+static const struct {
+	SDL_AudioFilter filter;
+	const char *name;
+} audio_filters[] = {
+	AUDIO_FILTER(SDL_ConvertMono),
+	AUDIO_FILTER(SDL_ConvertStrip),
+	AUDIO_FILTER(SDL_ConvertStrip_2),
+	AUDIO_FILTER(SDL_ConvertStereo),
+	AUDIO_FILTER(SDL_ConvertSurround),
+	AUDIO_FILTER(SDL_ConvertSurround_4),
+	AUDIO_FILTER(SDL_Convert16LSB),
+	AUDIO_FILTER(SDL_Convert16MSB),
+	AUDIO_FILTER(SDL_Convert8),
+	AUDIO_FILTER(SDL_ConvertSign),
+	AUDIO_FILTER(SDL_ConvertEndian),
+	AUDIO_FILTER(SDL_RateMUL2),
+	AUDIO_FILTER(SDL_RateMUL2_c2),
+	AUDIO_FILTER(SDL_RateMUL2_c4),
+	AUDIO_FILTER(SDL_RateMUL2_c6),
+	AUDIO_FILTER(SDL_RateDIV2),
+	AUDIO_FILTER(SDL_RateDIV2_c2),
+	AUDIO_FILTER(SDL_RateDIV2_c4),
+	AUDIO_FILTER(SDL_RateDIV2_c6),
+	AUDIO_FILTER(SDL_RateSLOW)
+};
+
+const char *SDL_GetAudioFilterName(SDL_AudioFilter filter)
+{
+	int i;
+
+	for ( i=0; i<(int)SDL_arraysize(audio_filters); ++i ) {
+		if ( audio_filters[i].filter == filter ) {
+			return(audio_filters[i].name);
+		}
+	}
+	return(NULL);
+}
+
+SDL_AudioFilter SDL_GetAudioFilter(const char *name)
+{
+	int i;
+
+	for ( i=0; i<(int)SDL_arraysize(audio_filters); ++i ) {
+		if ( SDL_strcmp(audio_filters[i].name, name) == 0 ) {
+			return(audio_filters[i].filter);
+		}
+	}
+	SDL_SetError("Unknown audio filter %s", name);
+	return(NULL);
+}
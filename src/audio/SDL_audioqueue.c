@@ -0,0 +1,247 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* A lock-free queue of audio chunks, for pushing audio to the audio thread */
+
+#include "SDL_atomic.h"
+#include "SDL_error.h"
+#include "SDL_audioqueue_c.h"
+
+/* The queue grows and shrinks by chunks of this many bytes */
+#define AUDIO_CHUNK_SIZE	8192
+
+/* Every chunk in the queue is full but the last one, so the running byte
+   counts are all the reader needs to know how far it can go.
+ */
+typedef struct SDL_AudioChunk {
+	/* The next chunk in the queue, linked in by the writer once this one
+	   is full.  On the free lists it links the free chunks instead. */
+	SDL_AtomicPointer next;
+	Uint8 data[AUDIO_CHUNK_SIZE];
+} SDL_AudioChunk;
+
+struct SDL_AudioQueue {
+	/* Writer side, protected by 'lock' */
+	SDL_SpinLock lock;
+	SDL_AudioChunk *tail;	/* the chunk being written to */
+	Uint32 tail_used;	/* bytes written to it */
+	SDL_AudioChunk *spare;	/* chunks ready to be linked in */
+	Uint32 num_spare;
+
+	/* Reader side */
+	SDL_AudioChunk *head;	/* the chunk being read from */
+	Uint32 head_pos;	/* bytes read from it */
+
+	/* Chunks the reader has finished with, for the writer to take back */
+	SDL_AtomicPointer freed;
+
+	/* Running byte counts, they wrap around at 4 GB */
+	SDL_AtomicInt written;	/* only moved by the writer */
+	SDL_AtomicInt read;	/* only moved by the reader */
+	SDL_AtomicInt cleared;	/* everything before this is thrown away */
+};
+
+static SDL_AudioChunk *SDL_NewAudioChunk(void)
+{
+	SDL_AudioChunk *chunk;
+
+	chunk = (SDL_AudioChunk *)SDL_malloc(sizeof(*chunk));
+	if ( chunk == NULL ) {
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	SDL_AtomicStorePtr(&chunk->next, NULL);
+	return(chunk);
+}
+
+static void SDL_FreeAudioChunks(SDL_AudioChunk *chunk)
+{
+	SDL_AudioChunk *next;
+
+	while ( chunk ) {
+		next = (SDL_AudioChunk *)SDL_AtomicLoadPtr(&chunk->next);
+		SDL_free(chunk);
+		chunk = next;
+	}
+}
+
+SDL_AudioQueue *SDL_CreateAudioQueue(void)
+{
+	SDL_AudioQueue *queue;
+
+	queue = (SDL_AudioQueue *)SDL_malloc(sizeof(*queue));
+	if ( queue == NULL ) {
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	SDL_memset(queue, 0, sizeof(*queue));
+	queue->head = SDL_NewAudioChunk();
+	if ( queue->head == NULL ) {
+		SDL_free(queue);
+		return(NULL);
+	}
+	queue->tail = queue->head;
+	return(queue);
+}
+
+void SDL_FreeAudioQueue(SDL_AudioQueue *queue)
+{
+	if ( queue ) {
+		SDL_FreeAudioChunks(queue->head);
+		SDL_FreeAudioChunks(queue->spare);
+		SDL_FreeAudioChunks((SDL_AudioChunk *)SDL_AtomicLoadPtr(&queue->freed));
+		SDL_free(queue);
+	}
+}
+
+int SDL_WriteAudioQueue(SDL_AudioQueue *queue, const Uint8 *data, Uint32 len)
+{
+	SDL_AudioChunk *chunk, *next;
+	Uint32 total, needed, n;
+
+	SDL_AtomicLock(&queue->lock);
+
+	/* Gather enough chunks for all of it before linking any in */
+	needed = 0;
+	if ( len > AUDIO_CHUNK_SIZE - queue->tail_used ) {
+		needed = (len - (AUDIO_CHUNK_SIZE - queue->tail_used) +
+		          AUDIO_CHUNK_SIZE - 1) / AUDIO_CHUNK_SIZE;
+	}
+	if ( needed > queue->num_spare ) {
+		chunk = (SDL_AudioChunk *)SDL_AtomicSwapPtr(&queue->freed, NULL);
+		while ( chunk ) {
+			next = (SDL_AudioChunk *)SDL_AtomicLoadPtr(&chunk->next);
+			SDL_AtomicStorePtr(&chunk->next, queue->spare);
+			queue->spare = chunk;
+			++queue->num_spare;
+			chunk = next;
+		}
+	}
+	while ( needed > queue->num_spare ) {
+		chunk = SDL_NewAudioChunk();
+		if ( chunk == NULL ) {
+			SDL_AtomicUnlock(&queue->lock);
+			return(-1);
+		}
+		SDL_AtomicStorePtr(&chunk->next, queue->spare);
+		queue->spare = chunk;
+		++queue->num_spare;
+	}
+
+	total = len;
+	while ( len > 0 ) {
+		if ( queue->tail_used == AUDIO_CHUNK_SIZE ) {
+			chunk = queue->spare;
+			queue->spare = (SDL_AudioChunk *)SDL_AtomicLoadPtr(&chunk->next);
+			--queue->num_spare;
+			SDL_AtomicStorePtr(&chunk->next, NULL);
+			SDL_AtomicStorePtr(&queue->tail->next, chunk);
+			queue->tail = chunk;
+			queue->tail_used = 0;
+		}
+		n = SDL_min(len, AUDIO_CHUNK_SIZE - queue->tail_used);
+		SDL_memcpy(queue->tail->data + queue->tail_used, data, n);
+		queue->tail_used += n;
+		data += n;
+		len -= n;
+	}
+
+	/* Publish the data to the reader */
+	SDL_AtomicStore(&queue->written,
+	                (int)((Uint32)SDL_AtomicLoad(&queue->written) + total));
+
+	SDL_AtomicUnlock(&queue->lock);
+	return(0);
+}
+
+Uint32 SDL_ReadAudioQueue(SDL_AudioQueue *queue, Uint8 *data, Uint32 len)
+{
+	SDL_AudioChunk *chunk, *top;
+	Uint32 cleared, read, written, skip, total, copied, n;
+
+	/* Load 'cleared' and 'read' first, so neither is past 'written' */
+	cleared = (Uint32)SDL_AtomicLoad(&queue->cleared);
+	read = (Uint32)SDL_AtomicLoad(&queue->read);
+	written = (Uint32)SDL_AtomicLoad(&queue->written);
+
+	skip = 0;
+	if ( (Sint32)(cleared - read) > 0 ) {
+		skip = cleared - read;
+	}
+	if ( len > written - read - skip ) {
+		len = written - read - skip;
+	}
+	total = skip + len;
+	read += total;
+
+	copied = 0;
+	while ( total > 0 ) {
+		if ( queue->head_pos == AUDIO_CHUNK_SIZE ) {
+			/* The writer linked in the next chunk before it
+			   published the bytes we're after, so it's there */
+			chunk = queue->head;
+			queue->head = (SDL_AudioChunk *)SDL_AtomicLoadPtr(&chunk->next);
+			queue->head_pos = 0;
+
+			/* Hand the finished chunk back to the writer */
+			do {
+				top = (SDL_AudioChunk *)SDL_AtomicLoadPtr(&queue->freed);
+				SDL_AtomicStorePtr(&chunk->next, top);
+			} while ( ! SDL_AtomicCASPtr(&queue->freed, top, chunk) );
+		}
+		n = SDL_min(total, AUDIO_CHUNK_SIZE - queue->head_pos);
+		if ( skip > 0 ) {
+			n = SDL_min(n, skip);
+			skip -= n;
+		} else {
+			SDL_memcpy(data + copied, queue->head->data + queue->head_pos, n);
+			copied += n;
+		}
+		queue->head_pos += n;
+		total -= n;
+	}
+
+	/* Count the bytes as gone from the queue */
+	SDL_AtomicStore(&queue->read, (int)read);
+	return(copied);
+}
+
+Uint32 SDL_AudioQueueSize(SDL_AudioQueue *queue)
+{
+	Uint32 cleared, read, written;
+
+	cleared = (Uint32)SDL_AtomicLoad(&queue->cleared);
+	read = (Uint32)SDL_AtomicLoad(&queue->read);
+	written = (Uint32)SDL_AtomicLoad(&queue->written);
+	if ( (Sint32)(cleared - read) > 0 ) {
+		read = cleared;
+	}
+	return(written - read);
+}
+
+void SDL_ClearAudioQueue(SDL_AudioQueue *queue)
+{
+	SDL_AtomicLock(&queue->lock);
+	SDL_AtomicStore(&queue->cleared, SDL_AtomicLoad(&queue->written));
+	SDL_AtomicUnlock(&queue->lock);
+}
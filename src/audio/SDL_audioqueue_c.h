@@ -0,0 +1,55 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* A chunked queue of audio bytes.
+   Any thread may queue audio while one other thread reads it out without
+   taking a lock: the writer only links a new chunk in once the last one
+   is full, and publishes its byte count after the data it covers has
+   been copied.  Chunks the reader has finished with go back to the
+   writer, so once the queue has grown to its working size, neither side
+   allocates any memory.
+ */
+
+typedef struct SDL_AudioQueue SDL_AudioQueue;
+
+extern SDL_AudioQueue *SDL_CreateAudioQueue(void);
+extern void SDL_FreeAudioQueue(SDL_AudioQueue *queue);
+
+/* Copy all 'len' bytes onto the end of the queue, returning 0, or -1 if
+   there wasn't enough memory, in which case nothing was queued.
+   Writers are serialized with a spinlock, so any thread may call this.
+ */
+extern int SDL_WriteAudioQueue(SDL_AudioQueue *queue, const Uint8 *data, Uint32 len);
+
+/* Copy up to 'len' bytes off the front of the queue, returning the amount.
+   Only one thread may read.
+ */
+extern Uint32 SDL_ReadAudioQueue(SDL_AudioQueue *queue, Uint8 *data, Uint32 len);
+
+/* The number of bytes queued and not read yet */
+extern Uint32 SDL_AudioQueueSize(SDL_AudioQueue *queue);
+
+/* Throw away everything queued so far.  The reader skips over it the next
+   time it reads, so this is safe to call while it is running.
+ */
+extern void SDL_ClearAudioQueue(SDL_AudioQueue *queue);
@@ -0,0 +1,134 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* A lock-free ring buffer for passing audio between two threads */
+
+#include "SDL_atomic.h"
+#include "SDL_error.h"
+#include "SDL_audioring_c.h"
+
+struct SDL_AudioRing {
+	Uint8 *buf;
+	Uint32 mask;		/* the size is a power of two */
+
+	/* Running byte counts, they wrap around at 4 GB */
+	SDL_AtomicInt head;	/* written so far, only moved by the writer */
+	SDL_AtomicInt tail;	/* read so far, only moved by the reader */
+};
+
+SDL_AudioRing *SDL_CreateAudioRing(Uint32 size)
+{
+	SDL_AudioRing *ring;
+	Uint32 power2;
+
+	for ( power2 = 64; power2 < size; power2 *= 2 ) {
+		if ( power2 >= 0x40000000 ) {
+			SDL_SetError("Audio ring is too large");
+			return(NULL);
+		}
+	}
+
+	ring = (SDL_AudioRing *)SDL_malloc(sizeof(*ring));
+	if ( ring == NULL ) {
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	SDL_memset(ring, 0, sizeof(*ring));
+	ring->buf = (Uint8 *)SDL_malloc(power2);
+	if ( ring->buf == NULL ) {
+		SDL_free(ring);
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	ring->mask = power2 - 1;
+	return(ring);
+}
+
+void SDL_FreeAudioRing(SDL_AudioRing *ring)
+{
+	if ( ring ) {
+		SDL_free(ring->buf);
+		SDL_free(ring);
+	}
+}
+
+Uint32 SDL_AudioRingAvailable(SDL_AudioRing *ring)
+{
+	return (Uint32)SDL_AtomicLoad(&ring->head) -
+	       (Uint32)SDL_AtomicLoad(&ring->tail);
+}
+
+Uint32 SDL_AudioRingSpace(SDL_AudioRing *ring)
+{
+	return (ring->mask + 1) - SDL_AudioRingAvailable(ring);
+}
+
+Uint32 SDL_WriteAudioRing(SDL_AudioRing *ring, const Uint8 *data, Uint32 len)
+{
+	Uint32 head, tail, pos, first;
+
+	head = (Uint32)SDL_AtomicLoad(&ring->head);
+	tail = (Uint32)SDL_AtomicLoad(&ring->tail);
+	if ( len > (ring->mask + 1) - (head - tail) ) {
+		len = (ring->mask + 1) - (head - tail);
+	}
+	if ( len == 0 ) {
+		return(0);
+	}
+
+	pos = head & ring->mask;
+	first = SDL_min(len, ring->mask + 1 - pos);
+	SDL_memcpy(ring->buf + pos, data, first);
+	if ( first < len ) {
+		SDL_memcpy(ring->buf, data + first, len - first);
+	}
+
+	/* Publish the data to the reader */
+	SDL_AtomicStore(&ring->head, (int)(head + len));
+	return(len);
+}
+
+Uint32 SDL_ReadAudioRing(SDL_AudioRing *ring, Uint8 *data, Uint32 len)
+{
+	Uint32 head, tail, pos, first;
+
+	tail = (Uint32)SDL_AtomicLoad(&ring->tail);
+	head = (Uint32)SDL_AtomicLoad(&ring->head);
+	if ( len > head - tail ) {
+		len = head - tail;
+	}
+	if ( len == 0 ) {
+		return(0);
+	}
+
+	pos = tail & ring->mask;
+	first = SDL_min(len, ring->mask + 1 - pos);
+	SDL_memcpy(data, ring->buf + pos, first);
+	if ( first < len ) {
+		SDL_memcpy(data + first, ring->buf, len - first);
+	}
+
+	/* Hand the space back to the writer */
+	SDL_AtomicStore(&ring->tail, (int)(tail + len));
+	return(len);
+}
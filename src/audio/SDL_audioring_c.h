@@ -0,0 +1,44 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* A single-producer, single-consumer ring of audio bytes.
+   One thread may write to the ring while another reads from it without
+   any locking: each side only moves its own index, and publishes it
+   with release semantics after the data it covers has been copied.
+ */
+
+typedef struct SDL_AudioRing SDL_AudioRing;
+
+/* Create a ring that holds at least 'size' bytes */
+extern SDL_AudioRing *SDL_CreateAudioRing(Uint32 size);
+extern void SDL_FreeAudioRing(SDL_AudioRing *ring);
+
+/* The number of bytes waiting to be read, and the room left to write */
+extern Uint32 SDL_AudioRingAvailable(SDL_AudioRing *ring);
+extern Uint32 SDL_AudioRingSpace(SDL_AudioRing *ring);
+
+/* Copy up to 'len' bytes in or out of the ring, returning the amount.
+   Only one thread may write, and only one may read.
+ */
+extern Uint32 SDL_WriteAudioRing(SDL_AudioRing *ring, const Uint8 *data, Uint32 len);
+extern Uint32 SDL_ReadAudioRing(SDL_AudioRing *ring, Uint8 *data, Uint32 len);
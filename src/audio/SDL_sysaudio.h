@@ -24,6 +24,7 @@
 #ifndef _SDL_sysaudio_h
 #define _SDL_sysaudio_h
 
+#include "SDL_atomic.h"
 #include "SDL_mutex.h"
 #include "SDL_thread.h"
 
@@ -54,6 +55,16 @@ struct SDL_AudioDevice {
 	void (*WaitDone)(_THIS);
 	void (*CloseAudio)(_THIS);
 
+	/* * * */
+	/* Recording functions, for drivers that can capture audio.
+	   The capture device is a separate instance of the driver, and
+	   is shut down with CloseAudio() like an output device.
+	   CaptureAudio() blocks until it has read some whole sample frames
+	   and returns the number of bytes, or -1 on a fatal error.
+	 */
+	int  (*OpenCapture)(_THIS, SDL_AudioSpec *spec);
+	int  (*CaptureAudio)(_THIS, Uint8 *buffer, int buflen);
+
 	/* * * */
 	/* Lock / Unlock functions added for the Mac port */
 	void (*LockAudio)(_THIS);
@@ -61,6 +72,10 @@ struct SDL_AudioDevice {
 
 	void (*SetCaption)(_THIS, const char *caption);
 
+	/* Returns the output latency the device was opened with, in sample
+	   frames, for drivers that know it */
+	int  (*GetLatency)(_THIS);
+
 	/* * * */
 	/* Data common to all devices */
 
@@ -70,9 +85,10 @@ struct SDL_AudioDevice {
 	/* An audio conversion block for audio format emulation */
 	SDL_AudioCVT convert;
 
-	/* Current state flags */
-	int enabled;
-	int paused;
+	/* Current state flags, 'enabled' and 'paused' are shared with the
+	   audio thread and driver callbacks, so they are accessed atomically */
+	SDL_AtomicInt enabled;
+	SDL_AtomicInt paused;
 	int opened;
 
 	/* Fake audio buffer for when the audio hardware is busy */
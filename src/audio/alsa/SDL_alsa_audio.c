@@ -49,6 +49,8 @@ static void ALSA_WaitAudio(_THIS);
 static void ALSA_PlayAudio(_THIS);
 static Uint8 *ALSA_GetAudioBuf(_THIS);
 static void ALSA_CloseAudio(_THIS);
+static int ALSA_OpenCapture(_THIS, SDL_AudioSpec *spec);
+static int ALSA_CaptureAudio(_THIS, Uint8 *buffer, int buflen);
 
 #ifdef SDL_AUDIO_DRIVER_ALSA_DYNAMIC
 
@@ -59,6 +61,14 @@ static int alsa_loaded = 0;
 static int (*SDL_NAME(snd_pcm_open))(snd_pcm_t **pcm, const char *name, snd_pcm_stream_t stream, int mode);
 static int (*SDL_NAME(snd_pcm_close))(snd_pcm_t *pcm);
 static snd_pcm_sframes_t (*SDL_NAME(snd_pcm_writei))(snd_pcm_t *pcm, const void *buffer, snd_pcm_uframes_t size);
+static snd_pcm_sframes_t (*SDL_NAME(snd_pcm_readi))(snd_pcm_t *pcm, void *buffer, snd_pcm_uframes_t size);
+static snd_pcm_sframes_t (*SDL_NAME(snd_pcm_mmap_writei))(snd_pcm_t *pcm, const void *buffer, snd_pcm_uframes_t size);
+static int (*SDL_NAME(snd_pcm_mmap_begin))(snd_pcm_t *pcm, const snd_pcm_channel_area_t **areas, snd_pcm_uframes_t *offset, snd_pcm_uframes_t *frames);
+static snd_pcm_sframes_t (*SDL_NAME(snd_pcm_mmap_commit))(snd_pcm_t *pcm, snd_pcm_uframes_t offset, snd_pcm_uframes_t frames);
+static snd_pcm_sframes_t (*SDL_NAME(snd_pcm_avail_update))(snd_pcm_t *pcm);
+static int (*SDL_NAME(snd_pcm_wait))(snd_pcm_t *pcm, int timeout);
+static snd_pcm_state_t (*SDL_NAME(snd_pcm_state))(snd_pcm_t *pcm);
+static int (*SDL_NAME(snd_pcm_start))(snd_pcm_t *pcm);
 static int (*SDL_NAME(snd_pcm_resume))(snd_pcm_t *pcm);
 static int (*SDL_NAME(snd_pcm_prepare))(snd_pcm_t *pcm);
 static const char *(*SDL_NAME(snd_strerror))(int errnum);
@@ -97,6 +107,14 @@ static struct {
 	{ "snd_pcm_open",	(void**)(char*)&SDL_NAME(snd_pcm_open)		},
 	{ "snd_pcm_close",	(void**)(char*)&SDL_NAME(snd_pcm_close)	},
 	{ "snd_pcm_writei",	(void**)(char*)&SDL_NAME(snd_pcm_writei)	},
+	{ "snd_pcm_readi",	(void**)(char*)&SDL_NAME(snd_pcm_readi)		},
+	{ "snd_pcm_mmap_writei",	(void**)(char*)&SDL_NAME(snd_pcm_mmap_writei)	},
+	{ "snd_pcm_mmap_begin",	(void**)(char*)&SDL_NAME(snd_pcm_mmap_begin)	},
+	{ "snd_pcm_mmap_commit",	(void**)(char*)&SDL_NAME(snd_pcm_mmap_commit)	},
+	{ "snd_pcm_avail_update",	(void**)(char*)&SDL_NAME(snd_pcm_avail_update)	},
+	{ "snd_pcm_wait",	(void**)(char*)&SDL_NAME(snd_pcm_wait)		},
+	{ "snd_pcm_state",	(void**)(char*)&SDL_NAME(snd_pcm_state)		},
+	{ "snd_pcm_start",	(void**)(char*)&SDL_NAME(snd_pcm_start)		},
 	{ "snd_pcm_resume",	(void**)(char*)&SDL_NAME(snd_pcm_resume)	},
 	{ "snd_pcm_prepare",	(void**)(char*)&SDL_NAME(snd_pcm_prepare)	},
 	{ "snd_strerror",	(void**)(char*)&SDL_NAME(snd_strerror)		},
@@ -238,6 +256,8 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 	this->PlayAudio = ALSA_PlayAudio;
 	this->GetAudioBuf = ALSA_GetAudioBuf;
 	this->CloseAudio = ALSA_CloseAudio;
+	this->OpenCapture = ALSA_OpenCapture;
+	this->CaptureAudio = ALSA_CaptureAudio;
 
 	this->free = Audio_DeleteDevice;
 
@@ -249,12 +269,6 @@ AudioBootStrap ALSA_bootstrap = {
 	Audio_Available, Audio_CreateDevice
 };
 
-/* This function waits until it is possible to write a full sound buffer */
-static void ALSA_WaitAudio(_THIS)
-{
-	/* We're in blocking mode, so there's nothing to do here */
-}
-
 
 /*
  * http://bugzilla.libsdl.org/show_bug.cgi?id=110
@@ -262,7 +276,7 @@ static void ALSA_WaitAudio(_THIS)
  *  and for Windows DirectX [and CoreAudio], this is FL-FR-C-LFE-RL-RR"
  */
 #define SWIZ6(T) \
-    T *ptr = (T *) mixbuf; \
+    T *ptr = (T *) buf; \
     Uint32 i; \
     for (i = 0; i < this->spec.samples; i++, ptr += 6) { \
         T tmp; \
@@ -270,30 +284,30 @@ static void ALSA_WaitAudio(_THIS)
         tmp = ptr[3]; ptr[3] = ptr[5]; ptr[5] = tmp; \
     }
 
-static __inline__ void swizzle_alsa_channels_6_64bit(_THIS) { SWIZ6(Uint64); }
-static __inline__ void swizzle_alsa_channels_6_32bit(_THIS) { SWIZ6(Uint32); }
-static __inline__ void swizzle_alsa_channels_6_16bit(_THIS) { SWIZ6(Uint16); }
-static __inline__ void swizzle_alsa_channels_6_8bit(_THIS) { SWIZ6(Uint8); }
+static __inline__ void swizzle_alsa_channels_6_64bit(_THIS, Uint8 *buf) { SWIZ6(Uint64); }
+static __inline__ void swizzle_alsa_channels_6_32bit(_THIS, Uint8 *buf) { SWIZ6(Uint32); }
+static __inline__ void swizzle_alsa_channels_6_16bit(_THIS, Uint8 *buf) { SWIZ6(Uint16); }
+static __inline__ void swizzle_alsa_channels_6_8bit(_THIS, Uint8 *buf) { SWIZ6(Uint8); }
 
 #undef SWIZ6
 
 
 /*
- * Called right before feeding this->mixbuf to the hardware. Swizzle channels
+ * Called right before feeding a buffer to the hardware. Swizzle channels
  *  from Windows/Mac order to the format alsalib will want.
  */
-static __inline__ void swizzle_alsa_channels(_THIS)
+static __inline__ void swizzle_alsa_channels(_THIS, Uint8 *buf)
 {
     if (this->spec.channels == 6) {
         const Uint16 fmtsize = (this->spec.format & 0xFF); /* bits/channel. */
         if (fmtsize == 16)
-            swizzle_alsa_channels_6_16bit(this);
+            swizzle_alsa_channels_6_16bit(this, buf);
         else if (fmtsize == 8)
-            swizzle_alsa_channels_6_8bit(this);
+            swizzle_alsa_channels_6_8bit(this, buf);
         else if (fmtsize == 32)
-            swizzle_alsa_channels_6_32bit(this);
+            swizzle_alsa_channels_6_32bit(this, buf);
         else if (fmtsize == 64)
-            swizzle_alsa_channels_6_64bit(this);
+            swizzle_alsa_channels_6_64bit(this, buf);
     }
 
     /* !!! FIXME: update this for 7.1 if needed, later. */
@@ -319,6 +333,39 @@ static int ALSA_pcm_recover(snd_pcm_t *handle, int err, int silent)
 	return err;
 }
 
+/* This function waits until it is possible to write a full sound buffer */
+static void ALSA_WaitAudio(_THIS)
+{
+	snd_pcm_sframes_t avail;
+	int status;
+
+	/* Blocking writes wait by themselves, but in mmap mode there has
+	   to be room for a whole buffer before ALSA_GetAudioBuf() maps it.
+	 */
+	if ( !mmap_access ) {
+		return;
+	}
+	while ( SDL_AtomicLoad(&this->enabled) ) {
+		avail = SDL_NAME(snd_pcm_avail_update)(pcm_handle);
+		if ( avail < 0 ) {
+			status = ALSA_pcm_recover(pcm_handle, (int)avail, 0);
+			if ( status < 0 ) {
+				fprintf(stderr, "ALSA wait failed (unrecoverable): %s\n", SDL_NAME(snd_strerror)(status));
+				SDL_AtomicStore(&this->enabled, 0);
+			}
+			continue;
+		}
+		if ( avail >= (snd_pcm_sframes_t)this->spec.samples ) {
+			break;
+		}
+		/* The buffer is full, so make sure it's playing */
+		if ( SDL_NAME(snd_pcm_state)(pcm_handle) == SND_PCM_STATE_PREPARED ) {
+			SDL_NAME(snd_pcm_start)(pcm_handle);
+		}
+		SDL_NAME(snd_pcm_wait)(pcm_handle, ((this->spec.samples * 2000) / this->spec.freq) + 1);
+	}
+}
+
 static void ALSA_PlayAudio(_THIS)
 {
 	int status;
@@ -326,12 +373,35 @@ static void ALSA_PlayAudio(_THIS)
 	const Uint8 *sample_buf = (const Uint8 *) mixbuf;
 	const int frame_size = (((int) (this->spec.format & 0xFF)) / 8) * this->spec.channels;
 
-	swizzle_alsa_channels(this);
+	/* The app wrote straight into the hardware buffer, hand it over */
+	if ( mmap_frames ) {
+		snd_pcm_sframes_t committed;
+
+		swizzle_alsa_channels(this, mmap_buf);
+		committed = SDL_NAME(snd_pcm_mmap_commit)(pcm_handle, mmap_offset, mmap_frames);
+		if ( committed < 0 || (snd_pcm_uframes_t)committed != mmap_frames ) {
+			status = ALSA_pcm_recover(pcm_handle, committed < 0 ? (int)committed : -EPIPE, 0);
+			if ( status < 0 ) {
+				fprintf(stderr, "ALSA commit failed (unrecoverable): %s\n", SDL_NAME(snd_strerror)(status));
+				SDL_AtomicStore(&this->enabled, 0);
+			}
+		} else if ( SDL_NAME(snd_pcm_state)(pcm_handle) == SND_PCM_STATE_PREPARED ) {
+			SDL_NAME(snd_pcm_start)(pcm_handle);
+		}
+		mmap_frames = 0;
+		return;
+	}
+
+	swizzle_alsa_channels(this, mixbuf);
 
 	frames_left = ((snd_pcm_uframes_t) this->spec.samples);
 
-	while ( frames_left > 0 && this->enabled ) {
-		status = SDL_NAME(snd_pcm_writei)(pcm_handle, sample_buf, frames_left);
+	while ( frames_left > 0 && SDL_AtomicLoad(&this->enabled) ) {
+		if ( mmap_access ) {
+			status = SDL_NAME(snd_pcm_mmap_writei)(pcm_handle, sample_buf, frames_left);
+		} else {
+			status = SDL_NAME(snd_pcm_writei)(pcm_handle, sample_buf, frames_left);
+		}
 		if ( status < 0 ) {
 			if ( status == -EAGAIN ) {
 				/* Apparently snd_pcm_recover() doesn't handle this case. Foo. */
@@ -342,7 +412,7 @@ static void ALSA_PlayAudio(_THIS)
 			if ( status < 0 ) {
 				/* Hmm, not much we can do - abort */
 				fprintf(stderr, "ALSA write failed (unrecoverable): %s\n", SDL_NAME(snd_strerror)(status));
-				this->enabled = 0;
+				SDL_AtomicStore(&this->enabled, 0);
 				return;
 			}
 			continue;
@@ -354,6 +424,43 @@ static void ALSA_PlayAudio(_THIS)
 
 static Uint8 *ALSA_GetAudioBuf(_THIS)
 {
+	const snd_pcm_channel_area_t *areas;
+	snd_pcm_uframes_t offset;
+	snd_pcm_uframes_t frames;
+	int frame_bits;
+	int status;
+
+	if ( !mmap_access ) {
+		return(mixbuf);
+	}
+
+	/* Map the next buffer's worth of the hardware ring */
+	frames = this->spec.samples;
+	status = SDL_NAME(snd_pcm_mmap_begin)(pcm_handle, &areas, &offset, &frames);
+	if ( status < 0 ) {
+		status = ALSA_pcm_recover(pcm_handle, status, 0);
+		if ( status < 0 ) {
+			fprintf(stderr, "ALSA mmap failed (unrecoverable): %s\n", SDL_NAME(snd_strerror)(status));
+			SDL_AtomicStore(&this->enabled, 0);
+			return(NULL);
+		}
+		return(mixbuf);
+	}
+
+	/* Interleaved channels all share the first channel's area */
+	frame_bits = (this->spec.format & 0xFF) * this->spec.channels;
+	if ( frames == this->spec.samples &&
+	     areas[0].step == (unsigned int)frame_bits &&
+	     (areas[0].first % 8) == 0 ) {
+		mmap_buf = (Uint8 *)areas[0].addr + (areas[0].first / 8) +
+		           offset * (frame_bits / 8);
+		mmap_offset = offset;
+		mmap_frames = frames;
+		return(mmap_buf);
+	}
+
+	/* It wraps around the end of the ring, go through mixbuf instead */
+	SDL_NAME(snd_pcm_mmap_commit)(pcm_handle, offset, 0);
 	return(mixbuf);
 }
 
@@ -367,8 +474,10 @@ static void ALSA_CloseAudio(_THIS)
 		/* Wait for the submitted audio to drain
 		   snd_pcm_drop() can hang, so don't use that.
 		 */
-		Uint32 delay = ((this->spec.samples * 1000) / this->spec.freq) * 2;
-		SDL_Delay(delay);
+		if ( !capture ) {
+			Uint32 delay = ((this->spec.samples * 1000) / this->spec.freq) * num_periods;
+			SDL_Delay(delay);
+		}
 		SDL_NAME(snd_pcm_close)(pcm_handle);
 		pcm_handle = NULL;
 	}
@@ -390,12 +499,12 @@ static int ALSA_finalize_hardware(_THIS, SDL_AudioSpec *spec, snd_pcm_hw_params_
 	if ( status < 0 ) {
 		return(-1);
 	}
-	if ( !override && bufsize != spec->samples * 2 ) {
+	if ( !override && bufsize != spec->samples * num_periods ) {
 		return(-1);
 	}
 
 	/* FIXME: Is this safe to do? */
-	spec->samples = bufsize / 2;
+	spec->samples = bufsize / num_periods;
 
 	/* This is useful for debugging */
 	if ( getenv("SDL_AUDIO_ALSA_DEBUG") ) {
@@ -405,7 +514,7 @@ static int ALSA_finalize_hardware(_THIS, SDL_AudioSpec *spec, snd_pcm_hw_params_
 		SDL_NAME(snd_pcm_hw_params_get_period_size)(hwparams, &persize, NULL);
 		SDL_NAME(snd_pcm_hw_params_get_periods)(hwparams, &periods, NULL);
 
-		fprintf(stderr, "ALSA: period size = %ld, periods = %u, buffer size = %lu\n", persize, periods, bufsize);
+		fprintf(stderr, "ALSA: period size = %ld, periods = %u, buffer size = %lu, %s access\n", persize, periods, bufsize, mmap_access ? "mmap" : "read/write");
 	}
 	return(0);
 }
@@ -438,7 +547,7 @@ static int ALSA_set_period_size(_THIS, SDL_AudioSpec *spec, snd_pcm_hw_params_t
 		return(-1);
 	}
 
-	periods = 2;
+	periods = num_periods;
 	status = SDL_NAME(snd_pcm_hw_params_set_periods_near)(pcm_handle, hwparams, &periods, NULL);
 	if ( status < 0 ) {
 		return(-1);
@@ -468,7 +577,7 @@ static int ALSA_set_buffer_size(_THIS, SDL_AudioSpec *spec, snd_pcm_hw_params_t
 		}
 	}
 
-	frames = spec->samples * 2;
+	frames = spec->samples * num_periods;
 	status = SDL_NAME(snd_pcm_hw_params_set_buffer_size_near)(pcm_handle, hwparams, &frames);
 	if ( status < 0 ) {
 		return(-1);
@@ -477,8 +586,9 @@ static int ALSA_set_buffer_size(_THIS, SDL_AudioSpec *spec, snd_pcm_hw_params_t
 	return ALSA_finalize_hardware(this, spec, hwparams, override);
 }
 
-static int ALSA_OpenAudio(_THIS, SDL_AudioSpec *spec)
+static int ALSA_OpenDevice(_THIS, SDL_AudioSpec *spec, snd_pcm_stream_t stream)
 {
+	const char          *env;
 	int                  status;
 	snd_pcm_hw_params_t *hwparams;
 	snd_pcm_sw_params_t *swparams;
@@ -489,13 +599,15 @@ static int ALSA_OpenAudio(_THIS, SDL_AudioSpec *spec)
 
 	/* Open the audio device */
 	/* Name of device should depend on # channels in spec */
-	status = SDL_NAME(snd_pcm_open)(&pcm_handle, get_audio_device(spec->channels), SND_PCM_STREAM_PLAYBACK, SND_PCM_NONBLOCK);
+	status = SDL_NAME(snd_pcm_open)(&pcm_handle, get_audio_device(spec->channels), stream, SND_PCM_NONBLOCK);
 
 	if ( status < 0 ) {
 		SDL_SetError("Couldn't open audio device: %s", SDL_NAME(snd_strerror)(status));
 		return(-1);
 	}
 
+	capture = (stream == SND_PCM_STREAM_CAPTURE);
+
 	/* Switch to blocking mode for playback */
 	/* Note: this must happen before hw/sw params are set. */
 	SDL_NAME(snd_pcm_nonblock)(pcm_handle, 0);
@@ -509,8 +621,21 @@ static int ALSA_OpenAudio(_THIS, SDL_AudioSpec *spec)
 		return(-1);
 	}
 
-	/* SDL only uses interleaved sample output */
-	status = SDL_NAME(snd_pcm_hw_params_set_access)(pcm_handle, hwparams, SND_PCM_ACCESS_RW_INTERLEAVED);
+	/* SDL only uses interleaved sample output.  With mmap access the
+	   app callback writes straight into the hardware buffer, but not
+	   every device (or plugin) can do that.
+	 */
+	env = getenv("SDL_AUDIO_ALSA_MMAP");
+	mmap_access = 0;
+	if ( env && SDL_atoi(env) && !capture ) {
+		status = SDL_NAME(snd_pcm_hw_params_set_access)(pcm_handle, hwparams, SND_PCM_ACCESS_MMAP_INTERLEAVED);
+		if ( status >= 0 ) {
+			mmap_access = 1;
+		}
+	}
+	if ( !mmap_access ) {
+		status = SDL_NAME(snd_pcm_hw_params_set_access)(pcm_handle, hwparams, SND_PCM_ACCESS_RW_INTERLEAVED);
+	}
 	if ( status < 0 ) {
 		SDL_SetError("Couldn't set interleaved access: %s", SDL_NAME(snd_strerror)(status));
 		ALSA_CloseAudio(this);
@@ -582,6 +707,20 @@ static int ALSA_OpenAudio(_THIS, SDL_AudioSpec *spec)
 	}
 	spec->freq = rate;
 
+	/* Each period is a buffer of spec->samples, and there are two of
+	   them unless overridden.  Fewer, smaller periods mean less latency
+	   but more chance of an underrun.
+	 */
+	env = getenv("SDL_AUDIO_ALSA_PERIOD_SIZE");
+	if ( env && SDL_atoi(env) > 0 ) {
+		spec->samples = SDL_atoi(env);
+	}
+	num_periods = 2;
+	env = getenv("SDL_AUDIO_ALSA_PERIODS");
+	if ( env && SDL_atoi(env) >= 2 ) {
+		num_periods = SDL_atoi(env);
+	}
+
 	/* Set the buffer size, in samples */
 	if ( ALSA_set_period_size(this, spec, hwparams, 0) < 0 &&
 	     ALSA_set_buffer_size(this, spec, hwparams, 0) < 0 ) {
@@ -635,3 +774,46 @@ static int ALSA_OpenAudio(_THIS, SDL_AudioSpec *spec)
 	/* We're ready to rock and roll. :-) */
 	return(0);
 }
+
+static int ALSA_OpenAudio(_THIS, SDL_AudioSpec *spec)
+{
+	return ALSA_OpenDevice(this, spec, SND_PCM_STREAM_PLAYBACK);
+}
+
+static int ALSA_OpenCapture(_THIS, SDL_AudioSpec *spec)
+{
+	return ALSA_OpenDevice(this, spec, SND_PCM_STREAM_CAPTURE);
+}
+
+static int ALSA_CaptureAudio(_THIS, Uint8 *buffer, int buflen)
+{
+	int status;
+	const int frame_size = (((int) (this->spec.format & 0xFF)) / 8) * this->spec.channels;
+	snd_pcm_uframes_t frames_left = buflen / frame_size;
+	Uint8 *sample_buf = buffer;
+
+	while ( frames_left > 0 ) {
+		status = SDL_NAME(snd_pcm_readi)(pcm_handle, sample_buf, frames_left);
+		if ( status < 0 ) {
+			if ( status == -EAGAIN ) {
+				SDL_Delay(1);
+				continue;
+			}
+			/* An overrun lost some audio, but we can carry on */
+			status = ALSA_pcm_recover(pcm_handle, status, 0);
+			if ( status < 0 ) {
+				fprintf(stderr, "ALSA read failed (unrecoverable): %s\n", SDL_NAME(snd_strerror)(status));
+				return(-1);
+			}
+			continue;
+		}
+		sample_buf += status * frame_size;
+		frames_left -= status;
+	}
+
+	/* The swap back to SDL's channel order is the same one */
+	if ( (sample_buf - buffer) == (int)this->spec.size ) {
+		swizzle_alsa_channels(this, buffer);
+	}
+	return (int)(sample_buf - buffer);
+}
@@ -38,11 +38,31 @@ struct SDL_PrivateAudioData {
 	/* Raw mixing buffer */
 	Uint8 *mixbuf;
 	int    mixlen;
+
+	/* Whether this is a capture device */
+	int capture;
+
+	/* The number of periods in the hardware buffer */
+	unsigned int num_periods;
+
+	/* Whether the app writes straight into the hardware buffer, and
+	   the part of it that was handed out by ALSA_GetAudioBuf()
+	 */
+	int mmap_access;
+	Uint8 *mmap_buf;
+	snd_pcm_uframes_t mmap_offset;
+	snd_pcm_uframes_t mmap_frames;
 };
 
 /* Old variable names */
 #define pcm_handle		(this->hidden->pcm_handle)
 #define mixbuf			(this->hidden->mixbuf)
 #define mixlen			(this->hidden->mixlen)
+#define capture			(this->hidden->capture)
+#define num_periods		(this->hidden->num_periods)
+#define mmap_access		(this->hidden->mmap_access)
+#define mmap_buf		(this->hidden->mmap_buf)
+#define mmap_offset		(this->hidden->mmap_offset)
+#define mmap_frames		(this->hidden->mmap_frames)
 
 #endif /* _ALSA_PCM_audio_h */
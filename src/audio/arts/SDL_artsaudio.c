@@ -223,7 +223,7 @@ static void ARTS_WaitAudio(_THIS)
 		*/
 		if (parent && (((++cnt)%10) == 0)) { /* Check every 10 loops */
 			if ( kill(parent, 0) < 0 ) {
-				this->enabled = 0;
+				SDL_AtomicStore(&this->enabled, 0);
 			}
 		}
 	}
@@ -249,7 +249,7 @@ static void ARTS_PlayAudio(_THIS)
 
 	/* If we couldn't write, assume fatal error for now */
 	if ( written < 0 ) {
-		this->enabled = 0;
+		SDL_AtomicStore(&this->enabled, 0);
 	}
 #ifdef DEBUG_AUDIO
 	fprintf(stderr, "Wrote %d bytes of audio data\n", written);
@@ -103,10 +103,10 @@ static void FillSound(void *device, void *stream, size_t len,
 	SDL_memset(stream, audio->spec.silence, len);
 
 	/* Only do soemthing if audio is enabled */
-	if ( ! audio->enabled )
+	if ( ! SDL_AtomicLoad(&audio->enabled) )
 		return;
 
-	if ( ! audio->paused ) {
+	if ( ! SDL_AtomicLoad(&audio->paused) ) {
 		if ( audio->convert.needed ) {
 			SDL_mutexP(audio->mixer_lock);
 			(*audio->spec.callback)(audio->spec.userdata,
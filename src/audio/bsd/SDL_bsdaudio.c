@@ -172,7 +172,7 @@ OBSD_WaitAudio(_THIS)
 			   the user know what happened.
 			*/
 			fprintf(stderr, "SDL: %s\n", message);
-			this->enabled = 0;
+			SDL_AtomicStore(&this->enabled, 0);
 			/* Don't try to close - may hang */
 			audio_fd = -1;
 #ifdef DEBUG_AUDIO
@@ -215,7 +215,7 @@ OBSD_PlayAudio(_THIS)
 
 	/* If we couldn't write, assume fatal error for now */
 	if ( written < 0 ) {
-		this->enabled = 0;
+		SDL_AtomicStore(&this->enabled, 0);
 	}
 #ifdef DEBUG_AUDIO
 	fprintf(stderr, "Wrote %d bytes of audio data\n", written);
@@ -23,7 +23,7 @@
 */
 #include "SDL_config.h"
 
-/* Output raw audio data to a file. */
+/* Output raw audio data to a file, and record it from one. */
 
 #if HAVE_STDIO_H
 #include <stdio.h>
@@ -45,6 +45,14 @@
 #define DISKDEFAULT_OUTFILE      "sdlaudio.raw"
 #define DISKENVR_WRITEDELAY      "SDL_DISKAUDIODELAY"
 #define DISKDEFAULT_WRITEDELAY   150
+#define DISKENVR_INFILE          "SDL_DISKAUDIOINFILE"
+#define DISKDEFAULT_INFILE       DISKDEFAULT_OUTFILE
+#define DISKENVR_MODE            "SDL_DISKAUDIOMODE"
+#define DISKENVR_BUFFER          "SDL_DISKAUDIOBUFFER"
+#define DISKDEFAULT_BUFFER       (256 * 1024)
+
+/* How far real-time pacing may fall behind before it gives up catching up */
+#define DISKAUD_MAX_LAG          250
 
 /* Audio driver functions */
 static int DISKAUD_OpenAudio(_THIS, SDL_AudioSpec *spec);
@@ -52,6 +60,8 @@ static void DISKAUD_WaitAudio(_THIS);
 static void DISKAUD_PlayAudio(_THIS);
 static Uint8 *DISKAUD_GetAudioBuf(_THIS);
 static void DISKAUD_CloseAudio(_THIS);
+static int DISKAUD_OpenCapture(_THIS, SDL_AudioSpec *spec);
+static int DISKAUD_CaptureAudio(_THIS, Uint8 *buffer, int buflen);
 
 static const char *DISKAUD_GetOutputFilename(void)
 {
@@ -59,6 +69,12 @@ static const char *DISKAUD_GetOutputFilename(void)
 	return((envr != NULL) ? envr : DISKDEFAULT_OUTFILE);
 }
 
+static const char *DISKAUD_GetInputFilename(void)
+{
+	const char *envr = SDL_getenv(DISKENVR_INFILE);
+	return((envr != NULL) ? envr : DISKDEFAULT_INFILE);
+}
+
 /* Audio driver bootstrap functions */
 static int DISKAUD_Available(void)
 {
@@ -99,12 +115,24 @@ static SDL_AudioDevice *DISKAUD_CreateDevice(int devindex)
 	envr = SDL_getenv(DISKENVR_WRITEDELAY);
 	this->hidden->write_delay = (envr) ? SDL_atoi(envr) : DISKDEFAULT_WRITEDELAY;
 
+	/* Render as fast as possible, at the real rate, or with the delay */
+	envr = SDL_getenv(DISKENVR_MODE);
+	if ( envr && (SDL_strcasecmp(envr, "freewheel") == 0) ) {
+		this->hidden->mode = DISKAUD_FREEWHEEL;
+	} else if ( envr && (SDL_strcasecmp(envr, "realtime") == 0) ) {
+		this->hidden->mode = DISKAUD_REALTIME;
+	} else {
+		this->hidden->mode = DISKAUD_DELAY;
+	}
+
 	/* Set the function pointers */
 	this->OpenAudio = DISKAUD_OpenAudio;
 	this->WaitAudio = DISKAUD_WaitAudio;
 	this->PlayAudio = DISKAUD_PlayAudio;
 	this->GetAudioBuf = DISKAUD_GetAudioBuf;
 	this->CloseAudio = DISKAUD_CloseAudio;
+	this->OpenCapture = DISKAUD_OpenCapture;
+	this->CaptureAudio = DISKAUD_CaptureAudio;
 
 	this->free = DISKAUD_DeleteDevice;
 
@@ -116,50 +144,164 @@ AudioBootStrap DISKAUD_bootstrap = {
 	DISKAUD_Available, DISKAUD_CreateDevice
 };
 
+/* Sleep until 'frames' more sample frames would have played in real time.
+   The time is counted from a fixed start, so the rounding of each
+   SDL_Delay() doesn't add up to drift.  If we fall too far behind, start
+   counting again from now rather than rushing to catch up.
+ */
+static void DISKAUD_Pace(_THIS, Uint32 frames)
+{
+	const Uint32 freq = (Uint32)this->spec.freq;
+	Uint32 due, now;
+
+	this->hidden->pace_frames += frames;
+	while ( this->hidden->pace_frames >= freq ) {
+		this->hidden->pace_frames -= freq;
+		this->hidden->pace_start += 1000;
+	}
+	due = this->hidden->pace_start +
+	      (this->hidden->pace_frames * 1000) / freq;
+	now = SDL_GetTicks();
+	if ( (Sint32)(due - now) > 0 ) {
+		SDL_Delay(due - now);
+	} else if ( (Sint32)(now - due) > DISKAUD_MAX_LAG ) {
+		this->hidden->pace_start = now;
+		this->hidden->pace_frames = 0;
+	}
+}
+
 /* This function waits until it is possible to write a full sound buffer */
 static void DISKAUD_WaitAudio(_THIS)
 {
-	SDL_Delay(this->hidden->write_delay);
+	switch (this->hidden->mode) {
+	    case DISKAUD_FREEWHEEL:
+		/* Don't spin while there's nothing to render */
+		if ( SDL_AtomicLoad(&this->paused) ) {
+			SDL_Delay((this->spec.samples * 1000) / this->spec.freq);
+		}
+		break;
+	    case DISKAUD_REALTIME:
+		DISKAUD_Pace(this, this->spec.samples);
+		break;
+	    default:
+		SDL_Delay(this->hidden->write_delay);
+		break;
+	}
 }
 
-static void DISKAUD_PlayAudio(_THIS)
+/* Write out the buffered audio */
+static int DISKAUD_Flush(_THIS)
 {
 	int written;
 
-	/* Write the audio data */
+	if ( this->hidden->bufpos == 0 ) {
+		return(0);
+	}
 	written = SDL_RWwrite(this->hidden->output,
                         this->hidden->mixbuf, 1,
-                        this->hidden->mixlen);
-
-	/* If we couldn't write, assume fatal error for now */
-	if ( (Uint32)written != this->hidden->mixlen ) {
-		this->enabled = 0;
-	}
+                        this->hidden->bufpos);
 #ifdef DEBUG_AUDIO
 	fprintf(stderr, "Wrote %d bytes of audio data\n", written);
 #endif
+	if ( written > 0 ) {
+		this->hidden->data_len += written;
+	}
+	if ( (Uint32)written != this->hidden->bufpos ) {
+		this->hidden->bufpos = 0;
+		return(-1);
+	}
+	this->hidden->bufpos = 0;
+	return(0);
+}
+
+/* The canonical 44 byte header of a PCM WAVE file */
+static int DISKAUD_WriteWAVHeader(_THIS)
+{
+	SDL_RWops *dst = this->hidden->output;
+	const Uint16 bits = (this->spec.format & 0xFF);
+	const Uint16 block = (bits / 8) * this->spec.channels;
+	const Uint32 len = this->hidden->data_len;
+
+	return( (SDL_RWwrite(dst, "RIFF", 4, 1) == 1) &&
+	        SDL_WriteLE32(dst, 36 + len) &&
+	        (SDL_RWwrite(dst, "WAVEfmt ", 8, 1) == 1) &&
+	        SDL_WriteLE32(dst, 16) &&
+	        SDL_WriteLE16(dst, 1) &&		/* PCM */
+	        SDL_WriteLE16(dst, this->spec.channels) &&
+	        SDL_WriteLE32(dst, this->spec.freq) &&
+	        SDL_WriteLE32(dst, this->spec.freq * block) &&
+	        SDL_WriteLE16(dst, block) &&
+	        SDL_WriteLE16(dst, bits) &&
+	        (SDL_RWwrite(dst, "data", 4, 1) == 1) &&
+	        SDL_WriteLE32(dst, len) ) ? 0 : -1;
+}
+
+static void DISKAUD_PlayAudio(_THIS)
+{
+	/* An offline render only gets the audio the application made.
+	   The buffer is only skipped if it was paused all along, so that
+	   pausing just after the callback ran can't lose its audio.
+	 */
+	if ( (this->hidden->mode == DISKAUD_FREEWHEEL) &&
+	     this->hidden->paused && SDL_AtomicLoad(&this->paused) ) {
+		return;
+	}
+
+	/* Collect several buffers so the file gets written in large pieces */
+	this->hidden->bufpos += this->hidden->mixlen;
+	if ( (this->hidden->bufpos + this->hidden->mixlen) > this->hidden->buflen ) {
+		/* If we couldn't write, assume fatal error for now */
+		if ( DISKAUD_Flush(this) < 0 ) {
+			SDL_AtomicStore(&this->enabled, 0);
+		}
+	}
 }
 
 static Uint8 *DISKAUD_GetAudioBuf(_THIS)
 {
-	return(this->hidden->mixbuf);
+	this->hidden->paused = SDL_AtomicLoad(&this->paused);
+	return(this->hidden->mixbuf + this->hidden->bufpos);
 }
 
 static void DISKAUD_CloseAudio(_THIS)
 {
+	if ( this->hidden->output != NULL ) {
+		DISKAUD_Flush(this);
+		/* Now that we know how long it is, fill in the WAVE header */
+		if ( this->hidden->wav &&
+		     (SDL_RWseek(this->hidden->output, 0, RW_SEEK_SET) == 0) ) {
+			DISKAUD_WriteWAVHeader(this);
+		}
+		SDL_RWclose(this->hidden->output);
+		this->hidden->output = NULL;
+	}
 	if ( this->hidden->mixbuf != NULL ) {
 		SDL_FreeAudioMem(this->hidden->mixbuf);
 		this->hidden->mixbuf = NULL;
 	}
-	if ( this->hidden->output != NULL ) {
-		SDL_RWclose(this->hidden->output);
-		this->hidden->output = NULL;
+	if ( this->hidden->input != NULL ) {
+		SDL_RWclose(this->hidden->input);
+		this->hidden->input = NULL;
 	}
 }
 
 static int DISKAUD_OpenAudio(_THIS, SDL_AudioSpec *spec)
 {
 	const char *fname = DISKAUD_GetOutputFilename();
+	const char *envr;
+	size_t len;
+
+	/* Write a WAVE file if it's called one, which only has these formats */
+	len = SDL_strlen(fname);
+	if ( (len >= 4) && (SDL_strcasecmp(fname + len - 4, ".wav") == 0) ) {
+		this->hidden->wav = 1;
+		if ( (spec->format & 0xFF) == 8 ) {
+			spec->format = AUDIO_U8;
+		} else {
+			spec->format = AUDIO_S16LSB;
+		}
+		SDL_CalculateAudioSpec(spec);
+	}
 
 	/* Open the audio device */
 	this->hidden->output = SDL_RWFromFile(fname, "wb");
@@ -172,15 +314,82 @@ static int DISKAUD_OpenAudio(_THIS, SDL_AudioSpec *spec)
                     " audio driver!\n Writing to file [%s].\n", fname);
 #endif
 
-	/* Allocate mixing buffer */
+	if ( this->hidden->wav && (DISKAUD_WriteWAVHeader(this) < 0) ) {
+		SDL_SetError("Couldn't write WAVE header to %s", fname);
+		return(-1);
+	}
+
+	/* Allocate mixing buffer, a whole number of audio buffers long */
 	this->hidden->mixlen = spec->size;
-	this->hidden->mixbuf = (Uint8 *) SDL_AllocAudioMem(this->hidden->mixlen);
+	envr = SDL_getenv(DISKENVR_BUFFER);
+	this->hidden->buflen = (envr) ? SDL_atoi(envr) : DISKDEFAULT_BUFFER;
+	this->hidden->buflen -= (this->hidden->buflen % spec->size);
+	if ( this->hidden->buflen < spec->size ) {
+		this->hidden->buflen = spec->size;
+	}
+	this->hidden->mixbuf = (Uint8 *) SDL_AllocAudioMem(this->hidden->buflen);
 	if ( this->hidden->mixbuf == NULL ) {
 		return(-1);
 	}
 	SDL_memset(this->hidden->mixbuf, spec->silence, spec->size);
+	this->hidden->bufpos = 0;
+
+	this->hidden->pace_start = SDL_GetTicks();
+	this->hidden->pace_frames = 0;
 
 	/* We're ready to rock and roll. :-) */
 	return(0);
 }
 
+/* Record from a file of raw audio data in the requested format, looping
+   at the end of it, at the rate a real device would deliver it.
+ */
+static int DISKAUD_OpenCapture(_THIS, SDL_AudioSpec *spec)
+{
+	const char *fname = DISKAUD_GetInputFilename();
+
+	/* Open the audio device */
+	this->hidden->input = SDL_RWFromFile(fname, "rb");
+	if ( this->hidden->input == NULL ) {
+		return(-1);
+	}
+
+#if HAVE_STDIO_H
+	fprintf(stderr, "WARNING: You are using the SDL disk reader"
+                    " audio driver!\n Reading from file [%s].\n", fname);
+#endif
+
+	this->hidden->pace_start = SDL_GetTicks();
+	this->hidden->pace_frames = 0;
+
+	/* We're ready to rock and roll. :-) */
+	return(0);
+}
+
+static int DISKAUD_CaptureAudio(_THIS, Uint8 *buffer, int buflen)
+{
+	int frame_size = ((this->spec.format & 0xFF) / 8) * this->spec.channels;
+	int amount = 0;
+	int got;
+
+	buflen -= (buflen % frame_size);
+	while ( amount < buflen ) {
+		got = SDL_RWread(this->hidden->input, buffer + amount, 1,
+		                 buflen - amount);
+		if ( got > 0 ) {
+			amount += got;
+			continue;
+		}
+		/* Start over at the end of the file, unless it's empty */
+		if ( (got < 0) ||
+		     (SDL_RWtell(this->hidden->input) <= 0) ||
+		     (SDL_RWseek(this->hidden->input, 0, RW_SEEK_SET) < 0) ) {
+			SDL_SetError("Couldn't read from audio input file");
+			return(-1);
+		}
+	}
+
+	/* Don't deliver the audio before it would have been recorded */
+	DISKAUD_Pace(this, amount / frame_size);
+	return(amount);
+}
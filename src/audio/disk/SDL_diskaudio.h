@@ -30,12 +30,36 @@
 /* Hidden "this" pointer for the video functions */
 #define _THIS	SDL_AudioDevice *this
 
+/* How the disk writer keeps time */
+enum {
+	DISKAUD_DELAY,		/* sleep write_delay ms after each buffer */
+	DISKAUD_FREEWHEEL,	/* as fast as the application can mix */
+	DISKAUD_REALTIME	/* at the rate the audio would play */
+};
+
 struct SDL_PrivateAudioData {
 	/* The file descriptor for the audio device */
 	SDL_RWops *output;
 	Uint8 *mixbuf;
 	Uint32 mixlen;
 	Uint32 write_delay;
+	int mode;
+	int paused;	/* whether the audio was paused when mixbuf was handed out */
+
+	/* mixbuf holds buflen bytes of audio buffers before it's written */
+	Uint32 buflen;
+	Uint32 bufpos;
+
+	/* Whether the file gets a WAVE header, and the audio written so far */
+	int wav;
+	Uint32 data_len;
+
+	/* The file recorded from */
+	SDL_RWops *input;
+
+	/* The time real-time pacing started, and the frames since then */
+	Uint32 pace_start;
+	Uint32 pace_frames;
 };
 
 #endif /* _SDL_diskaudio_h */
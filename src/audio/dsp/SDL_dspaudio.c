@@ -56,6 +56,7 @@
 
 /* Open the audio device for playback, and don't block if busy */
 #define OPEN_FLAGS	(O_WRONLY|O_NONBLOCK)
+#define CAPTURE_FLAGS	(O_RDONLY|O_NONBLOCK)
 
 /* Audio driver functions */
 static int DSP_OpenAudio(_THIS, SDL_AudioSpec *spec);
@@ -63,6 +64,8 @@ static void DSP_WaitAudio(_THIS);
 static void DSP_PlayAudio(_THIS);
 static Uint8 *DSP_GetAudioBuf(_THIS);
 static void DSP_CloseAudio(_THIS);
+static int DSP_OpenCapture(_THIS, SDL_AudioSpec *spec);
+static int DSP_CaptureAudio(_THIS, Uint8 *buffer, int buflen);
 
 /* Audio driver bootstrap functions */
 
@@ -113,6 +116,8 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 	this->PlayAudio = DSP_PlayAudio;
 	this->GetAudioBuf = DSP_GetAudioBuf;
 	this->CloseAudio = DSP_CloseAudio;
+	this->OpenCapture = DSP_OpenCapture;
+	this->CaptureAudio = DSP_CaptureAudio;
 
 	this->free = Audio_DeleteDevice;
 
@@ -135,7 +140,7 @@ static void DSP_PlayAudio(_THIS)
 	if (write(audio_fd, mixbuf, mixlen)==-1)
 	{
 		perror("Audio write");
-		this->enabled = 0;
+		SDL_AtomicStore(&this->enabled, 0);
 	}
 
 #ifdef DEBUG_AUDIO
@@ -160,7 +165,7 @@ static void DSP_CloseAudio(_THIS)
 	}
 }
 
-static int DSP_OpenAudio(_THIS, SDL_AudioSpec *spec)
+static int DSP_OpenDevice(_THIS, SDL_AudioSpec *spec, int flags)
 {
 	char audiodev[1024];
 	int format;
@@ -178,14 +183,14 @@ static int DSP_OpenAudio(_THIS, SDL_AudioSpec *spec)
 	    spec->channels = 2;
 
 	/* Open the audio device */
-	audio_fd = SDL_OpenAudioPath(audiodev, sizeof(audiodev), OPEN_FLAGS, 0);
+	audio_fd = SDL_OpenAudioPath(audiodev, sizeof(audiodev), flags, 0);
 	if ( audio_fd < 0 ) {
 		SDL_SetError("Couldn't open %s: %s", audiodev, strerror(errno));
 		return(-1);
 	}
 	mixbuf = NULL;
 
-	/* Make the file descriptor use blocking writes with fcntl() */
+	/* Make the file descriptor use blocking reads and writes with fcntl() */
 	{ long flags;
 		flags = fcntl(audio_fd, F_GETFL);
 		flags &= ~O_NONBLOCK;
@@ -338,3 +343,36 @@ static int DSP_OpenAudio(_THIS, SDL_AudioSpec *spec)
 	/* We're ready to rock and roll. :-) */
 	return(0);
 }
+
+static int DSP_OpenAudio(_THIS, SDL_AudioSpec *spec)
+{
+	return DSP_OpenDevice(this, spec, OPEN_FLAGS);
+}
+
+static int DSP_OpenCapture(_THIS, SDL_AudioSpec *spec)
+{
+	return DSP_OpenDevice(this, spec, CAPTURE_FLAGS);
+}
+
+static int DSP_CaptureAudio(_THIS, Uint8 *buffer, int buflen)
+{
+	int amount = 0;
+	int got;
+
+	/* OSS blocks until there's a whole fragment to read */
+	while ( amount < buflen ) {
+		got = read(audio_fd, buffer + amount, buflen - amount);
+		if ( got < 0 ) {
+			if ( errno == EINTR ) {
+				continue;
+			}
+			perror("Audio read");
+			return(-1);
+		}
+		if ( got == 0 ) {
+			break;
+		}
+		amount += got;
+	}
+	return(amount);
+}
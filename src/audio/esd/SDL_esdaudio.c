@@ -193,7 +193,7 @@ static void ESD_WaitAudio(_THIS)
 		*/
 		if (parent && (((++cnt)%10) == 0)) { /* Check every 10 loops */
 			if ( kill(parent, 0) < 0 ) {
-				this->enabled = 0;
+				SDL_AtomicStore(&this->enabled, 0);
 			}
 		}
 	}
@@ -223,7 +223,7 @@ static void ESD_PlayAudio(_THIS)
 
 	/* If we couldn't write, assume fatal error for now */
 	if ( written < 0 ) {
-		this->enabled = 0;
+		SDL_AtomicStore(&this->enabled, 0);
 	}
 }
 
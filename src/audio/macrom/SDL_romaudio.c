@@ -128,7 +128,7 @@ static void mix_buffer(SDL_AudioDevice *audio, UInt8 *buffer)
 #ifdef DEBUG_CALLBACK
    fprintf(stderr,"mix_buffer...\n"); fflush(stderr);
 #endif
-   if ( ! audio->paused ) {
+   if ( ! SDL_AtomicLoad(&audio->paused) ) {
 #ifdef __MACOSX__
         SDL_mutexP(audio->mixer_lock);
 #endif
@@ -234,7 +234,7 @@ static void callBackProc (SndChannel *chan, SndCommand *cmd_passed ) {
    fill_me = cmd_passed->param2;  /* buffer that has just finished playing, so fill it */      
    play_me = ! fill_me;           /* filled buffer to play _now_ */
 
-   if ( ! audio->enabled ) {
+   if ( ! SDL_AtomicLoad(&audio->enabled) ) {
       return;
    }
    
@@ -469,12 +469,12 @@ void sndDoubleBackProc (SndChannelPtr chan, SndDoubleBufferPtr newbuf)
 #endif
 
     /* If audio is quitting, don't do anything */
-    if ( ! audio->enabled ) {
+    if ( ! SDL_AtomicLoad(&audio->enabled) ) {
         return;
     }
     memset (newbuf->dbSoundData, 0, audio->spec.size);
     newbuf->dbNumFrames = audio->spec.samples;
-    if ( ! audio->paused ) {
+    if ( ! SDL_AtomicLoad(&audio->paused) ) {
 #ifdef DEBUG_CALLBACK
     fprintf(stderr,"(audio not paused)\n"); fflush(stderr);
 #endif
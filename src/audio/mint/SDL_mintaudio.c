@@ -179,7 +179,7 @@ static void SDL_MintAudio_Callback(void)
 		MINTAUDIO_audiobuf[SDL_MintAudio_numbuf]);
 	SDL_memset(buffer, this->spec.silence, this->spec.size * SDL_MintAudio_max_buf);
 
-	if (!this->paused) {
+	if (!SDL_AtomicLoad(&this->paused)) {
 		for (i=0; i<SDL_MintAudio_max_buf; i++) {
 			if (this->convert.needed) {
 				int silence;
@@ -251,7 +251,7 @@ static void NTO_PlayAudio(_THIS)
     int towrite;
     void* pcmbuffer;
 
-    if (!this->enabled)
+    if (!SDL_AtomicLoad(&this->enabled))
     {
         return;
     }
@@ -306,12 +306,12 @@ static void NTO_PlayAudio(_THIS)
             towrite -= written;
             pcmbuffer += written * this->spec.channels;
         }
-    } while ((towrite > 0)  && (this->enabled));
+    } while ((towrite > 0)  && SDL_AtomicLoad(&this->enabled));
 
     /* If we couldn't write, assume fatal error for now */
     if (towrite != 0)
     {
-        this->enabled = 0;
+        SDL_AtomicStore(&this->enabled, 0);
     }
 
     return;
@@ -326,7 +326,7 @@ static void NTO_CloseAudio(_THIS)
 {
     int rval;
 
-    this->enabled = 0;
+    SDL_AtomicStore(&this->enabled, 0);
 
     if (audio_handle != NULL)
     {
@@ -352,7 +352,7 @@ static int NTO_OpenAudio(_THIS, SDL_AudioSpec* spec)
     int found;
 
     audio_handle = NULL;
-    this->enabled = 0;
+    SDL_AtomicStore(&this->enabled, 0);
 
     if (pcm_buf != NULL)
     {
@@ -497,7 +497,7 @@ static int NTO_OpenAudio(_THIS, SDL_AudioSpec* spec)
         return (-1);
     }
 
-    this->enabled = 1;
+    SDL_AtomicStore(&this->enabled, 1);
 
     /* Get the parent process id (we're the parent of the audio thread) */
     parent = getpid();
@@ -58,6 +58,9 @@ static Uint8 *PULSE_GetAudioBuf(_THIS);
 static void PULSE_CloseAudio(_THIS);
 static void PULSE_WaitDone(_THIS);
 static void PULSE_SetCaption(_THIS, const char *str);
+static int PULSE_GetLatency(_THIS);
+static int PULSE_OpenCapture(_THIS, SDL_AudioSpec *spec);
+static int PULSE_CaptureAudio(_THIS, Uint8 *buffer, int buflen);
 
 #ifdef SDL_AUDIO_DRIVER_PULSE_DYNAMIC
 
@@ -77,6 +80,8 @@ static pa_simple* (*SDL_NAME(pa_simple_new))(
 	int *error
 );
 static void (*SDL_NAME(pa_simple_free))(pa_simple *s);
+static int (*SDL_NAME(pa_simple_read))(pa_simple *s, void *data,
+	size_t bytes, int *error);
 
 static pa_channel_map* (*SDL_NAME(pa_channel_map_init_auto))(
 	pa_channel_map *m,
@@ -89,6 +94,21 @@ static pa_mainloop_api * (*SDL_NAME(pa_mainloop_get_api))(pa_mainloop *m);
 static int (*SDL_NAME(pa_mainloop_iterate))(pa_mainloop *m, int block, int *retval);
 static void (*SDL_NAME(pa_mainloop_free))(pa_mainloop *m);
 
+static pa_threaded_mainloop * (*SDL_NAME(pa_threaded_mainloop_new))(void);
+static void (*SDL_NAME(pa_threaded_mainloop_free))(pa_threaded_mainloop *m);
+static int (*SDL_NAME(pa_threaded_mainloop_start))(pa_threaded_mainloop *m);
+static void (*SDL_NAME(pa_threaded_mainloop_stop))(pa_threaded_mainloop *m);
+static void (*SDL_NAME(pa_threaded_mainloop_lock))(pa_threaded_mainloop *m);
+static void (*SDL_NAME(pa_threaded_mainloop_unlock))(pa_threaded_mainloop *m);
+static void (*SDL_NAME(pa_threaded_mainloop_wait))(pa_threaded_mainloop *m);
+static void (*SDL_NAME(pa_threaded_mainloop_signal))(pa_threaded_mainloop *m,
+	int wait_for_accept);
+static pa_mainloop_api * (*SDL_NAME(pa_threaded_mainloop_get_api))(
+	pa_threaded_mainloop *m);
+
+static size_t (*SDL_NAME(pa_usec_to_bytes))(pa_usec_t t, const pa_sample_spec *spec);
+static pa_usec_t (*SDL_NAME(pa_bytes_to_usec))(uint64_t length, const pa_sample_spec *spec);
+
 static pa_operation_state_t (*SDL_NAME(pa_operation_get_state))(pa_operation *o);
 static void (*SDL_NAME(pa_operation_cancel))(pa_operation *o);
 static void (*SDL_NAME(pa_operation_unref))(pa_operation *o);
@@ -101,6 +121,8 @@ static int (*SDL_NAME(pa_context_connect))(
 static pa_context_state_t (*SDL_NAME(pa_context_get_state))(pa_context *c);
 static void (*SDL_NAME(pa_context_disconnect))(pa_context *c);
 static void (*SDL_NAME(pa_context_unref))(pa_context *c);
+static void (*SDL_NAME(pa_context_set_state_callback))(pa_context *c,
+	pa_context_notify_cb_t cb, void *userdata);
 
 static pa_stream * (*SDL_NAME(pa_stream_new))(pa_context *c,
 	const char *name, const pa_sample_spec *ss, const pa_channel_map *map);
@@ -115,6 +137,13 @@ static pa_operation * (*SDL_NAME(pa_stream_drain))(pa_stream *s,
 	pa_stream_success_cb_t cb, void *userdata);
 static int (*SDL_NAME(pa_stream_disconnect))(pa_stream *s);
 static void (*SDL_NAME(pa_stream_unref))(pa_stream *s);
+static void (*SDL_NAME(pa_stream_set_state_callback))(pa_stream *s,
+	pa_stream_notify_cb_t cb, void *userdata);
+static void (*SDL_NAME(pa_stream_set_write_callback))(pa_stream *s,
+	pa_stream_request_cb_t cb, void *userdata);
+static const pa_buffer_attr * (*SDL_NAME(pa_stream_get_buffer_attr))(pa_stream *s);
+static int (*SDL_NAME(pa_stream_get_latency))(pa_stream *s,
+	pa_usec_t *r_usec, int *negative);
 static pa_operation* (*SDL_NAME(pa_context_set_name))(pa_context *c,
 	const char *name, pa_context_success_cb_t cb, void *userdata);
 
@@ -126,6 +155,8 @@ static struct {
 		(void **)&SDL_NAME(pa_simple_new)		},
 	{ "pa_simple_free",
 		(void **)&SDL_NAME(pa_simple_free)		},
+	{ "pa_simple_read",
+		(void **)&SDL_NAME(pa_simple_read)		},
 	{ "pa_channel_map_init_auto",
 		(void **)&SDL_NAME(pa_channel_map_init_auto)	},
 	{ "pa_mainloop_new",
@@ -136,6 +167,28 @@ static struct {
 		(void **)&SDL_NAME(pa_mainloop_iterate)		},
 	{ "pa_mainloop_free",
 		(void **)&SDL_NAME(pa_mainloop_free)		},
+	{ "pa_threaded_mainloop_new",
+		(void **)&SDL_NAME(pa_threaded_mainloop_new)	},
+	{ "pa_threaded_mainloop_free",
+		(void **)&SDL_NAME(pa_threaded_mainloop_free)	},
+	{ "pa_threaded_mainloop_start",
+		(void **)&SDL_NAME(pa_threaded_mainloop_start)	},
+	{ "pa_threaded_mainloop_stop",
+		(void **)&SDL_NAME(pa_threaded_mainloop_stop)	},
+	{ "pa_threaded_mainloop_lock",
+		(void **)&SDL_NAME(pa_threaded_mainloop_lock)	},
+	{ "pa_threaded_mainloop_unlock",
+		(void **)&SDL_NAME(pa_threaded_mainloop_unlock)	},
+	{ "pa_threaded_mainloop_wait",
+		(void **)&SDL_NAME(pa_threaded_mainloop_wait)	},
+	{ "pa_threaded_mainloop_signal",
+		(void **)&SDL_NAME(pa_threaded_mainloop_signal)	},
+	{ "pa_threaded_mainloop_get_api",
+		(void **)&SDL_NAME(pa_threaded_mainloop_get_api)	},
+	{ "pa_usec_to_bytes",
+		(void **)&SDL_NAME(pa_usec_to_bytes)		},
+	{ "pa_bytes_to_usec",
+		(void **)&SDL_NAME(pa_bytes_to_usec)		},
 	{ "pa_operation_get_state",
 		(void **)&SDL_NAME(pa_operation_get_state)	},
 	{ "pa_operation_cancel",
@@ -152,6 +205,8 @@ static struct {
 		(void **)&SDL_NAME(pa_context_disconnect)	},
 	{ "pa_context_unref",
 		(void **)&SDL_NAME(pa_context_unref)		},
+	{ "pa_context_set_state_callback",
+		(void **)&SDL_NAME(pa_context_set_state_callback)	},
 	{ "pa_stream_new",
 		(void **)&SDL_NAME(pa_stream_new)		},
 	{ "pa_stream_connect_playback",
@@ -168,6 +223,14 @@ static struct {
 		(void **)&SDL_NAME(pa_stream_disconnect)	},
 	{ "pa_stream_unref",
 		(void **)&SDL_NAME(pa_stream_unref)		},
+	{ "pa_stream_set_state_callback",
+		(void **)&SDL_NAME(pa_stream_set_state_callback)	},
+	{ "pa_stream_set_write_callback",
+		(void **)&SDL_NAME(pa_stream_set_write_callback)	},
+	{ "pa_stream_get_buffer_attr",
+		(void **)&SDL_NAME(pa_stream_get_buffer_attr)	},
+	{ "pa_stream_get_latency",
+		(void **)&SDL_NAME(pa_stream_get_latency)	},
 	{ "pa_context_set_name",
 		(void **)&SDL_NAME(pa_context_set_name)		},
 };
@@ -289,6 +352,9 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 	this->CloseAudio = PULSE_CloseAudio;
 	this->WaitDone = PULSE_WaitDone;
 	this->SetCaption = PULSE_SetCaption;
+	this->GetLatency = PULSE_GetLatency;
+	this->OpenCapture = PULSE_OpenCapture;
+	this->CaptureAudio = PULSE_CaptureAudio;
 
 	this->free = Audio_DeleteDevice;
 
@@ -308,7 +374,7 @@ static void PULSE_WaitAudio(_THIS)
 		if (SDL_NAME(pa_context_get_state)(context) != PA_CONTEXT_READY ||
 		    SDL_NAME(pa_stream_get_state)(stream) != PA_STREAM_READY ||
 		    SDL_NAME(pa_mainloop_iterate)(mainloop, 1, NULL) < 0) {
-			this->enabled = 0;
+			SDL_AtomicStore(&this->enabled, 0);
 			return;
 		}
 		size = SDL_NAME(pa_stream_writable_size)(stream);
@@ -321,7 +387,7 @@ static void PULSE_PlayAudio(_THIS)
 {
 	/* Write the audio data */
 	if (SDL_NAME(pa_stream_write)(stream, mixbuf, mixlen, NULL, 0LL, PA_SEEK_RELATIVE) < 0)
-		this->enabled = 0;
+		SDL_AtomicStore(&this->enabled, 0);
 }
 
 static Uint8 *PULSE_GetAudioBuf(_THIS)
@@ -329,26 +395,126 @@ static Uint8 *PULSE_GetAudioBuf(_THIS)
 	return(mixbuf);
 }
 
+/* Refill the mixing buffer from the application callback, in threaded mode */
+static void PULSE_FillAudio(_THIS)
+{
+	Uint8 *buf;
+	int len;
+
+	if ( !SDL_AtomicLoad(&this->enabled) || SDL_AtomicLoad(&this->paused) ||
+	     (this->convert.needed && !this->convert.buf) ) {
+		SDL_memset(mixbuf, this->spec.silence, mixlen);
+		return;
+	}
+
+	if ( this->convert.needed ) {
+		buf = this->convert.buf;
+		len = this->convert.len;
+		SDL_memset(buf, (this->convert.src_format == AUDIO_U8) ? 0x80 : 0, len);
+	} else {
+		buf = mixbuf;
+		len = mixlen;
+		SDL_memset(buf, this->spec.silence, len);
+	}
+
+	SDL_mutexP(this->mixer_lock);
+	(*this->spec.callback)(this->spec.userdata, buf, len);
+	SDL_mutexV(this->mixer_lock);
+
+	if ( this->convert.needed ) {
+		SDL_ConvertAudio(&this->convert);
+		len = this->convert.len_cvt;
+		if ( len > mixlen ) {
+			len = mixlen;
+		}
+		SDL_memcpy(mixbuf, this->convert.buf, len);
+		if ( len < mixlen ) {
+			SDL_memset(mixbuf+len, this->spec.silence, mixlen-len);
+		}
+	}
+}
+
+/* Called from the PulseAudio thread whenever the server wants more data */
+static void stream_write_request(pa_stream *s, size_t nbytes, void *userdata)
+{
+	SDL_AudioDevice *this = (SDL_AudioDevice *)userdata;
+	int len;
+
+	while ( nbytes > 0 ) {
+		if ( mixpos >= mixlen ) {
+			PULSE_FillAudio(this);
+			mixpos = 0;
+		}
+		len = mixlen - mixpos;
+		if ( (size_t)len > nbytes ) {
+			len = (int)nbytes;
+		}
+		if ( SDL_NAME(pa_stream_write)(s, mixbuf + mixpos, len, NULL,
+				0LL, PA_SEEK_RELATIVE) < 0 ) {
+			SDL_AtomicStore(&this->enabled, 0);
+			break;
+		}
+		mixpos += len;
+		nbytes -= len;
+	}
+}
+
+static void context_state_changed(pa_context *c, void *userdata)
+{
+	SDL_NAME(pa_threaded_mainloop_signal)((pa_threaded_mainloop *)userdata, 0);
+}
+
+static void stream_state_changed(pa_stream *s, void *userdata)
+{
+	SDL_NAME(pa_threaded_mainloop_signal)((pa_threaded_mainloop *)userdata, 0);
+}
+
 static void PULSE_CloseAudio(_THIS)
 {
-	if ( mixbuf != NULL ) {
-		SDL_FreeAudioMem(mixbuf);
-		mixbuf = NULL;
+	if ( threaded_mainloop != NULL ) {
+		SDL_NAME(pa_threaded_mainloop_lock)(threaded_mainloop);
+	}
+	if ( capture_stream != NULL ) {
+		SDL_NAME(pa_simple_free)(capture_stream);
+		capture_stream = NULL;
 	}
 	if ( stream != NULL ) {
+		if ( SDL_getenv("SDL_AUDIO_PULSE_DEBUG") ) {
+			pa_usec_t latency = 0;
+			int negative = 0;
+
+			if ( SDL_NAME(pa_stream_get_latency)(stream, &latency,
+						&negative) == 0 ) {
+				fprintf(stderr, "PulseAudio: stream latency = %s%.1f ms\n",
+					negative ? "-" : "", latency / 1000.0);
+			}
+		}
+		SDL_NAME(pa_stream_set_write_callback)(stream, NULL, NULL);
+		SDL_NAME(pa_stream_set_state_callback)(stream, NULL, NULL);
 		SDL_NAME(pa_stream_disconnect)(stream);
 		SDL_NAME(pa_stream_unref)(stream);
 		stream = NULL;
 	}
 	if (context != NULL) {
+		SDL_NAME(pa_context_set_state_callback)(context, NULL, NULL);
 		SDL_NAME(pa_context_disconnect)(context);
 		SDL_NAME(pa_context_unref)(context);
 		context = NULL;
 	}
+	if ( threaded_mainloop != NULL ) {
+		SDL_NAME(pa_threaded_mainloop_unlock)(threaded_mainloop);
+		SDL_NAME(pa_threaded_mainloop_stop)(threaded_mainloop);
+		SDL_NAME(pa_threaded_mainloop_free)(threaded_mainloop);
+		threaded_mainloop = NULL;
+	}
 	if (mainloop != NULL) {
 		SDL_NAME(pa_mainloop_free)(mainloop);
 		mainloop = NULL;
 	}
+	if ( mixbuf != NULL ) {
+		SDL_FreeAudioMem(mixbuf);
+		mixbuf = NULL;
+	}
 }
 
 /* Try to get the name of the program */
@@ -422,14 +588,11 @@ static void PULSE_WaitDone(_THIS)
 	SDL_NAME(pa_operation_unref)(o);
 }
 
-static int PULSE_OpenAudio(_THIS, SDL_AudioSpec *spec)
+/* Find a sample format PulseAudio takes that's closest to the requested one */
+static int PULSE_ChooseFormat(SDL_AudioSpec *spec, pa_sample_spec *pspec)
 {
-	int             state;
 	Uint16          test_format;
 	pa_sample_spec  paspec;
-	pa_buffer_attr  paattr;
-	pa_channel_map  pacmap;
-	pa_stream_flags_t flags = 0;
 
 	paspec.format = PA_SAMPLE_INVALID;
 	for ( test_format = SDL_FirstAudioFormat(spec->format); test_format; ) {
@@ -457,9 +620,159 @@ static int PULSE_OpenAudio(_THIS, SDL_AudioSpec *spec)
 	paspec.channels = spec->channels;
 	paspec.rate = spec->freq;
 
+	*pspec = paspec;
+	return(0);
+}
+
+/* Keep the buffer length the server granted for PULSE_GetLatency(),
+   and print it when debugging.  'framesize' is the bytes per frame.
+ */
+static void PULSE_ReportLatency(_THIS, const pa_sample_spec *paspec,
+                                int framesize)
+{
+	const pa_buffer_attr *attr;
+
+	if ( threaded_mainloop ) {
+		SDL_NAME(pa_threaded_mainloop_lock)(threaded_mainloop);
+	}
+	attr = SDL_NAME(pa_stream_get_buffer_attr)(stream);
+	if ( attr ) {
+		latency_frames = (int)(attr->tlength / framesize);
+	}
+	if ( attr && SDL_getenv("SDL_AUDIO_PULSE_DEBUG") ) {
+		fprintf(stderr, "PulseAudio: tlength = %u (%.1f ms), minreq = %u (%.1f ms), %s mainloop\n",
+			attr->tlength,
+			SDL_NAME(pa_bytes_to_usec)(attr->tlength, paspec) / 1000.0,
+			attr->minreq,
+			SDL_NAME(pa_bytes_to_usec)(attr->minreq, paspec) / 1000.0,
+			threaded_mainloop ? "threaded" : "blocking");
+	}
+	if ( threaded_mainloop ) {
+		SDL_NAME(pa_threaded_mainloop_unlock)(threaded_mainloop);
+	}
+}
+
+static int PULSE_GetLatency(_THIS)
+{
+	if ( !latency_frames ) {
+		SDL_SetError("PulseAudio didn't report the buffer length");
+		return(-1);
+	}
+	return latency_frames;
+}
+
+/* Connect the context and stream from PulseAudio's own thread.
+   The application callback is then run from stream_write_request(),
+   and SDL doesn't need an audio thread of its own.
+ */
+static int PULSE_OpenThreaded(_THIS, const pa_sample_spec *paspec,
+                              const pa_buffer_attr *paattr,
+                              const pa_channel_map *pacmap)
+{
+	int state;
+	pa_stream_flags_t flags;
+
+	if (!(threaded_mainloop = SDL_NAME(pa_threaded_mainloop_new)())) {
+		SDL_SetError("pa_threaded_mainloop_new() failed");
+		return(-1);
+	}
+	mainloop_api = SDL_NAME(pa_threaded_mainloop_get_api)(threaded_mainloop);
+	if (!(context = SDL_NAME(pa_context_new)(mainloop_api,
+	                                         this->hidden->caption))) {
+		SDL_SetError("pa_context_new() failed");
+		return(-1);
+	}
+	SDL_NAME(pa_context_set_state_callback)(context,
+		context_state_changed, threaded_mainloop);
+
+	SDL_NAME(pa_threaded_mainloop_lock)(threaded_mainloop);
+	if (SDL_NAME(pa_threaded_mainloop_start)(threaded_mainloop) < 0) {
+		SDL_NAME(pa_threaded_mainloop_unlock)(threaded_mainloop);
+		SDL_SetError("pa_threaded_mainloop_start() failed");
+		return(-1);
+	}
+
+	/* Connect to the PulseAudio server */
+	if (SDL_NAME(pa_context_connect)(context, NULL, 0, NULL) < 0) {
+		SDL_NAME(pa_threaded_mainloop_unlock)(threaded_mainloop);
+		SDL_SetError("Could not setup connection to PulseAudio");
+		return(-1);
+	}
+	while ((state = SDL_NAME(pa_context_get_state)(context)) != PA_CONTEXT_READY) {
+		if (!PA_CONTEXT_IS_GOOD(state)) {
+			SDL_NAME(pa_threaded_mainloop_unlock)(threaded_mainloop);
+			SDL_SetError("Could not connect to PulseAudio");
+			return(-1);
+		}
+		SDL_NAME(pa_threaded_mainloop_wait)(threaded_mainloop);
+	}
+
+	stream = SDL_NAME(pa_stream_new)(
+		context,
+		"Simple DirectMedia Layer",  /* stream description */
+		paspec,                      /* sample format spec */
+		pacmap                       /* channel map */
+	);
+	if ( stream == NULL ) {
+		SDL_NAME(pa_threaded_mainloop_unlock)(threaded_mainloop);
+		SDL_SetError("Could not setup PulseAudio stream");
+		return(-1);
+	}
+	SDL_NAME(pa_stream_set_state_callback)(stream,
+		stream_state_changed, threaded_mainloop);
+	SDL_NAME(pa_stream_set_write_callback)(stream,
+		stream_write_request, this);
+
+	/* Start out with an empty buffer, so the first request mixes */
+	mixpos = mixlen;
+
+	flags = PA_STREAM_INTERPOLATE_TIMING | PA_STREAM_AUTO_TIMING_UPDATE;
+#ifdef PA_STREAM_ADJUST_LATENCY
+	flags |= PA_STREAM_ADJUST_LATENCY;
+#endif
+	if (SDL_NAME(pa_stream_connect_playback)(stream, NULL, paattr, flags,
+			NULL, NULL) < 0) {
+		SDL_NAME(pa_threaded_mainloop_unlock)(threaded_mainloop);
+		SDL_SetError("Could not connect PulseAudio stream");
+		return(-1);
+	}
+	while ((state = SDL_NAME(pa_stream_get_state)(stream)) != PA_STREAM_READY) {
+		if (!PA_STREAM_IS_GOOD(state)) {
+			SDL_NAME(pa_threaded_mainloop_unlock)(threaded_mainloop);
+			SDL_SetError("Could not create to PulseAudio stream");
+			return(-1);
+		}
+		SDL_NAME(pa_threaded_mainloop_wait)(threaded_mainloop);
+	}
+	SDL_NAME(pa_threaded_mainloop_unlock)(threaded_mainloop);
+
+	return(0);
+}
+
+static int PULSE_OpenAudio(_THIS, SDL_AudioSpec *spec)
+{
+	int             state;
+	int             threaded;
+	pa_sample_spec  paspec;
+	pa_buffer_attr  paattr;
+	pa_channel_map  pacmap;
+	pa_stream_flags_t flags = 0;
+	const char     *env;
+	Uint32          latency = 0;
+
+	if ( PULSE_ChooseFormat(spec, &paspec) < 0 ) {
+		return(-1);
+	}
+
+	/* Fill from PulseAudio's write requests instead of our own thread? */
+	env = SDL_getenv("SDL_AUDIO_PULSE_THREADED");
+	threaded = (env && SDL_atoi(env) > 0);
+
 	/* Calculate the final parameters for this audio specification */
 #ifdef PA_STREAM_ADJUST_LATENCY
-	spec->samples /= 2; /* Mix in smaller chunck to avoid underruns */
+	if ( !threaded ) {
+		spec->samples /= 2; /* Mix in smaller chunck to avoid underruns */
+	}
 #endif
 	SDL_CalculateAudioSpec(spec);
 
@@ -471,26 +784,64 @@ static int PULSE_OpenAudio(_THIS, SDL_AudioSpec *spec)
 	}
 	SDL_memset(mixbuf, spec->silence, spec->size);
 
-	/* Reduced prebuffering compared to the defaults. */
+	/* The requested latency in milliseconds, if any */
+	env = SDL_getenv("SDL_AUDIO_PULSE_LATENCY");
+	if ( env && SDL_atoi(env) > 0 ) {
+		latency = (Uint32)SDL_NAME(pa_usec_to_bytes)(
+			(pa_usec_t)SDL_atoi(env) * 1000, &paspec);
+	}
+
+	if ( threaded ) {
+		/* Let the server pick the request size, we can fill any amount */
+		paattr.tlength = latency ? latency : (Uint32)mixlen*2;
+		paattr.prebuf = (Uint32)-1;
+		paattr.maxlength = (Uint32)-1;
+		paattr.minreq = (Uint32)-1;
+	} else {
+		/* Reduced prebuffering compared to the defaults. */
 #ifdef PA_STREAM_ADJUST_LATENCY
-	paattr.tlength = mixlen * 4; /* 2x original requested bufsize */
-	paattr.prebuf = -1;
-	paattr.maxlength = -1;
-	paattr.minreq = mixlen; /* -1 can lead to pa_stream_writable_size()
-				   >= mixlen never becoming true */
-	flags = PA_STREAM_ADJUST_LATENCY;
+		paattr.tlength = mixlen * 4; /* 2x original requested bufsize */
+		paattr.prebuf = -1;
+		paattr.maxlength = -1;
+		paattr.minreq = mixlen; /* -1 can lead to pa_stream_writable_size()
+					   >= mixlen never becoming true */
+		flags = PA_STREAM_ADJUST_LATENCY;
 #else
-	paattr.tlength = mixlen*2;
-	paattr.prebuf = mixlen*2;
-	paattr.maxlength = mixlen*2;
-	paattr.minreq = mixlen;
+		paattr.tlength = mixlen*2;
+		paattr.prebuf = mixlen*2;
+		paattr.maxlength = mixlen*2;
+		paattr.minreq = mixlen;
 #endif
+		if ( latency ) {
+			paattr.tlength = SDL_max(latency, (Uint32)mixlen*2);
+#ifndef PA_STREAM_ADJUST_LATENCY
+			paattr.prebuf = paattr.tlength;
+			paattr.maxlength = paattr.tlength;
+#endif
+		}
+	}
 
 	/* The SDL ALSA output hints us that we use Windows' channel mapping */
 	/* http://bugzilla.libsdl.org/show_bug.cgi?id=110 */
 	SDL_NAME(pa_channel_map_init_auto)(
 		&pacmap, spec->channels, PA_CHANNEL_MAP_WAVEEX);
 
+	if ( threaded ) {
+		if (this->hidden->caption == NULL) {
+			char *title = NULL;
+			SDL_WM_GetCaption(&title, NULL);
+			PULSE_SetCaption(this, title);
+		}
+		if ( PULSE_OpenThreaded(this, &paspec, &paattr, &pacmap) < 0 ) {
+			PULSE_CloseAudio(this);
+			return(-1);
+		}
+		PULSE_ReportLatency(this, &paspec, spec->size / spec->samples);
+
+		/* We're ready to rock and roll. :-) */
+		return(1);
+	}
+
 	/* Set up a new main loop */
 	if (!(mainloop = SDL_NAME(pa_mainloop_new)())) {
 		PULSE_CloseAudio(this);
@@ -565,6 +916,63 @@ static int PULSE_OpenAudio(_THIS, SDL_AudioSpec *spec)
 			return(-1);
 		}
 	} while (state != PA_STREAM_READY);
+	PULSE_ReportLatency(this, &paspec, spec->size / spec->samples);
+
+	return(0);
+}
+
+/* Recording uses the blocking simple API, from SDL's capture thread */
+static int PULSE_OpenCapture(_THIS, SDL_AudioSpec *spec)
+{
+	pa_sample_spec  paspec;
+	pa_buffer_attr  paattr;
+	pa_channel_map  pacmap;
+	int             error = 0;
+
+	if ( PULSE_ChooseFormat(spec, &paspec) < 0 ) {
+		return(-1);
+	}
+	SDL_CalculateAudioSpec(spec);
+
+	/* Have the server send us a buffer at a time */
+	paattr.maxlength = (Uint32)-1;
+	paattr.tlength = (Uint32)-1;
+	paattr.prebuf = (Uint32)-1;
+	paattr.minreq = (Uint32)-1;
+	paattr.fragsize = spec->size;
 
+	SDL_NAME(pa_channel_map_init_auto)(
+		&pacmap, spec->channels, PA_CHANNEL_MAP_WAVEEX);
+
+	if (this->hidden->caption == NULL) {
+		char *title = NULL;
+		SDL_WM_GetCaption(&title, NULL);
+		PULSE_SetCaption(this, title);
+	}
+
+	capture_stream = SDL_NAME(pa_simple_new)(
+		NULL,                        /* server */
+		this->hidden->caption,       /* application name */
+		PA_STREAM_RECORD,            /* record mode */
+		NULL,                        /* device on the server */
+		"Simple DirectMedia Layer",  /* stream description */
+		&paspec,                     /* sample format spec */
+		&pacmap,                     /* channel map */
+		&paattr,                     /* buffering attributes */
+		&error                       /* error code */
+	);
+	if ( capture_stream == NULL ) {
+		SDL_SetError("Could not connect PulseAudio record stream");
+		return(-1);
+	}
 	return(0);
 }
+
+static int PULSE_CaptureAudio(_THIS, Uint8 *buffer, int buflen)
+{
+	if ( SDL_NAME(pa_simple_read)(capture_stream, buffer, buflen, NULL) < 0 ) {
+		SDL_SetError("PulseAudio read failed");
+		return(-1);
+	}
+	return(buflen);
+}
@@ -37,11 +37,23 @@ struct SDL_PrivateAudioData {
 	pa_context *context;
 	pa_stream *stream;
 
+	/* In threaded mode, PulseAudio's own thread asks for the audio */
+	pa_threaded_mainloop *threaded_mainloop;
+
+	/* The record stream of a capture device */
+	pa_simple *capture_stream;
+
 	char *caption;
 
 	/* Raw mixing buffer */
 	Uint8 *mixbuf;
 	int    mixlen;
+
+	/* How much of mixbuf has been written, in threaded mode */
+	int    mixpos;
+
+	/* The buffer length the server granted, in sample frames */
+	int    latency_frames;
 };
 
 #if (PA_API_VERSION < 12)
@@ -68,6 +80,10 @@ static inline int PA_STREAM_IS_GOOD(pa_stream_state_t x) {
 #define stream			(this->hidden->stream)
 #define mixbuf			(this->hidden->mixbuf)
 #define mixlen			(this->hidden->mixlen)
+#define threaded_mainloop	(this->hidden->threaded_mainloop)
+#define mixpos			(this->hidden->mixpos)
+#define latency_frames		(this->hidden->latency_frames)
+#define capture_stream		(this->hidden->capture_stream)
 
 #endif /* _SDL_pulseaudio_h */
 
@@ -117,7 +117,7 @@ static void SNDIO_PlayAudio(_THIS)
 	
 	/* If we couldn't write, assume fatal error for now */
 	if ( written == 0 ) {
-		this->enabled = 0;
+		SDL_AtomicStore(&this->enabled, 0);
 	}
 #ifdef DEBUG_AUDIO
 	fprintf(stderr, "Wrote %d bytes of audio data\n", written);
@@ -211,7 +211,7 @@ void DSP_PlayAudio(_THIS)
 #endif
 		if ( write(audio_fd, ulaw_buf, fragsize) < 0 ) {
 			/* Assume fatal error, for now */
-			this->enabled = 0;
+			SDL_AtomicStore(&this->enabled, 0);
 		}
 		written += fragsize;
 	} else {
@@ -220,7 +220,7 @@ void DSP_PlayAudio(_THIS)
 #endif
 		if ( write(audio_fd, mixbuf, this->spec.size) < 0 ) {
 			/* Assume fatal error, for now */
-			this->enabled = 0;
+			SDL_AtomicStore(&this->enabled, 0);
 		}
 		written += fragsize;
 	}
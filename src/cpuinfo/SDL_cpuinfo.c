@@ -41,6 +41,22 @@
 #include <sys/syspage.h>
 #endif
 
+#if defined(__WIN32__)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>	/* For the processor count */
+#elif defined(__LINUX__) || defined(__MACOSX__) || defined(__FREEBSD__) || \
+      defined(__NETBSD__) || defined(__OPENBSD__) || defined(__SOLARIS__) || \
+      defined(__IRIX__) || defined(__QNXNTO__)
+#include <unistd.h>	/* For sysconf() */
+#endif
+#if defined(__MACOSX__)
+#include <sys/sysctl.h>	/* For the cache sizes */
+#endif
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1600) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>	/* For __cpuidex() and _xgetbv() */
+#endif
+
 #if defined(__LINUX__) && defined(__arm__)
 #include <unistd.h>
 #include <sys/types.h>
@@ -79,6 +95,16 @@
 #define CPU_HAS_ALTIVEC	0x00000100
 #define CPU_HAS_ARM_SIMD 0x00000200
 #define CPU_HAS_NEON     0x00000400
+#define CPU_HAS_SSE3	0x00000800
+#define CPU_HAS_SSSE3	0x00001000
+#define CPU_HAS_SSE41	0x00002000
+#define CPU_HAS_SSE42	0x00004000
+#define CPU_HAS_AVX	0x00008000
+#define CPU_HAS_AVX2	0x00010000
+#define CPU_HAS_AVX512F	0x00020000
+
+/* Used when the cache line size can't be found out */
+#define CPU_DEFAULT_CACHELINE	128
 
 #if SDL_ALTIVEC_BLITTERS && HAVE_SETJMP && !__MACOSX__ && !__OpenBSD__
 /* This is the brute force way of detecting instruction sets...
@@ -339,6 +365,104 @@ done:
 	return features;
 }
 
+/* Run CPUID with the given function and subfunction, setting eax, ebx,
+   ecx and edx in 'regs', or zeroes if the compiler can't do it.
+   The caller has to check CPU_haveCPUID() first.
+ */
+static __inline__ void CPU_cpuid(Uint32 func, Uint32 subfunc, Uint32 regs[4])
+{
+	regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#if defined(__GNUC__) && defined(__i386__)
+	/* ebx may be the PIC register, so it's swapped through esi */
+	__asm__ __volatile__ (
+"        movl    %%ebx,%%esi                                           \n"
+"        cpuid                                                         \n"
+"        xchgl   %%ebx,%%esi                                           \n"
+	: "=a" (regs[0]), "=S" (regs[1]), "=c" (regs[2]), "=d" (regs[3])
+	: "a" (func), "c" (subfunc)
+	);
+#elif defined(__GNUC__) && defined(__x86_64__)
+	__asm__ __volatile__ (
+"        movq    %%rbx,%%rsi                                           \n"
+"        cpuid                                                         \n"
+"        xchgq   %%rbx,%%rsi                                           \n"
+	: "=a" (regs[0]), "=S" (regs[1]), "=c" (regs[2]), "=d" (regs[3])
+	: "a" (func), "c" (subfunc)
+	);
+#elif defined(_MSC_VER) && (_MSC_VER >= 1600) && (defined(_M_IX86) || defined(_M_X64))
+	__cpuidex((int *)regs, (int)func, (int)subfunc);
+#endif
+}
+
+/* Returns the register state the OS saves on context switches (XCR0).
+   The caller has to check that CPUID reports OSXSAVE first.
+ */
+static __inline__ Uint32 CPU_getXCR0(void)
+{
+	Uint32 xcr0 = 0;
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	Uint32 edx;
+	/* xgetbv, for assemblers that don't know it */
+	__asm__ __volatile__ (
+"        .byte   0x0f, 0x01, 0xd0                                      \n"
+	: "=a" (xcr0), "=d" (edx)
+	: "c" (0)
+	);
+#elif defined(_MSC_FULL_VER) && (_MSC_FULL_VER >= 160040219) && (defined(_M_IX86) || defined(_M_X64))
+	xcr0 = (Uint32)_xgetbv(0);
+#endif
+	return xcr0;
+}
+
+/* The SSE3 and later features, checking that the OS saves the AVX state */
+static __inline__ Uint32 CPU_getSIMDFeatures(void)
+{
+	Uint32 features = 0;
+	Uint32 regs[4];
+	Uint32 maxfunc, xcr0 = 0;
+
+	if ( !CPU_haveCPUID() ) {
+		return 0;
+	}
+	CPU_cpuid(0, 0, regs);
+	maxfunc = regs[0];
+	if ( maxfunc < 1 ) {
+		return 0;
+	}
+	CPU_cpuid(1, 0, regs);
+	if ( regs[2] & 0x00000001 ) {
+		features |= CPU_HAS_SSE3;
+	}
+	if ( regs[2] & 0x00000200 ) {
+		features |= CPU_HAS_SSSE3;
+	}
+	if ( regs[2] & 0x00080000 ) {
+		features |= CPU_HAS_SSE41;
+	}
+	if ( regs[2] & 0x00100000 ) {
+		features |= CPU_HAS_SSE42;
+	}
+	if ( regs[2] & 0x08000000 ) {	/* OSXSAVE */
+		xcr0 = CPU_getXCR0();
+	}
+	/* The OS has to save the SSE and AVX registers */
+	if ( (regs[2] & 0x10000000) && ((xcr0 & 0x06) == 0x06) ) {
+		features |= CPU_HAS_AVX;
+	}
+	if ( maxfunc >= 7 ) {
+		CPU_cpuid(7, 0, regs);
+		if ( (features & CPU_HAS_AVX) && (regs[1] & 0x00000020) ) {
+			features |= CPU_HAS_AVX2;
+		}
+		/* ... and the opmask and upper ZMM registers for AVX-512 */
+		if ( (features & CPU_HAS_AVX) && ((xcr0 & 0xE0) == 0xE0) &&
+		     (regs[1] & 0x00010000) ) {
+			features |= CPU_HAS_AVX512F;
+		}
+	}
+	return features;
+}
+
 static __inline__ int CPU_haveRDTSC(void)
 {
 	if ( CPU_haveCPUID() ) {
@@ -526,7 +650,9 @@ static __inline__  int readProcAuxvForNeon(void)
 
 static __inline__ int CPU_haveNEON(void)
 {
-#if !defined(__arm__)  /* not an ARM CPU at all. */
+#if defined(__aarch64__) || defined(_M_ARM64)
+	return 1;  /* NEON is part of the 64-bit ARM architecture. */
+#elif !defined(__arm__)  /* not an ARM CPU at all. */
 	return 0;
 #elif defined(_WIN32_WCE)
 	return 0;
@@ -606,10 +732,218 @@ static Uint32 SDL_GetCPUFeatures(void)
 		if ( CPU_haveNEON() ) {
 			SDL_CPUFeatures |= CPU_HAS_NEON;
 		}
+		SDL_CPUFeatures |= CPU_getSIMDFeatures();
 	}
 	return SDL_CPUFeatures;
 }
 
+static int SDL_CPUCount = 0;
+
+int SDL_GetCPUCount(void)
+{
+	if ( SDL_CPUCount == 0 ) {
+#if defined(__WIN32__)
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		SDL_CPUCount = (int)info.dwNumberOfProcessors;
+#elif defined(__IRIX__)
+		SDL_CPUCount = (int)sysconf(_SC_NPROC_ONLN);
+#elif defined(_SC_NPROCESSORS_ONLN)
+		/* number of processors online (SVR4.0MP compliant machines) */
+		SDL_CPUCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#elif defined(_SC_NPROCESSORS_CONF)
+		SDL_CPUCount = (int)sysconf(_SC_NPROCESSORS_CONF);
+#endif
+		if ( SDL_CPUCount <= 0 ) {
+			SDL_CPUCount = 1;
+		}
+	}
+	return SDL_CPUCount;
+}
+
+/* Cache sizes in bytes, by level, and the line size; 0 until looked up */
+static int SDL_CPUCacheSize[4];
+static int SDL_CPUCacheLine = 0;
+
+/* Get the cache sizes from CPUID, the deterministic cache parameters
+   on Intel and the extended functions on AMD.
+ */
+static void CPU_getX86CacheInfo(void)
+{
+	Uint32 regs[4];
+	Uint32 maxfunc, maxext, type, level, size;
+	int i;
+
+	if ( !CPU_haveCPUID() ) {
+		return;
+	}
+	CPU_cpuid(0, 0, regs);
+	maxfunc = regs[0];
+	if ( maxfunc >= 1 ) {
+		CPU_cpuid(1, 0, regs);
+		if ( regs[3] & 0x00080000 ) {	/* CLFLUSH line size */
+			SDL_CPUCacheLine = ((regs[1] >> 8) & 0xFF) * 8;
+		}
+	}
+	if ( maxfunc >= 4 ) {
+		for ( i=0; i<16; ++i ) {
+			CPU_cpuid(4, i, regs);
+			type = regs[0] & 0x1F;
+			if ( type == 0 ) {
+				break;
+			}
+			if ( type == 2 ) {	/* Instruction cache */
+				continue;
+			}
+			level = (regs[0] >> 5) & 0x07;
+			size = ((regs[1] >> 22) + 1) *		/* ways */
+			       (((regs[1] >> 12) & 0x3FF) + 1) *	/* partitions */
+			       ((regs[1] & 0xFFF) + 1) *		/* line size */
+			       (regs[2] + 1);			/* sets */
+			if ( level >= 1 && level <= 3 ) {
+				SDL_CPUCacheSize[level] = (int)size;
+			}
+		}
+	}
+	if ( SDL_CPUCacheSize[1] == 0 ) {
+		CPU_cpuid(0x80000000, 0, regs);
+		maxext = regs[0];
+		if ( maxext >= 0x80000005 ) {
+			CPU_cpuid(0x80000005, 0, regs);
+			SDL_CPUCacheSize[1] = (int)(regs[2] >> 24) * 1024;
+		}
+		if ( maxext >= 0x80000006 ) {
+			CPU_cpuid(0x80000006, 0, regs);
+			SDL_CPUCacheSize[2] = (int)(regs[2] >> 16) * 1024;
+			SDL_CPUCacheSize[3] = (int)(regs[3] >> 18) * 512 * 1024;
+		}
+	}
+}
+
+#if defined(__LINUX__)
+/* Read a small sysfs file, returning its length or -1 */
+static int CPU_readSysFile(const char *path, char *buf, int len)
+{
+	SDL_RWops *rw;
+	int amount;
+
+	rw = SDL_RWFromFile(path, "r");
+	if ( rw == NULL ) {
+		SDL_ClearError();
+		return -1;
+	}
+	amount = SDL_RWread(rw, buf, 1, len - 1);
+	SDL_RWclose(rw);
+	if ( amount < 0 ) {
+		return -1;
+	}
+	buf[amount] = '\0';
+	return amount;
+}
+
+/* Get the cache sizes the kernel reports for the first CPU, which works
+   on ARM and other CPUs without a CPUID instruction.
+ */
+static void CPU_getSysfsCacheInfo(void)
+{
+	char path[64];
+	char buf[32];
+	int i, level, size;
+	char *end;
+
+	for ( i=0; i<8; ++i ) {
+		SDL_snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/type", i);
+		if ( CPU_readSysFile(path, buf, sizeof(buf)) < 0 ) {
+			break;
+		}
+		if ( SDL_strncmp(buf, "Instruction", 11) == 0 ) {
+			continue;
+		}
+		SDL_snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/level", i);
+		if ( CPU_readSysFile(path, buf, sizeof(buf)) < 0 ) {
+			continue;
+		}
+		level = SDL_atoi(buf);
+		SDL_snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/size", i);
+		if ( level < 1 || level > 3 || SDL_CPUCacheSize[level] ||
+		     CPU_readSysFile(path, buf, sizeof(buf)) < 0 ) {
+			continue;
+		}
+		size = (int)SDL_strtol(buf, &end, 10);
+		if ( *end == 'K' ) {
+			size *= 1024;
+		} else if ( *end == 'M' ) {
+			size *= 1024 * 1024;
+		}
+		SDL_CPUCacheSize[level] = size;
+	}
+	if ( SDL_CPUCacheLine == 0 &&
+	     CPU_readSysFile("/sys/devices/system/cpu/cpu0/cache/index0/coherency_line_size", buf, sizeof(buf)) > 0 ) {
+		SDL_CPUCacheLine = SDL_atoi(buf);
+	}
+}
+#endif /* __LINUX__ */
+
+#if defined(__MACOSX__)
+static int CPU_getSysctl(const char *name)
+{
+	Uint64 value = 0;
+	size_t size = sizeof(value);
+
+	if ( sysctlbyname(name, &value, &size, NULL, 0) != 0 ) {
+		return 0;
+	}
+	if ( size == sizeof(Uint32) ) {
+		Uint32 value32;
+		SDL_memcpy(&value32, &value, sizeof(value32));
+		return (int)value32;
+	}
+	return (int)value;
+}
+#endif
+
+static void CPU_getCacheInfo(void)
+{
+	static int looked = 0;
+
+	if ( looked ) {
+		return;
+	}
+	looked = 1;
+
+	CPU_getX86CacheInfo();
+#if defined(__MACOSX__)
+	if ( SDL_CPUCacheSize[1] == 0 ) {
+		SDL_CPUCacheSize[1] = CPU_getSysctl("hw.l1dcachesize");
+		SDL_CPUCacheSize[2] = CPU_getSysctl("hw.l2cachesize");
+		SDL_CPUCacheSize[3] = CPU_getSysctl("hw.l3cachesize");
+	}
+	if ( SDL_CPUCacheLine == 0 ) {
+		SDL_CPUCacheLine = CPU_getSysctl("hw.cachelinesize");
+	}
+#elif defined(__LINUX__)
+	CPU_getSysfsCacheInfo();
+#endif
+	if ( SDL_CPUCacheLine <= 0 ) {
+		SDL_CPUCacheLine = CPU_DEFAULT_CACHELINE;
+	}
+}
+
+int SDL_GetCPUCacheLineSize(void)
+{
+	CPU_getCacheInfo();
+	return SDL_CPUCacheLine;
+}
+
+int SDL_GetCPUCacheSize(int level)
+{
+	if ( level < 1 || level > 3 ) {
+		return 0;
+	}
+	CPU_getCacheInfo();
+	return SDL_CPUCacheSize[level];
+}
+
 SDL_bool SDL_HasRDTSC(void)
 {
 	if ( SDL_GetCPUFeatures() & CPU_HAS_RDTSC ) {
@@ -666,6 +1000,62 @@ SDL_bool SDL_HasSSE2(void)
 	return SDL_FALSE;
 }
 
+SDL_bool SDL_HasSSE3(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_SSE3 ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasSSSE3(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_SSSE3 ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasSSE41(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_SSE41 ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasSSE42(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_SSE42 ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasAVX(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_AVX ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasAVX2(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_AVX2 ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasAVX512F(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_AVX512F ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
 SDL_bool SDL_HasAltiVec(void)
 {
 	if ( SDL_GetCPUFeatures() & CPU_HAS_ALTIVEC ) {
@@ -703,9 +1093,20 @@ int main()
 	printf("3DNowExt: %d\n", SDL_Has3DNowExt());
 	printf("SSE: %d\n", SDL_HasSSE());
 	printf("SSE2: %d\n", SDL_HasSSE2());
+	printf("SSE3: %d\n", SDL_HasSSE3());
+	printf("SSSE3: %d\n", SDL_HasSSSE3());
+	printf("SSE4.1: %d\n", SDL_HasSSE41());
+	printf("SSE4.2: %d\n", SDL_HasSSE42());
+	printf("AVX: %d\n", SDL_HasAVX());
+	printf("AVX2: %d\n", SDL_HasAVX2());
+	printf("AVX-512F: %d\n", SDL_HasAVX512F());
 	printf("AltiVec: %d\n", SDL_HasAltiVec());
 	printf("ARM SIMD: %d\n", SDL_HasARMSIMD());
 	printf("NEON: %d\n", SDL_HasNEON());
+	printf("CPUs: %d\n", SDL_GetCPUCount());
+	printf("Cache line: %d\n", SDL_GetCPUCacheLineSize());
+	printf("L1/L2/L3 cache: %d/%d/%d\n", SDL_GetCPUCacheSize(1),
+	       SDL_GetCPUCacheSize(2), SDL_GetCPUCacheSize(3));
 	return 0;
 }
 
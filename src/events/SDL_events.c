@@ -52,7 +52,7 @@ static struct {
 /* Private data -- event locking structure */
 static struct {
 	SDL_mutex *lock;
-	int safe;
+	SDL_AtomicInt safe;
 } SDL_EventLock;
 
 /* Thread functions */
@@ -64,7 +64,7 @@ void SDL_Lock_EventThread(void)
 	if ( SDL_EventThread && (SDL_ThreadID() != event_thread) ) {
 		/* Grab lock and spin until we're sure event thread stopped */
 		SDL_mutexP(SDL_EventLock.lock);
-		while ( ! SDL_EventLock.safe ) {
+		while ( ! SDL_AtomicLoad(&SDL_EventLock.safe) ) {
 			SDL_Delay(1);
 		}
 	}
@@ -118,7 +118,7 @@ static int SDLCALL SDL_GobbleEvents(void *unused)
 #endif
 
 		/* Give up the CPU for the rest of our timeslice */
-		SDL_EventLock.safe = 1;
+		SDL_AtomicStore(&SDL_EventLock.safe, 1);
 		if ( SDL_timer_running ) {
 			SDL_ThreadedTimerCheck();
 		}
@@ -133,7 +133,7 @@ static int SDLCALL SDL_GobbleEvents(void *unused)
 		   it's not safe to interfere with the event thread.
 		 */
 		SDL_mutexP(SDL_EventLock.lock);
-		SDL_EventLock.safe = 0;
+		SDL_AtomicStore(&SDL_EventLock.safe, 0);
 		SDL_mutexV(SDL_EventLock.lock);
 	}
 	SDL_SetTimerThreaded(0);
@@ -165,7 +165,7 @@ static int SDL_StartEventThread(Uint32 flags)
 		if ( SDL_EventLock.lock == NULL ) {
 			return(-1);
 		}
-		SDL_EventLock.safe = 0;
+		SDL_AtomicStore(&SDL_EventLock.safe, 0);
 
 		/* The event thread will handle timers too */
 		SDL_SetTimerThreaded(2);
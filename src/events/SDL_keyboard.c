@@ -40,10 +40,10 @@ static const char *keynames[SDLK_LAST];	/* Array of keycode names */
  * jk 991215 - added
  */
 struct {
-	int firsttime;    /* if we check against the delay or repeat value */
+	int pending;      /* if a repeatable key is being held down */
 	int delay;        /* the delay before we start repeating */
 	int interval;     /* the delay between key repeat events */
-	Uint32 timestamp; /* the time the first keydown event occurred */
+	Uint32 deadline;  /* the SDL_GetTicks() time of the next repeat */
 
 	SDL_Event evt;    /* the event we are supposed to repeat */
 } SDL_KeyRepeat;
@@ -362,7 +362,7 @@ void SDL_ResetKeyboard(void)
 			SDL_PrivateKeyboard(SDL_RELEASED, &keysym);
 		}
 	}
-	SDL_KeyRepeat.timestamp = 0;
+	SDL_KeyRepeat.pending = 0;
 }
 
 int SDL_EnableUNICODE(int enable)
@@ -538,9 +538,9 @@ printf("The '%s' key has been %s\n", SDL_GetKeyName(keysym->sym),
 			/*
 			 * jk 991215 - Added
 			 */
-			if ( SDL_KeyRepeat.timestamp &&
+			if ( SDL_KeyRepeat.pending &&
 			     SDL_KeyRepeat.evt.key.keysym.sym == keysym->sym ) {
-				SDL_KeyRepeat.timestamp = 0;
+				SDL_KeyRepeat.pending = 0;
 			}
 			break;
 		default:
@@ -572,8 +572,9 @@ printf("Keyboard event didn't change state - dropped!\n");
 		 */
 		if (repeatable && (SDL_KeyRepeat.delay != 0)) {
 			SDL_KeyRepeat.evt = event;
-			SDL_KeyRepeat.firsttime = 1;
-			SDL_KeyRepeat.timestamp=SDL_GetTicks();
+			SDL_KeyRepeat.pending = 1;
+			SDL_KeyRepeat.deadline = SDL_GetTicks() +
+				SDL_KeyRepeat.delay + SDL_KeyRepeat.interval;
 		}
 		if ( (SDL_EventOK == NULL) || SDL_EventOK(&event) ) {
 			posted = 1;
@@ -588,22 +589,21 @@ printf("Keyboard event didn't change state - dropped!\n");
  */
 void SDL_CheckKeyRepeat(void)
 {
-	if ( SDL_KeyRepeat.timestamp ) {
-		Uint32 now, interval;
+	/* Nothing to do (and no clock to read) unless a key is held */
+	if ( SDL_KeyRepeat.pending ) {
+		Uint32 now;
 
 		now = SDL_GetTicks();
-		interval = (now - SDL_KeyRepeat.timestamp);
-		if ( SDL_KeyRepeat.firsttime ) {
-			if ( interval > (Uint32)SDL_KeyRepeat.delay ) {
-				SDL_KeyRepeat.timestamp = now;
-				SDL_KeyRepeat.firsttime = 0;
+		if ( (Sint32)(now - SDL_KeyRepeat.deadline) > 0 ) {
+			/* Stay on the original schedule, but don't send a burst
+			   of repeats if we weren't pumped for a while.
+			 */
+			SDL_KeyRepeat.deadline += SDL_KeyRepeat.interval;
+			if ( (Sint32)(now - SDL_KeyRepeat.deadline) > 0 ) {
+				SDL_KeyRepeat.deadline = now + SDL_KeyRepeat.interval;
 			}
-		} else {
-			if ( interval > (Uint32)SDL_KeyRepeat.interval ) {
-				SDL_KeyRepeat.timestamp = now;
-				if ( (SDL_EventOK == NULL) || SDL_EventOK(&SDL_KeyRepeat.evt) ) {
-					SDL_PushEvent(&SDL_KeyRepeat.evt);
-				}
+			if ( (SDL_EventOK == NULL) || SDL_EventOK(&SDL_KeyRepeat.evt) ) {
+				SDL_PushEvent(&SDL_KeyRepeat.evt);
 			}
 		}
 	}
@@ -615,10 +615,9 @@ int SDL_EnableKeyRepeat(int delay, int interval)
 		SDL_SetError("keyboard repeat value less than zero");
 		return(-1);
 	}
-	SDL_KeyRepeat.firsttime = 0;
+	SDL_KeyRepeat.pending = 0;
 	SDL_KeyRepeat.delay = delay;
 	SDL_KeyRepeat.interval = interval;
-	SDL_KeyRepeat.timestamp = 0;
 	return(0);
 }
 
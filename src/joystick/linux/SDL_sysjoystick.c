@@ -31,12 +31,16 @@
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <limits.h>		/* For the definition of PATH_MAX */
+#include <poll.h>
 #include <linux/joystick.h>
 #if SDL_INPUT_LINUXEV
 #include <linux/input.h>
 #endif
 
 #include "SDL_joystick.h"
+#include "SDL_thread.h"
+#include "SDL_mutex.h"
+#include "SDL_atomic.h"
 #include "../SDL_sysjoystick.h"
 #include "../SDL_joystick_c.h"
 
@@ -298,6 +302,196 @@ struct joystick_hwdata {
 };
 
 
+#if !SDL_THREADS_DISABLED
+/* Rather than reading every open device on each joystick update, a
+   helper thread sleeps in poll() on the device descriptors and flags
+   each device that has input waiting.  Updating an idle joystick is
+   then just a check of that flag.  Once a device is flagged the thread
+   stops watching it until the update has drained it, so it never spins.
+ */
+static struct {
+	SDL_Thread *thread;
+	SDL_mutex *lock;
+	int wake[2];		/* Pipe to make the thread rescan the slots */
+	int quit;
+	struct {
+		int fd;		/* -1 if the slot isn't being watched */
+		int armed;	/* Waiting for the device to have input */
+		int hangup;	/* The device went away, don't rearm */
+		SDL_AtomicInt ready;
+	} slot[MAX_JOYSTICKS];
+} JoyWatch;
+
+static void JoyWatchWake(void)
+{
+	if ( write(JoyWatch.wake[1], "", 1) < 0 ) {
+		/* The pipe is full, so the thread is waking up anyway */
+	}
+}
+
+static int SDLCALL JoyWatchThread(void *unused)
+{
+	struct pollfd fds[MAX_JOYSTICKS+1];
+	int which[MAX_JOYSTICKS+1];
+	char buf[32];
+	int i, n;
+
+	for ( ;; ) {
+		/* Collect the devices we're waiting on */
+		fds[0].fd = JoyWatch.wake[0];
+		fds[0].events = POLLIN;
+		n = 1;
+		SDL_mutexP(JoyWatch.lock);
+		if ( JoyWatch.quit ) {
+			SDL_mutexV(JoyWatch.lock);
+			break;
+		}
+		for ( i=0; i<MAX_JOYSTICKS; ++i ) {
+			if ( (JoyWatch.slot[i].fd >= 0) && JoyWatch.slot[i].armed ) {
+				fds[n].fd = JoyWatch.slot[i].fd;
+				fds[n].events = POLLIN;
+				which[n] = i;
+				++n;
+			}
+		}
+		SDL_mutexV(JoyWatch.lock);
+
+		if ( poll(fds, n, -1) <= 0 ) {
+			continue;
+		}
+		if ( fds[0].revents ) {
+			while ( read(JoyWatch.wake[0], buf, sizeof(buf)) > 0 ) {
+				/* Drain the wakeups */;
+			}
+		}
+
+		/* Flag the devices with input, skipping any that were
+		   closed (or closed and reopened) while we were asleep.
+		 */
+		SDL_mutexP(JoyWatch.lock);
+		for ( i=1; i<n; ++i ) {
+			int index = which[i];
+			if ( fds[i].revents &&
+			     (JoyWatch.slot[index].fd == fds[i].fd) ) {
+				if ( fds[i].revents & (POLLERR|POLLHUP|POLLNVAL) ) {
+					JoyWatch.slot[index].hangup = 1;
+				}
+				JoyWatch.slot[index].armed = 0;
+				SDL_AtomicStore(&JoyWatch.slot[index].ready, 1);
+			}
+		}
+		SDL_mutexV(JoyWatch.lock);
+	}
+	return(0);
+}
+
+static void JoyWatchStart(void)
+{
+	SDL_ThreadAttr attr;
+	int i;
+
+	JoyWatch.lock = SDL_CreateMutex();
+	if ( JoyWatch.lock == NULL ) {
+		return;
+	}
+	if ( pipe(JoyWatch.wake) < 0 ) {
+		SDL_DestroyMutex(JoyWatch.lock);
+		JoyWatch.lock = NULL;
+		return;
+	}
+	fcntl(JoyWatch.wake[0], F_SETFL, O_NONBLOCK);
+	fcntl(JoyWatch.wake[1], F_SETFL, O_NONBLOCK);
+	for ( i=0; i<MAX_JOYSTICKS; ++i ) {
+		JoyWatch.slot[i].fd = -1;
+	}
+	JoyWatch.quit = 0;
+
+	SDL_InitThreadAttr(&attr);
+	attr.name = "SDLJoystick";
+	attr.stacksize = 64*1024;
+	JoyWatch.thread = SDL_CreateThreadEx(JoyWatchThread, NULL, &attr);
+	if ( JoyWatch.thread == NULL ) {
+		/* Fall back to reading the devices on every update */
+		close(JoyWatch.wake[0]);
+		close(JoyWatch.wake[1]);
+		SDL_DestroyMutex(JoyWatch.lock);
+		JoyWatch.lock = NULL;
+	}
+}
+
+static void JoyWatchStop(void)
+{
+	if ( JoyWatch.thread ) {
+		SDL_mutexP(JoyWatch.lock);
+		JoyWatch.quit = 1;
+		SDL_mutexV(JoyWatch.lock);
+		JoyWatchWake();
+		SDL_WaitThread(JoyWatch.thread, NULL);
+		JoyWatch.thread = NULL;
+		close(JoyWatch.wake[0]);
+		close(JoyWatch.wake[1]);
+		SDL_DestroyMutex(JoyWatch.lock);
+		JoyWatch.lock = NULL;
+	}
+}
+
+static void JoyWatchAdd(int index, int fd)
+{
+	if ( JoyWatch.thread == NULL ) {
+		JoyWatchStart();
+		if ( JoyWatch.thread == NULL ) {
+			return;
+		}
+	}
+	SDL_mutexP(JoyWatch.lock);
+	JoyWatch.slot[index].fd = fd;
+	JoyWatch.slot[index].armed = 0;
+	JoyWatch.slot[index].hangup = 0;
+	/* Read the initial state on the first update */
+	SDL_AtomicStore(&JoyWatch.slot[index].ready, 1);
+	SDL_mutexV(JoyWatch.lock);
+}
+
+static void JoyWatchRemove(int index)
+{
+	if ( JoyWatch.thread ) {
+		SDL_mutexP(JoyWatch.lock);
+		JoyWatch.slot[index].fd = -1;
+		JoyWatch.slot[index].armed = 0;
+		SDL_mutexV(JoyWatch.lock);
+		JoyWatchWake();
+	}
+}
+
+/* Returns 1 if the device in this slot may have input to read */
+static int JoyWatchReady(int index)
+{
+	if ( JoyWatch.thread == NULL ) {
+		return(1);
+	}
+	if ( ! SDL_AtomicLoad(&JoyWatch.slot[index].ready) ) {
+		return(0);
+	}
+	SDL_AtomicStore(&JoyWatch.slot[index].ready, 0);
+	return(1);
+}
+
+/* Called after the device in this slot has been read dry */
+static void JoyWatchRearm(int index)
+{
+	if ( JoyWatch.thread ) {
+		SDL_mutexP(JoyWatch.lock);
+		if ( (JoyWatch.slot[index].fd >= 0) &&
+		     ! JoyWatch.slot[index].hangup ) {
+			JoyWatch.slot[index].armed = 1;
+		}
+		SDL_mutexV(JoyWatch.lock);
+		JoyWatchWake();
+	}
+}
+#endif /* !SDL_THREADS_DISABLED */
+
+
 #ifndef NO_LOGICAL_JOYSTICKS
 
 static int CountLogicalJoysticks(int max)
@@ -830,6 +1024,14 @@ int SDL_SYS_JoystickOpen(SDL_Joystick *joystick)
 	/* Set the joystick to non-blocking read mode */
 	fcntl(fd, F_SETFL, O_NONBLOCK);
 
+#if !SDL_THREADS_DISABLED
+	/* Logical joysticks share the device with the real one */
+#ifndef NO_LOGICAL_JOYSTICKS
+	if ( realjoy == NULL )
+#endif
+		JoyWatchAdd(joystick->index, fd);
+#endif
+
 	/* Get the number of buttons and axes on the joystick */
 #ifndef NO_LOGICAL_JOYSTICKS
 	if (realjoy)
@@ -1161,7 +1363,20 @@ static __inline__ void EV_HandleEvents(SDL_Joystick *joystick)
 void SDL_SYS_JoystickUpdate(SDL_Joystick *joystick)
 {
 	int i;
-	
+#if !SDL_THREADS_DISABLED
+	int slot = joystick->index;
+
+#ifndef NO_LOGICAL_JOYSTICKS
+	if (SDL_joylist[slot].fname == NULL) {
+		SDL_joylist_head(slot, joystick->index);
+	}
+#endif
+	/* Nothing has changed unless the device has input waiting */
+	if ( ! JoyWatchReady(slot) ) {
+		return;
+	}
+#endif
+
 #if SDL_INPUT_LINUXEV
 	if ( joystick->hwdata->is_hid )
 		EV_HandleEvents(joystick);
@@ -1169,6 +1384,10 @@ void SDL_SYS_JoystickUpdate(SDL_Joystick *joystick)
 #endif
 		JS_HandleEvents(joystick);
 
+#if !SDL_THREADS_DISABLED
+	JoyWatchRearm(slot);
+#endif
+
 	/* Deliver ball motion updates */
 	for ( i=0; i<joystick->nballs; ++i ) {
 		int xrel, yrel;
@@ -1198,7 +1417,12 @@ void SDL_SYS_JoystickClose(SDL_Joystick *joystick)
 #ifndef NO_LOGICAL_JOYSTICKS
 		if (SDL_joylist[joystick->index].fname != NULL)
 #endif
-		close(joystick->hwdata->fd);
+		{
+#if !SDL_THREADS_DISABLED
+			JoyWatchRemove(joystick->index);
+#endif
+			close(joystick->hwdata->fd);
+		}
 		if ( joystick->hwdata->hats ) {
 			SDL_free(joystick->hwdata->hats);
 		}
@@ -1215,6 +1439,10 @@ void SDL_SYS_JoystickQuit(void)
 {
 	int i;
 
+#if !SDL_THREADS_DISABLED
+	JoyWatchStop();
+#endif
+
 	for ( i=0; SDL_joylist[i].fname; ++i ) {
 		SDL_free(SDL_joylist[i].fname);
 		SDL_joylist[i].fname = NULL;
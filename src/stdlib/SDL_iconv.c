@@ -25,6 +25,7 @@
 
 #include "SDL_stdinc.h"
 #include "SDL_endian.h"
+#include "SDL_atomic.h"
 
 #if defined(HAVE_ICONV) && defined(HAVE_ICONV_H)
 
@@ -54,6 +55,10 @@ size_t SDL_iconv(SDL_iconv_t cd,
 
 #else
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 /* Lots of useful information on Unicode at:
 	http://www.cl.cam.ac.uk/~mgk25/unicode.html
 */
@@ -89,36 +94,70 @@ struct _SDL_iconv_t
 {
 	int src_fmt;
 	int dst_fmt;
+	int open_src_fmt;	/* The formats as opened, before any BOM */
+	int open_dst_fmt;
+	char fromcode[16];	/* The names it was opened with, if short */
+	char tocode[16];
 };
 
+/* The last descriptor closed, kept for the next SDL_iconv_open() */
+static SDL_AtomicPointer cached_cd;
+
+/* Encoding names, uppercased and without '-' or '_' (see GetEncoding) */
 static struct {
 	const char *name;
 	int format;
 } encodings[] = {
-	{ "ASCII",	ENCODING_ASCII },
-	{ "US-ASCII",	ENCODING_ASCII },
-	{ "8859-1",	ENCODING_LATIN1 },
-	{ "ISO-8859-1",	ENCODING_LATIN1 },
 	{ "UTF8",	ENCODING_UTF8 },
-	{ "UTF-8",	ENCODING_UTF8 },
+	{ "ASCII",	ENCODING_ASCII },
+	{ "USASCII",	ENCODING_ASCII },
+	{ "88591",	ENCODING_LATIN1 },
+	{ "ISO88591",	ENCODING_LATIN1 },
 	{ "UTF16",	ENCODING_UTF16 },
-	{ "UTF-16",	ENCODING_UTF16 },
 	{ "UTF16BE",	ENCODING_UTF16BE },
-	{ "UTF-16BE",	ENCODING_UTF16BE },
 	{ "UTF16LE",	ENCODING_UTF16LE },
-	{ "UTF-16LE",	ENCODING_UTF16LE },
 	{ "UTF32",	ENCODING_UTF32 },
-	{ "UTF-32",	ENCODING_UTF32 },
 	{ "UTF32BE",	ENCODING_UTF32BE },
-	{ "UTF-32BE",	ENCODING_UTF32BE },
 	{ "UTF32LE",	ENCODING_UTF32LE },
-	{ "UTF-32LE",	ENCODING_UTF32LE },
 	{ "UCS2",	ENCODING_UCS2 },
-	{ "UCS-2",	ENCODING_UCS2 },
 	{ "UCS4",	ENCODING_UCS4 },
-	{ "UCS-4",	ENCODING_UCS4 },
 };
 
+/* Look up an encoding by name, ignoring case, '-' and '_'.  The name is
+   folded once into a short key, so a lookup is a handful of strcmp()s
+   on short strings rather than two case-insensitive scans of the whole
+   table for every SDL_iconv_open() / SDL_iconv_string() call.
+ */
+static int GetEncoding(const char *name)
+{
+	char key[16];
+	size_t len = 0;
+	int i;
+
+	for ( ; *name; ++name ) {
+		char c = *name;
+		if ( c == '-' || c == '_' ) {
+			continue;
+		}
+		if ( len == sizeof(key)-1 ) {
+			return ENCODING_UNKNOWN;
+		}
+		if ( c >= 'a' && c <= 'z' ) {
+			c -= 'a' - 'A';
+		}
+		key[len++] = c;
+	}
+	key[len] = '\0';
+
+	for ( i = 0; i < SDL_arraysize(encodings); ++i ) {
+		if ( encodings[i].name[0] == key[0] &&
+		     SDL_strcmp(encodings[i].name, key) == 0 ) {
+			return encodings[i].format;
+		}
+	}
+	return ENCODING_UNKNOWN;
+}
+
 static const char *getlocale(char *buffer, size_t bufsize)
 {
 	const char *lang;
@@ -155,9 +194,9 @@ static const char *getlocale(char *buffer, size_t bufsize)
 
 SDL_iconv_t SDL_iconv_open(const char *tocode, const char *fromcode)
 {
-	int src_fmt = ENCODING_UNKNOWN;
-	int dst_fmt = ENCODING_UNKNOWN;
-	int i;
+	SDL_iconv_t cd;
+	int src_fmt;
+	int dst_fmt;
 	char fromcode_buffer[64];
 	char tocode_buffer[64];
 
@@ -167,29 +206,512 @@ SDL_iconv_t SDL_iconv_open(const char *tocode, const char *fromcode)
 	if ( !tocode || !*tocode ) {
 		tocode = getlocale(tocode_buffer, sizeof(tocode_buffer));
 	}
-	for ( i = 0; i < SDL_arraysize(encodings); ++i ) {
-		if ( SDL_strcasecmp(fromcode, encodings[i].name) == 0 ) {
-			src_fmt = encodings[i].format;
-			if ( dst_fmt != ENCODING_UNKNOWN ) {
+
+	/* SDL_iconv_string() opens and closes a descriptor for every string,
+	   usually with the same names, so reuse the last one closed.
+	 */
+	cd = (SDL_iconv_t)SDL_AtomicSwapPtr(&cached_cd, NULL);
+	if ( cd && SDL_strcmp(cd->fromcode, fromcode) == 0 &&
+	           SDL_strcmp(cd->tocode, tocode) == 0 ) {
+		cd->src_fmt = cd->open_src_fmt;
+		cd->dst_fmt = cd->open_dst_fmt;
+		return cd;
+	}
+
+	src_fmt = GetEncoding(fromcode);
+	dst_fmt = GetEncoding(tocode);
+	if ( src_fmt == ENCODING_UNKNOWN || dst_fmt == ENCODING_UNKNOWN ) {
+		if ( cd ) {
+			SDL_free(cd);
+		}
+		return (SDL_iconv_t)-1;
+	}
+	if ( !cd ) {
+		cd = (SDL_iconv_t)SDL_malloc(sizeof(*cd));
+		if ( !cd ) {
+			return (SDL_iconv_t)-1;
+		}
+	}
+	cd->src_fmt = cd->open_src_fmt = src_fmt;
+	cd->dst_fmt = cd->open_dst_fmt = dst_fmt;
+	/* Names too long to keep never match, as they can't be empty */
+	if ( SDL_strlcpy(cd->fromcode, fromcode, sizeof(cd->fromcode)) >= sizeof(cd->fromcode) ) {
+		cd->fromcode[0] = '\0';
+	}
+	if ( SDL_strlcpy(cd->tocode, tocode, sizeof(cd->tocode)) >= sizeof(cd->tocode) ) {
+		cd->tocode[0] = '\0';
+	}
+	return cd;
+}
+
+/* Every encoding here stores the 7-bit ASCII characters as a single
+   code unit holding the character, so runs of them can be converted
+   without going through UCS-4.  An ASCII code unit is 1, 2 or 4 bytes
+   wide, and its character is in the low (last for big endian) byte.
+ */
+typedef struct {
+	int size;		/* Bytes per code unit */
+	int low;		/* Offset of the character byte in a unit */
+	Uint8 mask[16];		/* Bits that must be clear, 16 bytes' worth */
+} ASCIIUnit;
+
+static SDL_bool GetASCIIUnit(int fmt, ASCIIUnit *unit)
+{
+	int i;
+
+	switch ( fmt ) {
+	    case ENCODING_ASCII:
+	    case ENCODING_LATIN1:
+	    case ENCODING_UTF8:
+		unit->size = 1;
+		unit->low = 0;
+		break;
+	    case ENCODING_UTF16BE:
+		unit->size = 2;
+		unit->low = 1;
+		break;
+	    case ENCODING_UTF16LE:
+		unit->size = 2;
+		unit->low = 0;
+		break;
+	    case ENCODING_UCS2:
+		unit->size = 2;
+		unit->low = (SDL_BYTEORDER == SDL_BIG_ENDIAN) ? 1 : 0;
+		break;
+	    case ENCODING_UTF32BE:
+		unit->size = 4;
+		unit->low = 3;
+		break;
+	    case ENCODING_UTF32LE:
+		unit->size = 4;
+		unit->low = 0;
+		break;
+	    case ENCODING_UCS4:
+		unit->size = 4;
+		unit->low = (SDL_BYTEORDER == SDL_BIG_ENDIAN) ? 3 : 0;
+		break;
+	    default:
+		return SDL_FALSE;
+	}
+	for ( i = 0; i < sizeof(unit->mask); ++i ) {
+		unit->mask[i] = ((i % unit->size) == unit->low) ? 0x80 : 0xFF;
+	}
+	return SDL_TRUE;
+}
+
+/* Returns how many of the first 'units' code units are ASCII */
+static size_t ScanASCII(const Uint8 *src, size_t units, const ASCIIUnit *unit)
+{
+	const size_t size = unit->size;
+	const size_t len = units * size;
+	size_t i = 0;
+	size_t j;
+
+#ifdef __SSE2__
+	{
+		const __m128i mask = _mm_loadu_si128((const __m128i *)unit->mask);
+		const __m128i zero = _mm_setzero_si128();
+		while ( i + 16 <= len ) {
+			__m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+			v = _mm_cmpeq_epi8(_mm_and_si128(v, mask), zero);
+			if ( _mm_movemask_epi8(v) != 0xFFFF ) {
 				break;
 			}
+			i += 16;
 		}
-		if ( SDL_strcasecmp(tocode, encodings[i].name) == 0 ) {
-			dst_fmt = encodings[i].format;
-			if ( src_fmt != ENCODING_UNKNOWN ) {
+	}
+#else
+	/* A machine word at a time, once the source is aligned */
+	while ( i < len && ((uintptr_t)(src + i) % sizeof(size_t)) != 0 ) {
+		for ( j = 0; j < size; ++j ) {
+			if ( src[i + j] & unit->mask[j] ) {
+				return i / size;
+			}
+		}
+		i += size;
+	}
+	if ( ((uintptr_t)(src + i) % sizeof(size_t)) == 0 ) {
+		size_t mask;
+		SDL_memcpy(&mask, unit->mask, sizeof(mask));
+		while ( i + sizeof(size_t) <= len ) {
+			if ( *(const size_t *)(src + i) & mask ) {
 				break;
 			}
+			i += sizeof(size_t);
 		}
 	}
-	if ( src_fmt != ENCODING_UNKNOWN && dst_fmt != ENCODING_UNKNOWN ) {
-		SDL_iconv_t cd = (SDL_iconv_t)SDL_malloc(sizeof(*cd));
-		if ( cd ) {
-			cd->src_fmt = src_fmt;
-			cd->dst_fmt = dst_fmt;
-			return cd;
+#endif
+	while ( i < len ) {
+		for ( j = 0; j < size; ++j ) {
+			if ( src[i + j] & unit->mask[j] ) {
+				return i / size;
+			}
+		}
+		i += size;
+	}
+	return units;
+}
+
+/* Converts 'units' ASCII code units from one encoding to another */
+static void CopyASCII(const Uint8 *src, const ASCIIUnit *srcunit,
+                      Uint8 *dst, const ASCIIUnit *dstunit, size_t units)
+{
+	const int srcsize = srcunit->size;
+	const int dstsize = dstunit->size;
+
+	if ( srcsize == dstsize && srcunit->low == dstunit->low ) {
+		SDL_memcpy(dst, src, units * srcsize);
+		return;
+	}
+#ifdef __SSE2__
+	/* Widen or narrow sixteen characters at a time */
+	if ( srcsize == 1 && dstsize == 2 ) {
+		const __m128i zero = _mm_setzero_si128();
+		while ( units >= 16 ) {
+			__m128i v = _mm_loadu_si128((const __m128i *)src);
+			__m128i lo, hi;
+			if ( dstunit->low == 0 ) {
+				lo = _mm_unpacklo_epi8(v, zero);
+				hi = _mm_unpackhi_epi8(v, zero);
+			} else {
+				lo = _mm_unpacklo_epi8(zero, v);
+				hi = _mm_unpackhi_epi8(zero, v);
+			}
+			_mm_storeu_si128((__m128i *)dst, lo);
+			_mm_storeu_si128((__m128i *)(dst + 16), hi);
+			src += 16;
+			dst += 32;
+			units -= 16;
+		}
+	} else if ( srcsize == 1 && dstsize == 4 ) {
+		const __m128i zero = _mm_setzero_si128();
+		while ( units >= 16 ) {
+			__m128i v = _mm_loadu_si128((const __m128i *)src);
+			__m128i w[4];
+			int k;
+			if ( dstunit->low == 0 ) {
+				__m128i lo = _mm_unpacklo_epi8(v, zero);
+				__m128i hi = _mm_unpackhi_epi8(v, zero);
+				w[0] = _mm_unpacklo_epi16(lo, zero);
+				w[1] = _mm_unpackhi_epi16(lo, zero);
+				w[2] = _mm_unpacklo_epi16(hi, zero);
+				w[3] = _mm_unpackhi_epi16(hi, zero);
+			} else {
+				__m128i lo = _mm_unpacklo_epi8(zero, v);
+				__m128i hi = _mm_unpackhi_epi8(zero, v);
+				w[0] = _mm_unpacklo_epi16(zero, lo);
+				w[1] = _mm_unpackhi_epi16(zero, lo);
+				w[2] = _mm_unpacklo_epi16(zero, hi);
+				w[3] = _mm_unpackhi_epi16(zero, hi);
+			}
+			for ( k = 0; k < 4; ++k ) {
+				_mm_storeu_si128((__m128i *)(dst + k * 16), w[k]);
+			}
+			src += 16;
+			dst += 64;
+			units -= 16;
+		}
+	} else if ( srcsize == 2 && dstsize == 1 ) {
+		while ( units >= 16 ) {
+			__m128i lo = _mm_loadu_si128((const __m128i *)src);
+			__m128i hi = _mm_loadu_si128((const __m128i *)(src + 16));
+			if ( srcunit->low ) {
+				lo = _mm_srli_epi16(lo, 8);
+				hi = _mm_srli_epi16(hi, 8);
+			}
+			_mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(lo, hi));
+			src += 32;
+			dst += 16;
+			units -= 16;
+		}
+	}
+#endif
+	src += srcunit->low;
+	if ( dstsize == 1 ) {
+		while ( units-- ) {
+			*dst++ = *src;
+			src += srcsize;
+		}
+	} else {
+		SDL_memset(dst, 0, units * dstsize);
+		dst += dstunit->low;
+		while ( units-- ) {
+			*dst = *src;
+			src += srcsize;
+			dst += dstsize;
+		}
+	}
+}
+
+/* UTF-8 and UTF-16 are converted straight into each other, without
+   going through UCS-4, for as long as the text is well formed.  These
+   stop at anything else (a bad or truncated sequence, a character that
+   SDL_iconv() would replace, or a full output buffer) and leave it to
+   the character at a time code, returning how many characters they
+   converted.  'bigendian' is the byte order of the UTF-16 side.
+ */
+static Uint32 GetUTF16(const Uint8 *p, int bigendian)
+{
+	if ( bigendian ) {
+		return ((Uint32)p[0] << 8) | p[1];
+	} else {
+		return ((Uint32)p[1] << 8) | p[0];
+	}
+}
+
+static void PutUTF16(Uint8 *p, Uint32 w, int bigendian)
+{
+	if ( bigendian ) {
+		p[0] = (Uint8)(w >> 8);
+		p[1] = (Uint8)w;
+	} else {
+		p[0] = (Uint8)w;
+		p[1] = (Uint8)(w >> 8);
+	}
+}
+
+static size_t UTF8ToUTF16(const char **srcp, size_t *srclen,
+                          const ASCIIUnit *srcunit,
+                          char **dstp, size_t *dstlen,
+                          const ASCIIUnit *dstunit)
+{
+	const Uint8 *src = (const Uint8 *)*srcp;
+	const Uint8 *srcend = src + *srclen;
+	Uint8 *dst = (Uint8 *)*dstp;
+	Uint8 *dstend = dst + *dstlen;
+	const int bigendian = dstunit->low;
+	size_t total = 0;
+	size_t n;
+	Uint32 ch;
+
+	while ( src < srcend ) {
+#ifdef __SSE2__
+		const Uint8 *start = src;
+#endif
+		const Uint8 c = src[0];
+
+		if ( c < 0x80 ) {
+			n = SDL_min((size_t)(srcend - src),
+			            (size_t)(dstend - dst) / 2);
+			n = ScanASCII(src, n, srcunit);
+			if ( n == 0 ) {
+				break;
+			}
+			CopyASCII(src, srcunit, dst, dstunit, n);
+			src += n;
+			dst += n * 2;
+			total += n;
+			continue;
+		}
+#ifdef __SSE2__
+		/* Text in Latin, Greek, Cyrillic, Hebrew or Arabic script is
+		   mostly two byte sequences.  Check eight of them at once,
+		   with a lead byte of C2-DF and a continuation byte in each
+		   16-bit lane, and decode them together.
+		 */
+		while ( (srcend - src) >= 16 && (dstend - dst) >= 16 ) {
+			const __m128i v = _mm_loadu_si128((const __m128i *)src);
+			__m128i ok, w;
+			ok = _mm_cmpeq_epi16(
+				_mm_and_si128(v, _mm_set1_epi16((short)0xC0E0)),
+				_mm_set1_epi16((short)0x80C0));
+			ok = _mm_andnot_si128(
+				_mm_cmpeq_epi16(
+					_mm_and_si128(v, _mm_set1_epi16(0x001E)),
+					_mm_setzero_si128()), ok);
+			if ( _mm_movemask_epi8(ok) != 0xFFFF ) {
+				break;
+			}
+			w = _mm_or_si128(
+				_mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0x001F)), 6),
+				_mm_and_si128(_mm_srli_epi16(v, 8), _mm_set1_epi16(0x003F)));
+			if ( bigendian ) {
+				w = _mm_or_si128(_mm_slli_epi16(w, 8),
+				                 _mm_srli_epi16(w, 8));
+			}
+			_mm_storeu_si128((__m128i *)dst, w);
+			src += 16;
+			dst += 16;
+			total += 8;
+		}
+		if ( src != start ) {
+			continue;
+		}
+#endif
+		if ( c < 0xC2 ) {
+			/* A stray continuation byte or an overlong sequence */
+			break;
+		} else if ( c < 0xE0 ) {
+			if ( (srcend - src) < 2 || (src[1] & 0xC0) != 0x80 ) {
+				break;
+			}
+			ch = ((Uint32)(c & 0x1F) << 6) | (src[1] & 0x3F);
+			n = 2;
+		} else if ( c < 0xF0 ) {
+			if ( (srcend - src) < 3 ||
+			     (src[1] & 0xC0) != 0x80 || (src[2] & 0xC0) != 0x80 ) {
+				break;
+			}
+			ch = ((Uint32)(c & 0x0F) << 12) |
+			     ((Uint32)(src[1] & 0x3F) << 6) | (src[2] & 0x3F);
+			if ( ch < 0x800 || (ch >= 0xD800 && ch <= 0xDFFF) ||
+			     ch >= 0xFFFE ) {
+				break;
+			}
+			n = 3;
+		} else if ( c < 0xF5 ) {
+			if ( (srcend - src) < 4 ||
+			     (src[1] & 0xC0) != 0x80 || (src[2] & 0xC0) != 0x80 ||
+			     (src[3] & 0xC0) != 0x80 ) {
+				break;
+			}
+			ch = ((Uint32)(c & 0x07) << 18) |
+			     ((Uint32)(src[1] & 0x3F) << 12) |
+			     ((Uint32)(src[2] & 0x3F) << 6) | (src[3] & 0x3F);
+			if ( ch < 0x10000 || ch > 0x10FFFF ) {
+				break;
+			}
+			n = 4;
+		} else {
+			break;
+		}
+
+		if ( ch < 0x10000 ) {
+			if ( (dstend - dst) < 2 ) {
+				break;
+			}
+			PutUTF16(dst, ch, bigendian);
+			dst += 2;
+		} else {
+			if ( (dstend - dst) < 4 ) {
+				break;
+			}
+			ch -= 0x10000;
+			PutUTF16(dst, 0xD800 | (ch >> 10), bigendian);
+			PutUTF16(dst + 2, 0xDC00 | (ch & 0x3FF), bigendian);
+			dst += 4;
+		}
+		src += n;
+		++total;
+	}
+
+	*srclen -= (src - (const Uint8 *)*srcp);
+	*srcp = (const char *)src;
+	*dstlen -= (dst - (Uint8 *)*dstp);
+	*dstp = (char *)dst;
+	return total;
+}
+
+static size_t UTF16ToUTF8(const char **srcp, size_t *srclen,
+                          const ASCIIUnit *srcunit,
+                          char **dstp, size_t *dstlen,
+                          const ASCIIUnit *dstunit)
+{
+	const Uint8 *src = (const Uint8 *)*srcp;
+	const Uint8 *srcend = src + (*srclen & ~1);
+	Uint8 *dst = (Uint8 *)*dstp;
+	Uint8 *dstend = dst + *dstlen;
+	const int bigendian = srcunit->low;
+	size_t total = 0;
+	size_t n;
+	Uint32 ch;
+
+	while ( src < srcend ) {
+#ifdef __SSE2__
+		const Uint8 *start = src;
+#endif
+		ch = GetUTF16(src, bigendian);
+
+		if ( ch < 0x80 ) {
+			n = SDL_min((size_t)(srcend - src) / 2,
+			            (size_t)(dstend - dst));
+			n = ScanASCII(src, n, srcunit);
+			if ( n == 0 ) {
+				break;
+			}
+			CopyASCII(src, srcunit, dst, dstunit, n);
+			src += n * 2;
+			dst += n;
+			total += n;
+			continue;
+		}
+#ifdef __SSE2__
+		/* The reverse of UTF8ToUTF16(): eight characters from U+0080
+		   to U+07FF become eight two byte sequences.
+		 */
+		while ( (srcend - src) >= 16 && (dstend - dst) >= 16 ) {
+			__m128i w = _mm_loadu_si128((const __m128i *)src);
+			__m128i ok;
+			if ( bigendian ) {
+				w = _mm_or_si128(_mm_slli_epi16(w, 8),
+				                 _mm_srli_epi16(w, 8));
+			}
+			ok = _mm_cmpeq_epi16(
+				_mm_and_si128(w, _mm_set1_epi16((short)0xF800)),
+				_mm_setzero_si128());
+			ok = _mm_andnot_si128(
+				_mm_cmpeq_epi16(
+					_mm_and_si128(w, _mm_set1_epi16(0x0780)),
+					_mm_setzero_si128()), ok);
+			if ( _mm_movemask_epi8(ok) != 0xFFFF ) {
+				break;
+			}
+			w = _mm_or_si128(
+				_mm_or_si128(_mm_srli_epi16(w, 6),
+				             _mm_set1_epi16((short)0x80C0)),
+				_mm_slli_epi16(_mm_and_si128(w, _mm_set1_epi16(0x003F)), 8));
+			_mm_storeu_si128((__m128i *)dst, w);
+			src += 16;
+			dst += 16;
+			total += 8;
 		}
+		if ( src != start ) {
+			continue;
+		}
+#endif
+		if ( ch < 0x800 ) {
+			if ( (dstend - dst) < 2 ) {
+				break;
+			}
+			dst[0] = 0xC0 | (Uint8)(ch >> 6);
+			dst[1] = 0x80 | (Uint8)(ch & 0x3F);
+			dst += 2;
+			n = 2;
+		} else if ( ch < 0xD800 || ch > 0xDFFF ) {
+			if ( (dstend - dst) < 3 ) {
+				break;
+			}
+			dst[0] = 0xE0 | (Uint8)(ch >> 12);
+			dst[1] = 0x80 | (Uint8)((ch >> 6) & 0x3F);
+			dst[2] = 0x80 | (Uint8)(ch & 0x3F);
+			dst += 3;
+			n = 2;
+		} else {
+			Uint32 W2;
+			if ( ch > 0xDBFF || (srcend - src) < 4 ) {
+				break;
+			}
+			W2 = GetUTF16(src + 2, bigendian);
+			if ( W2 < 0xDC00 || W2 > 0xDFFF || (dstend - dst) < 4 ) {
+				break;
+			}
+			ch = (((ch & 0x3FF) << 10) | (W2 & 0x3FF)) + 0x10000;
+			dst[0] = 0xF0 | (Uint8)(ch >> 18);
+			dst[1] = 0x80 | (Uint8)((ch >> 12) & 0x3F);
+			dst[2] = 0x80 | (Uint8)((ch >> 6) & 0x3F);
+			dst[3] = 0x80 | (Uint8)(ch & 0x3F);
+			dst += 4;
+			n = 4;
+		}
+		src += n;
+		++total;
 	}
-	return (SDL_iconv_t)-1;
+
+	*srclen -= (src - (const Uint8 *)*srcp);
+	*srcp = (const char *)src;
+	*dstlen -= (dst - (Uint8 *)*dstp);
+	*dstp = (char *)dst;
+	return total;
 }
 
 size_t SDL_iconv(SDL_iconv_t cd,
@@ -202,6 +724,10 @@ size_t SDL_iconv(SDL_iconv_t cd,
 	size_t srclen, dstlen;
 	Uint32 ch = 0;
 	size_t total;
+	ASCIIUnit srcunit, dstunit;
+	SDL_bool ascii;
+	size_t (*transcode)(const char **, size_t *, const ASCIIUnit *,
+	                    char **, size_t *, const ASCIIUnit *);
 
 	if ( !inbuf || !*inbuf ) {
 		/* Reset the context */
@@ -287,8 +813,54 @@ size_t SDL_iconv(SDL_iconv_t cd,
 		break;
 	}
 
+	ascii = GetASCIIUnit(cd->src_fmt, &srcunit) &&
+	        GetASCIIUnit(cd->dst_fmt, &dstunit);
+	transcode = NULL;
+	if ( cd->src_fmt == ENCODING_UTF8 &&
+	     (cd->dst_fmt == ENCODING_UTF16BE ||
+	      cd->dst_fmt == ENCODING_UTF16LE) ) {
+		transcode = UTF8ToUTF16;
+	} else if ( (cd->src_fmt == ENCODING_UTF16BE ||
+	             cd->src_fmt == ENCODING_UTF16LE) &&
+	            cd->dst_fmt == ENCODING_UTF8 ) {
+		transcode = UTF16ToUTF8;
+	}
+
 	total = 0;
 	while ( srclen > 0 ) {
+		/* Convert any run of ASCII characters in bulk */
+		if ( ascii ) {
+			size_t n = SDL_min(srclen / srcunit.size,
+			                   dstlen / dstunit.size);
+			n = ScanASCII((const Uint8 *)src, n, &srcunit);
+			if ( n > 0 ) {
+				CopyASCII((const Uint8 *)src, &srcunit,
+				          (Uint8 *)dst, &dstunit, n);
+				src += n * srcunit.size;
+				srclen -= n * srcunit.size;
+				dst += n * dstunit.size;
+				dstlen -= n * dstunit.size;
+				*inbuf = src;
+				*inbytesleft = srclen;
+				*outbuf = dst;
+				*outbytesleft = dstlen;
+				total += n;
+				continue;
+			}
+		}
+		if ( transcode ) {
+			size_t n = transcode(&src, &srclen, &srcunit,
+			                     &dst, &dstlen, &dstunit);
+			if ( n > 0 ) {
+				*inbuf = src;
+				*inbytesleft = srclen;
+				*outbuf = dst;
+				*outbytesleft = dstlen;
+				total += n;
+				continue;
+			}
+		}
+
 		/* Decode a character */
 		switch ( cd->src_fmt ) {
 		    case ENCODING_ASCII:
@@ -310,7 +882,11 @@ size_t SDL_iconv(SDL_iconv_t cd,
 		    case ENCODING_UTF8: /* RFC 3629 */
 			{
 				Uint8 *p = (Uint8 *)src;
+				static const Uint32 minimums[] = {
+					0, 0x80, 0x800, 0x10000, 0x200000, 0x4000000
+				};
 				size_t left = 0;
+				Uint32 minimum;
 				SDL_bool overlong = SDL_FALSE;
 				if ( p[0] >= 0xFC ) {
 					if ( (p[0] & 0xFE) != 0xFC ) {
@@ -392,6 +968,7 @@ size_t SDL_iconv(SDL_iconv_t cd,
 				if ( srclen < left ) {
 					return SDL_ICONV_EINVAL;
 				}
+				minimum = minimums[left];
 				while ( left-- ) {
 					++p;
 					if ( (p[0] & 0xC0) != 0x80 ) {
@@ -406,7 +983,7 @@ size_t SDL_iconv(SDL_iconv_t cd,
 					++src;
 					--srclen;
 				}
-				if ( overlong ) {
+				if ( overlong && ch < minimum ) {
 					/* Potential security risk
 					return SDL_ICONV_EILSEQ;
 					*/
@@ -788,7 +1365,10 @@ size_t SDL_iconv(SDL_iconv_t cd,
 int SDL_iconv_close(SDL_iconv_t cd)
 {
 	if ( cd != (SDL_iconv_t)-1 ) {
-		SDL_free(cd);
+		cd = (SDL_iconv_t)SDL_AtomicSwapPtr(&cached_cd, cd);
+		if ( cd ) {
+			SDL_free(cd);
+		}
 	}
 	return 0;
 }
@@ -0,0 +1,360 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* This file contains the 2D copy and fill functions for SDL.  Small
+   rectangles go through the C library a row at a time.  Ones bigger
+   than the CPU cache would evict it for no gain if they were written
+   through it, so on x86 they are written with non-temporal (streaming)
+   stores instead, which go straight to memory.
+
+   Like the rest of stdlib this doesn't call into the video code.  It
+   picks the stores from the CPU features itself, and the blitter calls
+   SDL_SetStreamFeatures() whenever SDL_SetBlitFeatures() changes what
+   may be used.  Only the SDL_BLIT_* constants come from SDL_video.h.
+ */
+
+#include "SDL_stdinc.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_video.h"
+
+#if SDL_ASSEMBLY_ROUTINES && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define SDL_MEMCPY_SSE2	1
+#define SDL_MEMCPY_AVX2	1
+#include <immintrin.h>
+#endif
+
+typedef void (*StreamCopyFunc)(Uint8 *dst, const Uint8 *src, size_t len);
+typedef void (*StreamFillFunc)(Uint8 *dst, const Uint8 *val, size_t len);
+
+typedef struct StreamFuncs {
+	StreamCopyFunc copy;
+	StreamFillFunc fill;
+} StreamFuncs;
+
+/* Rows narrower than this are never streamed, since partial cache lines
+   written with non-temporal stores are slow to get out to memory.
+ */
+#define STREAM_MIN_ROW	256
+
+static const StreamFuncs stream_none = { NULL, NULL };
+
+/* The choice is published with a single pointer store, after the
+   threshold, so other threads see either the old or the new one.
+ */
+static volatile size_t stream_threshold = 0;
+static const StreamFuncs * volatile stream_funcs = NULL;
+
+/* Fill bytes with the 4 byte pattern 'val', which starts at 'phase' */
+static __inline__ void FillBytes(Uint8 *dst, const Uint8 *val, size_t phase, size_t len)
+{
+	while ( len-- ) {
+		*dst++ = val[phase++ & 3];
+	}
+}
+
+/* Returns the 4 byte pattern 'val' shifted to start at 'phase' */
+static __inline__ Uint32 RotatePattern(const Uint8 *val, size_t phase)
+{
+	Uint8 rotated[4];
+	Uint32 pattern;
+	int i;
+
+	for ( i = 0; i < 4; ++i ) {
+		rotated[i] = val[(phase + i) & 3];
+	}
+	SDL_memcpy(&pattern, rotated, sizeof(pattern));
+	return pattern;
+}
+
+static void FillRow(Uint8 *dst, const Uint8 *val, size_t len)
+{
+	size_t head, body;
+
+#ifndef __powerpc__
+	/* Not on PowerPC, where SDL_memset() may use dcbz, which faults on
+	   uncached video memory (see SDL_FillRect())
+	 */
+	if ( val[0] == val[1] && val[0] == val[2] && val[0] == val[3] ) {
+		SDL_memset(dst, val[0], len);
+		return;
+	}
+#endif
+	head = (4 - ((uintptr_t)dst & 3)) & 3;
+	if ( head > len ) {
+		head = len;
+	}
+	body = (len - head) & ~3;
+	FillBytes(dst, val, 0, head);
+	if ( body ) {
+		SDL_memset4(dst + head, RotatePattern(val, head), body / 4);
+	}
+	FillBytes(dst + head + body, val, head + body, len - head - body);
+}
+
+#if SDL_MEMCPY_SSE2
+
+#define SSE2_FUNC	static __attribute__((target("sse2")))
+
+SSE2_FUNC void StreamCopySSE2(Uint8 *dst, const Uint8 *src, size_t len)
+{
+	size_t head = (16 - ((uintptr_t)dst & 15)) & 15;
+
+	SDL_memcpy(dst, src, head);
+	dst += head;
+	src += head;
+	len -= head;
+	while ( len >= 64 ) {
+		__m128i a = _mm_loadu_si128((const __m128i *)(src + 0));
+		__m128i b = _mm_loadu_si128((const __m128i *)(src + 16));
+		__m128i c = _mm_loadu_si128((const __m128i *)(src + 32));
+		__m128i d = _mm_loadu_si128((const __m128i *)(src + 48));
+		_mm_stream_si128((__m128i *)(dst + 0), a);
+		_mm_stream_si128((__m128i *)(dst + 16), b);
+		_mm_stream_si128((__m128i *)(dst + 32), c);
+		_mm_stream_si128((__m128i *)(dst + 48), d);
+		src += 64;
+		dst += 64;
+		len -= 64;
+	}
+	while ( len >= 16 ) {
+		_mm_stream_si128((__m128i *)dst,
+		                 _mm_loadu_si128((const __m128i *)src));
+		src += 16;
+		dst += 16;
+		len -= 16;
+	}
+	SDL_memcpy(dst, src, len);
+}
+
+SSE2_FUNC void StreamFillSSE2(Uint8 *dst, const Uint8 *val, size_t len)
+{
+	size_t head = (16 - ((uintptr_t)dst & 15)) & 15;
+	__m128i v;
+
+	FillBytes(dst, val, 0, head);
+	v = _mm_set1_epi32((int)RotatePattern(val, head));
+	dst += head;
+	len -= head;
+	while ( len >= 64 ) {
+		_mm_stream_si128((__m128i *)(dst + 0), v);
+		_mm_stream_si128((__m128i *)(dst + 16), v);
+		_mm_stream_si128((__m128i *)(dst + 32), v);
+		_mm_stream_si128((__m128i *)(dst + 48), v);
+		dst += 64;
+		len -= 64;
+	}
+	while ( len >= 16 ) {
+		_mm_stream_si128((__m128i *)dst, v);
+		dst += 16;
+		len -= 16;
+	}
+	FillBytes(dst, val, head, len);
+}
+
+static const StreamFuncs stream_sse2 = { StreamCopySSE2, StreamFillSSE2 };
+
+#endif /* SDL_MEMCPY_SSE2 */
+
+#if SDL_MEMCPY_AVX2
+
+#define AVX2_FUNC	static __attribute__((target("avx2")))
+
+AVX2_FUNC void StreamCopyAVX2(Uint8 *dst, const Uint8 *src, size_t len)
+{
+	size_t head = (32 - ((uintptr_t)dst & 31)) & 31;
+
+	SDL_memcpy(dst, src, head);
+	dst += head;
+	src += head;
+	len -= head;
+	while ( len >= 128 ) {
+		__m256i a = _mm256_loadu_si256((const __m256i *)(src + 0));
+		__m256i b = _mm256_loadu_si256((const __m256i *)(src + 32));
+		__m256i c = _mm256_loadu_si256((const __m256i *)(src + 64));
+		__m256i d = _mm256_loadu_si256((const __m256i *)(src + 96));
+		_mm256_stream_si256((__m256i *)(dst + 0), a);
+		_mm256_stream_si256((__m256i *)(dst + 32), b);
+		_mm256_stream_si256((__m256i *)(dst + 64), c);
+		_mm256_stream_si256((__m256i *)(dst + 96), d);
+		src += 128;
+		dst += 128;
+		len -= 128;
+	}
+	while ( len >= 32 ) {
+		_mm256_stream_si256((__m256i *)dst,
+		                    _mm256_loadu_si256((const __m256i *)src));
+		src += 32;
+		dst += 32;
+		len -= 32;
+	}
+	SDL_memcpy(dst, src, len);
+}
+
+AVX2_FUNC void StreamFillAVX2(Uint8 *dst, const Uint8 *val, size_t len)
+{
+	size_t head = (32 - ((uintptr_t)dst & 31)) & 31;
+	__m256i v;
+
+	FillBytes(dst, val, 0, head);
+	v = _mm256_set1_epi32((int)RotatePattern(val, head));
+	dst += head;
+	len -= head;
+	while ( len >= 128 ) {
+		_mm256_stream_si256((__m256i *)(dst + 0), v);
+		_mm256_stream_si256((__m256i *)(dst + 32), v);
+		_mm256_stream_si256((__m256i *)(dst + 64), v);
+		_mm256_stream_si256((__m256i *)(dst + 96), v);
+		dst += 128;
+		len -= 128;
+	}
+	while ( len >= 32 ) {
+		_mm256_stream_si256((__m256i *)dst, v);
+		dst += 32;
+		len -= 32;
+	}
+	FillBytes(dst, val, head, len);
+}
+
+static const StreamFuncs stream_avx2 = { StreamCopyAVX2, StreamFillAVX2 };
+
+#endif /* SDL_MEMCPY_AVX2 */
+
+/* Pick the streaming functions allowed by 'features', a mask of
+   SDL_BLIT_* values, and work out how big a copy needs to be to use them.
+ */
+static const StreamFuncs *InitStreaming(Uint32 features)
+{
+	const StreamFuncs *funcs = &stream_none;
+	size_t cache;
+
+	if ( !stream_threshold ) {
+		cache = SDL_GetCPUCacheSize(3);
+		if ( !cache ) {
+			cache = SDL_GetCPUCacheSize(2);
+		}
+		if ( !cache ) {
+			cache = 1024*1024;
+		}
+		/* Anything over half the cache would push out most of what's in it */
+		stream_threshold = cache / 2;
+	}
+
+#if SDL_MEMCPY_AVX2
+	if ( (features & SDL_BLIT_AVX2) && SDL_HasAVX2() ) {
+		funcs = &stream_avx2;
+	} else
+#endif
+#if SDL_MEMCPY_SSE2
+	if ( (features & SDL_BLIT_SSE2) && SDL_HasSSE2() ) {
+		funcs = &stream_sse2;
+	}
+#endif
+	stream_funcs = funcs;
+	return funcs;
+}
+
+/* Called by SDL_SetBlitFeatures(), which can leave the streaming stores
+   out for comparing against the C library.
+ */
+void SDL_SetStreamFeatures(Uint32 features)
+{
+	InitStreaming(features);
+}
+
+/* Returns the streaming functions to use for a 'w' by 'h' byte area */
+static __inline__ const StreamFuncs *GetStreaming(int w, int h)
+{
+	const StreamFuncs *funcs = stream_funcs;
+
+	if ( !funcs ) {
+		funcs = InitStreaming(SDL_BLIT_ALL);
+	}
+	if ( w < STREAM_MIN_ROW || ((size_t)w * h) < stream_threshold ) {
+		return &stream_none;
+	}
+	return funcs;
+}
+
+/* Make the streaming stores visible to other threads before returning */
+static __inline__ void StreamFence(void)
+{
+#if SDL_MEMCPY_SSE2
+	__asm__ __volatile__ ( "sfence" ::: "memory" );
+#endif
+}
+
+void SDL_memcpy2D(void *dst, int dpitch, const void *src, int spitch, int w, int h)
+{
+	Uint8 *d = (Uint8 *)dst;
+	const Uint8 *s = (const Uint8 *)src;
+	StreamCopyFunc copy;
+
+	if ( w <= 0 || h <= 0 ) {
+		return;
+	}
+	copy = GetStreaming(w, h)->copy;
+	if ( copy ) {
+		while ( h-- ) {
+			copy(d, s, w);
+			s += spitch;
+			d += dpitch;
+		}
+		StreamFence();
+		return;
+	}
+	if ( dpitch == w && spitch == w ) {
+		SDL_memcpy(d, s, (size_t)w * h);
+		return;
+	}
+	while ( h-- ) {
+		SDL_memcpy(d, s, w);
+		s += spitch;
+		d += dpitch;
+	}
+}
+
+void SDL_memset2D(void *dst, int dpitch, Uint32 val, int w, int h)
+{
+	Uint8 *d = (Uint8 *)dst;
+	Uint8 pattern[4];
+	StreamFillFunc fill;
+
+	if ( w <= 0 || h <= 0 ) {
+		return;
+	}
+	SDL_memcpy(pattern, &val, sizeof(pattern));
+	fill = GetStreaming(w, h)->fill;
+	if ( fill ) {
+		while ( h-- ) {
+			fill(d, pattern, w);
+			d += dpitch;
+		}
+		StreamFence();
+		return;
+	}
+	while ( h-- ) {
+		FillRow(d, pattern, w);
+		d += dpitch;
+	}
+}
@@ -0,0 +1,402 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Atomic operations and spinlocks for SDL */
+
+#include "SDL_atomic.h"
+#include "SDL_mutex.h"
+#include "SDL_timer.h"
+#include "SDL_thread_c.h"
+
+#if SDL_THREADS_DISABLED
+/* There is nobody to race with, plain memory accesses are fine */
+#define SDL_ATOMIC_NONE
+#elif defined(__GNUC__) && defined(__ATOMIC_ACQUIRE)
+/* gcc 4.7 and later, clang */
+#define SDL_ATOMIC_GCC_ATOMIC
+#elif defined(__GNUC__) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4)
+/* gcc 4.1 and later, on architectures with a native compare-and-swap */
+#define SDL_ATOMIC_GCC_SYNC
+#elif defined(__WIN32__) && !defined(__SYMBIAN32__)
+#define SDL_ATOMIC_WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+/* Serialize everything through a single mutex */
+#define SDL_ATOMIC_MUTEX
+#endif
+
+#ifdef SDL_ATOMIC_MUTEX
+static SDL_mutex *SDL_atomic_lock = NULL;
+
+/* The lock is created when SDL starts its first thread and freed by
+   SDL_Quit().  Without it the caller is the only thread, so there is
+   nobody to serialize against.
+ */
+static void SDL_LockAtomics(void)
+{
+	if ( SDL_atomic_lock ) {
+		SDL_mutexP(SDL_atomic_lock);
+	}
+}
+
+static void SDL_UnlockAtomics(void)
+{
+	if ( SDL_atomic_lock ) {
+		SDL_mutexV(SDL_atomic_lock);
+	}
+}
+#endif /* SDL_ATOMIC_MUTEX */
+
+int SDL_AtomicInit(void)
+{
+#ifdef SDL_ATOMIC_MUTEX
+	if ( SDL_atomic_lock == NULL ) {
+		SDL_atomic_lock = SDL_CreateMutex();
+		if ( SDL_atomic_lock == NULL ) {
+			return(-1);
+		}
+	}
+#endif
+	return(0);
+}
+
+void SDL_AtomicQuit(void)
+{
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_mutex *mutex;
+
+	mutex = SDL_atomic_lock;
+	SDL_atomic_lock = NULL;
+	if ( mutex != NULL ) {
+		SDL_DestroyMutex(mutex);
+	}
+#endif
+}
+
+void SDL_MemoryBarrier(void)
+{
+#if defined(SDL_ATOMIC_GCC_ATOMIC)
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+#elif defined(SDL_ATOMIC_GCC_SYNC)
+	__sync_synchronize();
+#elif defined(SDL_ATOMIC_WIN32)
+	LONG barrier = 0;
+	InterlockedExchange(&barrier, 1);
+#elif defined(SDL_ATOMIC_MUTEX)
+	SDL_LockAtomics();
+	SDL_UnlockAtomics();
+#endif
+}
+
+/* Spinlocks */
+
+SDL_bool SDL_AtomicTryLock(SDL_SpinLock *lock)
+{
+#if defined(SDL_ATOMIC_GCC_ATOMIC)
+	return (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE) == 0);
+#elif defined(SDL_ATOMIC_GCC_SYNC)
+	return (__sync_lock_test_and_set(lock, 1) == 0);
+#elif defined(SDL_ATOMIC_WIN32)
+	return (InterlockedExchange((LONG *)lock, 1) == 0);
+#elif defined(SDL_ATOMIC_MUTEX)
+	SDL_bool locked = SDL_FALSE;
+
+	SDL_LockAtomics();
+	if ( *lock == 0 ) {
+		*lock = 1;
+		locked = SDL_TRUE;
+	}
+	SDL_UnlockAtomics();
+	return locked;
+#else
+	if ( *lock == 0 ) {
+		*lock = 1;
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+#endif
+}
+
+/* Tell the processor we're busy-waiting, so it can back off a little */
+static __inline__ void SDL_CPUPause(void)
+{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	__asm__ __volatile__ ("pause");
+#elif defined(__GNUC__) && defined(__aarch64__)
+	__asm__ __volatile__ ("yield");
+#endif
+}
+
+void SDL_AtomicLock(SDL_SpinLock *lock)
+{
+	int spins = 0;
+
+	while ( !SDL_AtomicTryLock(lock) ) {
+		/* Spin on a plain read so we don't bounce the cache line,
+		   and give up the CPU if the holder has been preempted.
+		 */
+		do {
+			if ( ++spins < 64 ) {
+				SDL_CPUPause();
+			} else {
+				SDL_Delay(0);
+			}
+			SDL_CompilerBarrier();
+		} while ( *(volatile SDL_SpinLock *)lock != 0 );
+	}
+}
+
+void SDL_AtomicUnlock(SDL_SpinLock *lock)
+{
+#if defined(SDL_ATOMIC_GCC_ATOMIC)
+	__atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+#elif defined(SDL_ATOMIC_GCC_SYNC)
+	__sync_lock_release(lock);
+#elif defined(SDL_ATOMIC_WIN32)
+	InterlockedExchange((LONG *)lock, 0);
+#elif defined(SDL_ATOMIC_MUTEX)
+	SDL_LockAtomics();
+	*lock = 0;
+	SDL_UnlockAtomics();
+#else
+	*lock = 0;
+#endif
+}
+
+/* Atomic integers */
+
+SDL_bool SDL_AtomicCAS(SDL_AtomicInt *a, int oldval, int newval)
+{
+#if defined(SDL_ATOMIC_GCC_ATOMIC)
+	return __atomic_compare_exchange_n(&a->value, &oldval, newval, 0,
+	                                   __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ?
+	                                   SDL_TRUE : SDL_FALSE;
+#elif defined(SDL_ATOMIC_GCC_SYNC)
+	return __sync_bool_compare_and_swap(&a->value, oldval, newval) ?
+	                                    SDL_TRUE : SDL_FALSE;
+#elif defined(SDL_ATOMIC_WIN32)
+	return (InterlockedCompareExchange((LONG *)&a->value, newval, oldval) == oldval) ? SDL_TRUE : SDL_FALSE;
+#else
+	SDL_bool retval = SDL_FALSE;
+
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_LockAtomics();
+#endif
+	if ( a->value == oldval ) {
+		a->value = newval;
+		retval = SDL_TRUE;
+	}
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_UnlockAtomics();
+#endif
+	return retval;
+#endif
+}
+
+int SDL_AtomicSwap(SDL_AtomicInt *a, int value)
+{
+#if defined(SDL_ATOMIC_GCC_ATOMIC)
+	return __atomic_exchange_n(&a->value, value, __ATOMIC_SEQ_CST);
+#elif defined(SDL_ATOMIC_GCC_SYNC)
+	int oldval;
+	do {
+		oldval = a->value;
+	} while ( !__sync_bool_compare_and_swap(&a->value, oldval, value) );
+	return oldval;
+#elif defined(SDL_ATOMIC_WIN32)
+	return InterlockedExchange((LONG *)&a->value, value);
+#else
+	int oldval;
+
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_LockAtomics();
+#endif
+	oldval = a->value;
+	a->value = value;
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_UnlockAtomics();
+#endif
+	return oldval;
+#endif
+}
+
+int SDL_AtomicAdd(SDL_AtomicInt *a, int value)
+{
+#if defined(SDL_ATOMIC_GCC_ATOMIC)
+	return __atomic_fetch_add(&a->value, value, __ATOMIC_SEQ_CST);
+#elif defined(SDL_ATOMIC_GCC_SYNC)
+	return __sync_fetch_and_add(&a->value, value);
+#elif defined(SDL_ATOMIC_WIN32)
+	return InterlockedExchangeAdd((LONG *)&a->value, value);
+#else
+	int oldval;
+
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_LockAtomics();
+#endif
+	oldval = a->value;
+	a->value += value;
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_UnlockAtomics();
+#endif
+	return oldval;
+#endif
+}
+
+int SDL_AtomicLoad(SDL_AtomicInt *a)
+{
+#if defined(SDL_ATOMIC_GCC_ATOMIC)
+	return __atomic_load_n(&a->value, __ATOMIC_ACQUIRE);
+#elif defined(SDL_ATOMIC_GCC_SYNC) || defined(SDL_ATOMIC_WIN32)
+	int value = *(volatile int *)&a->value;
+	SDL_MemoryBarrier();
+	return value;
+#else
+	int value;
+
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_LockAtomics();
+#endif
+	value = a->value;
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_UnlockAtomics();
+#endif
+	return value;
+#endif
+}
+
+void SDL_AtomicStore(SDL_AtomicInt *a, int value)
+{
+#if defined(SDL_ATOMIC_GCC_ATOMIC)
+	__atomic_store_n(&a->value, value, __ATOMIC_RELEASE);
+#elif defined(SDL_ATOMIC_GCC_SYNC) || defined(SDL_ATOMIC_WIN32)
+	SDL_MemoryBarrier();
+	*(volatile int *)&a->value = value;
+#else
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_LockAtomics();
+#endif
+	a->value = value;
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_UnlockAtomics();
+#endif
+#endif
+}
+
+/* Atomic pointers */
+
+SDL_bool SDL_AtomicCASPtr(SDL_AtomicPointer *a, void *oldval, void *newval)
+{
+#if defined(SDL_ATOMIC_GCC_ATOMIC)
+	return __atomic_compare_exchange_n(&a->value, &oldval, newval, 0,
+	                                   __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ?
+	                                   SDL_TRUE : SDL_FALSE;
+#elif defined(SDL_ATOMIC_GCC_SYNC)
+	return __sync_bool_compare_and_swap(&a->value, oldval, newval) ?
+	                                    SDL_TRUE : SDL_FALSE;
+#elif defined(SDL_ATOMIC_WIN32)
+	return (InterlockedCompareExchangePointer(&a->value, newval, oldval) == oldval) ? SDL_TRUE : SDL_FALSE;
+#else
+	SDL_bool retval = SDL_FALSE;
+
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_LockAtomics();
+#endif
+	if ( a->value == oldval ) {
+		a->value = newval;
+		retval = SDL_TRUE;
+	}
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_UnlockAtomics();
+#endif
+	return retval;
+#endif
+}
+
+void *SDL_AtomicSwapPtr(SDL_AtomicPointer *a, void *value)
+{
+#if defined(SDL_ATOMIC_GCC_ATOMIC)
+	return __atomic_exchange_n(&a->value, value, __ATOMIC_SEQ_CST);
+#elif defined(SDL_ATOMIC_GCC_SYNC)
+	void *oldval;
+	do {
+		oldval = a->value;
+	} while ( !__sync_bool_compare_and_swap(&a->value, oldval, value) );
+	return oldval;
+#elif defined(SDL_ATOMIC_WIN32)
+	return InterlockedExchangePointer(&a->value, value);
+#else
+	void *oldval;
+
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_LockAtomics();
+#endif
+	oldval = a->value;
+	a->value = value;
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_UnlockAtomics();
+#endif
+	return oldval;
+#endif
+}
+
+void *SDL_AtomicLoadPtr(SDL_AtomicPointer *a)
+{
+#if defined(SDL_ATOMIC_GCC_ATOMIC)
+	return __atomic_load_n(&a->value, __ATOMIC_ACQUIRE);
+#elif defined(SDL_ATOMIC_GCC_SYNC) || defined(SDL_ATOMIC_WIN32)
+	void *value = *(void * volatile *)&a->value;
+	SDL_MemoryBarrier();
+	return value;
+#else
+	void *value;
+
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_LockAtomics();
+#endif
+	value = a->value;
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_UnlockAtomics();
+#endif
+	return value;
+#endif
+}
+
+void SDL_AtomicStorePtr(SDL_AtomicPointer *a, void *value)
+{
+#if defined(SDL_ATOMIC_GCC_ATOMIC)
+	__atomic_store_n(&a->value, value, __ATOMIC_RELEASE);
+#elif defined(SDL_ATOMIC_GCC_SYNC) || defined(SDL_ATOMIC_WIN32)
+	SDL_MemoryBarrier();
+	*(void * volatile *)&a->value = value;
+#else
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_LockAtomics();
+#endif
+	a->value = value;
+#ifdef SDL_ATOMIC_MUTEX
+	SDL_UnlockAtomics();
+#endif
+#endif
+}
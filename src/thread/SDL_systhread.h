@@ -41,6 +41,18 @@ extern int SDL_SYS_CreateThread(SDL_Thread *thread, void *args);
 /* This function does any necessary setup in the child thread */
 extern void SDL_SYS_SetupThread(void);
 
+/* Not a priority an application can ask for: SDL_RunThread() uses it to
+   leave the scheduling a new thread inherited alone.
+ */
+#define SDL_THREAD_PRIORITY_INHERIT	((SDL_ThreadPriority)-1)
+
+/* This function applies the name, priority and CPU affinity in attr
+   to the calling thread.  A NULL name, zero affinity or a priority of
+   SDL_THREAD_PRIORITY_INHERIT leave those settings unchanged.  It returns
+   0, or -1 with the error set if the priority could not be set.
+ */
+extern int SDL_SYS_SetThreadAttr(const SDL_ThreadAttr *attr);
+
 /* This function waits for the thread to finish and frees any data
    allocated by SDL_SYS_CreateThread()
  */
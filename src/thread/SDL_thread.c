@@ -174,6 +174,7 @@ typedef struct {
 	void *data;
 	SDL_Thread *info;
 	SDL_sem *wait;
+	const SDL_ThreadAttr *attr;
 } thread_args;
 
 void SDL_RunThread(void *data)
@@ -192,6 +193,20 @@ void SDL_RunThread(void *data)
 	args = (thread_args *)data;
 	args->info->threadid = SDL_ThreadID();
 
+	/* Apply the requested name, priority and affinity.  This may fail
+	   if we lack the privileges, but the thread runs regardless.  The
+	   thread id is known now, so an error only goes into this thread's
+	   own error message.  A thread that only wants a name keeps the
+	   scheduling it inherited.
+	 */
+	if ( args->attr ) {
+		SDL_ThreadAttr attr = *args->attr;
+		if ( attr.priority == SDL_THREAD_PRIORITY_NORMAL ) {
+			attr.priority = SDL_THREAD_PRIORITY_INHERIT;
+		}
+		SDL_SYS_SetThreadAttr(&attr);
+	}
+
 	/* Figure out what function to run */
 	userfunc = args->func;
 	userdata = args->data;
@@ -204,17 +219,38 @@ void SDL_RunThread(void *data)
 	*statusloc = userfunc(userdata);
 }
 
+void SDL_InitThreadAttr(SDL_ThreadAttr *attr)
+{
+	SDL_memset(attr, 0, sizeof(*attr));
+	attr->priority = SDL_THREAD_PRIORITY_NORMAL;
+}
+
+int SDL_SetThreadPriority(SDL_ThreadPriority priority)
+{
+	SDL_ThreadAttr attr;
+
+	SDL_InitThreadAttr(&attr);
+	attr.priority = priority;
+	return SDL_SYS_SetThreadAttr(&attr);
+}
+
 #ifdef SDL_PASSED_BEGINTHREAD_ENDTHREAD
 #undef SDL_CreateThread
-DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *data, pfnSDL_CurrentBeginThread pfnBeginThread, pfnSDL_CurrentEndThread pfnEndThread)
+#undef SDL_CreateThreadEx
+DECLSPEC SDL_Thread * SDLCALL SDL_CreateThreadEx(int (SDLCALL *fn)(void *), void *data, const SDL_ThreadAttr *attr, pfnSDL_CurrentBeginThread pfnBeginThread, pfnSDL_CurrentEndThread pfnEndThread)
 #else
-DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *data)
+DECLSPEC SDL_Thread * SDLCALL SDL_CreateThreadEx(int (SDLCALL *fn)(void *), void *data, const SDL_ThreadAttr *attr)
 #endif
 {
 	SDL_Thread *thread;
 	thread_args *args;
 	int ret;
 
+	/* Atomics need their lock before there is anyone to race with */
+	if ( SDL_AtomicInit() < 0 ) {
+		return(NULL);
+	}
+
 	/* Allocate memory for the thread info structure */
 	thread = (SDL_Thread *)SDL_malloc(sizeof(*thread));
 	if ( thread == NULL ) {
@@ -223,6 +259,9 @@ DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *
 	}
 	SDL_memset(thread, 0, (sizeof *thread));
 	thread->status = -1;
+	if ( attr ) {
+		thread->stacksize = attr->stacksize;
+	}
 
 	/* Set up the arguments for the thread */
 	args = (thread_args *)SDL_malloc(sizeof(*args));
@@ -234,6 +273,7 @@ DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *
 	args->func = fn;
 	args->data = data;
 	args->info = thread;
+	args->attr = attr;
 	args->wait = SDL_CreateSemaphore(0);
 	if ( args->wait == NULL ) {
 		SDL_free(thread);
@@ -266,6 +306,18 @@ DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *
 	return(thread);
 }
 
+#ifdef SDL_PASSED_BEGINTHREAD_ENDTHREAD
+DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *data, pfnSDL_CurrentBeginThread pfnBeginThread, pfnSDL_CurrentEndThread pfnEndThread)
+{
+	return SDL_CreateThreadEx(fn, data, NULL, pfnBeginThread, pfnEndThread);
+}
+#else
+DECLSPEC SDL_Thread * SDLCALL SDL_CreateThread(int (SDLCALL *fn)(void *), void *data)
+{
+	return SDL_CreateThreadEx(fn, data, NULL);
+}
+#endif
+
 void SDL_WaitThread(SDL_Thread *thread, int *status)
 {
 	if ( thread ) {
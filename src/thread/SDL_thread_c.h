@@ -56,9 +56,14 @@ struct SDL_Thread {
 	int status;
 	SDL_error errbuf;
 	void *data;
+	Uint32 stacksize;	/* 0 for the system default */
 };
 
 /* This is the function called to run a thread */
 extern void SDL_RunThread(void *data);
 
+/* Called before SDL creates a thread, and by SDL_Quit() */
+extern int SDL_AtomicInit(void);
+extern void SDL_AtomicQuit(void);
+
 #endif /* _SDL_thread_c_h */
@@ -78,6 +78,37 @@ void SDL_SYS_SetupThread(void)
 	SDL_MaskSignals(NULL);
 }
 
+int SDL_SYS_SetThreadAttr(const SDL_ThreadAttr *attr)
+{
+	int32 value;
+
+	if ( attr->name ) {
+		rename_thread(find_thread(NULL), attr->name);
+	}
+	if ( attr->priority == SDL_THREAD_PRIORITY_INHERIT ) {
+		return(0);
+	}
+	switch (attr->priority) {
+	    case SDL_THREAD_PRIORITY_LOW:
+		value = B_LOW_PRIORITY;
+		break;
+	    case SDL_THREAD_PRIORITY_HIGH:
+		value = B_URGENT_DISPLAY_PRIORITY;
+		break;
+	    case SDL_THREAD_PRIORITY_REALTIME:
+		value = B_REAL_TIME_DISPLAY_PRIORITY;
+		break;
+	    default:
+		value = B_NORMAL_PRIORITY;
+		break;
+	}
+	if ( set_thread_priority(find_thread(NULL), value) < B_NO_ERROR ) {
+		SDL_SetError("set_thread_priority() failed");
+		return(-1);
+	}
+	return(0);
+}
+
 Uint32 SDL_ThreadID(void)
 {
 	return((Uint32)find_thread(NULL));
@@ -44,6 +44,11 @@ void SDL_SYS_SetupThread(void)
 	return;
 }
 
+int SDL_SYS_SetThreadAttr(const SDL_ThreadAttr *attr)
+{
+	return(0);
+}
+
 Uint32 SDL_ThreadID(void)
 {
 	return (Uint32)thd_get_current();
@@ -0,0 +1,254 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* An implementation of reader-writer locks using mutexes and condition variables */
+
+#include "SDL_timer.h"
+#include "SDL_thread.h"
+
+
+#if SDL_THREADS_DISABLED
+
+SDL_RWLock *SDL_CreateRWLock(void)
+{
+	SDL_SetError("SDL not configured with thread support");
+	return (SDL_RWLock *)0;
+}
+
+void SDL_DestroyRWLock(SDL_RWLock *rwlock)
+{
+	return;
+}
+
+int SDL_RWLockReadTimeout(SDL_RWLock *rwlock, Uint32 ms)
+{
+	SDL_SetError("SDL not configured with thread support");
+	return -1;
+}
+
+int SDL_RWLockWriteTimeout(SDL_RWLock *rwlock, Uint32 ms)
+{
+	SDL_SetError("SDL not configured with thread support");
+	return -1;
+}
+
+int SDL_RWLockUnlock(SDL_RWLock *rwlock)
+{
+	SDL_SetError("SDL not configured with thread support");
+	return -1;
+}
+
+#else
+
+struct SDL_RWLock
+{
+	SDL_mutex *lock;
+	SDL_cond *read_ok;
+	SDL_cond *write_ok;
+	int readers;		/* Number of threads holding the read lock */
+	int writing;		/* Non-zero while a thread holds the write lock */
+	int writers_waiting;
+};
+
+SDL_RWLock *SDL_CreateRWLock(void)
+{
+	SDL_RWLock *rwlock;
+
+	rwlock = (SDL_RWLock *)SDL_malloc(sizeof(*rwlock));
+	if ( rwlock ) {
+		rwlock->lock = SDL_CreateMutex();
+		rwlock->read_ok = SDL_CreateCond();
+		rwlock->write_ok = SDL_CreateCond();
+		rwlock->readers = 0;
+		rwlock->writing = 0;
+		rwlock->writers_waiting = 0;
+		if ( ! rwlock->lock || ! rwlock->read_ok || ! rwlock->write_ok ) {
+			SDL_DestroyRWLock(rwlock);
+			rwlock = NULL;
+		}
+	} else {
+		SDL_OutOfMemory();
+	}
+	return rwlock;
+}
+
+void SDL_DestroyRWLock(SDL_RWLock *rwlock)
+{
+	if ( rwlock ) {
+		if ( rwlock->read_ok ) {
+			SDL_DestroyCond(rwlock->read_ok);
+		}
+		if ( rwlock->write_ok ) {
+			SDL_DestroyCond(rwlock->write_ok);
+		}
+		if ( rwlock->lock ) {
+			SDL_DestroyMutex(rwlock->lock);
+		}
+		SDL_free(rwlock);
+	}
+}
+
+/* Wait on a condition until the deadline, with the rwlock mutex held */
+static int SDL_RWLockWaitCond(SDL_RWLock *rwlock, SDL_cond *cond,
+                              Uint32 ms, Uint32 deadline)
+{
+	Sint32 left;
+
+	if ( ms == SDL_MUTEX_MAXWAIT ) {
+		return SDL_CondWait(cond, rwlock->lock);
+	}
+	left = (Sint32)(deadline - SDL_GetTicks());
+	if ( left <= 0 ) {
+		return SDL_MUTEX_TIMEDOUT;
+	}
+	return SDL_CondWaitTimeout(cond, rwlock->lock, (Uint32)left);
+}
+
+int SDL_RWLockReadTimeout(SDL_RWLock *rwlock, Uint32 ms)
+{
+	int retval;
+	Uint32 deadline;
+
+	if ( ! rwlock ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+
+	deadline = SDL_GetTicks() + ms;
+	retval = 0;
+	SDL_LockMutex(rwlock->lock);
+	/* Don't starve writers that are already waiting */
+	while ( rwlock->writing || rwlock->writers_waiting ) {
+		if ( ms == 0 ) {
+			retval = SDL_MUTEX_TIMEDOUT;
+			break;
+		}
+		retval = SDL_RWLockWaitCond(rwlock, rwlock->read_ok, ms, deadline);
+		if ( retval != 0 ) {
+			break;
+		}
+	}
+	if ( retval == 0 ) {
+		++rwlock->readers;
+	}
+	SDL_UnlockMutex(rwlock->lock);
+
+	return retval;
+}
+
+int SDL_RWLockWriteTimeout(SDL_RWLock *rwlock, Uint32 ms)
+{
+	int retval;
+	Uint32 deadline;
+
+	if ( ! rwlock ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+
+	deadline = SDL_GetTicks() + ms;
+	retval = 0;
+	SDL_LockMutex(rwlock->lock);
+	++rwlock->writers_waiting;
+	while ( rwlock->writing || rwlock->readers ) {
+		if ( ms == 0 ) {
+			retval = SDL_MUTEX_TIMEDOUT;
+			break;
+		}
+		retval = SDL_RWLockWaitCond(rwlock, rwlock->write_ok, ms, deadline);
+		if ( retval != 0 ) {
+			break;
+		}
+	}
+	--rwlock->writers_waiting;
+	if ( retval == 0 ) {
+		rwlock->writing = 1;
+	} else if ( ! rwlock->writing ) {
+		if ( rwlock->writers_waiting ) {
+			/* We may have eaten the wakeup meant for another writer */
+			if ( ! rwlock->readers ) {
+				SDL_CondSignal(rwlock->write_ok);
+			}
+		} else {
+			/* We were holding off new readers, let them in */
+			SDL_CondBroadcast(rwlock->read_ok);
+		}
+	}
+	SDL_UnlockMutex(rwlock->lock);
+
+	return retval;
+}
+
+int SDL_RWLockUnlock(SDL_RWLock *rwlock)
+{
+	int retval;
+
+	if ( ! rwlock ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+
+	retval = 0;
+	SDL_LockMutex(rwlock->lock);
+	if ( rwlock->writing ) {
+		rwlock->writing = 0;
+	} else if ( rwlock->readers > 0 ) {
+		--rwlock->readers;
+	} else {
+		SDL_SetError("rwlock not locked");
+		retval = -1;
+	}
+	if ( retval == 0 && ! rwlock->writing && ! rwlock->readers ) {
+		/* Writers go first, otherwise let any blocked readers in */
+		if ( rwlock->writers_waiting ) {
+			SDL_CondSignal(rwlock->write_ok);
+		} else {
+			SDL_CondBroadcast(rwlock->read_ok);
+		}
+	}
+	SDL_UnlockMutex(rwlock->lock);
+
+	return retval;
+}
+
+#endif /* SDL_THREADS_DISABLED */
+
+int SDL_RWLockRead(SDL_RWLock *rwlock)
+{
+	return SDL_RWLockReadTimeout(rwlock, SDL_MUTEX_MAXWAIT);
+}
+
+int SDL_RWLockTryRead(SDL_RWLock *rwlock)
+{
+	return SDL_RWLockReadTimeout(rwlock, 0);
+}
+
+int SDL_RWLockWrite(SDL_RWLock *rwlock)
+{
+	return SDL_RWLockWriteTimeout(rwlock, SDL_MUTEX_MAXWAIT);
+}
+
+int SDL_RWLockTryWrite(SDL_RWLock *rwlock)
+{
+	return SDL_RWLockWriteTimeout(rwlock, 0);
+}
@@ -62,6 +62,11 @@ void SDL_SYS_SetupThread(void)
 	sigprocmask(SIG_BLOCK, &mask, NULL);
 }
 
+int SDL_SYS_SetThreadAttr(const SDL_ThreadAttr *attr)
+{
+	return(0);
+}
+
 /* WARNING:  This may not work for systems with 64-bit pid_t */
 Uint32 SDL_ThreadID(void)
 {
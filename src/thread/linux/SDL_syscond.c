@@ -0,0 +1,143 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Condition variables built directly on Linux futexes.
+   Waiters sleep on a sequence number that is bumped on every signal.
+ */
+
+#include "SDL_thread.h"
+#include "SDL_sysmutex_c.h"
+
+struct SDL_cond
+{
+	int seq;
+	int waiters;
+};
+
+/* Create a condition variable */
+SDL_cond * SDL_CreateCond(void)
+{
+	SDL_cond *cond;
+
+	cond = (SDL_cond *) SDL_calloc(1, sizeof(SDL_cond));
+	if ( ! cond ) {
+		SDL_OutOfMemory();
+	}
+	return(cond);
+}
+
+/* Destroy a condition variable */
+void SDL_DestroyCond(SDL_cond *cond)
+{
+	if ( cond ) {
+		SDL_free(cond);
+	}
+}
+
+static int SDL_CondWake(SDL_cond *cond, int count)
+{
+	if ( ! cond ) {
+		SDL_SetError("Passed a NULL condition variable");
+		return -1;
+	}
+
+	/* Waiters register themselves before reading the sequence number,
+	   so either they see the new sequence or we see them waiting.
+	 */
+	__atomic_add_fetch(&cond->seq, 1, __ATOMIC_SEQ_CST);
+	if ( __atomic_load_n(&cond->waiters, __ATOMIC_SEQ_CST) > 0 ) {
+		SDL_FutexWake(&cond->seq, count);
+	}
+	return 0;
+}
+
+/* Restart one of the threads that are waiting on the condition variable */
+int SDL_CondSignal(SDL_cond *cond)
+{
+	return SDL_CondWake(cond, 1);
+}
+
+/* Restart all threads that are waiting on the condition variable */
+int SDL_CondBroadcast(SDL_cond *cond)
+{
+	return SDL_CondWake(cond, INT_MAX);
+}
+
+int SDL_CondWaitTimeout(SDL_cond *cond, SDL_mutex *mutex, Uint32 ms)
+{
+	int retval;
+	int seq;
+	int recursive;
+	Uint32 deadline;
+	struct timespec timeout;
+
+	if ( ! cond ) {
+		SDL_SetError("Passed a NULL condition variable");
+		return -1;
+	}
+	if ( ! mutex ) {
+		SDL_SetError("Passed a NULL mutex");
+		return -1;
+	}
+	if ( __atomic_load_n(&mutex->owner, __ATOMIC_RELAXED) != pthread_self() ) {
+		SDL_SetError("mutex not owned by this thread");
+		return -1;
+	}
+
+	deadline = SDL_GetTicks() + ms;
+	__atomic_add_fetch(&cond->waiters, 1, __ATOMIC_SEQ_CST);
+	seq = __atomic_load_n(&cond->seq, __ATOMIC_SEQ_CST);
+
+	/* Release the mutex completely, even if it's held recursively */
+	recursive = mutex->recursive;
+	__atomic_store_n(&mutex->owner, 0, __ATOMIC_RELAXED);
+	SDL_FutexUnlock(&mutex->state);
+
+	retval = 0;
+	if ( ms == SDL_MUTEX_MAXWAIT ) {
+		SDL_FutexWait(&cond->seq, seq, NULL);
+	} else if ( ! SDL_FutexTimeLeft(deadline, &timeout) ||
+	            (SDL_FutexWait(&cond->seq, seq, &timeout) < 0 &&
+	             errno == ETIMEDOUT) ) {
+		retval = SDL_MUTEX_TIMEDOUT;
+	}
+	/* Any other early return is a spurious wakeup, which callers
+	   of condition variables must be prepared for anyway.
+	 */
+
+	__atomic_sub_fetch(&cond->waiters, 1, __ATOMIC_SEQ_CST);
+
+	SDL_FutexLock(&mutex->state);
+	__atomic_store_n(&mutex->owner, pthread_self(), __ATOMIC_RELAXED);
+	mutex->recursive = recursive;
+
+	return retval;
+}
+
+/* Wait on the condition variable, unlocking the provided mutex.
+   The mutex must be locked before entering this function!
+ */
+int SDL_CondWait(SDL_cond *cond, SDL_mutex *mutex)
+{
+	return SDL_CondWaitTimeout(cond, mutex, SDL_MUTEX_MAXWAIT);
+}
@@ -0,0 +1,81 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_sysfutex_c_h
+#define _SDL_sysfutex_c_h
+
+/* Thin wrappers around the Linux futex system call */
+
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "SDL_timer.h"
+
+/* How many times to retry an uncontended lock before going to sleep */
+#define SDL_FUTEX_SPINS	100
+
+/* Tell the processor we're busy-waiting */
+static __inline__ void SDL_FutexPause(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	__asm__ __volatile__ ("pause");
+#elif defined(__aarch64__)
+	__asm__ __volatile__ ("yield");
+#endif
+}
+
+/* Sleep while *addr == val, for at most 'timeout' if it's not NULL.
+   Returns 0 when woken, or -1 with errno set to ETIMEDOUT, EAGAIN
+   (the value had already changed) or EINTR.
+ */
+static __inline__ int SDL_FutexWait(int *addr, int val, const struct timespec *timeout)
+{
+	return syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, timeout, NULL, 0);
+}
+
+/* Wake up at most 'count' threads sleeping on addr */
+static __inline__ void SDL_FutexWake(int *addr, int count)
+{
+	syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+/* Fill in the time remaining until 'deadline' (in SDL ticks).
+   Returns 0 if the deadline has already passed.
+ */
+static __inline__ int SDL_FutexTimeLeft(Uint32 deadline, struct timespec *ts)
+{
+	Sint32 left = (Sint32)(deadline - SDL_GetTicks());
+
+	if ( left <= 0 ) {
+		return 0;
+	}
+	ts->tv_sec = left / 1000;
+	ts->tv_nsec = (left % 1000) * 1000000;
+	return 1;
+}
+
+#endif /* _SDL_sysfutex_c_h */
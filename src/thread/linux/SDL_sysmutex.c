@@ -0,0 +1,97 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Recursive mutexes built directly on Linux futexes.
+   The uncontended lock and unlock never enter the kernel.
+ */
+
+#include "SDL_thread.h"
+#include "SDL_sysmutex_c.h"
+
+
+SDL_mutex *SDL_CreateMutex(void)
+{
+	SDL_mutex *mutex;
+
+	/* Allocate the structure */
+	mutex = (SDL_mutex *)SDL_calloc(1, sizeof(*mutex));
+	if ( ! mutex ) {
+		SDL_OutOfMemory();
+	}
+	return(mutex);
+}
+
+void SDL_DestroyMutex(SDL_mutex *mutex)
+{
+	if ( mutex ) {
+		SDL_free(mutex);
+	}
+}
+
+/* Lock the mutex */
+int SDL_mutexP(SDL_mutex *mutex)
+{
+	pthread_t this_thread;
+
+	if ( mutex == NULL ) {
+		SDL_SetError("Passed a NULL mutex");
+		return -1;
+	}
+
+	/* Only the owner can see its own id here, so this is safe
+	   even though other threads may be changing the owner.
+	 */
+	this_thread = pthread_self();
+	if ( __atomic_load_n(&mutex->owner, __ATOMIC_RELAXED) == this_thread ) {
+		++mutex->recursive;
+	} else {
+		SDL_FutexLock(&mutex->state);
+		__atomic_store_n(&mutex->owner, this_thread, __ATOMIC_RELAXED);
+		mutex->recursive = 0;
+	}
+	return 0;
+}
+
+int SDL_mutexV(SDL_mutex *mutex)
+{
+	if ( mutex == NULL ) {
+		SDL_SetError("Passed a NULL mutex");
+		return -1;
+	}
+
+	/* We can only unlock the mutex if we own it */
+	if ( __atomic_load_n(&mutex->owner, __ATOMIC_RELAXED) != pthread_self() ) {
+		SDL_SetError("mutex not owned by this thread");
+		return -1;
+	}
+	if ( mutex->recursive ) {
+		--mutex->recursive;
+	} else {
+		/* Reset the owner before releasing the lock, so another
+		   thread can't take it and then have its ownership erased.
+		 */
+		__atomic_store_n(&mutex->owner, 0, __ATOMIC_RELAXED);
+		SDL_FutexUnlock(&mutex->state);
+	}
+	return 0;
+}
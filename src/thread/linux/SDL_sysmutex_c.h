@@ -0,0 +1,70 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#ifndef _SDL_mutex_c_h
+#define _SDL_mutex_c_h
+
+#include <pthread.h>
+
+#include "SDL_sysfutex_c.h"
+
+struct SDL_mutex {
+	int state;		/* 0 = unlocked, 1 = locked, 2 = locked with waiters */
+	int recursive;
+	pthread_t owner;
+};
+
+/* Acquire the futex word, spinning briefly before going to sleep */
+static __inline__ void SDL_FutexLock(int *state)
+{
+	int c = 0;
+	int spins;
+
+	if ( __atomic_compare_exchange_n(state, &c, 1, 0,
+	                                 __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ) {
+		return;
+	}
+	for ( spins = 0; spins < SDL_FUTEX_SPINS; ++spins ) {
+		SDL_FutexPause();
+		c = 0;
+		if ( __atomic_load_n(state, __ATOMIC_RELAXED) == 0 &&
+		     __atomic_compare_exchange_n(state, &c, 1, 0,
+		                                 __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ) {
+			return;
+		}
+	}
+
+	/* Mark the lock contended, so the holder knows to wake us up */
+	while ( __atomic_exchange_n(state, 2, __ATOMIC_ACQUIRE) != 0 ) {
+		SDL_FutexWait(state, 2, NULL);
+	}
+}
+
+static __inline__ void SDL_FutexUnlock(int *state)
+{
+	if ( __atomic_exchange_n(state, 0, __ATOMIC_RELEASE) == 2 ) {
+		SDL_FutexWake(state, 1);
+	}
+}
+
+#endif /* _SDL_mutex_c_h */
@@ -0,0 +1,164 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Semaphores built directly on Linux futexes.
+   Posting and taking an available count never enter the kernel.
+ */
+
+#include "SDL_thread.h"
+#include "SDL_sysfutex_c.h"
+
+struct SDL_semaphore {
+	int count;
+	int waiters;
+};
+
+/* Create a semaphore, initialized with value */
+SDL_sem *SDL_CreateSemaphore(Uint32 initial_value)
+{
+	SDL_sem *sem;
+
+	if ( initial_value > INT_MAX ) {
+		SDL_SetError("Semaphore value out of range");
+		return NULL;
+	}
+	sem = (SDL_sem *) SDL_malloc(sizeof(SDL_sem));
+	if ( sem ) {
+		sem->count = (int)initial_value;
+		sem->waiters = 0;
+	} else {
+		SDL_OutOfMemory();
+	}
+	return sem;
+}
+
+void SDL_DestroySemaphore(SDL_sem *sem)
+{
+	if ( sem ) {
+		SDL_free(sem);
+	}
+}
+
+/* Take one from the count if it's positive, without blocking */
+static __inline__ int SDL_SemTake(SDL_sem *sem)
+{
+	int count = __atomic_load_n(&sem->count, __ATOMIC_SEQ_CST);
+
+	while ( count > 0 ) {
+		if ( __atomic_compare_exchange_n(&sem->count, &count, count - 1, 0,
+		                                 __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int SDL_SemTryWait(SDL_sem *sem)
+{
+	if ( ! sem ) {
+		SDL_SetError("Passed a NULL semaphore");
+		return -1;
+	}
+	return SDL_SemTake(sem) ? 0 : SDL_MUTEX_TIMEDOUT;
+}
+
+int SDL_SemWaitTimeout(SDL_sem *sem, Uint32 timeout)
+{
+	int retval;
+	int spins;
+	Uint32 deadline;
+	struct timespec ts;
+
+	if ( ! sem ) {
+		SDL_SetError("Passed a NULL semaphore");
+		return -1;
+	}
+
+	/* Try the easy cases first */
+	if ( SDL_SemTake(sem) ) {
+		return 0;
+	}
+	if ( timeout == 0 ) {
+		return SDL_MUTEX_TIMEDOUT;
+	}
+	for ( spins = 0; spins < SDL_FUTEX_SPINS; ++spins ) {
+		SDL_FutexPause();
+		if ( SDL_SemTake(sem) ) {
+			return 0;
+		}
+	}
+
+	/* We register as a waiter before checking the count again,
+	   so either we see the post or the poster sees us and wakes us.
+	 */
+	deadline = SDL_GetTicks() + timeout;
+	__atomic_add_fetch(&sem->waiters, 1, __ATOMIC_SEQ_CST);
+	for ( ;; ) {
+		if ( SDL_SemTake(sem) ) {
+			retval = 0;
+			break;
+		}
+		if ( timeout == SDL_MUTEX_MAXWAIT ) {
+			SDL_FutexWait(&sem->count, 0, NULL);
+		} else if ( ! SDL_FutexTimeLeft(deadline, &ts) ) {
+			retval = SDL_MUTEX_TIMEDOUT;
+			break;
+		} else {
+			SDL_FutexWait(&sem->count, 0, &ts);
+		}
+	}
+	__atomic_sub_fetch(&sem->waiters, 1, __ATOMIC_SEQ_CST);
+
+	return retval;
+}
+
+int SDL_SemWait(SDL_sem *sem)
+{
+	return SDL_SemWaitTimeout(sem, SDL_MUTEX_MAXWAIT);
+}
+
+Uint32 SDL_SemValue(SDL_sem *sem)
+{
+	int ret = 0;
+	if ( sem ) {
+		ret = __atomic_load_n(&sem->count, __ATOMIC_RELAXED);
+		if ( ret < 0 ) {
+			ret = 0;
+		}
+	}
+	return (Uint32)ret;
+}
+
+int SDL_SemPost(SDL_sem *sem)
+{
+	if ( ! sem ) {
+		SDL_SetError("Passed a NULL semaphore");
+		return -1;
+	}
+
+	__atomic_add_fetch(&sem->count, 1, __ATOMIC_SEQ_CST);
+	if ( __atomic_load_n(&sem->waiters, __ATOMIC_SEQ_CST) > 0 ) {
+		SDL_FutexWake(&sem->count, 1);
+	}
+	return 0;
+}
@@ -71,7 +71,7 @@ int SDL_SYS_CreateThread(SDL_Thread *thread, void *args, pfnSDL_CurrentBeginThre
   // Also save the real parameters we have to pass to thread function
   pThreadParms->args = args;
   // Start the thread using the runtime library of calling app!
-  thread->threadid = thread->handle = (*pfnBeginThread)(threadfunc, NULL, 512*1024, pThreadParms);
+  thread->threadid = thread->handle = (*pfnBeginThread)(threadfunc, NULL, thread->stacksize ? thread->stacksize : 512*1024, pThreadParms);
   if ((int)thread->threadid <= 0)
   {
     SDL_SetError("Not enough resources to create thread");
@@ -85,6 +85,36 @@ void SDL_SYS_SetupThread(void)
   return;
 }
 
+int SDL_SYS_SetThreadAttr(const SDL_ThreadAttr *attr)
+{
+  ULONG ulClass;
+
+  if (attr->priority == SDL_THREAD_PRIORITY_INHERIT)
+    return(0);
+
+  switch (attr->priority)
+  {
+    case SDL_THREAD_PRIORITY_LOW:
+      ulClass = PRTYC_IDLETIME;
+      break;
+    case SDL_THREAD_PRIORITY_HIGH:
+      ulClass = PRTYC_FOREGROUNDSERVER;
+      break;
+    case SDL_THREAD_PRIORITY_REALTIME:
+      ulClass = PRTYC_TIMECRITICAL;
+      break;
+    default:
+      ulClass = PRTYC_REGULAR;
+      break;
+  }
+  if (DosSetPriority(PRTYS_THREAD, ulClass, 0, 0) != NO_ERROR)
+  {
+    SDL_SetError("DosSetPriority() failed");
+    return(-1);
+  }
+  return(0);
+}
+
 DECLSPEC Uint32 SDLCALL SDL_ThreadID(void)
 {
   PTIB tib;
@@ -85,6 +85,11 @@ void SDL_SYS_SetupThread(void)
 	pth_cancel_state(PTH_CANCEL_ASYNCHRONOUS, &oldstate);
 }
 
+int SDL_SYS_SetThreadAttr(const SDL_ThreadAttr *attr)
+{
+	return(0);
+}
+
 /* WARNING:  This may not work for systems with 64-bit pid_t */
 Uint32 SDL_ThreadID(void)
 {
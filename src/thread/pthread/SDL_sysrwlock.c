@@ -0,0 +1,264 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include "SDL_thread.h"
+#include "SDL_timer.h"
+
+/* Wrapper around POSIX reader-writer locks */
+
+struct SDL_RWLock {
+	pthread_rwlock_t id;
+};
+
+SDL_RWLock *SDL_CreateRWLock(void)
+{
+	SDL_RWLock *rwlock;
+	pthread_rwlockattr_t attr;
+
+	rwlock = (SDL_RWLock *)SDL_malloc(sizeof(*rwlock));
+	if ( rwlock ) {
+		pthread_rwlockattr_init(&attr);
+#if defined(__GLIBC__) && defined(__USE_GNU)
+		/* glibc lets readers starve writers by default */
+		pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+		if ( pthread_rwlock_init(&rwlock->id, &attr) != 0 ) {
+			SDL_SetError("pthread_rwlock_init() failed");
+			SDL_free(rwlock);
+			rwlock = NULL;
+		}
+		pthread_rwlockattr_destroy(&attr);
+	} else {
+		SDL_OutOfMemory();
+	}
+	return rwlock;
+}
+
+void SDL_DestroyRWLock(SDL_RWLock *rwlock)
+{
+	if ( rwlock ) {
+		pthread_rwlock_destroy(&rwlock->id);
+		SDL_free(rwlock);
+	}
+}
+
+#ifdef HAVE_PTHREAD_RWLOCK_TIMEDRDLOCK
+/* The timed lock functions wait until an absolute time */
+static void SDL_RWLockDeadline(Uint32 ms, struct timespec *abstime)
+{
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+	abstime->tv_sec = now.tv_sec + (ms / 1000);
+	abstime->tv_nsec = (now.tv_usec + (ms % 1000) * 1000) * 1000;
+	if ( abstime->tv_nsec >= 1000000000 ) {
+		abstime->tv_sec += 1;
+		abstime->tv_nsec -= 1000000000;
+	}
+}
+#endif
+
+int SDL_RWLockRead(SDL_RWLock *rwlock)
+{
+	if ( ! rwlock ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+	if ( pthread_rwlock_rdlock(&rwlock->id) != 0 ) {
+		SDL_SetError("pthread_rwlock_rdlock() failed");
+		return -1;
+	}
+	return 0;
+}
+
+int SDL_RWLockTryRead(SDL_RWLock *rwlock)
+{
+	int retval;
+
+	if ( ! rwlock ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+	retval = pthread_rwlock_tryrdlock(&rwlock->id);
+	switch (retval) {
+	    case 0:
+		break;
+	    case EBUSY:
+		retval = SDL_MUTEX_TIMEDOUT;
+		break;
+	    default:
+		SDL_SetError("pthread_rwlock_tryrdlock() failed");
+		retval = -1;
+		break;
+	}
+	return retval;
+}
+
+int SDL_RWLockReadTimeout(SDL_RWLock *rwlock, Uint32 ms)
+{
+	int retval;
+#ifdef HAVE_PTHREAD_RWLOCK_TIMEDRDLOCK
+	struct timespec abstime;
+#else
+	Uint32 end;
+#endif
+
+	/* Try the easy cases first */
+	if ( ms == 0 ) {
+		return SDL_RWLockTryRead(rwlock);
+	}
+	if ( ms == SDL_MUTEX_MAXWAIT ) {
+		return SDL_RWLockRead(rwlock);
+	}
+
+#ifdef HAVE_PTHREAD_RWLOCK_TIMEDRDLOCK
+	if ( ! rwlock ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+	SDL_RWLockDeadline(ms, &abstime);
+	retval = pthread_rwlock_timedrdlock(&rwlock->id, &abstime);
+	switch (retval) {
+	    case 0:
+		break;
+	    case ETIMEDOUT:
+		retval = SDL_MUTEX_TIMEDOUT;
+		break;
+	    default:
+		SDL_SetError("pthread_rwlock_timedrdlock() failed");
+		retval = -1;
+		break;
+	}
+#else
+	end = SDL_GetTicks() + ms;
+	while ((retval = SDL_RWLockTryRead(rwlock)) == SDL_MUTEX_TIMEDOUT) {
+		if ((Sint32)(SDL_GetTicks() - end) >= 0) {
+			break;
+		}
+		SDL_Delay(1);
+	}
+#endif /* HAVE_PTHREAD_RWLOCK_TIMEDRDLOCK */
+
+	return retval;
+}
+
+int SDL_RWLockWrite(SDL_RWLock *rwlock)
+{
+	if ( ! rwlock ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+	if ( pthread_rwlock_wrlock(&rwlock->id) != 0 ) {
+		SDL_SetError("pthread_rwlock_wrlock() failed");
+		return -1;
+	}
+	return 0;
+}
+
+int SDL_RWLockTryWrite(SDL_RWLock *rwlock)
+{
+	int retval;
+
+	if ( ! rwlock ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+	retval = pthread_rwlock_trywrlock(&rwlock->id);
+	switch (retval) {
+	    case 0:
+		break;
+	    case EBUSY:
+		retval = SDL_MUTEX_TIMEDOUT;
+		break;
+	    default:
+		SDL_SetError("pthread_rwlock_trywrlock() failed");
+		retval = -1;
+		break;
+	}
+	return retval;
+}
+
+int SDL_RWLockWriteTimeout(SDL_RWLock *rwlock, Uint32 ms)
+{
+	int retval;
+#ifdef HAVE_PTHREAD_RWLOCK_TIMEDRDLOCK
+	struct timespec abstime;
+#else
+	Uint32 end;
+#endif
+
+	/* Try the easy cases first */
+	if ( ms == 0 ) {
+		return SDL_RWLockTryWrite(rwlock);
+	}
+	if ( ms == SDL_MUTEX_MAXWAIT ) {
+		return SDL_RWLockWrite(rwlock);
+	}
+
+#ifdef HAVE_PTHREAD_RWLOCK_TIMEDRDLOCK
+	if ( ! rwlock ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+	SDL_RWLockDeadline(ms, &abstime);
+	retval = pthread_rwlock_timedwrlock(&rwlock->id, &abstime);
+	switch (retval) {
+	    case 0:
+		break;
+	    case ETIMEDOUT:
+		retval = SDL_MUTEX_TIMEDOUT;
+		break;
+	    default:
+		SDL_SetError("pthread_rwlock_timedwrlock() failed");
+		retval = -1;
+		break;
+	}
+#else
+	end = SDL_GetTicks() + ms;
+	while ((retval = SDL_RWLockTryWrite(rwlock)) == SDL_MUTEX_TIMEDOUT) {
+		if ((Sint32)(SDL_GetTicks() - end) >= 0) {
+			break;
+		}
+		SDL_Delay(1);
+	}
+#endif /* HAVE_PTHREAD_RWLOCK_TIMEDRDLOCK */
+
+	return retval;
+}
+
+int SDL_RWLockUnlock(SDL_RWLock *rwlock)
+{
+	if ( ! rwlock ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+	if ( pthread_rwlock_unlock(&rwlock->id) != 0 ) {
+		SDL_SetError("pthread_rwlock_unlock() failed");
+		return -1;
+	}
+	return 0;
+}
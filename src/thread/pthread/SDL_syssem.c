@@ -155,7 +155,7 @@ int SDL_SemWaitTimeout(SDL_sem *sem, Uint32 timeout)
 #else
 	end = SDL_GetTicks() + timeout;
 	while ((retval = SDL_SemTryWait(sem)) == SDL_MUTEX_TIMEDOUT) {
-		if ((SDL_GetTicks() - end) >= 0) {
+		if ((Sint32)(SDL_GetTicks() - end) >= 0) {
 			break;
 		}
 		SDL_Delay(0);
@@ -23,6 +23,13 @@
 
 #include <pthread.h>
 #include <signal.h>
+#include <sched.h>
+#ifdef __LINUX__
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "SDL_thread.h"
 #include "../SDL_thread_c.h"
@@ -59,6 +66,9 @@ int SDL_SYS_CreateThread(SDL_Thread *thread, void *args)
 		return(-1);
 	}
 	pthread_attr_setdetachstate(&type, PTHREAD_CREATE_JOINABLE);
+	if ( thread->stacksize ) {
+		pthread_attr_setstacksize(&type, (size_t)thread->stacksize);
+	}
 
 	/* Create the thread and go! */
 	if ( pthread_create(&thread->handle, &type, RunThread, args) != 0 ) {
@@ -96,6 +106,158 @@ void SDL_SYS_SetupThread(void)
 #endif
 }
 
+#if defined(__GLIBC__) && defined(__USE_GNU) && \
+    ((__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 12))
+#define HAVE_PTHREAD_SETNAME_NP
+#endif
+
+#ifdef SCHED_FIFO
+static int SetRealtimePriority(void)
+{
+	struct sched_param param;
+	int min, max;
+
+	min = sched_get_priority_min(SCHED_FIFO);
+	max = sched_get_priority_max(SCHED_FIFO);
+	if ( (min < 0) || (max < 0) ) {
+		return(-1);
+	}
+	/* Stay below the kernel's own real-time threads */
+	param.sched_priority = min + (max - min) / 2;
+	if ( pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0 ) {
+		return(-1);
+	}
+	return(0);
+}
+#endif
+
+static int SetPriority(SDL_ThreadPriority priority)
+{
+#ifdef __LINUX__
+	/* Linux threads are scheduled individually by their nice value */
+	struct sched_param param;
+	pid_t tid;
+	int value;
+
+	if ( priority == SDL_THREAD_PRIORITY_INHERIT ) {
+		return(0);
+	}
+	if ( priority == SDL_THREAD_PRIORITY_REALTIME ) {
+		if ( SetRealtimePriority() == 0 ) {
+			return(0);
+		}
+		priority = SDL_THREAD_PRIORITY_HIGH;
+	}
+	param.sched_priority = 0;
+	pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+	switch (priority) {
+	    case SDL_THREAD_PRIORITY_LOW:
+		value = 19;
+		break;
+	    case SDL_THREAD_PRIORITY_HIGH:
+		value = -10;
+		break;
+	    default:
+		value = 0;
+		break;
+	}
+	tid = (pid_t)syscall(SYS_gettid);
+	if ( setpriority(PRIO_PROCESS, (id_t)tid, value) == 0 ) {
+		return(0);
+	}
+#ifdef RLIMIT_NICE
+	/* Without CAP_SYS_NICE, RLIMIT_NICE says how far we may go */
+	if ( value < 0 ) {
+		struct rlimit limit;
+		int allowed;
+		if ( (getrlimit(RLIMIT_NICE, &limit) == 0) &&
+		     (limit.rlim_cur != RLIM_INFINITY) ) {
+			allowed = 20 - (int)limit.rlim_cur;
+			if ( (allowed < 0) && (allowed > value) &&
+			     (setpriority(PRIO_PROCESS, (id_t)tid, allowed) == 0) ) {
+				return(0);
+			}
+		}
+	}
+#endif
+	SDL_SetError("Not allowed to set the thread's nice value to %d", value);
+	return(-1);
+#else
+	struct sched_param param;
+	int policy, min, max;
+
+	if ( priority == SDL_THREAD_PRIORITY_INHERIT ) {
+		return(0);
+	}
+#ifdef SCHED_FIFO
+	if ( priority == SDL_THREAD_PRIORITY_REALTIME ) {
+		if ( SetRealtimePriority() == 0 ) {
+			return(0);
+		}
+		priority = SDL_THREAD_PRIORITY_HIGH;
+	}
+#endif
+	if ( pthread_getschedparam(pthread_self(), &policy, &param) != 0 ) {
+		SDL_SetError("pthread_getschedparam() failed");
+		return(-1);
+	}
+#ifdef SCHED_FIFO
+	if ( policy == SCHED_FIFO ) {
+		policy = SCHED_OTHER;
+	}
+#endif
+	min = sched_get_priority_min(policy);
+	max = sched_get_priority_max(policy);
+	switch (priority) {
+	    case SDL_THREAD_PRIORITY_LOW:
+		param.sched_priority = min;
+		break;
+	    case SDL_THREAD_PRIORITY_HIGH:
+		param.sched_priority = min + ((max - min) * 3) / 4;
+		break;
+	    default:
+		param.sched_priority = min + (max - min) / 2;
+		break;
+	}
+	if ( pthread_setschedparam(pthread_self(), policy, &param) != 0 ) {
+		SDL_SetError("pthread_setschedparam() failed");
+		return(-1);
+	}
+	return(0);
+#endif /* __LINUX__ */
+}
+
+int SDL_SYS_SetThreadAttr(const SDL_ThreadAttr *attr)
+{
+	if ( attr->name ) {
+#if defined(HAVE_PTHREAD_SETNAME_NP)
+		/* Linux limits names to 15 characters plus the terminator */
+		char name[16];
+		SDL_strlcpy(name, attr->name, sizeof(name));
+		pthread_setname_np(pthread_self(), name);
+#elif defined(__MACOSX__)
+		pthread_setname_np(attr->name);
+#endif
+	}
+
+#if defined(__LINUX__) && defined(CPU_SET)
+	if ( attr->affinity ) {
+		cpu_set_t cpus;
+		int i;
+
+		CPU_ZERO(&cpus);
+		for ( i = 0; i < 32; ++i ) {
+			if ( attr->affinity & (1u << i) ) {
+				CPU_SET(i, &cpus);
+			}
+		}
+		sched_setaffinity(0, sizeof(cpus), &cpus);
+	}
+#endif
+
+	return SetPriority(attr->priority);
+}
+
 /* WARNING:  This may not work for systems with 64-bit pid_t */
 Uint32 SDL_ThreadID(void)
 {
@@ -123,11 +123,11 @@ int SDL_SYS_CreateThread(SDL_Thread *thread, void *args)
 	if (pfnBeginThread) {
 		unsigned threadid = 0;
 		thread->handle = (SYS_ThreadHandle)
-				((uintptr_t) pfnBeginThread(NULL, 0, RunThreadViaBeginThreadEx,
+				((uintptr_t) pfnBeginThread(NULL, thread->stacksize, RunThreadViaBeginThreadEx,
 										 pThreadParms, 0, &threadid));
 	} else {
 		DWORD threadid = 0;
-		thread->handle = CreateThread(NULL, 0, RunThreadViaCreateThread, pThreadParms, 0, &threadid);
+		thread->handle = CreateThread(NULL, thread->stacksize, RunThreadViaCreateThread, pThreadParms, 0, &threadid);
 	}
 	if (thread->handle == NULL) {
 		SDL_SetError("Not enough resources to create thread");
@@ -141,6 +141,38 @@ void SDL_SYS_SetupThread(void)
 	return;
 }
 
+int SDL_SYS_SetThreadAttr(const SDL_ThreadAttr *attr)
+{
+	int value;
+
+	/* Thread names need a debugger exception; not worth it here */
+	if ( attr->affinity ) {
+		SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)attr->affinity);
+	}
+	if ( attr->priority == SDL_THREAD_PRIORITY_INHERIT ) {
+		return(0);
+	}
+	switch (attr->priority) {
+	    case SDL_THREAD_PRIORITY_LOW:
+		value = THREAD_PRIORITY_LOWEST;
+		break;
+	    case SDL_THREAD_PRIORITY_HIGH:
+		value = THREAD_PRIORITY_HIGHEST;
+		break;
+	    case SDL_THREAD_PRIORITY_REALTIME:
+		value = THREAD_PRIORITY_TIME_CRITICAL;
+		break;
+	    default:
+		value = THREAD_PRIORITY_NORMAL;
+		break;
+	}
+	if ( ! SetThreadPriority(GetCurrentThread(), value) ) {
+		SDL_SetError("SetThreadPriority() failed");
+		return(-1);
+	}
+	return(0);
+}
+
 Uint32 SDL_ThreadID(void)
 {
 	return((Uint32)GetCurrentThreadId());
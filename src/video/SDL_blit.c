@@ -22,11 +22,15 @@
 #include "SDL_config.h"
 
 #include "SDL_video.h"
+#include "SDL_cpuinfo.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
 
+/* From src/stdlib/SDL_memcpy.c, which has no header of its own */
+extern void SDL_SetStreamFeatures(Uint32 features);
+
 #if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) && SDL_ASSEMBLY_ROUTINES
 #define MMX_ASMBLIT
 #if (__GNUC__ > 2)  /* SSE instructions aren't in GCC 2. */
@@ -35,7 +39,6 @@
 #endif
 
 #if defined(MMX_ASMBLIT)
-#include "SDL_cpuinfo.h"
 #include "mmx.h"
 #endif
 
@@ -152,7 +155,8 @@ static __inline__ void SDL_memcpySSE(Uint8 *to, const Uint8 *from, int len)
 #endif
 #endif
 
-static void SDL_BlitCopy(SDL_BlitInfo *info)
+#ifdef SSE_ASMBLIT
+static void SDL_BlitCopySSE(SDL_BlitInfo *info)
 {
 	Uint8 *src, *dst;
 	int w, h;
@@ -165,39 +169,49 @@ static void SDL_BlitCopy(SDL_BlitInfo *info)
 	srcskip = w+info->s_skip;
 	dstskip = w+info->d_skip;
 
-#ifdef SSE_ASMBLIT
-	if(SDL_HasSSE())
-	{
-		while ( h-- ) {
-			SDL_memcpySSE(dst, src, w);
-			src += srcskip;
-			dst += dstskip;
-		}
-		__asm__ __volatile__ (
-		"	emms\n"
-		::);
+	while ( h-- ) {
+		SDL_memcpySSE(dst, src, w);
+		src += srcskip;
+		dst += dstskip;
 	}
-	else
+	__asm__ __volatile__ (
+	"	emms\n"
+	::);
+}
 #endif
+
 #ifdef MMX_ASMBLIT
-	if(SDL_HasMMX())
-	{
-		while ( h-- ) {
-			SDL_memcpyMMX(dst, src, w);
-			src += srcskip;
-			dst += dstskip;
-		}
-		__asm__ __volatile__ (
-		"	emms\n"
-		::);
-	}
-	else
-#endif
+static void SDL_BlitCopyMMX(SDL_BlitInfo *info)
+{
+	Uint8 *src, *dst;
+	int w, h;
+	int srcskip, dstskip;
+
+	w = info->d_width*info->dst->BytesPerPixel;
+	h = info->d_height;
+	src = info->s_pixels;
+	dst = info->d_pixels;
+	srcskip = w+info->s_skip;
+	dstskip = w+info->d_skip;
+
 	while ( h-- ) {
-		SDL_memcpy(dst, src, w);
+		SDL_memcpyMMX(dst, src, w);
 		src += srcskip;
 		dst += dstskip;
 	}
+	__asm__ __volatile__ (
+	"	emms\n"
+	::);
+}
+#endif
+
+static void SDL_BlitCopy(SDL_BlitInfo *info)
+{
+	int w;
+
+	w = info->d_width*info->dst->BytesPerPixel;
+	SDL_memcpy2D(info->d_pixels, w+info->d_skip,
+	             info->s_pixels, w+info->s_skip, w, info->d_height);
 }
 
 static void SDL_BlitCopyOverlap(SDL_BlitInfo *info)
@@ -229,6 +243,157 @@ static void SDL_BlitCopyOverlap(SDL_BlitInfo *info)
 	}
 }
 
+/* The instruction sets the blitters may use, or 0 until first asked */
+static Uint32 blit_features = 0;
+static int blit_features_set = 0;
+
+static Uint32 SDL_BlitCPUFeatures(void)
+{
+	Uint32 features = SDL_BLIT_C;
+
+	if ( SDL_HasMMX() ) {
+		features |= SDL_BLIT_MMX;
+	}
+	if ( SDL_Has3DNow() ) {
+		features |= SDL_BLIT_3DNOW;
+	}
+	if ( SDL_HasSSE() ) {
+		features |= SDL_BLIT_SSE;
+	}
+	if ( SDL_HasSSE2() ) {
+		features |= SDL_BLIT_SSE2;
+	}
+	if ( SDL_HasAVX2() ) {
+		features |= SDL_BLIT_AVX2;
+	}
+	if ( SDL_HasAltiVec() ) {
+		features |= SDL_BLIT_ALTIVEC;
+	}
+	if ( SDL_HasARMSIMD() ) {
+		features |= SDL_BLIT_ARMSIMD;
+	}
+	if ( SDL_HasNEON() ) {
+		features |= SDL_BLIT_NEON;
+	}
+	return features;
+}
+
+/* Parse a list like "mmx,sse" from SDL_BLIT_FEATURES */
+static Uint32 SDL_ParseBlitFeatures(const char *list)
+{
+	static const struct {
+		const char *name;
+		Uint32 feature;
+	} names[] = {
+		{ "c", SDL_BLIT_C },
+		{ "mmx", SDL_BLIT_MMX },
+		{ "3dnow", SDL_BLIT_3DNOW },
+		{ "sse", SDL_BLIT_SSE },
+		{ "sse2", SDL_BLIT_SSE2 },
+		{ "avx2", SDL_BLIT_AVX2 },
+		{ "altivec", SDL_BLIT_ALTIVEC },
+		{ "armsimd", SDL_BLIT_ARMSIMD },
+		{ "neon", SDL_BLIT_NEON },
+		{ "all", SDL_BLIT_ALL }
+	};
+	Uint32 features = SDL_BLIT_C;
+	size_t len;
+	int i;
+
+	while ( *list ) {
+		for ( len = 0; list[len] && list[len] != ',' && list[len] != ' '; ++len ) {
+			/* find the end of this name */
+		}
+		for ( i = 0; i < SDL_arraysize(names); ++i ) {
+			if ( (SDL_strlen(names[i].name) == len) &&
+			     (SDL_strncasecmp(names[i].name, list, len) == 0) ) {
+				features |= names[i].feature;
+				break;
+			}
+		}
+		list += len;
+		if ( *list ) {
+			++list;
+		}
+	}
+	return features;
+}
+
+Uint32 SDL_SetBlitFeatures(Uint32 features)
+{
+	blit_features = (features & SDL_BlitCPUFeatures());
+	blit_features_set = 1;
+	SDL_SetStreamFeatures(blit_features);
+	return blit_features;
+}
+
+Uint32 SDL_GetBlitFeatures(void)
+{
+	if ( !blit_features_set ) {
+		const char *env = SDL_getenv("SDL_BLIT_FEATURES");
+		if ( env ) {
+			SDL_SetBlitFeatures(SDL_ParseBlitFeatures(env));
+		} else {
+			SDL_SetBlitFeatures(SDL_BLIT_ALL);
+		}
+	}
+	return blit_features;
+}
+
+static const SDL_BlitEntry SDL_BlitCopyEntries[] = {
+	SDL_BLIT_ENTRY(SDL_BlitCopy),
+#ifdef MMX_ASMBLIT
+	SDL_BLIT_ENTRY(SDL_BlitCopyMMX),
+#endif
+#ifdef SSE_ASMBLIT
+	SDL_BLIT_ENTRY(SDL_BlitCopySSE),
+#endif
+	SDL_BLIT_ENTRY(SDL_BlitCopyOverlap),
+	{ NULL, NULL }
+};
+
+static const SDL_BlitEntry *blit_registry[] = {
+	SDL_BlitCopyEntries,
+	SDL_Blit0Entries,
+	SDL_Blit1Entries,
+	SDL_BlitNEntries,
+	SDL_BlitAEntries
+};
+
+/* Look up the name of a blit routine */
+const char *SDL_BlitName(SDL_loblit blit)
+{
+	const SDL_BlitEntry *entry;
+	int i;
+
+	for ( i = 0; i < SDL_arraysize(blit_registry); ++i ) {
+		for ( entry = blit_registry[i]; entry->blit; ++entry ) {
+			if ( entry->blit == blit ) {
+				return entry->name;
+			}
+		}
+	}
+	return "unknown";
+}
+
+const char *SDL_GetBlitterName(SDL_Surface *src, SDL_Surface *dst)
+{
+	if ( !src || !dst ) {
+		SDL_SetError("Passed a NULL surface");
+		return(NULL);
+	}
+	if ( (src->map->dst != dst) ||
+	     (dst->format_version != src->map->format_version) ) {
+		if ( SDL_MapSurface(src, dst) < 0 ) {
+			return(NULL);
+		}
+	}
+	if ( (src->flags & SDL_HWACCEL) == SDL_HWACCEL ) {
+		return("hardware");
+	}
+	return(src->map->sw_data->name);
+}
+
 /* Figure out which of many blit routines to set up on a surface */
 int SDL_CalculateBlit(SDL_Surface *surface)
 {
@@ -303,6 +468,19 @@ int SDL_CalculateBlit(SDL_Surface *surface)
 	/* Check for special "identity" case -- copy blit */
 	if ( surface->map->identity && blit_index == 0 ) {
 	        surface->map->sw_data->blit = SDL_BlitCopy;
+		/* The MMX and SSE copies always bypass the cache, which is
+		   only a win on CPUs too old for SDL_memcpy2D() to stream.
+		 */
+#ifdef SSE_ASMBLIT
+		if ( SDL_BlitHas(SDL_BLIT_SSE) && !SDL_BlitHas(SDL_BLIT_SSE2) ) {
+			surface->map->sw_data->blit = SDL_BlitCopySSE;
+		} else
+#endif
+#ifdef MMX_ASMBLIT
+		if ( SDL_BlitHas(SDL_BLIT_MMX) && !SDL_BlitHas(SDL_BLIT_SSE2) ) {
+			surface->map->sw_data->blit = SDL_BlitCopyMMX;
+		}
+#endif
 
 		/* Handle overlapping blits on the same surface */
 		if ( surface == surface->map->dst ) {
@@ -336,6 +514,7 @@ int SDL_CalculateBlit(SDL_Surface *surface)
 		SDL_SetError("Blit combination not supported");
 		return(-1);
 	}
+	surface->map->sw_data->name = SDL_BlitName(surface->map->sw_data->blit);
 
 	/* Choose software blitting function */
 	if(surface->flags & SDL_RLEACCELOK
@@ -344,11 +523,15 @@ int SDL_CalculateBlit(SDL_Surface *surface)
 	        if(surface->map->identity
 		   && (blit_index == 1
 		       || (blit_index == 3 && !surface->format->Amask))) {
-		        if ( SDL_RLESurface(surface) == 0 )
+		        if ( SDL_RLESurface(surface) == 0 ) {
 			        surface->map->sw_blit = SDL_RLEBlit;
+				surface->map->sw_data->name = "SDL_RLEBlit";
+			}
 		} else if(blit_index == 2 && surface->format->Amask) {
-		        if ( SDL_RLESurface(surface) == 0 )
+		        if ( SDL_RLESurface(surface) == 0 ) {
 			        surface->map->sw_blit = SDL_RLEAlphaBlit;
+				surface->map->sw_data->name = "SDL_RLEAlphaBlit";
+			}
 		}
 	}
 	
@@ -24,11 +24,9 @@
 #ifndef _SDL_blit_h
 #define _SDL_blit_h
 
+#include "SDL_cpuinfo.h"
 #include "SDL_endian.h"
 
-extern SDL_bool SDL_HasARMSIMD(void);		/* whether CPU has ARM SIMD (ARMv6) features */
-extern SDL_bool SDL_HasNEON (void);		/* whether CPU has ARM NEON features.        */
-
 /* The structure passed to the low level blit functions */
 typedef struct {
 	Uint8 *s_pixels;
@@ -52,6 +50,7 @@ typedef void (*SDL_loblit)(SDL_BlitInfo *info);
 struct private_swaccel {
 	SDL_loblit blit;
 	void *aux_data;
+	const char *name;	/* name of the routine, see SDL_BlitName() */
 };
 
 /* Blit mapping definition */
@@ -72,6 +71,25 @@ typedef struct SDL_BlitMap {
 
 /* Functions found in SDL_blit.c */
 extern int SDL_CalculateBlit(SDL_Surface *surface);
+extern const char *SDL_BlitName(SDL_loblit blit);
+
+/* True if the blitters may use the given SDL_BLIT_* instruction set */
+#define SDL_BlitHas(feature)	((SDL_GetBlitFeatures() & (feature)) != 0)
+
+/* Every blit routine a SDL_CalculateBlit*() function can return is
+   listed with its name in its file's table, ending with a NULL entry.
+ */
+typedef struct SDL_BlitEntry {
+	SDL_loblit blit;
+	const char *name;
+} SDL_BlitEntry;
+
+#define SDL_BLIT_ENTRY(blit)	{ blit, #blit }
+
+extern const SDL_BlitEntry SDL_Blit0Entries[];
+extern const SDL_BlitEntry SDL_Blit1Entries[];
+extern const SDL_BlitEntry SDL_BlitNEntries[];
+extern const SDL_BlitEntry SDL_BlitAEntries[];
 
 /* Functions found in SDL_blit_{0,1,N,A}.c */
 extern SDL_loblit SDL_CalculateBlit0(SDL_Surface *surface, int complex);
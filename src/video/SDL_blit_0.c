@@ -469,3 +469,17 @@ SDL_loblit SDL_CalculateBlit0(SDL_Surface *surface, int blit_index)
 	return NULL;
 }
 
+
+const SDL_BlitEntry SDL_Blit0Entries[] = {
+	SDL_BLIT_ENTRY(BlitBto1),
+	SDL_BLIT_ENTRY(BlitBto2),
+	SDL_BLIT_ENTRY(BlitBto3),
+	SDL_BLIT_ENTRY(BlitBto4),
+	SDL_BLIT_ENTRY(BlitBto1Key),
+	SDL_BLIT_ENTRY(BlitBto2Key),
+	SDL_BLIT_ENTRY(BlitBto3Key),
+	SDL_BLIT_ENTRY(BlitBto4Key),
+	SDL_BLIT_ENTRY(BlitBtoNAlpha),
+	SDL_BLIT_ENTRY(BlitBtoNAlphaKey),
+	{ NULL, NULL }
+};
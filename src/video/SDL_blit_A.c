@@ -2792,7 +2792,7 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 	    else
 #if SDL_ALTIVEC_BLITTERS
 	if (sf->BytesPerPixel == 4 && df->BytesPerPixel == 4 &&
-	    !(surface->map->dst->flags & SDL_HWSURFACE) && SDL_HasAltiVec())
+	    !(surface->map->dst->flags & SDL_HWSURFACE) && SDL_BlitHas(SDL_BLIT_ALTIVEC))
             return Blit32to32SurfaceAlphaKeyAltivec;
         else
 #endif
@@ -2808,7 +2808,7 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 		    if(df->Gmask == 0x7e0)
 		    {
 #if MMX_ASMBLIT
-		if(SDL_HasMMX())
+		if(SDL_BlitHas(SDL_BLIT_MMX))
 			return Blit565to565SurfaceAlphaMMX;
 		else
 #endif
@@ -2817,7 +2817,7 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 		    else if(df->Gmask == 0x3e0)
 		    {
 #if MMX_ASMBLIT
-		if(SDL_HasMMX())
+		if(SDL_BlitHas(SDL_BLIT_MMX))
 			return Blit555to555SurfaceAlphaMMX;
 		else
 #endif
@@ -2836,14 +2836,14 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 			if(sf->Rshift % 8 == 0
 			   && sf->Gshift % 8 == 0
 			   && sf->Bshift % 8 == 0
-			   && SDL_HasMMX())
+			   && SDL_BlitHas(SDL_BLIT_MMX))
 			    return BlitRGBtoRGBSurfaceAlphaMMX;
 #endif
 			if((sf->Rmask | sf->Gmask | sf->Bmask) == 0xffffff)
 			{
 #if SDL_ALTIVEC_BLITTERS
 				if(!(surface->map->dst->flags & SDL_HWSURFACE)
-					&& SDL_HasAltiVec())
+					&& SDL_BlitHas(SDL_BLIT_ALTIVEC))
 					return BlitRGBtoRGBSurfaceAlphaAltivec;
 #endif
 				return BlitRGBtoRGBSurfaceAlpha;
@@ -2851,7 +2851,7 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 		}
 #if SDL_ALTIVEC_BLITTERS
 		if((sf->BytesPerPixel == 4) &&
-		   !(surface->map->dst->flags & SDL_HWSURFACE) && SDL_HasAltiVec())
+		   !(surface->map->dst->flags & SDL_HWSURFACE) && SDL_BlitHas(SDL_BLIT_ALTIVEC))
 			return Blit32to32SurfaceAlphaAltivec;
 		else
 #endif
@@ -2872,7 +2872,7 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 #if SDL_ALTIVEC_BLITTERS
 	if(sf->BytesPerPixel == 4 && !(surface->map->dst->flags & SDL_HWSURFACE) &&
            df->Gmask == 0x7e0 &&
-	   df->Bmask == 0x1f && SDL_HasAltiVec())
+	   df->Bmask == 0x1f && SDL_BlitHas(SDL_BLIT_ALTIVEC))
             return Blit32to565PixelAlphaAltivec;
         else
 #endif
@@ -2883,11 +2883,11 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 		   || (sf->Bmask == 0xff && df->Bmask == 0x1f)))
 		{
 #if SDL_ARM_NEON_BLITTERS
-		    if(SDL_HasNEON())
+		    if(SDL_BlitHas(SDL_BLIT_NEON))
 		        return BlitARGBto565PixelAlphaARMNEON;
 #endif
 #if SDL_ARM_SIMD_BLITTERS
-		    if(SDL_HasARMSIMD())
+		    if(SDL_BlitHas(SDL_BLIT_ARMSIMD))
 		        return BlitARGBto565PixelAlphaARMSIMD;
 #endif
 		}
@@ -2916,9 +2916,9 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 		   && sf->Ashift % 8 == 0
 		   && sf->Aloss == 0)
 		{
-			if(SDL_Has3DNow())
+			if(SDL_BlitHas(SDL_BLIT_3DNOW))
 				return BlitRGBtoRGBPixelAlphaMMX3DNOW;
-			if(SDL_HasMMX())
+			if(SDL_BlitHas(SDL_BLIT_MMX))
 				return BlitRGBtoRGBPixelAlphaMMX;
 		}
 #endif
@@ -2926,15 +2926,15 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 		{
 #if SDL_ALTIVEC_BLITTERS
 			if(!(surface->map->dst->flags & SDL_HWSURFACE)
-				&& SDL_HasAltiVec())
+				&& SDL_BlitHas(SDL_BLIT_ALTIVEC))
 				return BlitRGBtoRGBPixelAlphaAltivec;
 #endif
 #if SDL_ARM_NEON_BLITTERS
-			if (SDL_HasNEON())
+			if (SDL_BlitHas(SDL_BLIT_NEON))
 				return BlitRGBtoRGBPixelAlphaARMNEON;
 #endif
 #if SDL_ARM_SIMD_BLITTERS
-			if (SDL_HasARMSIMD())
+			if (SDL_BlitHas(SDL_BLIT_ARMSIMD))
 				return BlitRGBtoRGBPixelAlphaARMSIMD;
 #endif
 			return BlitRGBtoRGBPixelAlpha;
@@ -2942,7 +2942,7 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 	    }
 #if SDL_ALTIVEC_BLITTERS
 	    if (sf->Amask && sf->BytesPerPixel == 4 &&
-	        !(surface->map->dst->flags & SDL_HWSURFACE) && SDL_HasAltiVec())
+	        !(surface->map->dst->flags & SDL_HWSURFACE) && SDL_BlitHas(SDL_BLIT_ALTIVEC))
 		return Blit32to32PixelAlphaAltivec;
 	    else
 #endif
@@ -2955,3 +2955,41 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
     }
 }
 
+const SDL_BlitEntry SDL_BlitAEntries[] = {
+#if MMX_ASMBLIT
+	SDL_BLIT_ENTRY(Blit565to565SurfaceAlphaMMX),
+	SDL_BLIT_ENTRY(Blit555to555SurfaceAlphaMMX),
+	SDL_BLIT_ENTRY(BlitRGBtoRGBSurfaceAlphaMMX),
+	SDL_BLIT_ENTRY(BlitRGBtoRGBPixelAlphaMMX),
+	SDL_BLIT_ENTRY(BlitRGBtoRGBPixelAlphaMMX3DNOW),
+#endif
+#if SDL_ALTIVEC_BLITTERS
+	SDL_BLIT_ENTRY(Blit32to565PixelAlphaAltivec),
+	SDL_BLIT_ENTRY(Blit32to32SurfaceAlphaKeyAltivec),
+	SDL_BLIT_ENTRY(Blit32to32PixelAlphaAltivec),
+	SDL_BLIT_ENTRY(BlitRGBtoRGBPixelAlphaAltivec),
+	SDL_BLIT_ENTRY(Blit32to32SurfaceAlphaAltivec),
+	SDL_BLIT_ENTRY(BlitRGBtoRGBSurfaceAlphaAltivec),
+#endif
+#if SDL_ARM_SIMD_BLITTERS
+	SDL_BLIT_ENTRY(BlitARGBto565PixelAlphaARMSIMD),
+	SDL_BLIT_ENTRY(BlitRGBtoRGBPixelAlphaARMSIMD),
+#endif
+#if SDL_ARM_NEON_BLITTERS
+	SDL_BLIT_ENTRY(BlitARGBto565PixelAlphaARMNEON),
+	SDL_BLIT_ENTRY(BlitRGBtoRGBPixelAlphaARMNEON),
+#endif
+	SDL_BLIT_ENTRY(BlitNto1SurfaceAlpha),
+	SDL_BLIT_ENTRY(BlitNto1PixelAlpha),
+	SDL_BLIT_ENTRY(BlitNto1SurfaceAlphaKey),
+	SDL_BLIT_ENTRY(BlitRGBtoRGBSurfaceAlpha),
+	SDL_BLIT_ENTRY(BlitRGBtoRGBPixelAlpha),
+	SDL_BLIT_ENTRY(Blit565to565SurfaceAlpha),
+	SDL_BLIT_ENTRY(Blit555to555SurfaceAlpha),
+	SDL_BLIT_ENTRY(BlitARGBto565PixelAlpha),
+	SDL_BLIT_ENTRY(BlitARGBto555PixelAlpha),
+	SDL_BLIT_ENTRY(BlitNtoNSurfaceAlpha),
+	SDL_BLIT_ENTRY(BlitNtoNSurfaceAlphaKey),
+	SDL_BLIT_ENTRY(BlitNtoNPixelAlpha),
+	{ NULL, NULL }
+};
@@ -52,27 +52,15 @@ enum blit_features {
 #include <altivec.h>
 #endif
 #define assert(X)
-#ifdef __MACOSX__
-#include <sys/sysctl.h>
 static size_t GetL3CacheSize( void )
 {
-    const char key[] = "hw.l3cachesize";
-    u_int64_t result = 0;
-    size_t typeSize = sizeof( result );
-
-
-    int err = sysctlbyname( key, &result, &typeSize, NULL, 0 );
-    if( 0 != err ) return 0;
-
-    return result;
-}
+#if defined(__MACOSX__) || defined(__LINUX__)
+    return SDL_GetCPUCacheSize(3);
 #else
-static size_t GetL3CacheSize( void )
-{
     /* XXX: Just guess G4 */
     return 2097152;
+#endif
 }
-#endif /* __MACOSX__ */
 
 #if (defined(__MACOSX__) && (__GNUC__ < 4))
     #define VECUINT8_LITERAL(a,b,c,d,e,f,g,h,i,j,k,l,m,n,o,p) \
@@ -890,9 +878,9 @@ static enum blit_features GetBlitFeatures( void )
         } else {
             features = ( 0
                 /* Feature 1 is has-MMX */
-                | ((SDL_HasMMX()) ? BLIT_FEATURE_HAS_MMX : 0)
+                | ((SDL_BlitHas(SDL_BLIT_MMX)) ? BLIT_FEATURE_HAS_MMX : 0)
                 /* Feature 2 is has-AltiVec */
-                | ((SDL_HasAltiVec()) ? BLIT_FEATURE_HAS_ALTIVEC : 0)
+                | ((SDL_BlitHas(SDL_BLIT_ALTIVEC)) ? BLIT_FEATURE_HAS_ALTIVEC : 0)
                 /* Feature 4 is dont-use-prefetch */
                 /* !!!! FIXME: Check for G5 or later, not the cache size! Always prefetch on a G4. */
                 | ((GetL3CacheSize() == 0) ? BLIT_FEATURE_ALTIVEC_DONT_USE_PREFETCH : 0)
@@ -906,7 +894,7 @@ static enum blit_features GetBlitFeatures( void )
 #endif
 #else
 /* Feature 1 is has-MMX */
-#define GetBlitFeatures() ((SDL_HasMMX() ? BLIT_FEATURE_HAS_MMX : 0) | (SDL_HasARMSIMD() ? BLIT_FEATURE_HAS_ARM_SIMD : 0))
+#define GetBlitFeatures() ((SDL_BlitHas(SDL_BLIT_MMX) ? BLIT_FEATURE_HAS_MMX : 0) | (SDL_BlitHas(SDL_BLIT_ARMSIMD) ? BLIT_FEATURE_HAS_ARM_SIMD : 0))
 #endif
 
 #if SDL_ARM_SIMD_BLITTERS
@@ -3243,7 +3231,7 @@ SDL_loblit SDL_CalculateBlitN(SDL_Surface *surface, int blit_index)
 		return BlitNto1Key;
 	    else {
 #if SDL_ALTIVEC_BLITTERS
-        if((srcfmt->BytesPerPixel == 4) && (dstfmt->BytesPerPixel == 4) && SDL_HasAltiVec()) {
+        if((srcfmt->BytesPerPixel == 4) && (dstfmt->BytesPerPixel == 4) && SDL_BlitHas(SDL_BLIT_ALTIVEC)) {
             return Blit32to32KeyAltivec;
         } else
 #endif
@@ -3335,3 +3323,43 @@ SDL_loblit SDL_CalculateBlitN(SDL_Surface *surface, int blit_index)
 
 	return(blitfun);
 }
+
+const SDL_BlitEntry SDL_BlitNEntries[] = {
+#if SDL_ALTIVEC_BLITTERS
+	SDL_BLIT_ENTRY(Blit_RGB888_RGB565Altivec),
+	SDL_BLIT_ENTRY(Blit_RGB565_32Altivec),
+	SDL_BLIT_ENTRY(Blit_RGB555_32Altivec),
+	SDL_BLIT_ENTRY(Blit32to32KeyAltivec),
+	SDL_BLIT_ENTRY(ConvertAltivec32to32_noprefetch),
+	SDL_BLIT_ENTRY(ConvertAltivec32to32_prefetch),
+#endif
+#if SDL_ARM_SIMD_BLITTERS
+	SDL_BLIT_ENTRY(Blit_BGR888_RGB888ARMSIMD),
+	SDL_BLIT_ENTRY(Blit_RGB444_RGB888ARMSIMD),
+#endif
+#if SDL_HERMES_BLITTERS
+	SDL_BLIT_ENTRY(ConvertMMX),
+	SDL_BLIT_ENTRY(ConvertX86),
+#else
+	SDL_BLIT_ENTRY(Blit_RGB888_index8),
+	SDL_BLIT_ENTRY(Blit_RGB888_RGB555),
+	SDL_BLIT_ENTRY(Blit_RGB888_RGB565),
+#endif
+	SDL_BLIT_ENTRY(Blit_RGB565_ARGB8888),
+	SDL_BLIT_ENTRY(Blit_RGB565_ABGR8888),
+	SDL_BLIT_ENTRY(Blit_RGB565_RGBA8888),
+	SDL_BLIT_ENTRY(Blit_RGB565_BGRA8888),
+	SDL_BLIT_ENTRY(Blit_RGB888_index8_map),
+	SDL_BLIT_ENTRY(Blit_3or4_to_3or4__same_rgb),
+	SDL_BLIT_ENTRY(Blit_3or4_to_3or4__inversed_rgb),
+	SDL_BLIT_ENTRY(Blit4to4MaskAlpha),
+	SDL_BLIT_ENTRY(Blit4to4CopyAlpha),
+	SDL_BLIT_ENTRY(BlitNto1),
+	SDL_BLIT_ENTRY(BlitNtoN),
+	SDL_BLIT_ENTRY(BlitNtoNCopyAlpha),
+	SDL_BLIT_ENTRY(BlitNto1Key),
+	SDL_BLIT_ENTRY(Blit2to2Key),
+	SDL_BLIT_ENTRY(BlitNtoNKey),
+	SDL_BLIT_ENTRY(BlitNtoNKeyCopyAlpha),
+	{ NULL, NULL }
+};
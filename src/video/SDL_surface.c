@@ -27,6 +27,7 @@
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
+#include "SDL_videostats_c.h"
 #include "SDL_leaks.h"
 #include "SDL_cpuinfo.h"
 
@@ -435,8 +436,16 @@ int SDL_LowerBlit (SDL_Surface *src, SDL_Rect *srcrect,
 			dstrect = &hw_dstrect;
 		}
 		do_blit = src->map->hw_blit;
+		if ( SDL_videostats_enabled ) {
+			SDL_VideoStatsBlit("hardware",
+			                   srcrect->w*srcrect->h);
+		}
 	} else {
 		do_blit = src->map->sw_blit;
+		if ( SDL_videostats_enabled ) {
+			SDL_VideoStatsBlit(src->map->sw_data->name,
+			                   srcrect->w*srcrect->h);
+		}
 	}
 	return(do_blit(src, srcrect, dst, dstrect));
 }
@@ -583,6 +592,8 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 	} else {
 		dstrect = &dst->clip_rect;
 	}
+	SDL_VIDEOSTATS_ADD(fills, 1);
+	SDL_VIDEOSTATS_ADD(fill_pixels, dstrect->w*dstrect->h);
 
 	/* Check for hardware acceleration */
 	if ( ((dst->flags & SDL_HWSURFACE) == SDL_HWSURFACE) &&
@@ -604,7 +615,7 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 	row = (Uint8 *)dst->pixels+dstrect->y*dst->pitch+
 			dstrect->x*dst->format->BytesPerPixel;
 #if SDL_ARM_NEON_BLITTERS
-    if (SDL_HasNEON() && dst->format->BytesPerPixel != 3) {
+    if (SDL_BlitHas(SDL_BLIT_NEON) && dst->format->BytesPerPixel != 3) {
         void FillRect8ARMNEONAsm(int32_t w, int32_t h, uint8_t *dst, int32_t dst_stride, uint8_t src);
         void FillRect16ARMNEONAsm(int32_t w, int32_t h, uint16_t *dst, int32_t dst_stride, uint16_t src);
         void FillRect32ARMNEONAsm(int32_t w, int32_t h, uint32_t *dst, int32_t dst_stride, uint32_t src);
@@ -625,7 +636,7 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
     }
 #endif
 #if SDL_ARM_SIMD_BLITTERS
-	if (SDL_HasARMSIMD() && dst->format->BytesPerPixel != 3) {
+	if (SDL_BlitHas(SDL_BLIT_ARMSIMD) && dst->format->BytesPerPixel != 3) {
 		void FillRect8ARMSIMDAsm(int32_t w, int32_t h, uint8_t *dst, int32_t dst_stride, uint8_t src);
 		void FillRect16ARMSIMDAsm(int32_t w, int32_t h, uint16_t *dst, int32_t dst_stride, uint16_t src);
 		void FillRect32ARMSIMDAsm(int32_t w, int32_t h, uint32_t *dst, int32_t dst_stride, uint32_t src);
@@ -648,11 +659,7 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 	if ( dst->format->palette || (color == 0) ) {
 		x = dstrect->w*dst->format->BytesPerPixel;
 		if ( !color && !((uintptr_t)row&3) && !(x&3) && !(dst->pitch&3) ) {
-			int n = x >> 2;
-			for ( y=dstrect->h; y; --y ) {
-				SDL_memset4(row, 0, n);
-				row += dst->pitch;
-			}
+			SDL_memset2D(row, dst->pitch, 0, x, dstrect->h);
 		} else {
 #ifdef __powerpc__
 			/*
@@ -719,29 +726,19 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 			} else
 #endif /* __powerpc__ */
 			{
-				for(y = dstrect->h; y; y--) {
-					SDL_memset(row, color, x);
-					row += dst->pitch;
-				}
+				SDL_memset2D(row, dst->pitch,
+				             (color & 0xFF) * 0x01010101,
+				             x, dstrect->h);
 			}
 		}
 	} else {
 		switch (dst->format->BytesPerPixel) {
 		    case 2:
-			for ( y=dstrect->h; y; --y ) {
-				Uint16 *pixels = (Uint16 *)row;
+			{
 				Uint16 c = (Uint16)color;
 				Uint32 cc = (Uint32)c << 16 | c;
-				int n = dstrect->w;
-				if((uintptr_t)pixels & 3) {
-					*pixels++ = c;
-					n--;
-				}
-				if(n >> 1)
-					SDL_memset4(pixels, cc, n >> 1);
-				if(n & 1)
-					pixels[n - 1] = c;
-				row += dst->pitch;
+				SDL_memset2D(row, dst->pitch, cc,
+				             dstrect->w*2, dstrect->h);
 			}
 			break;
 
@@ -760,10 +757,8 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 			break;
 
 		    case 4:
-			for(y = dstrect->h; y; --y) {
-				SDL_memset4(row, color, dstrect->w);
-				row += dst->pitch;
-			}
+			SDL_memset2D(row, dst->pitch, color,
+			             dstrect->w*4, dstrect->h);
 			break;
 		}
 	}
@@ -778,6 +773,7 @@ int SDL_FillRect(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
  */
 int SDL_LockSurface (SDL_Surface *surface)
 {
+	SDL_VIDEOSTATS_ADD(locks, 1);
 	if ( ! surface->locked ) {
 		/* Perform the lock */
 		if ( surface->flags & (SDL_HWSURFACE|SDL_ASYNCBLIT) ) {
@@ -806,6 +802,8 @@ int SDL_LockSurface (SDL_Surface *surface)
  */
 void SDL_UnlockSurface (SDL_Surface *surface)
 {
+	SDL_VIDEOSTATS_ADD(unlocks, 1);
+
 	/* Only perform an unlock if we are locked */
 	if ( ! surface->locked || (--surface->locked > 0) ) {
 		return;
@@ -106,6 +106,9 @@ struct SDL_VideoDevice {
 	 */
 	void (*UpdateRects)(_THIS, int numrects, SDL_Rect *rects);
 
+	/* Reports how screen updates were sent to the display */
+	int (*GetUpdateStats)(_THIS, SDL_UpdateStats *stats);
+
 	/* Reverse the effects VideoInit() -- called if VideoInit() fails
 	   or if the application is shutting down the video subsystem.
 	*/
@@ -144,6 +147,9 @@ struct SDL_VideoDevice {
 	/* Performs hardware flipping */
 	int (*FlipHWSurface)(_THIS, SDL_Surface *surface);
 
+	/* Reports when flipped frames reached the screen */
+	int (*GetFlipStats)(_THIS, SDL_FlipStats *stats);
+
 	/* Frees a previously allocated video surface */
 	void (*FreeHWSurface)(_THIS, SDL_Surface *surface);
 
@@ -28,6 +28,7 @@
 #include "SDL_blit.h"
 #include "SDL_pixels_c.h"
 #include "SDL_cursor_c.h"
+#include "SDL_videostats_c.h"
 #include "../events/SDL_sysevents.h"
 #include "../events/SDL_events_c.h"
 
@@ -175,6 +176,7 @@ int SDL_VideoInit (const char *driver_name, Uint32 flags)
 	if ( current_video != NULL ) {
 		SDL_VideoQuit();
 	}
+	SDL_VideoStatsInit();
 
 	/* Select the proper video driver */
 	i = index = 0;
@@ -1049,6 +1051,8 @@ void SDL_UpdateRects (SDL_Surface *screen, int numrects, SDL_Rect *rects)
 	int i;
 	SDL_VideoDevice *video = current_video;
 	SDL_VideoDevice *this = current_video;
+	int stats = SDL_videostats_enabled;
+	Uint32 start = 0;
 
 	if ( (screen->flags & (SDL_OPENGL | SDL_OPENGLBLIT)) == SDL_OPENGL ) {
 		SDL_SetError("OpenGL active, use SDL_GL_SwapBuffers()");
@@ -1058,6 +1062,9 @@ void SDL_UpdateRects (SDL_Surface *screen, int numrects, SDL_Rect *rects)
 		/* Blit the shadow surface using saved mapping */
 		SDL_Palette *pal = screen->format->palette;
 		SDL_Color *saved_colors = NULL;
+		if ( stats ) {
+			start = SDL_VideoStatsTime();
+		}
 		if ( pal && !(SDL_VideoSurface->flags & SDL_HWPALETTE) ) {
 			/* simulated 8bpp, use correct physical palette */
 			saved_colors = pal->colors;
@@ -1087,11 +1094,27 @@ void SDL_UpdateRects (SDL_Surface *screen, int numrects, SDL_Rect *rects)
 		if ( saved_colors ) {
 			pal->colors = saved_colors;
 		}
+		if ( stats ) {
+			SDL_videostats.convert_usec +=
+				SDL_VideoStatsTime() - start;
+		}
 
 		/* Fall through to video surface update */
 		screen = SDL_VideoSurface;
 	}
 	if ( screen == SDL_VideoSurface ) {
+		if ( stats ) {
+			SDL_videostats.updates += 1;
+			for ( i=0; i<numrects; ++i ) {
+				if ( rects[i].w && rects[i].h ) {
+					SDL_videostats.update_rects += 1;
+					SDL_videostats.update_pixels +=
+						rects[i].w*rects[i].h;
+				}
+			}
+			start = SDL_VideoStatsTime();
+		}
+
 		/* Update the video surface */
 		if ( screen->offset ) {
 			for ( i=0; i<numrects; ++i ) {
@@ -1106,6 +1129,11 @@ void SDL_UpdateRects (SDL_Surface *screen, int numrects, SDL_Rect *rects)
 		} else {
 			video->UpdateRects(this, numrects, rects);
 		}
+		if ( stats ) {
+			SDL_videostats.present_usec +=
+				SDL_VideoStatsTime() - start;
+			SDL_VideoStatsFrame();
+		}
 	}
 }
 
@@ -1115,11 +1143,18 @@ void SDL_UpdateRects (SDL_Surface *screen, int numrects, SDL_Rect *rects)
 int SDL_Flip(SDL_Surface *screen)
 {
 	SDL_VideoDevice *video = current_video;
+	int stats = SDL_videostats_enabled;
+	Uint32 start = 0;
+	int retval;
+
 	/* Copy the shadow surface to the video surface */
 	if ( screen == SDL_ShadowSurface ) {
 		SDL_Rect rect;
 		SDL_Palette *pal = screen->format->palette;
 		SDL_Color *saved_colors = NULL;
+		if ( stats ) {
+			start = SDL_VideoStatsTime();
+		}
 		if ( pal && !(SDL_VideoSurface->flags & SDL_HWPALETTE) ) {
 			/* simulated 8bpp, use correct physical palette */
 			saved_colors = pal->colors;
@@ -1150,19 +1185,64 @@ int SDL_Flip(SDL_Surface *screen)
 		if ( saved_colors ) {
 			pal->colors = saved_colors;
 		}
+		if ( stats ) {
+			SDL_videostats.convert_usec +=
+				SDL_VideoStatsTime() - start;
+		}
 
 		/* Fall through to video surface update */
 		screen = SDL_VideoSurface;
 	}
 	if ( (screen->flags & SDL_DOUBLEBUF) == SDL_DOUBLEBUF ) {
 		SDL_VideoDevice *this  = current_video;
-		return(video->FlipHWSurface(this, SDL_VideoSurface));
+		if ( stats ) {
+			start = SDL_VideoStatsTime();
+		}
+		retval = video->FlipHWSurface(this, SDL_VideoSurface);
+		if ( stats ) {
+			SDL_videostats.present_usec +=
+				SDL_VideoStatsTime() - start;
+			SDL_VideoStatsFrame();
+		}
+		return(retval);
 	} else {
 		SDL_UpdateRect(screen, 0, 0, 0, 0);
 	}
 	return(0);
 }
 
+int SDL_GetFlipStats(SDL_FlipStats *stats)
+{
+	SDL_VideoDevice *video = current_video;
+	SDL_VideoDevice *this  = current_video;
+
+	if ( stats == NULL ) {
+		SDL_SetError("Passed a NULL stats pointer");
+		return(-1);
+	}
+	if ( video && SDL_VideoSurface && video->GetFlipStats ) {
+		return(video->GetFlipStats(this, stats));
+	}
+	SDL_Unsupported();
+	return(-1);
+}
+
+int SDL_GetUpdateStats(SDL_UpdateStats *stats)
+{
+	SDL_VideoDevice *video = current_video;
+	SDL_VideoDevice *this  = current_video;
+
+	if ( stats == NULL ) {
+		SDL_SetError("Passed a NULL stats pointer");
+		return(-1);
+	}
+	if ( video && SDL_VideoSurface && video->GetUpdateStats ) {
+		return(video->GetUpdateStats(this, stats));
+	}
+	SDL_Unsupported();
+	return(-1);
+}
+
 static void SetPalette_logical(SDL_Surface *screen, SDL_Color *colors,
 			       int firstcolor, int ncolors)
 {
@@ -0,0 +1,181 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Opt-in counters of the work done by the video core */
+
+#include <stdio.h>
+
+#if defined(SDL_TIMER_WIN32) || defined(SDL_TIMER_WINCE)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(SDL_TIMER_UNIX)
+#include <sys/time.h>
+#if HAVE_CLOCK_GETTIME
+#include <time.h>
+#endif
+#else
+#include "SDL_timer.h"
+#endif
+
+#include "SDL_video.h"
+#include "SDL_videostats_c.h"
+
+int SDL_videostats_enabled = 0;
+SDL_VideoStats SDL_videostats;
+
+/* Print the statistics every this many frames, if non-zero */
+static Uint32 dump_interval = 0;
+
+void SDL_VideoStatsInit(void)
+{
+	const char *env;
+
+	env = SDL_getenv("SDL_VIDEO_STATS");
+	if ( env && (SDL_atoi(env) > 0) ) {
+		dump_interval = SDL_atoi(env);
+		SDL_memset(&SDL_videostats, 0, sizeof(SDL_videostats));
+		SDL_videostats_enabled = 1;
+	}
+}
+
+int SDL_EnableVideoStats(int enable)
+{
+	int previous = SDL_videostats_enabled;
+
+	if ( enable >= 0 ) {
+		SDL_videostats_enabled = (enable != 0);
+	}
+	return(previous);
+}
+
+void SDL_GetVideoStats(SDL_VideoStats *stats, int reset)
+{
+	if ( stats ) {
+		*stats = SDL_videostats;
+	}
+	if ( reset ) {
+		SDL_memset(&SDL_videostats, 0, sizeof(SDL_videostats));
+	}
+}
+
+void SDL_VideoStatsBlit(const char *name, Uint32 pixels)
+{
+	SDL_BlitterStats *blitter;
+	int i;
+
+	SDL_videostats.blits += 1;
+	SDL_videostats.blit_pixels += pixels;
+
+	/* The names are string constants, so they can be told apart
+	   by address.  The last entry is kept for "other", which collects
+	   every routine that doesn't fit once the rest are taken.
+	 */
+	blitter = NULL;
+	for ( i = 0; i < SDL_videostats.num_blitters; ++i ) {
+		if ( SDL_videostats.blitters[i].name == name ) {
+			blitter = &SDL_videostats.blitters[i];
+			break;
+		}
+	}
+	if ( !blitter ) {
+		i = SDL_videostats.num_blitters;
+		if ( i < SDL_MAX_BLITTER_STATS-1 ) {
+			++SDL_videostats.num_blitters;
+			blitter = &SDL_videostats.blitters[i];
+			blitter->name = name;
+		} else {
+			SDL_videostats.num_blitters = SDL_MAX_BLITTER_STATS;
+			blitter = &SDL_videostats.blitters[SDL_MAX_BLITTER_STATS-1];
+			blitter->name = "other";
+		}
+	}
+	blitter->blits += 1;
+	blitter->pixels += pixels;
+}
+
+static void SDL_DumpVideoStats(void)
+{
+	const SDL_VideoStats *stats = &SDL_videostats;
+	Uint32 frames = stats->frames;
+	int i;
+
+	fprintf(stderr, "SDL video stats, average of %u frames:\n", frames);
+	fprintf(stderr,
+		"  %u blits (%u pixels), %u fills (%u pixels)\n",
+		stats->blits/frames, stats->blit_pixels/frames,
+		stats->fills/frames, stats->fill_pixels/frames);
+	fprintf(stderr,
+		"  %u updates (%u rects, %u pixels), %u locks, %u unlocks\n",
+		stats->updates/frames, stats->update_rects/frames,
+		stats->update_pixels/frames,
+		stats->locks/frames, stats->unlocks/frames);
+	fprintf(stderr, "  convert %u usec, present %u usec\n",
+		stats->convert_usec/frames, stats->present_usec/frames);
+	for ( i = 0; i < stats->num_blitters; ++i ) {
+		fprintf(stderr, "  %s: %u blits (%u pixels)\n",
+			stats->blitters[i].name,
+			stats->blitters[i].blits/frames,
+			stats->blitters[i].pixels/frames);
+	}
+}
+
+void SDL_VideoStatsFrame(void)
+{
+	SDL_videostats.frames += 1;
+	if ( dump_interval && (SDL_videostats.frames >= dump_interval) ) {
+		SDL_DumpVideoStats();
+		SDL_memset(&SDL_videostats, 0, sizeof(SDL_videostats));
+	}
+}
+
+Uint32 SDL_VideoStatsTime(void)
+{
+#if defined(SDL_TIMER_WIN32) || defined(SDL_TIMER_WINCE)
+	static LARGE_INTEGER frequency;
+	LARGE_INTEGER now;
+
+	if ( !frequency.QuadPart ) {
+		if ( !QueryPerformanceFrequency(&frequency) ) {
+			frequency.QuadPart = -1;
+		}
+	}
+	if ( frequency.QuadPart < 0 ) {
+		return(GetTickCount()*1000);
+	}
+	QueryPerformanceCounter(&now);
+	return((Uint32)((now.QuadPart/frequency.QuadPart)*1000000 +
+	       ((now.QuadPart%frequency.QuadPart)*1000000)/frequency.QuadPart));
+#elif defined(SDL_TIMER_UNIX) && HAVE_CLOCK_GETTIME
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return((Uint32)(now.tv_sec*1000000 + now.tv_nsec/1000));
+#elif defined(SDL_TIMER_UNIX)
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+	return((Uint32)(now.tv_sec*1000000 + now.tv_usec));
+#else
+	return(SDL_GetTicks()*1000);
+#endif
+}
@@ -0,0 +1,49 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Useful functions and variables from SDL_videostats.c */
+
+#include "SDL_video.h"
+
+extern int SDL_videostats_enabled;
+extern SDL_VideoStats SDL_videostats;
+
+/* Add to a counter, only when statistics are enabled */
+#define SDL_VIDEOSTATS_ADD(field, n)					\
+	do {								\
+		if ( SDL_videostats_enabled ) {				\
+			SDL_videostats.field += (n);			\
+		}							\
+	} while ( 0 )
+
+/* Read SDL_VIDEO_STATS, called from SDL_VideoInit() */
+extern void SDL_VideoStatsInit(void);
+
+/* Count a blit done with the named routine */
+extern void SDL_VideoStatsBlit(const char *name, Uint32 pixels);
+
+/* Count a frame, and print the statistics when SDL_VIDEO_STATS asks */
+extern void SDL_VideoStatsFrame(void);
+
+/* A clock in microseconds, for timing the conversion and present steps */
+extern Uint32 SDL_VideoStatsTime(void);
@@ -0,0 +1,798 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* SIMD kernels for the software YUV overlay conversion.
+
+   These convert 16 (SSE2, NEON) or 32 (AVX2) pixels at a time to
+   RGB565 or to 32-bit RGB with the red channel in either the high or
+   the low byte.  The fixed point math keeps 5 fractional bits, and
+   a row's leftover pixels go through the same lookup tables as the
+   C conversion.
+ */
+
+#include "SDL_video.h"
+#include "SDL_blit.h"
+#include "SDL_yuv_simd_c.h"
+
+#if SDL_YUV_SSE2 || SDL_YUV_AVX2
+#include <immintrin.h>
+#endif
+/* Output pixel layouts */
+#define OUT_565		0	/* 16-bit R5G6B5 */
+#define OUT_XRGB	1	/* 32-bit, red in bits 16-23 */
+#define OUT_XBGR	2	/* 32-bit, red in bits 0-7 */
+
+#define OUT_BPP(fmt)	(((fmt) == OUT_565) ? 2 : 4)
+
+#if SDL_YUV_SSE2 || SDL_YUV_AVX2 || SDL_YUV_NEON
+
+/* Table lookup conversion of a pair of pixels sharing chroma */
+static __inline__ void TablePixels(int *colortab, Uint32 *rgb_2_pix,
+                                   const Uint8 *lum, int cr, int cb,
+                                   Uint8 *out, int outfmt)
+{
+	int cr_r, crb_g, cb_b;
+	Uint32 p0, p1;
+
+	cr_r   = 0*768+256 + colortab[ cr + 0*256 ];
+	crb_g  = 1*768+256 + colortab[ cr + 1*256 ]
+	                   + colortab[ cb + 2*256 ];
+	cb_b   = 2*768+256 + colortab[ cb + 3*256 ];
+	p0 = rgb_2_pix[ lum[0] + cr_r ] |
+	     rgb_2_pix[ lum[0] + crb_g ] |
+	     rgb_2_pix[ lum[0] + cb_b ];
+	p1 = rgb_2_pix[ lum[1] + cr_r ] |
+	     rgb_2_pix[ lum[1] + crb_g ] |
+	     rgb_2_pix[ lum[1] + cb_b ];
+	if ( outfmt == OUT_565 ) {
+		((Uint16 *)out)[0] = (Uint16)p0;
+		((Uint16 *)out)[1] = (Uint16)p1;
+	} else {
+		((Uint32 *)out)[0] = p0;
+		((Uint32 *)out)[1] = p1;
+	}
+}
+
+/* Finish a planar row pair from column x with the lookup tables */
+static __inline__ void PlanarTail(int *colortab, Uint32 *rgb_2_pix,
+                                  const Uint8 *lum, const Uint8 *lum2,
+                                  const Uint8 *cr, const Uint8 *cb,
+                                  Uint8 *row1, Uint8 *row2,
+                                  int x, int cols, int outfmt)
+{
+	int bpp = OUT_BPP(outfmt);
+
+	for ( ; x+2 <= cols; x += 2 ) {
+		TablePixels(colortab, rgb_2_pix, lum+x, cr[x/2], cb[x/2], row1+x*bpp, outfmt);
+		TablePixels(colortab, rgb_2_pix, lum2+x, cr[x/2], cb[x/2], row2+x*bpp, outfmt);
+	}
+}
+
+/* Finish a packed row from column x with the lookup tables */
+static __inline__ void PackedTail(int *colortab, Uint32 *rgb_2_pix,
+                                  const Uint8 *lum, const Uint8 *cr,
+                                  const Uint8 *cb, Uint8 *row,
+                                  int x, int cols, int outfmt)
+{
+	int bpp = OUT_BPP(outfmt);
+	Uint8 Y[2];
+
+	for ( ; x+2 <= cols; x += 2 ) {
+		Y[0] = lum[x*2];
+		Y[1] = lum[x*2+2];
+		TablePixels(colortab, rgb_2_pix, Y, cr[x*2], cb[x*2], row+x*bpp, outfmt);
+	}
+}
+
+#endif /* SDL_YUV_SSE2 || SDL_YUV_AVX2 || SDL_YUV_NEON */
+
+
+#if SDL_YUV_SSE2
+
+#define SSE2_FUNC	static __attribute__((target("sse2")))
+#define SSE2_INLINE	static __inline__ __attribute__((target("sse2"), always_inline))
+
+typedef struct {
+	__m128i yoff, yscale, rv, gu, gv, bu;
+} SSE2_Coeffs;
+
+SSE2_INLINE void SSE2_LoadCoeffs(SSE2_Coeffs *k, const int *colortab)
+{
+	const int *c = colortab + YUV_COEFFS;
+
+	k->yoff = _mm_set1_epi16((short)((c[YUV_YOFFSET] * c[YUV_YSCALE] + 128) >> 8));
+	k->yscale = _mm_set1_epi16((short)c[YUV_YSCALE]);
+	k->rv = _mm_set1_epi16((short)c[YUV_RV]);
+	k->gu = _mm_set1_epi16((short)c[YUV_GU]);
+	k->gv = _mm_set1_epi16((short)c[YUV_GV]);
+	k->bu = _mm_set1_epi16((short)c[YUV_BU]);
+}
+
+/* Turn 8 chroma bytes into signed (C-128)<<8 words */
+SSE2_INLINE __m128i SSE2_Chroma(__m128i c8)
+{
+	return _mm_xor_si128(_mm_unpacklo_epi8(_mm_setzero_si128(), c8),
+	                     _mm_set1_epi16((short)0x8000));
+}
+
+/* One channel of 8 pixels: (Y + chroma term) with rounding, in bytes */
+SSE2_INLINE __m128i SSE2_Channel(__m128i ylo, __m128i yhi, __m128i tlo, __m128i thi)
+{
+	const __m128i round = _mm_set1_epi16(16);
+	__m128i lo, hi;
+
+	lo = _mm_srai_epi16(_mm_adds_epi16(_mm_adds_epi16(ylo, tlo), round), 5);
+	hi = _mm_srai_epi16(_mm_adds_epi16(_mm_adds_epi16(yhi, thi), round), 5);
+	return _mm_packus_epi16(lo, hi);
+}
+
+SSE2_INLINE void SSE2_Store(Uint8 *out, __m128i R, __m128i G, __m128i B, int outfmt)
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	if ( outfmt == OUT_565 ) {
+		const __m128i rmask = _mm_set1_epi16((short)0xF800);
+		const __m128i gmask = _mm_set1_epi16(0x07E0);
+		__m128i lo, hi;
+
+		/* Each channel unpacked as c<<8, then shifted into place */
+		lo = _mm_or_si128(_mm_and_si128(_mm_unpacklo_epi8(zero, R), rmask),
+		     _mm_or_si128(_mm_and_si128(_mm_srli_epi16(_mm_unpacklo_epi8(zero, G), 5), gmask),
+		                  _mm_srli_epi16(_mm_unpacklo_epi8(zero, B), 11)));
+		hi = _mm_or_si128(_mm_and_si128(_mm_unpackhi_epi8(zero, R), rmask),
+		     _mm_or_si128(_mm_and_si128(_mm_srli_epi16(_mm_unpackhi_epi8(zero, G), 5), gmask),
+		                  _mm_srli_epi16(_mm_unpackhi_epi8(zero, B), 11)));
+		_mm_storeu_si128((__m128i *)out, lo);
+		_mm_storeu_si128((__m128i *)(out+16), hi);
+	} else {
+		__m128i lowc, highc, lo, hi;
+
+		if ( outfmt == OUT_XRGB ) {
+			lowc = B;
+			highc = R;
+		} else {
+			lowc = R;
+			highc = B;
+		}
+		lo = _mm_unpacklo_epi8(lowc, G);
+		hi = _mm_unpacklo_epi8(highc, zero);
+		_mm_storeu_si128((__m128i *)out, _mm_unpacklo_epi16(lo, hi));
+		_mm_storeu_si128((__m128i *)(out+16), _mm_unpackhi_epi16(lo, hi));
+		lo = _mm_unpackhi_epi8(lowc, G);
+		hi = _mm_unpackhi_epi8(highc, zero);
+		_mm_storeu_si128((__m128i *)(out+32), _mm_unpacklo_epi16(lo, hi));
+		_mm_storeu_si128((__m128i *)(out+48), _mm_unpackhi_epi16(lo, hi));
+	}
+}
+
+/* Convert and store 16 pixels of luma, given the chroma terms */
+SSE2_INLINE void SSE2_Row(const SSE2_Coeffs *k, __m128i y,
+                          __m128i rlo, __m128i rhi, __m128i glo, __m128i ghi,
+                          __m128i blo, __m128i bhi, Uint8 *out, int outfmt)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i ylo, yhi;
+
+	ylo = _mm_sub_epi16(_mm_mulhi_epu16(_mm_unpacklo_epi8(zero, y), k->yscale), k->yoff);
+	yhi = _mm_sub_epi16(_mm_mulhi_epu16(_mm_unpackhi_epi8(zero, y), k->yscale), k->yoff);
+	SSE2_Store(out, SSE2_Channel(ylo, yhi, rlo, rhi),
+	                SSE2_Channel(ylo, yhi, glo, ghi),
+	                SSE2_Channel(ylo, yhi, blo, bhi), outfmt);
+}
+
+/* Chroma terms for 16 pixels from 8 signed chroma words */
+#define SSE2_CHROMA_TERMS(k, U, V) \
+	__m128i u0 = _mm_unpacklo_epi16(U, U), u1 = _mm_unpackhi_epi16(U, U); \
+	__m128i v0 = _mm_unpacklo_epi16(V, V), v1 = _mm_unpackhi_epi16(V, V); \
+	__m128i rlo = _mm_mulhi_epi16(v0, (k)->rv); \
+	__m128i rhi = _mm_mulhi_epi16(v1, (k)->rv); \
+	__m128i glo = _mm_adds_epi16(_mm_mulhi_epi16(u0, (k)->gu), _mm_mulhi_epi16(v0, (k)->gv)); \
+	__m128i ghi = _mm_adds_epi16(_mm_mulhi_epi16(u1, (k)->gu), _mm_mulhi_epi16(v1, (k)->gv)); \
+	__m128i blo = _mm_mulhi_epi16(u0, (k)->bu); \
+	__m128i bhi = _mm_mulhi_epi16(u1, (k)->bu)
+
+SSE2_INLINE void SSE2_Planar(int *colortab, Uint32 *rgb_2_pix,
+                             unsigned char *lum, unsigned char *cr,
+                             unsigned char *cb, unsigned char *out,
+                             int rows, int cols, int mod, int outfmt)
+{
+	const int bpp = OUT_BPP(outfmt);
+	const int pitch = (cols + mod) * bpp;
+	SSE2_Coeffs k;
+	int x, y;
+
+	SSE2_LoadCoeffs(&k, colortab);
+	for ( y = rows / 2; y--; ) {
+		Uint8 *lum2 = lum + cols;
+		Uint8 *row1 = out;
+		Uint8 *row2 = out + pitch;
+
+		for ( x = 0; x+16 <= cols; x += 16 ) {
+			__m128i U = SSE2_Chroma(_mm_loadl_epi64((const __m128i *)(cb + x/2)));
+			__m128i V = SSE2_Chroma(_mm_loadl_epi64((const __m128i *)(cr + x/2)));
+			SSE2_CHROMA_TERMS(&k, U, V);
+
+			SSE2_Row(&k, _mm_loadu_si128((const __m128i *)(lum + x)),
+			         rlo, rhi, glo, ghi, blo, bhi, row1 + x*bpp, outfmt);
+			SSE2_Row(&k, _mm_loadu_si128((const __m128i *)(lum2 + x)),
+			         rlo, rhi, glo, ghi, blo, bhi, row2 + x*bpp, outfmt);
+		}
+		PlanarTail(colortab, rgb_2_pix, lum, lum2, cr, cb, row1, row2, x, cols, outfmt);
+
+		lum += 2 * cols;
+		cr += cols / 2;
+		cb += cols / 2;
+		out += 2 * pitch;
+	}
+}
+
+SSE2_INLINE void SSE2_Packed(int *colortab, Uint32 *rgb_2_pix,
+                             unsigned char *lum, unsigned char *cr,
+                             unsigned char *cb, unsigned char *out,
+                             int rows, int cols, int mod, int outfmt)
+{
+	const int bpp = OUT_BPP(outfmt);
+	const int pitch = (cols + mod) * bpp;
+	const __m128i lobyte = _mm_set1_epi16(0x00FF);
+	const __m128i loword = _mm_set1_epi32(0x0000FFFF);
+	/* Byte positions within the 4 byte macropixel */
+	const int yfirst = (lum < cr) && (lum < cb);
+	const int ufirst = (cb < cr);
+	Uint8 *src = SDL_min(lum, SDL_min(cr, cb));
+	SSE2_Coeffs k;
+	int x, y;
+
+	SSE2_LoadCoeffs(&k, colortab);
+	for ( y = rows; y--; ) {
+		for ( x = 0; x+16 <= cols; x += 16 ) {
+			__m128i a = _mm_loadu_si128((const __m128i *)(src + x*2));
+			__m128i b = _mm_loadu_si128((const __m128i *)(src + x*2 + 16));
+			__m128i Y, ca, cc, c0, c1, U, V;
+
+			if ( yfirst ) {
+				Y = _mm_packus_epi16(_mm_and_si128(a, lobyte), _mm_and_si128(b, lobyte));
+				ca = _mm_srli_epi16(a, 8);
+				cc = _mm_srli_epi16(b, 8);
+			} else {
+				Y = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+				ca = _mm_and_si128(a, lobyte);
+				cc = _mm_and_si128(b, lobyte);
+			}
+			/* The first and second chroma sample of each macropixel */
+			c0 = _mm_packs_epi32(_mm_and_si128(ca, loword), _mm_and_si128(cc, loword));
+			c1 = _mm_packs_epi32(_mm_srli_epi32(ca, 16), _mm_srli_epi32(cc, 16));
+			c0 = _mm_xor_si128(_mm_slli_epi16(c0, 8), _mm_set1_epi16((short)0x8000));
+			c1 = _mm_xor_si128(_mm_slli_epi16(c1, 8), _mm_set1_epi16((short)0x8000));
+			U = ufirst ? c0 : c1;
+			V = ufirst ? c1 : c0;
+			{
+				SSE2_CHROMA_TERMS(&k, U, V);
+				SSE2_Row(&k, Y, rlo, rhi, glo, ghi, blo, bhi, out + x*bpp, outfmt);
+			}
+		}
+		PackedTail(colortab, rgb_2_pix, lum, cr, cb, out, x, cols, outfmt);
+
+		src += cols * 2;
+		lum += cols * 2;
+		cr += cols * 2;
+		cb += cols * 2;
+		out += pitch;
+	}
+}
+
+#define SSE2_KERNEL(name, layout, outfmt) \
+SSE2_FUNC void name(int *colortab, Uint32 *rgb_2_pix, \
+                    unsigned char *lum, unsigned char *cr, \
+                    unsigned char *cb, unsigned char *out, \
+                    int rows, int cols, int mod) \
+{ \
+	layout(colortab, rgb_2_pix, lum, cr, cb, out, rows, cols, mod, outfmt); \
+}
+
+SSE2_KERNEL(Color565YV12SSE2, SSE2_Planar, OUT_565)
+SSE2_KERNEL(ColorRGBYV12SSE2, SSE2_Planar, OUT_XRGB)
+SSE2_KERNEL(ColorBGRYV12SSE2, SSE2_Planar, OUT_XBGR)
+SSE2_KERNEL(Color565YUY2SSE2, SSE2_Packed, OUT_565)
+SSE2_KERNEL(ColorRGBYUY2SSE2, SSE2_Packed, OUT_XRGB)
+SSE2_KERNEL(ColorBGRYUY2SSE2, SSE2_Packed, OUT_XBGR)
+
+#endif /* SDL_YUV_SSE2 */
+
+
+#if SDL_YUV_AVX2
+
+#define AVX2_FUNC	static __attribute__((target("avx2")))
+#define AVX2_INLINE	static __inline__ __attribute__((target("avx2"), always_inline))
+
+/* The 256-bit unpack and pack instructions work within each 128-bit
+   half, so the pixels are processed as two interleaved sets of 16 and
+   put back in order when they're stored.
+ */
+
+typedef struct {
+	__m256i yoff, yscale, rv, gu, gv, bu;
+} AVX2_Coeffs;
+
+AVX2_INLINE void AVX2_LoadCoeffs(AVX2_Coeffs *k, const int *colortab)
+{
+	const int *c = colortab + YUV_COEFFS;
+
+	k->yoff = _mm256_set1_epi16((short)((c[YUV_YOFFSET] * c[YUV_YSCALE] + 128) >> 8));
+	k->yscale = _mm256_set1_epi16((short)c[YUV_YSCALE]);
+	k->rv = _mm256_set1_epi16((short)c[YUV_RV]);
+	k->gu = _mm256_set1_epi16((short)c[YUV_GU]);
+	k->gv = _mm256_set1_epi16((short)c[YUV_GV]);
+	k->bu = _mm256_set1_epi16((short)c[YUV_BU]);
+}
+
+AVX2_INLINE __m256i AVX2_Channel(__m256i ylo, __m256i yhi, __m256i tlo, __m256i thi)
+{
+	const __m256i round = _mm256_set1_epi16(16);
+	__m256i lo, hi;
+
+	lo = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(ylo, tlo), round), 5);
+	hi = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(yhi, thi), round), 5);
+	return _mm256_packus_epi16(lo, hi);
+}
+
+/* R, G and B hold pixels 0-31 in order */
+AVX2_INLINE void AVX2_Store(Uint8 *out, __m256i R, __m256i G, __m256i B, int outfmt)
+{
+	const __m256i zero = _mm256_setzero_si256();
+
+	if ( outfmt == OUT_565 ) {
+		const __m256i rmask = _mm256_set1_epi16((short)0xF800);
+		const __m256i gmask = _mm256_set1_epi16(0x07E0);
+		__m256i lo, hi;
+
+		lo = _mm256_or_si256(_mm256_and_si256(_mm256_unpacklo_epi8(zero, R), rmask),
+		     _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(_mm256_unpacklo_epi8(zero, G), 5), gmask),
+		                     _mm256_srli_epi16(_mm256_unpacklo_epi8(zero, B), 11)));
+		hi = _mm256_or_si256(_mm256_and_si256(_mm256_unpackhi_epi8(zero, R), rmask),
+		     _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(_mm256_unpackhi_epi8(zero, G), 5), gmask),
+		                     _mm256_srli_epi16(_mm256_unpackhi_epi8(zero, B), 11)));
+		/* lo has pixels 0-7 and 16-23, hi has 8-15 and 24-31 */
+		_mm256_storeu_si256((__m256i *)out, _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256((__m256i *)(out+32), _mm256_permute2x128_si256(lo, hi, 0x31));
+	} else {
+		__m256i lowc, highc, lo, hi, p0, p1, p2, p3;
+
+		if ( outfmt == OUT_XRGB ) {
+			lowc = B;
+			highc = R;
+		} else {
+			lowc = R;
+			highc = B;
+		}
+		lo = _mm256_unpacklo_epi8(lowc, G);
+		hi = _mm256_unpacklo_epi8(highc, zero);
+		p0 = _mm256_unpacklo_epi16(lo, hi);	/* 0-3, 16-19 */
+		p1 = _mm256_unpackhi_epi16(lo, hi);	/* 4-7, 20-23 */
+		lo = _mm256_unpackhi_epi8(lowc, G);
+		hi = _mm256_unpackhi_epi8(highc, zero);
+		p2 = _mm256_unpacklo_epi16(lo, hi);	/* 8-11, 24-27 */
+		p3 = _mm256_unpackhi_epi16(lo, hi);	/* 12-15, 28-31 */
+		_mm256_storeu_si256((__m256i *)out, _mm256_permute2x128_si256(p0, p1, 0x20));
+		_mm256_storeu_si256((__m256i *)(out+32), _mm256_permute2x128_si256(p2, p3, 0x20));
+		_mm256_storeu_si256((__m256i *)(out+64), _mm256_permute2x128_si256(p0, p1, 0x31));
+		_mm256_storeu_si256((__m256i *)(out+96), _mm256_permute2x128_si256(p2, p3, 0x31));
+	}
+}
+
+/* Convert and store 32 pixels of luma (in order), given the chroma terms */
+AVX2_INLINE void AVX2_Row(const AVX2_Coeffs *k, __m256i y,
+                          __m256i rlo, __m256i rhi, __m256i glo, __m256i ghi,
+                          __m256i blo, __m256i bhi, Uint8 *out, int outfmt)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i ylo, yhi;
+
+	ylo = _mm256_sub_epi16(_mm256_mulhi_epu16(_mm256_unpacklo_epi8(zero, y), k->yscale), k->yoff);
+	yhi = _mm256_sub_epi16(_mm256_mulhi_epu16(_mm256_unpackhi_epi8(zero, y), k->yscale), k->yoff);
+	AVX2_Store(out, AVX2_Channel(ylo, yhi, rlo, rhi),
+	                AVX2_Channel(ylo, yhi, glo, ghi),
+	                AVX2_Channel(ylo, yhi, blo, bhi), outfmt);
+}
+
+/* Chroma terms for 32 pixels from 16 signed chroma words, in order */
+#define AVX2_CHROMA_TERMS(k, U, V) \
+	__m256i u0 = _mm256_unpacklo_epi16(U, U), u1 = _mm256_unpackhi_epi16(U, U); \
+	__m256i v0 = _mm256_unpacklo_epi16(V, V), v1 = _mm256_unpackhi_epi16(V, V); \
+	__m256i rlo = _mm256_mulhi_epi16(v0, (k)->rv); \
+	__m256i rhi = _mm256_mulhi_epi16(v1, (k)->rv); \
+	__m256i glo = _mm256_adds_epi16(_mm256_mulhi_epi16(u0, (k)->gu), _mm256_mulhi_epi16(v0, (k)->gv)); \
+	__m256i ghi = _mm256_adds_epi16(_mm256_mulhi_epi16(u1, (k)->gu), _mm256_mulhi_epi16(v1, (k)->gv)); \
+	__m256i blo = _mm256_mulhi_epi16(u0, (k)->bu); \
+	__m256i bhi = _mm256_mulhi_epi16(u1, (k)->bu)
+
+AVX2_INLINE __m256i AVX2_Chroma(__m128i c8)
+{
+	return _mm256_xor_si256(_mm256_slli_epi16(_mm256_cvtepu8_epi16(c8), 8),
+	                        _mm256_set1_epi16((short)0x8000));
+}
+
+AVX2_INLINE void AVX2_Planar(int *colortab, Uint32 *rgb_2_pix,
+                             unsigned char *lum, unsigned char *cr,
+                             unsigned char *cb, unsigned char *out,
+                             int rows, int cols, int mod, int outfmt)
+{
+	const int bpp = OUT_BPP(outfmt);
+	const int pitch = (cols + mod) * bpp;
+	AVX2_Coeffs k;
+	int x, y;
+
+	AVX2_LoadCoeffs(&k, colortab);
+	for ( y = rows / 2; y--; ) {
+		Uint8 *lum2 = lum + cols;
+		Uint8 *row1 = out;
+		Uint8 *row2 = out + pitch;
+
+		for ( x = 0; x+32 <= cols; x += 32 ) {
+			__m256i U = AVX2_Chroma(_mm_loadu_si128((const __m128i *)(cb + x/2)));
+			__m256i V = AVX2_Chroma(_mm_loadu_si128((const __m128i *)(cr + x/2)));
+			AVX2_CHROMA_TERMS(&k, U, V);
+
+			AVX2_Row(&k, _mm256_loadu_si256((const __m256i *)(lum + x)),
+			         rlo, rhi, glo, ghi, blo, bhi, row1 + x*bpp, outfmt);
+			AVX2_Row(&k, _mm256_loadu_si256((const __m256i *)(lum2 + x)),
+			         rlo, rhi, glo, ghi, blo, bhi, row2 + x*bpp, outfmt);
+		}
+		PlanarTail(colortab, rgb_2_pix, lum, lum2, cr, cb, row1, row2, x, cols, outfmt);
+
+		lum += 2 * cols;
+		cr += cols / 2;
+		cb += cols / 2;
+		out += 2 * pitch;
+	}
+}
+
+AVX2_INLINE void AVX2_Packed(int *colortab, Uint32 *rgb_2_pix,
+                             unsigned char *lum, unsigned char *cr,
+                             unsigned char *cb, unsigned char *out,
+                             int rows, int cols, int mod, int outfmt)
+{
+	const int bpp = OUT_BPP(outfmt);
+	const int pitch = (cols + mod) * bpp;
+	const __m256i lobyte = _mm256_set1_epi16(0x00FF);
+	const __m256i loword = _mm256_set1_epi32(0x0000FFFF);
+	const __m256i sign = _mm256_set1_epi16((short)0x8000);
+	const int yfirst = (lum < cr) && (lum < cb);
+	const int ufirst = (cb < cr);
+	Uint8 *src = SDL_min(lum, SDL_min(cr, cb));
+	AVX2_Coeffs k;
+	int x, y;
+
+	AVX2_LoadCoeffs(&k, colortab);
+	for ( y = rows; y--; ) {
+		for ( x = 0; x+32 <= cols; x += 32 ) {
+			__m256i a = _mm256_loadu_si256((const __m256i *)(src + x*2));
+			__m256i b = _mm256_loadu_si256((const __m256i *)(src + x*2 + 32));
+			__m256i Y, ca, cc, c0, c1, U, V;
+
+			if ( yfirst ) {
+				Y = _mm256_packus_epi16(_mm256_and_si256(a, lobyte), _mm256_and_si256(b, lobyte));
+				ca = _mm256_srli_epi16(a, 8);
+				cc = _mm256_srli_epi16(b, 8);
+			} else {
+				Y = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+				ca = _mm256_and_si256(a, lobyte);
+				cc = _mm256_and_si256(b, lobyte);
+			}
+			c0 = _mm256_packs_epi32(_mm256_and_si256(ca, loword), _mm256_and_si256(cc, loword));
+			c1 = _mm256_packs_epi32(_mm256_srli_epi32(ca, 16), _mm256_srli_epi32(cc, 16));
+			/* Undo the in-lane interleaving of the packs */
+			Y = _mm256_permute4x64_epi64(Y, 0xD8);
+			c0 = _mm256_permute4x64_epi64(c0, 0xD8);
+			c1 = _mm256_permute4x64_epi64(c1, 0xD8);
+			c0 = _mm256_xor_si256(_mm256_slli_epi16(c0, 8), sign);
+			c1 = _mm256_xor_si256(_mm256_slli_epi16(c1, 8), sign);
+			U = ufirst ? c0 : c1;
+			V = ufirst ? c1 : c0;
+			{
+				AVX2_CHROMA_TERMS(&k, U, V);
+				AVX2_Row(&k, Y, rlo, rhi, glo, ghi, blo, bhi, out + x*bpp, outfmt);
+			}
+		}
+		PackedTail(colortab, rgb_2_pix, lum, cr, cb, out, x, cols, outfmt);
+
+		src += cols * 2;
+		lum += cols * 2;
+		cr += cols * 2;
+		cb += cols * 2;
+		out += pitch;
+	}
+}
+
+#define AVX2_KERNEL(name, layout, outfmt) \
+AVX2_FUNC void name(int *colortab, Uint32 *rgb_2_pix, \
+                    unsigned char *lum, unsigned char *cr, \
+                    unsigned char *cb, unsigned char *out, \
+                    int rows, int cols, int mod) \
+{ \
+	layout(colortab, rgb_2_pix, lum, cr, cb, out, rows, cols, mod, outfmt); \
+}
+
+AVX2_KERNEL(Color565YV12AVX2, AVX2_Planar, OUT_565)
+AVX2_KERNEL(ColorRGBYV12AVX2, AVX2_Planar, OUT_XRGB)
+AVX2_KERNEL(ColorBGRYV12AVX2, AVX2_Planar, OUT_XBGR)
+AVX2_KERNEL(Color565YUY2AVX2, AVX2_Packed, OUT_565)
+AVX2_KERNEL(ColorRGBYUY2AVX2, AVX2_Packed, OUT_XRGB)
+AVX2_KERNEL(ColorBGRYUY2AVX2, AVX2_Packed, OUT_XBGR)
+
+#endif /* SDL_YUV_AVX2 */
+
+
+#if SDL_YUV_NEON
+
+#if SDL_YUV_NEON_PRAGMA
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+#include <arm_neon.h>
+
+typedef struct {
+	int16x8_t yoff, yscale, rv, gu, gv, bu;
+} NEON_Coeffs;
+
+static __inline__ void NEON_LoadCoeffs(NEON_Coeffs *k, const int *colortab)
+{
+	const int *c = colortab + YUV_COEFFS;
+
+	k->yoff = vdupq_n_s16((int16_t)((c[YUV_YOFFSET] * c[YUV_YSCALE] + 128) >> 8));
+	k->yscale = vdupq_n_s16((int16_t)c[YUV_YSCALE]);
+	k->rv = vdupq_n_s16((int16_t)c[YUV_RV]);
+	k->gu = vdupq_n_s16((int16_t)c[YUV_GU]);
+	k->gv = vdupq_n_s16((int16_t)c[YUV_GV]);
+	k->bu = vdupq_n_s16((int16_t)c[YUV_BU]);
+}
+
+/* 8 chroma bytes to signed (C-128)<<7 words, so that vqdmulhq_s16()
+   gives the same result as the SSE2 multiply high of (C-128)<<8.
+ */
+static __inline__ int16x8_t NEON_Chroma(uint8x8_t c8)
+{
+	return vshlq_n_s16(vreinterpretq_s16_u16(vsubl_u8(c8, vdup_n_u8(128))), 7);
+}
+
+static __inline__ uint8x8_t NEON_Channel(int16x8_t y, int16x8_t t)
+{
+	return vqmovun_s16(vrshrq_n_s16(vqaddq_s16(y, t), 5));
+}
+
+static __inline__ void NEON_Store(Uint8 *out, uint8x16_t R, uint8x16_t G, uint8x16_t B, int outfmt)
+{
+	if ( outfmt == OUT_565 ) {
+		uint16x8_t lo, hi;
+
+		lo = vshll_n_u8(vget_low_u8(R), 8);
+		lo = vsriq_n_u16(lo, vshll_n_u8(vget_low_u8(G), 8), 5);
+		lo = vsriq_n_u16(lo, vshll_n_u8(vget_low_u8(B), 8), 11);
+		hi = vshll_n_u8(vget_high_u8(R), 8);
+		hi = vsriq_n_u16(hi, vshll_n_u8(vget_high_u8(G), 8), 5);
+		hi = vsriq_n_u16(hi, vshll_n_u8(vget_high_u8(B), 8), 11);
+		vst1q_u16((uint16_t *)out, lo);
+		vst1q_u16((uint16_t *)(out+16), hi);
+	} else {
+		uint8x16x4_t px;
+
+		if ( outfmt == OUT_XRGB ) {
+			px.val[0] = B;
+			px.val[2] = R;
+		} else {
+			px.val[0] = R;
+			px.val[2] = B;
+		}
+		px.val[1] = G;
+		px.val[3] = vdupq_n_u8(0);
+		vst4q_u8(out, px);
+	}
+}
+
+static __inline__ void NEON_Row(const NEON_Coeffs *k, uint8x16_t y,
+                                int16x8x2_t r, int16x8x2_t g, int16x8x2_t b,
+                                Uint8 *out, int outfmt)
+{
+	int16x8_t ylo, yhi;
+
+	ylo = vqdmulhq_s16(vreinterpretq_s16_u16(vshll_n_u8(vget_low_u8(y), 7)), k->yscale);
+	yhi = vqdmulhq_s16(vreinterpretq_s16_u16(vshll_n_u8(vget_high_u8(y), 7)), k->yscale);
+	ylo = vsubq_s16(ylo, k->yoff);
+	yhi = vsubq_s16(yhi, k->yoff);
+	NEON_Store(out,
+	           vcombine_u8(NEON_Channel(ylo, r.val[0]), NEON_Channel(yhi, r.val[1])),
+	           vcombine_u8(NEON_Channel(ylo, g.val[0]), NEON_Channel(yhi, g.val[1])),
+	           vcombine_u8(NEON_Channel(ylo, b.val[0]), NEON_Channel(yhi, b.val[1])),
+	           outfmt);
+}
+
+/* Chroma terms for 16 pixels from 8 chroma samples each */
+static __inline__ void NEON_ChromaTerms(const NEON_Coeffs *k, int16x8_t U, int16x8_t V,
+                                        int16x8x2_t *r, int16x8x2_t *g, int16x8x2_t *b)
+{
+	int16x8_t rt, gt, bt;
+
+	rt = vqdmulhq_s16(V, k->rv);
+	gt = vqaddq_s16(vqdmulhq_s16(U, k->gu), vqdmulhq_s16(V, k->gv));
+	bt = vqdmulhq_s16(U, k->bu);
+	*r = vzipq_s16(rt, rt);
+	*g = vzipq_s16(gt, gt);
+	*b = vzipq_s16(bt, bt);
+}
+
+static __inline__ void NEON_Planar(int *colortab, Uint32 *rgb_2_pix,
+                                   unsigned char *lum, unsigned char *cr,
+                                   unsigned char *cb, unsigned char *out,
+                                   int rows, int cols, int mod, int outfmt)
+{
+	const int bpp = OUT_BPP(outfmt);
+	const int pitch = (cols + mod) * bpp;
+	NEON_Coeffs k;
+	int x, y;
+
+	NEON_LoadCoeffs(&k, colortab);
+	for ( y = rows / 2; y--; ) {
+		Uint8 *lum2 = lum + cols;
+		Uint8 *row1 = out;
+		Uint8 *row2 = out + pitch;
+
+		for ( x = 0; x+16 <= cols; x += 16 ) {
+			int16x8x2_t r, g, b;
+
+			NEON_ChromaTerms(&k, NEON_Chroma(vld1_u8(cb + x/2)),
+			                 NEON_Chroma(vld1_u8(cr + x/2)), &r, &g, &b);
+			NEON_Row(&k, vld1q_u8(lum + x), r, g, b, row1 + x*bpp, outfmt);
+			NEON_Row(&k, vld1q_u8(lum2 + x), r, g, b, row2 + x*bpp, outfmt);
+		}
+		PlanarTail(colortab, rgb_2_pix, lum, lum2, cr, cb, row1, row2, x, cols, outfmt);
+
+		lum += 2 * cols;
+		cr += cols / 2;
+		cb += cols / 2;
+		out += 2 * pitch;
+	}
+}
+
+static __inline__ void NEON_Packed(int *colortab, Uint32 *rgb_2_pix,
+                                   unsigned char *lum, unsigned char *cr,
+                                   unsigned char *cb, unsigned char *out,
+                                   int rows, int cols, int mod, int outfmt)
+{
+	const int bpp = OUT_BPP(outfmt);
+	const int pitch = (cols + mod) * bpp;
+	Uint8 *src = SDL_min(lum, SDL_min(cr, cb));
+	/* Byte positions within the 4 byte macropixel */
+	const int ypos = lum - src;
+	const int upos = cb - src;
+	const int vpos = cr - src;
+	NEON_Coeffs k;
+	int x, y;
+
+	NEON_LoadCoeffs(&k, colortab);
+	for ( y = rows; y--; ) {
+		for ( x = 0; x+16 <= cols; x += 16 ) {
+			uint8x8x4_t m = vld4_u8(src + x*2);
+			uint8x8x2_t Y = vzip_u8(m.val[ypos], m.val[ypos+2]);
+			int16x8x2_t r, g, b;
+
+			NEON_ChromaTerms(&k, NEON_Chroma(m.val[upos]),
+			                 NEON_Chroma(m.val[vpos]), &r, &g, &b);
+			NEON_Row(&k, vcombine_u8(Y.val[0], Y.val[1]), r, g, b, out + x*bpp, outfmt);
+		}
+		PackedTail(colortab, rgb_2_pix, lum, cr, cb, out, x, cols, outfmt);
+
+		src += cols * 2;
+		lum += cols * 2;
+		cr += cols * 2;
+		cb += cols * 2;
+		out += pitch;
+	}
+}
+
+#define NEON_KERNEL(name, layout, outfmt) \
+static void name(int *colortab, Uint32 *rgb_2_pix, \
+                 unsigned char *lum, unsigned char *cr, \
+                 unsigned char *cb, unsigned char *out, \
+                 int rows, int cols, int mod) \
+{ \
+	layout(colortab, rgb_2_pix, lum, cr, cb, out, rows, cols, mod, outfmt); \
+}
+
+NEON_KERNEL(Color565YV12NEON, NEON_Planar, OUT_565)
+NEON_KERNEL(ColorRGBYV12NEON, NEON_Planar, OUT_XRGB)
+NEON_KERNEL(ColorBGRYV12NEON, NEON_Planar, OUT_XBGR)
+NEON_KERNEL(Color565YUY2NEON, NEON_Packed, OUT_565)
+NEON_KERNEL(ColorRGBYUY2NEON, NEON_Packed, OUT_XRGB)
+NEON_KERNEL(ColorBGRYUY2NEON, NEON_Packed, OUT_XBGR)
+
+#if SDL_YUV_NEON_PRAGMA
+#pragma GCC pop_options
+#endif
+
+#endif /* SDL_YUV_NEON */
+
+
+YUVDisplayFunc SDL_GetYUVDisplaySIMD(Uint32 format, SDL_PixelFormat *display)
+{
+	int outfmt, planar;
+
+	if ( (display->BytesPerPixel == 2) &&
+	     (display->Rmask == 0xF800) &&
+	     (display->Gmask == 0x07E0) &&
+	     (display->Bmask == 0x001F) ) {
+		outfmt = OUT_565;
+	} else if ( (display->BytesPerPixel == 4) &&
+	            (display->Rmask == 0x00FF0000) &&
+	            (display->Gmask == 0x0000FF00) &&
+	            (display->Bmask == 0x000000FF) ) {
+		outfmt = OUT_XRGB;
+	} else if ( (display->BytesPerPixel == 4) &&
+	            (display->Rmask == 0x000000FF) &&
+	            (display->Gmask == 0x0000FF00) &&
+	            (display->Bmask == 0x00FF0000) ) {
+		outfmt = OUT_XBGR;
+	} else {
+		return NULL;
+	}
+	switch (format) {
+	    case SDL_YV12_OVERLAY:
+	    case SDL_IYUV_OVERLAY:
+		planar = 1;
+		break;
+	    case SDL_YUY2_OVERLAY:
+	    case SDL_UYVY_OVERLAY:
+	    case SDL_YVYU_OVERLAY:
+		planar = 0;
+		break;
+	    default:
+		return NULL;
+	}
+
+#if SDL_YUV_AVX2
+	if ( SDL_BlitHas(SDL_BLIT_AVX2) ) {
+		static const YUVDisplayFunc avx2[2][3] = {
+			{ Color565YUY2AVX2, ColorRGBYUY2AVX2, ColorBGRYUY2AVX2 },
+			{ Color565YV12AVX2, ColorRGBYV12AVX2, ColorBGRYV12AVX2 }
+		};
+		return avx2[planar][outfmt];
+	}
+#endif
+#if SDL_YUV_SSE2
+	if ( SDL_BlitHas(SDL_BLIT_SSE2) ) {
+		static const YUVDisplayFunc sse2[2][3] = {
+			{ Color565YUY2SSE2, ColorRGBYUY2SSE2, ColorBGRYUY2SSE2 },
+			{ Color565YV12SSE2, ColorRGBYV12SSE2, ColorBGRYV12SSE2 }
+		};
+		return sse2[planar][outfmt];
+	}
+#endif
+#if SDL_YUV_NEON
+	if ( SDL_BlitHas(SDL_BLIT_NEON) ) {
+		static const YUVDisplayFunc neon[2][3] = {
+			{ Color565YUY2NEON, ColorRGBYUY2NEON, ColorBGRYUY2NEON },
+			{ Color565YV12NEON, ColorRGBYV12NEON, ColorBGRYV12NEON }
+		};
+		return neon[planar][outfmt];
+	}
+#endif
+	return NULL;
+}
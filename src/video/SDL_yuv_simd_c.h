@@ -0,0 +1,69 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* SIMD kernels for the software YUV overlay conversion */
+
+#include "SDL_endian.h"
+#include "SDL_video.h"
+
+/* Where the kernels can be built */
+#if SDL_ASSEMBLY_ROUTINES && (SDL_BYTEORDER == SDL_LIL_ENDIAN)
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define SDL_YUV_SSE2	1
+#define SDL_YUV_AVX2	1
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SDL_YUV_NEON	1
+#elif SDL_ARM_NEON_PRAGMA
+/* Built for NEON with a target pragma, and only run if SDL_HasNEON() */
+#define SDL_YUV_NEON	1
+#define SDL_YUV_NEON_PRAGMA	1
+#endif
+#endif
+
+/* The YUV to RGB matrix in use is kept after the colortab lookup
+   tables, as colortab[YUV_COEFFS + YUV_xxx], for the kernels that
+   don't use the tables.  The scale and chroma weights are in units
+   of 1/8192.
+ */
+#define YUV_COEFFS	(4*256)
+enum {
+	YUV_YOFFSET,	/* Black level of the luma (0 or 16) */
+	YUV_YSCALE,	/* Luma gain */
+	YUV_RV,		/* Cr weight in red */
+	YUV_GU,		/* Cb weight in green */
+	YUV_GV,		/* Cr weight in green */
+	YUV_BU,		/* Cb weight in blue */
+	YUV_NUM_COEFFS
+};
+
+typedef void (*YUVDisplayFunc)(int *colortab, Uint32 *rgb_2_pix,
+                               unsigned char *lum, unsigned char *cr,
+                               unsigned char *cb, unsigned char *out,
+                               int rows, int cols, int mod);
+
+/* Returns the fastest 1:1 conversion for this overlay format and
+   display pixel format supported by the CPU, or NULL if there is none.
+ */
+extern YUVDisplayFunc SDL_GetYUVDisplaySIMD(Uint32 format, SDL_PixelFormat *display);
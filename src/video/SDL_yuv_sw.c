@@ -85,9 +85,11 @@
 
 #include "SDL_video.h"
 #include "SDL_cpuinfo.h"
-#include "SDL_stretch_c.h"
+#include "SDL_thread.h"
 #include "SDL_yuvfuncs.h"
 #include "SDL_yuv_sw_c.h"
+#include "SDL_blit.h"
+#include "SDL_yuv_simd_c.h"
 
 /* The functions used to manipulate software video overlays */
 static struct private_yuvhwfuncs sw_yuvfuncs = {
@@ -99,7 +101,6 @@ static struct private_yuvhwfuncs sw_yuvfuncs = {
 
 /* RGB conversion lookup tables */
 struct private_yuvhwdata {
-	SDL_Surface *stretch;
 	SDL_Surface *display;
 	Uint8 *pixels;
 	int *colortab;
@@ -113,6 +114,15 @@ struct private_yuvhwdata {
                           unsigned char *cb, unsigned char *out,
                           int rows, int cols, int mod );
 
+	/* Source column lookup for clipped and scaled display */
+	int filter;
+	int scale_x, scale_w, scale_dstw;
+	int *scale_tab;
+
+	/* Worker threads sharing the conversion, created on first use */
+	int nthreads;
+	struct yuv_workers *workers;
+
 	/* These are just so we don't have to allocate them separately */
 	Uint16 pitches[3];
 	Uint8 *planes[3];
@@ -923,6 +933,98 @@ static int free_bits_at_bottom( Uint32 a )
 }
 
 
+/* YUV to RGB matrices:
+     R = yscale*(Y-yoffset) + rv*(Cr-128)
+     G = yscale*(Y-yoffset) + gu*(Cb-128) + gv*(Cr-128)
+     B = yscale*(Y-yoffset) + bu*(Cb-128)
+ */
+struct yuv_matrix {
+	int yoffset;
+	double yscale;
+	double rv, gu, gv, bu;
+};
+enum {
+	YUV_MATRIX_JPEG,	/* Full range BT.601, as used by JPEG */
+	YUV_MATRIX_BT601,	/* Video range BT.601 (SDTV) */
+	YUV_MATRIX_BT709	/* Video range BT.709 (HDTV) */
+};
+static const struct yuv_matrix yuv_matrices[] = {
+	{  0, 1.0,   1.402, -0.344, -0.714, 1.772 },
+	{ 16, 1.164, 1.596, -0.392, -0.813, 2.017 },
+	{ 16, 1.164, 1.793, -0.213, -0.533, 2.112 }
+};
+
+/* The matrix can be chosen with SDL_VIDEO_YUV_MATRIX=jpeg|bt601|bt709.
+   By default video range is assumed, BT.709 for overlays taller than
+   standard definition and BT.601 otherwise.
+ */
+#define MAX_YUV_THREADS		16
+
+#define YUV_FILTER_NEAREST	0
+#define YUV_FILTER_LINEAR	1
+
+static const struct yuv_matrix *ChooseYUVMatrix(int height)
+{
+	const char *hint = SDL_getenv("SDL_VIDEO_YUV_MATRIX");
+
+	if ( hint ) {
+		if ( SDL_strcasecmp(hint, "jpeg") == 0 ) {
+			return &yuv_matrices[YUV_MATRIX_JPEG];
+		}
+		if ( SDL_strcasecmp(hint, "bt601") == 0 ) {
+			return &yuv_matrices[YUV_MATRIX_BT601];
+		}
+		if ( SDL_strcasecmp(hint, "bt709") == 0 ) {
+			return &yuv_matrices[YUV_MATRIX_BT709];
+		}
+	}
+	if ( height > 576 ) {
+		return &yuv_matrices[YUV_MATRIX_BT709];
+	}
+	return &yuv_matrices[YUV_MATRIX_BT601];
+}
+
+/* The number of threads to use, from SDL_VIDEO_YUV_THREADS or the
+   number of processors online.
+ */
+static int ChooseYUVThreads(void)
+{
+	const char *hint = SDL_getenv("SDL_VIDEO_YUV_THREADS");
+	int n = 1;
+
+#if !SDL_THREADS_DISABLED
+	if ( hint && *hint ) {
+		n = SDL_atoi(hint);
+	} else {
+		n = SDL_GetCPUCount();
+	}
+#endif
+	if ( n < 1 ) {
+		n = 1;
+	} else if ( n > MAX_YUV_THREADS ) {
+		n = MAX_YUV_THREADS;
+	}
+	return n;
+}
+
+/* Scaled overlays use nearest neighbour sampling, unless bilinear
+   filtering is asked for with SDL_VIDEO_YUV_FILTER=linear.
+ */
+static int ChooseYUVFilter(void)
+{
+	const char *hint = SDL_getenv("SDL_VIDEO_YUV_FILTER");
+
+	if ( hint && (SDL_strcasecmp(hint, "linear") == 0) ) {
+		return YUV_FILTER_LINEAR;
+	}
+	return YUV_FILTER_NEAREST;
+}
+
+static int RoundInt( double x )
+{
+	return (int)((x < 0.0) ? (x - 0.5) : (x + 0.5));
+}
+
 SDL_Overlay *SDL_CreateYUV_SW(_THIS, int width, int height, Uint32 format, SDL_Surface *display)
 {
 	SDL_Overlay *overlay;
@@ -937,6 +1039,11 @@ SDL_Overlay *SDL_CreateYUV_SW(_THIS, int width, int height, Uint32 format, SDL_S
 	int i;
 	int CR, CB;
 	Uint32 Rmask, Gmask, Bmask;
+	int rbits, gbits, bbits;
+	int rshift, gshift, bshift;
+	const struct yuv_matrix *matrix;
+	int *coeffs;
+	YUVDisplayFunc simd;
 
 	/* Only RGB packed pixel conversion supported */
 	if ( (display->format->BytesPerPixel != 2) &&
@@ -983,10 +1090,14 @@ SDL_Overlay *SDL_CreateYUV_SW(_THIS, int width, int height, Uint32 format, SDL_S
 		SDL_FreeYUVOverlay(overlay);
 		return(NULL);
 	}
-	swdata->stretch = NULL;
 	swdata->display = display;
+	swdata->filter = ChooseYUVFilter();
+	swdata->scale_w = 0;
+	swdata->scale_tab = NULL;
+	swdata->nthreads = ChooseYUVThreads();
+	swdata->workers = NULL;
 	swdata->pixels = (Uint8 *) SDL_malloc(width*height*2);
-	swdata->colortab = (int *)SDL_malloc(4*256*sizeof(int));
+	swdata->colortab = (int *)SDL_malloc((YUV_COEFFS+YUV_NUM_COEFFS)*sizeof(int));
 	Cr_r_tab = &swdata->colortab[0*256];
 	Cr_g_tab = &swdata->colortab[1*256];
 	Cb_g_tab = &swdata->colortab[2*256];
@@ -1002,30 +1113,50 @@ SDL_Overlay *SDL_CreateYUV_SW(_THIS, int width, int height, Uint32 format, SDL_S
 	}
 
 	/* Generate the tables for the display surface */
+	matrix = ChooseYUVMatrix(height);
 	for (i=0; i<256; i++) {
 		/* Gamma correction (luminescence table) and chroma correction
 		   would be done here.  See the Berkeley mpeg_play sources.
 		*/
 		CB = CR = (i-128);
-		Cr_r_tab[i] = (int) ( (0.419/0.299) * CR);
-		Cr_g_tab[i] = (int) (-(0.299/0.419) * CR);
-		Cb_g_tab[i] = (int) (-(0.114/0.331) * CB); 
-		Cb_b_tab[i] = (int) ( (0.587/0.331) * CB);
+		Cr_r_tab[i] = RoundInt( (matrix->rv/matrix->yscale) * CR);
+		Cr_g_tab[i] = RoundInt( (matrix->gv/matrix->yscale) * CR);
+		Cb_g_tab[i] = RoundInt( (matrix->gu/matrix->yscale) * CB);
+		Cb_b_tab[i] = RoundInt( (matrix->bu/matrix->yscale) * CB);
 	}
+	coeffs = &swdata->colortab[YUV_COEFFS];
+	coeffs[YUV_YOFFSET] = matrix->yoffset;
+	coeffs[YUV_YSCALE] = RoundInt(matrix->yscale * 8192);
+	coeffs[YUV_RV] = RoundInt(matrix->rv * 8192);
+	coeffs[YUV_GU] = RoundInt(matrix->gu * 8192);
+	coeffs[YUV_GV] = RoundInt(matrix->gv * 8192);
+	coeffs[YUV_BU] = RoundInt(matrix->bu * 8192);
 
 	/* 
-	 * Set up entries 0-255 in rgb-to-pixel value tables.
+	 * Set up the rgb-to-pixel value tables.  The middle 256 entries
+	 * map the luma (plus the chroma offset) to the output level, and
+	 * the entries either side clamp so that we do not need to check
+	 * for overflow.
 	 */
 	Rmask = display->format->Rmask;
 	Gmask = display->format->Gmask;
 	Bmask = display->format->Bmask;
-	for ( i=0; i<256; ++i ) {
-		r_2_pix_alloc[i+256] = i >> (8 - number_of_bits_set(Rmask));
-		r_2_pix_alloc[i+256] <<= free_bits_at_bottom(Rmask);
-		g_2_pix_alloc[i+256] = i >> (8 - number_of_bits_set(Gmask));
-		g_2_pix_alloc[i+256] <<= free_bits_at_bottom(Gmask);
-		b_2_pix_alloc[i+256] = i >> (8 - number_of_bits_set(Bmask));
-		b_2_pix_alloc[i+256] <<= free_bits_at_bottom(Bmask);
+	rbits = 8 - number_of_bits_set(Rmask);
+	gbits = 8 - number_of_bits_set(Gmask);
+	bbits = 8 - number_of_bits_set(Bmask);
+	rshift = free_bits_at_bottom(Rmask);
+	gshift = free_bits_at_bottom(Gmask);
+	bshift = free_bits_at_bottom(Bmask);
+	for ( i=0; i<768; ++i ) {
+		int level = RoundInt(matrix->yscale * (i - 256 - matrix->yoffset));
+		if ( level < 0 ) {
+			level = 0;
+		} else if ( level > 255 ) {
+			level = 255;
+		}
+		r_2_pix_alloc[i] = (Uint32)(level >> rbits) << rshift;
+		g_2_pix_alloc[i] = (Uint32)(level >> gbits) << gshift;
+		b_2_pix_alloc[i] = (Uint32)(level >> bbits) << bshift;
 	}
 
 	/*
@@ -1036,26 +1167,13 @@ SDL_Overlay *SDL_CreateYUV_SW(_THIS, int width, int height, Uint32 format, SDL_S
 	 * through a short pointer will lose the top bits anyway.
 	 */
 	if( display->format->BytesPerPixel == 2 ) {
-		for ( i=0; i<256; ++i ) {
-			r_2_pix_alloc[i+256] |= (r_2_pix_alloc[i+256]) << 16;
-			g_2_pix_alloc[i+256] |= (g_2_pix_alloc[i+256]) << 16;
-			b_2_pix_alloc[i+256] |= (b_2_pix_alloc[i+256]) << 16;
+		for ( i=0; i<768; ++i ) {
+			r_2_pix_alloc[i] |= (r_2_pix_alloc[i]) << 16;
+			g_2_pix_alloc[i] |= (g_2_pix_alloc[i]) << 16;
+			b_2_pix_alloc[i] |= (b_2_pix_alloc[i]) << 16;
 		}
 	}
 
-	/*
-	 * Spread out the values we have to the rest of the array so that
-	 * we do not need to check for overflow.
-	 */
-	for ( i=0; i<256; ++i ) {
-		r_2_pix_alloc[i] = r_2_pix_alloc[256];
-		r_2_pix_alloc[i+512] = r_2_pix_alloc[511];
-		g_2_pix_alloc[i] = g_2_pix_alloc[256];
-		g_2_pix_alloc[i+512] = g_2_pix_alloc[511];
-		b_2_pix_alloc[i] = b_2_pix_alloc[256];
-		b_2_pix_alloc[i+512] = b_2_pix_alloc[511];
-	}
-
 	/* You have chosen wisely... */
 	switch (format) {
 	    case SDL_YV12_OVERLAY:
@@ -1063,7 +1181,8 @@ SDL_Overlay *SDL_CreateYUV_SW(_THIS, int width, int height, Uint32 format, SDL_S
 		if ( display->format->BytesPerPixel == 2 ) {
 #if (__GNUC__ > 2) && defined(__i386__) && __OPTIMIZE__ && SDL_ASSEMBLY_ROUTINES
 			/* inline assembly functions */
-			if ( SDL_HasMMX() && (Rmask == 0xF800) &&
+			if ( SDL_BlitHas(SDL_BLIT_MMX) && (matrix == &yuv_matrices[YUV_MATRIX_BT601]) &&
+			                     (Rmask == 0xF800) &&
 			                     (Gmask == 0x07E0) &&
 				             (Bmask == 0x001F) &&
 			                     (width & 15) == 0) {
@@ -1085,7 +1204,8 @@ SDL_Overlay *SDL_CreateYUV_SW(_THIS, int width, int height, Uint32 format, SDL_S
 		if ( display->format->BytesPerPixel == 4 ) {
 #if (__GNUC__ > 2) && defined(__i386__) && __OPTIMIZE__ && SDL_ASSEMBLY_ROUTINES
 			/* inline assembly functions */
-			if ( SDL_HasMMX() && (Rmask == 0x00FF0000) &&
+			if ( SDL_BlitHas(SDL_BLIT_MMX) && (matrix == &yuv_matrices[YUV_MATRIX_BT601]) &&
+			                     (Rmask == 0x00FF0000) &&
 			                     (Gmask == 0x0000FF00) &&
 				             (Bmask == 0x000000FF) && 
 			                     (width & 15) == 0) {
@@ -1121,6 +1241,10 @@ SDL_Overlay *SDL_CreateYUV_SW(_THIS, int width, int height, Uint32 format, SDL_S
 		/* We should never get here (caught above) */
 		break;
 	}
+	simd = SDL_GetYUVDisplaySIMD(format, display->format);
+	if ( simd ) {
+		swdata->Display1X = simd;
+	}
 
 	/* Find the pitch and offset values for the overlay */
 	overlay->pitches = swdata->pitches;
@@ -1164,51 +1288,502 @@ void SDL_UnlockYUV_SW(_THIS, SDL_Overlay *overlay)
 	return;
 }
 
+/* The clipped and scaled display converts only the visible part of
+   the overlay, sampling it straight into the display surface.
+ */
+typedef struct {
+	int *colortab;
+	Uint32 *rgb_2_pix;
+	Uint8 *lum, *cr, *cb;
+	int lpitch;		/* Bytes between luma rows */
+	int cpitch;		/* Bytes between chroma rows */
+	int cshift;		/* Luma to chroma row shift */
+	int filter;
+	const int *xtab;	/* Per destination column sample offsets */
+	int srcy, srch;		/* Visible source rows */
+	int dsth;
+	Uint8 *dstp;
+	int dstpitch;
+	int dstw;
+	int bpp;
+} YUVScaleJob;
+
+/* Entries in the column table per destination pixel */
+#define XTAB_NEAREST	2	/* luma offset, chroma offset */
+#define XTAB_LINEAR	6	/* luma offsets and weight, chroma offsets and weight */
+
+/* Find the samples either side of pos (16.16 fixed point, in units of
+   samples) and the 8-bit weight of the second, staying within [lo,hi]
+ */
+static void LinearTaps( int pos, int lo, int hi, int *i0, int *i1, int *frac )
+{
+	if ( pos < (lo << 16) ) {
+		pos = (lo << 16);
+	}
+	*i0 = (pos >> 16);
+	if ( *i0 >= hi ) {
+		*i0 = *i1 = hi;
+		*frac = 0;
+	} else {
+		*i1 = *i0 + 1;
+		*frac = (pos >> 8) & 0xFF;
+	}
+}
+
+/* Build the column table for the visible source columns */
+static int SetupScaleColumns( struct private_yuvhwdata *swdata, Uint32 format,
+                              int srcx, int srcw, int dstw )
+{
+	int lstep, cstep;
+	int step, pos;
+	int lo, hi;
+	int *xtab;
+	int x;
+
+	if ( swdata->scale_tab && (swdata->scale_x == srcx) &&
+	     (swdata->scale_w == srcw) && (swdata->scale_dstw == dstw) ) {
+		return(0);
+	}
+	if ( swdata->scale_tab ) {
+		SDL_free(swdata->scale_tab);
+	}
+	swdata->scale_tab = (int *)SDL_malloc(dstw*XTAB_LINEAR*sizeof(int));
+	if ( ! swdata->scale_tab ) {
+		swdata->scale_w = 0;
+		SDL_OutOfMemory();
+		return(-1);
+	}
+	swdata->scale_x = srcx;
+	swdata->scale_w = srcw;
+	swdata->scale_dstw = dstw;
+
+	if ( (format == SDL_YV12_OVERLAY) || (format == SDL_IYUV_OVERLAY) ) {
+		lstep = 1;
+		cstep = 1;
+	} else {
+		lstep = 2;
+		cstep = 4;
+	}
+	xtab = swdata->scale_tab;
+	step = (srcw << 16) / dstw;
+	pos = (srcx << 16) + step / 2;
+	if ( swdata->filter == YUV_FILTER_NEAREST ) {
+		for ( x=0; x<dstw; ++x, pos += step ) {
+			*xtab++ = (pos >> 16) * lstep;
+			*xtab++ = (pos >> 17) * cstep;
+		}
+	} else {
+		int i0, i1, frac;
+
+		/* Positions relative to the sample centers */
+		pos -= 0x8000;
+		for ( x=0; x<dstw; ++x, pos += step ) {
+			LinearTaps(pos, srcx, srcx+srcw-1, &i0, &i1, &frac);
+			*xtab++ = i0 * lstep;
+			*xtab++ = i1 * lstep;
+			*xtab++ = frac;
+			lo = srcx / 2;
+			hi = (srcx+srcw-1) / 2;
+			LinearTaps((pos - 0x8000) / 2, lo, hi, &i0, &i1, &frac);
+			*xtab++ = i0 * cstep;
+			*xtab++ = i1 * cstep;
+			*xtab++ = frac;
+		}
+	}
+	return(0);
+}
+
+static __inline__ void StorePixel( Uint8 *dstp, int bpp, Uint32 pixel )
+{
+	switch (bpp) {
+	    case 2:
+		*(Uint16 *)dstp = (Uint16)pixel;
+		break;
+	    case 3:
+		dstp[0] = (pixel      ) & 0xFF;
+		dstp[1] = (pixel >>  8) & 0xFF;
+		dstp[2] = (pixel >> 16) & 0xFF;
+		break;
+	    default:
+		*(Uint32 *)dstp = pixel;
+		break;
+	}
+}
+
+static __inline__ Uint32 YUVToPixel( int *colortab, Uint32 *rgb_2_pix,
+                                     int L, int CR, int CB )
+{
+	int cr_r, crb_g, cb_b;
+
+	cr_r   = 0*768+256 + colortab[ CR + 0*256 ];
+	crb_g  = 1*768+256 + colortab[ CR + 1*256 ]
+	                   + colortab[ CB + 2*256 ];
+	cb_b   = 2*768+256 + colortab[ CB + 3*256 ];
+	return (rgb_2_pix[ L + cr_r ] |
+	        rgb_2_pix[ L + crb_g ] |
+	        rgb_2_pix[ L + cb_b ]);
+}
+
+/* Convert destination rows [first,last) of a scaled display.
+   Rows are independent, so a job can be split up between threads.
+ */
+static void ScaleYUVRows( const YUVScaleJob *job, int first, int last )
+{
+	int *colortab = job->colortab;
+	Uint32 *rgb_2_pix = job->rgb_2_pix;
+	const int bpp = job->bpp;
+	const int *xtab;
+	Uint8 *dstp;
+	int step, pos;
+	int lastsy = -1;
+	int x, y;
+
+	step = (job->srch << 16) / job->dsth;
+	pos = (job->srcy << 16) + step / 2 + first * step;
+	dstp = job->dstp + first * job->dstpitch;
+	for ( y=first; y<last; ++y, pos += step, dstp += job->dstpitch ) {
+		Uint8 *out = dstp;
+
+		xtab = job->xtab;
+		if ( job->filter == YUV_FILTER_NEAREST ) {
+			int sy = (pos >> 16);
+			const Uint8 *lum = job->lum + sy * job->lpitch;
+			const Uint8 *cr = job->cr + (sy >> job->cshift) * job->cpitch;
+			const Uint8 *cb = job->cb + (sy >> job->cshift) * job->cpitch;
+			int loff = -1, coff = -1;
+			Uint32 pixel = 0;
+
+			/* Upscaled rows repeat, as do pixels within them */
+			if ( (y > first) && (sy == lastsy) ) {
+				SDL_memcpy(dstp, dstp - job->dstpitch, job->dstw * bpp);
+				continue;
+			}
+			lastsy = sy;
+			for ( x=job->dstw; x--; xtab += XTAB_NEAREST, out += bpp ) {
+				if ( (xtab[0] != loff) || (xtab[1] != coff) ) {
+					loff = xtab[0];
+					coff = xtab[1];
+					pixel = YUVToPixel(colortab, rgb_2_pix,
+					                   lum[loff], cr[coff], cb[coff]);
+				}
+				StorePixel(out, bpp, pixel);
+			}
+		} else {
+			const Uint8 *lum0, *lum1, *cr0, *cr1, *cb0, *cb1;
+			int i0, i1, yf, cf;
+			int lo, hi;
+			int L, CR, CB;
+
+			LinearTaps(pos - 0x8000, job->srcy, job->srcy+job->srch-1,
+			           &i0, &i1, &yf);
+			lum0 = job->lum + i0 * job->lpitch;
+			lum1 = job->lum + i1 * job->lpitch;
+			if ( job->cshift ) {
+				lo = job->srcy / 2;
+				hi = (job->srcy+job->srch-1) / 2;
+				LinearTaps((pos - 0x10000) / 2, lo, hi, &i0, &i1, &cf);
+			} else {
+				cf = yf;
+			}
+			cr0 = job->cr + i0 * job->cpitch;
+			cr1 = job->cr + i1 * job->cpitch;
+			cb0 = job->cb + i0 * job->cpitch;
+			cb1 = job->cb + i1 * job->cpitch;
+
+#define LERP2D(r0, r1, a, b, xf, yf) \
+	(((((r0)[a] * (256-(xf)) + (r0)[b] * (xf)) * (256-(yf)) + \
+	   ((r1)[a] * (256-(xf)) + (r1)[b] * (xf)) * (yf)) + 32768) >> 16)
+
+			for ( x=job->dstw; x--; xtab += XTAB_LINEAR, out += bpp ) {
+				L = LERP2D(lum0, lum1, xtab[0], xtab[1], xtab[2], yf);
+				CR = LERP2D(cr0, cr1, xtab[3], xtab[4], xtab[5], cf);
+				CB = LERP2D(cb0, cb1, xtab[3], xtab[4], xtab[5], cf);
+				StorePixel(out, bpp, YUVToPixel(colortab, rgb_2_pix,
+				           L, CR, CB));
+			}
+#undef LERP2D
+		}
+	}
+}
+
+/* A frame's conversion, split into horizontal stripes */
+typedef struct {
+	int scale;		/* 0 for 1X, 1 for 2X, 2 for the scaled display */
+	YUVDisplayFunc display;
+	int *colortab;
+	Uint32 *rgb_2_pix;
+	Uint8 *lum, *cr, *cb;
+	Uint8 *dstp;
+	int rows, cols, mod;
+	int planar;
+	int dstpitch;
+	YUVScaleJob *scaled;
+} YUVStripeJob;
+
+/* Stripes smaller than this aren't worth handing to another thread */
+#define MIN_STRIPE_PIXELS	(64*1024)
+
+/* Convert stripe i of n.  Overlay stripes start on an even row so
+   that they don't split the chroma of a planar overlay.
+ */
+static void RunYUVStripe( const YUVStripeJob *job, int i, int n )
+{
+	int height, first, rows;
+	int lumoff, choff, outrows;
+
+	height = (job->rows / n) & ~1;
+	first = i * height;
+	if ( i == n-1 ) {
+		rows = job->rows - first;
+	} else {
+		rows = height;
+	}
+	if ( rows <= 0 ) {
+		return;
+	}
+	if ( job->scale == 2 ) {
+		ScaleYUVRows(job->scaled, first, first + rows);
+		return;
+	}
+	if ( job->planar ) {
+		lumoff = first * job->cols;
+		choff = (first / 2) * (job->cols / 2);
+	} else {
+		lumoff = choff = first * job->cols * 2;
+	}
+	outrows = job->scale ? first * 2 : first;
+	job->display(job->colortab, job->rgb_2_pix,
+	             job->lum + lumoff, job->cr + choff, job->cb + choff,
+	             job->dstp + outrows * job->dstpitch,
+	             rows, job->cols, job->mod);
+}
+
+#if SDL_THREADS_DISABLED
+
+static void RunYUVJob( struct private_yuvhwdata *swdata, const YUVStripeJob *job )
+{
+	RunYUVStripe(job, 0, 1);
+}
+
+static void QuitYUVWorkers( struct private_yuvhwdata *swdata )
+{
+}
+
+#else
+
+struct yuv_workers {
+	int nthreads;		/* Including the displaying thread */
+	SDL_Thread *threads[MAX_YUV_THREADS];
+	SDL_mutex *lock;
+	SDL_cond *wake;
+	SDL_cond *done;
+	int generation;		/* Bumped for each frame */
+	int pending;		/* Workers yet to finish the frame */
+	int quit;
+	const YUVStripeJob *job;
+};
+
+struct yuv_worker_arg {
+	struct yuv_workers *workers;
+	int index;
+};
+
+static int SDLCALL YUVWorker( void *data )
+{
+	struct yuv_worker_arg arg = *(struct yuv_worker_arg *)data;
+	struct yuv_workers *workers = arg.workers;
+	int generation = 0;
+
+	SDL_free(data);
+	SDL_mutexP(workers->lock);
+	for ( ; ; ) {
+		while ( !workers->quit && (workers->generation == generation) ) {
+			SDL_CondWait(workers->wake, workers->lock);
+		}
+		if ( workers->quit ) {
+			break;
+		}
+		generation = workers->generation;
+		SDL_mutexV(workers->lock);
+
+		RunYUVStripe(workers->job, arg.index, workers->nthreads);
+
+		SDL_mutexP(workers->lock);
+		if ( --workers->pending == 0 ) {
+			SDL_CondSignal(workers->done);
+		}
+	}
+	SDL_mutexV(workers->lock);
+	return(0);
+}
+
+static void QuitYUVWorkers( struct private_yuvhwdata *swdata )
+{
+	struct yuv_workers *workers = swdata->workers;
+	int i;
+
+	if ( ! workers ) {
+		return;
+	}
+	if ( workers->lock ) {
+		SDL_mutexP(workers->lock);
+		workers->quit = 1;
+		SDL_CondBroadcast(workers->wake);
+		SDL_mutexV(workers->lock);
+	}
+	for ( i=1; i<workers->nthreads; ++i ) {
+		if ( workers->threads[i] ) {
+			SDL_WaitThread(workers->threads[i], NULL);
+		}
+	}
+	if ( workers->done ) {
+		SDL_DestroyCond(workers->done);
+	}
+	if ( workers->wake ) {
+		SDL_DestroyCond(workers->wake);
+	}
+	if ( workers->lock ) {
+		SDL_DestroyMutex(workers->lock);
+	}
+	SDL_free(workers);
+	swdata->workers = NULL;
+}
+
+/* Start the worker threads.  If they can't be started the conversion
+   is done on the displaying thread alone.
+ */
+static void InitYUVWorkers( struct private_yuvhwdata *swdata )
+{
+	struct yuv_workers *workers;
+	struct yuv_worker_arg *arg;
+	SDL_ThreadAttr attr;
+	int i;
+
+	workers = (struct yuv_workers *)SDL_malloc(sizeof(*workers));
+	if ( ! workers ) {
+		swdata->nthreads = 1;
+		return;
+	}
+	SDL_memset(workers, 0, sizeof(*workers));
+	swdata->workers = workers;
+	workers->nthreads = 1;
+	workers->lock = SDL_CreateMutex();
+	workers->wake = SDL_CreateCond();
+	workers->done = SDL_CreateCond();
+	if ( ! workers->lock || ! workers->wake || ! workers->done ) {
+		QuitYUVWorkers(swdata);
+		swdata->nthreads = 1;
+		return;
+	}
+	SDL_InitThreadAttr(&attr);
+	attr.name = "SDLYUV";
+	for ( i=1; i<swdata->nthreads; ++i ) {
+		arg = (struct yuv_worker_arg *)SDL_malloc(sizeof(*arg));
+		if ( ! arg ) {
+			break;
+		}
+		arg->workers = workers;
+		arg->index = i;
+#if (defined(__WIN32__) && !defined(_WIN32_WCE)) && !defined(HAVE_LIBC) && !defined(__SYMBIAN32__)
+#undef SDL_CreateThreadEx
+		workers->threads[i] = SDL_CreateThreadEx(YUVWorker, arg, &attr, NULL, NULL);
+#else
+		workers->threads[i] = SDL_CreateThreadEx(YUVWorker, arg, &attr);
+#endif
+		if ( ! workers->threads[i] ) {
+			SDL_free(arg);
+			break;
+		}
+		workers->nthreads = i+1;
+	}
+	swdata->nthreads = workers->nthreads;
+	if ( swdata->nthreads == 1 ) {
+		QuitYUVWorkers(swdata);
+	}
+}
+
+/* Convert a frame, sharing the stripes between the worker threads,
+   and wait for all of them to finish.
+ */
+static void RunYUVJob( struct private_yuvhwdata *swdata, const YUVStripeJob *job )
+{
+	struct yuv_workers *workers;
+	int pixels, n;
+
+	if ( (swdata->nthreads > 1) && ! swdata->workers ) {
+		InitYUVWorkers(swdata);
+	}
+	workers = swdata->workers;
+	if ( ! workers ) {
+		RunYUVStripe(job, 0, 1);
+		return;
+	}
+	pixels = job->rows * job->cols;
+	if ( job->scale == 2 ) {
+		pixels = job->rows * job->scaled->dstw;
+	}
+	n = workers->nthreads;
+	if ( (pixels / n < MIN_STRIPE_PIXELS) || (job->rows < 2*n) ) {
+		RunYUVStripe(job, 0, 1);
+		return;
+	}
+
+	SDL_mutexP(workers->lock);
+	workers->job = job;
+	workers->pending = n-1;
+	++workers->generation;
+	SDL_CondBroadcast(workers->wake);
+	SDL_mutexV(workers->lock);
+
+	RunYUVStripe(job, 0, n);
+
+	SDL_mutexP(workers->lock);
+	while ( workers->pending > 0 ) {
+		SDL_CondWait(workers->done, workers->lock);
+	}
+	SDL_mutexV(workers->lock);
+}
+
+#endif /* SDL_THREADS_DISABLED */
+
 int SDL_DisplayYUV_SW(_THIS, SDL_Overlay *overlay, SDL_Rect *src, SDL_Rect *dst)
 {
 	struct private_yuvhwdata *swdata;
-	int stretch;
+	int scaled;
 	int scale_2x;
 	SDL_Surface *display;
 	Uint8 *lum, *Cr, *Cb;
 	Uint8 *dstp;
 	int mod;
+	YUVStripeJob job;
+	YUVScaleJob scale;
 
 	swdata = overlay->hwdata;
-	stretch = 0;
+	display = swdata->display;
+	scaled = 0;
 	scale_2x = 0;
 	if ( src->x || src->y || src->w < overlay->w || src->h < overlay->h ) {
-		/* The source rectangle has been clipped.
-		   Using a scratch surface is easier than adding clipped
-		   source support to all the blitters, plus that would
-		   slow them down in the general unclipped case.
+		/* The source rectangle has been clipped, so only the
+		   visible part is converted, by the scaling code.
 		*/
-		stretch = 1;
+		scaled = 1;
 	} else if ( (src->w != dst->w) || (src->h != dst->h) ) {
 		if ( (dst->w == 2*src->w) &&
-		     (dst->h == 2*src->h) ) {
+		     (dst->h == 2*src->h) &&
+		     (swdata->filter == YUV_FILTER_NEAREST) ) {
 			scale_2x = 1;
 		} else {
-			stretch = 1;
+			scaled = 1;
 		}
 	}
-	if ( stretch ) {
-		if ( ! swdata->stretch ) {
-			display = swdata->display;
-			swdata->stretch = SDL_CreateRGBSurface(
-				SDL_SWSURFACE,
-				overlay->w, overlay->h,
-				display->format->BitsPerPixel,
-				display->format->Rmask,
-				display->format->Gmask,
-				display->format->Bmask, 0);
-			if ( ! swdata->stretch ) {
-				return(-1);
-			}
+	if ( scaled ) {
+		if ( (dst->w <= 0) || (dst->h <= 0) ) {
+			return(0);
+		}
+		if ( SetupScaleColumns(swdata, overlay->format,
+		                       src->x, src->w, dst->w) < 0 ) {
+			return(-1);
 		}
-		display = swdata->stretch;
-	} else {
-		display = swdata->display;
 	}
 	switch (overlay->format) {
 	    case SDL_YV12_OVERLAY:
@@ -1245,31 +1820,66 @@ int SDL_DisplayYUV_SW(_THIS, SDL_Overlay *overlay, SDL_Rect *src, SDL_Rect *dst)
 			return(-1);
 		}
 	}
-	if ( stretch ) {
-		dstp = (Uint8 *)swdata->stretch->pixels;
-	} else {
-		dstp = (Uint8 *)display->pixels
-			+ dst->x * display->format->BytesPerPixel
-			+ dst->y * display->pitch;
-	}
+	dstp = (Uint8 *)display->pixels
+		+ dst->x * display->format->BytesPerPixel
+		+ dst->y * display->pitch;
 	mod = (display->pitch / display->format->BytesPerPixel);
 
-	if ( scale_2x ) {
+	job.colortab = swdata->colortab;
+	job.rgb_2_pix = swdata->rgb_2_pix;
+	job.lum = lum;
+	job.cr = Cr;
+	job.cb = Cb;
+	job.dstp = dstp;
+	job.dstpitch = display->pitch;
+	job.planar = (overlay->planes == 3);
+	if ( scaled ) {
+		scale.colortab = swdata->colortab;
+		scale.rgb_2_pix = swdata->rgb_2_pix;
+		scale.lum = lum;
+		scale.cr = Cr;
+		scale.cb = Cb;
+		if ( job.planar ) {
+			scale.lpitch = overlay->pitches[0];
+			scale.cpitch = overlay->pitches[1];
+			scale.cshift = 1;
+		} else {
+			scale.lpitch = overlay->pitches[0];
+			scale.cpitch = overlay->pitches[0];
+			scale.cshift = 0;
+		}
+		scale.filter = swdata->filter;
+		scale.xtab = swdata->scale_tab;
+		scale.srcy = src->y;
+		scale.srch = src->h;
+		scale.dsth = dst->h;
+		scale.dstp = dstp;
+		scale.dstpitch = display->pitch;
+		scale.dstw = dst->w;
+		scale.bpp = display->format->BytesPerPixel;
+		job.scale = 2;
+		job.scaled = &scale;
+		job.rows = dst->h;
+		job.cols = dst->w;
+	} else if ( scale_2x ) {
 		mod -= (overlay->w * 2);
-		swdata->Display2X(swdata->colortab, swdata->rgb_2_pix,
-		                  lum, Cr, Cb, dstp, overlay->h, overlay->w, mod);
+		job.scale = 1;
+		job.display = swdata->Display2X;
+		job.rows = overlay->h;
+		job.cols = overlay->w;
+		job.mod = mod;
 	} else {
 		mod -= overlay->w;
-		swdata->Display1X(swdata->colortab, swdata->rgb_2_pix,
-		                  lum, Cr, Cb, dstp, overlay->h, overlay->w, mod);
+		job.scale = 0;
+		job.display = swdata->Display1X;
+		job.rows = overlay->h;
+		job.cols = overlay->w;
+		job.mod = mod;
 	}
+	RunYUVJob(swdata, &job);
 	if ( SDL_MUSTLOCK(display) ) {
 		SDL_UnlockSurface(display);
 	}
-	if ( stretch ) {
-		display = swdata->display;
-		SDL_SoftStretch(swdata->stretch, src, display, dst);
-	}
 	SDL_UpdateRects(display, 1, dst);
 
 	return(0);
@@ -1281,8 +1891,9 @@ void SDL_FreeYUV_SW(_THIS, SDL_Overlay *overlay)
 
 	swdata = overlay->hwdata;
 	if ( swdata ) {
-		if ( swdata->stretch ) {
-			SDL_FreeSurface(swdata->stretch);
+		QuitYUVWorkers(swdata);
+		if ( swdata->scale_tab ) {
+			SDL_free(swdata->scale_tab);
 		}
 		if ( swdata->pixels ) {
 			SDL_free(swdata->pixels);
@@ -0,0 +1,484 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Frame capture for the dummy video driver.
+
+   Each display update is published as a frame: to a ring of frames in
+   POSIX shared memory, and/or to a stream of PPM or raw images, paced
+   to an optional frame rate.  See SDL_dummycapture.h for the settings
+   and the shared memory layout.
+ */
+
+#if SDL_VIDEO_DRIVER_DUMMY_SHM
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include "SDL_timer.h"
+#include "SDL_atomic.h"
+#include "SDL_dummycapture.h"
+#include "SDL_nullcapture_c.h"
+
+#define DEFAULT_SHM_FRAMES	3
+#define MAX_SHM_FRAMES		64
+
+/* Round up to keep every frame slot cache line aligned */
+#define ALIGN64(x)	(((x) + 63) & ~63)
+
+
+/* Frame rate limiting */
+
+static void PaceFrame(_THIS)
+{
+	Uint32 fps = this->hidden->fps;
+	Uint32 now, due;
+
+	if ( ! fps ) {
+		return;
+	}
+	now = SDL_GetTicks();
+	due = this->hidden->pace_start + (this->hidden->pace_frames * 1000) / fps;
+	if ( (Sint32)(due - now) > 0 ) {
+		SDL_Delay(due - now);
+	} else if ( (now - due) > (1000 / fps) ) {
+		/* We're more than a frame late, start a new schedule
+		   rather than rushing out frames to catch up.
+		 */
+		this->hidden->pace_start = now;
+		this->hidden->pace_frames = 0;
+	}
+
+	/* Keep pace_frames small so the arithmetic above can't overflow */
+	if ( ++this->hidden->pace_frames == fps ) {
+		this->hidden->pace_start += 1000;
+		this->hidden->pace_frames = 0;
+	}
+}
+
+
+/* Shared memory frame ring */
+
+#if SDL_VIDEO_DRIVER_DUMMY_SHM
+
+static void CloseShm(_THIS)
+{
+	SDL_DummyCaptureHeader *header;
+
+	if ( this->hidden->shm ) {
+		/* Tell readers to let go before the object disappears */
+		header = (SDL_DummyCaptureHeader *)this->hidden->shm;
+		header->magic = 0;
+		SDL_MemoryBarrier();
+		munmap(this->hidden->shm, this->hidden->shm_size);
+		this->hidden->shm = NULL;
+		shm_unlink(this->hidden->shm_name);
+	}
+	if ( this->hidden->shm_name ) {
+		SDL_free(this->hidden->shm_name);
+		this->hidden->shm_name = NULL;
+	}
+	if ( this->hidden->damage ) {
+		SDL_free(this->hidden->damage);
+		this->hidden->damage = NULL;
+	}
+}
+
+static int OpenShm(_THIS, const char *name, SDL_Surface *current)
+{
+	SDL_DummyCaptureHeader *header;
+	const char *env;
+	Uint32 nframes, frame_offset, frame_size;
+	void *mem;
+	int fd;
+
+	nframes = DEFAULT_SHM_FRAMES;
+	env = SDL_getenv("SDL_VIDEO_DUMMY_SHM_FRAMES");
+	if ( env ) {
+		nframes = SDL_atoi(env);
+		if ( nframes < 1 ) {
+			nframes = 1;
+		} else if ( nframes > MAX_SHM_FRAMES ) {
+			nframes = MAX_SHM_FRAMES;
+		}
+	}
+	frame_offset = ALIGN64(sizeof(*header));
+	frame_size = ALIGN64(sizeof(SDL_DummyCaptureFrame) + current->pitch * current->h);
+
+	this->hidden->shm_name = SDL_strdup(name);
+	this->hidden->damage = (SDL_Rect *)SDL_malloc(nframes * sizeof(SDL_Rect));
+	if ( ! this->hidden->shm_name || ! this->hidden->damage ) {
+		CloseShm(this);
+		SDL_OutOfMemory();
+		return(-1);
+	}
+
+	fd = shm_open(name, O_RDWR|O_CREAT|O_TRUNC, 0600);
+	if ( fd < 0 ) {
+		CloseShm(this);
+		SDL_SetError("Couldn't create shared memory object %s", name);
+		return(-1);
+	}
+	this->hidden->shm_size = frame_offset + nframes * frame_size;
+	if ( ftruncate(fd, this->hidden->shm_size) < 0 ) {
+		close(fd);
+		shm_unlink(name);
+		CloseShm(this);
+		SDL_SetError("Couldn't size shared memory object %s", name);
+		return(-1);
+	}
+	mem = mmap(NULL, this->hidden->shm_size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if ( mem == MAP_FAILED ) {
+		shm_unlink(name);
+		CloseShm(this);
+		SDL_SetError("Couldn't map shared memory object %s", name);
+		return(-1);
+	}
+	this->hidden->shm = (Uint8 *)mem;
+
+	/* The slots are empty, so the first frame in each is a full copy */
+	SDL_memset(this->hidden->damage, 0, nframes * sizeof(SDL_Rect));
+	this->hidden->shm_published = 0;
+
+	header = (SDL_DummyCaptureHeader *)this->hidden->shm;
+	header->version = SDL_DUMMYCAPTURE_VERSION;
+	header->nframes = nframes;
+	header->frame_offset = frame_offset;
+	header->frame_size = frame_size;
+	header->w = current->w;
+	header->h = current->h;
+	header->pitch = current->pitch;
+	header->BitsPerPixel = current->format->BitsPerPixel;
+	header->Rmask = current->format->Rmask;
+	header->Gmask = current->format->Gmask;
+	header->Bmask = current->format->Bmask;
+	header->Amask = current->format->Amask;
+	header->fps = this->hidden->fps;
+	header->sequence = 0;
+	SDL_MemoryBarrier();
+	header->magic = SDL_DUMMYCAPTURE_MAGIC;
+	return(0);
+}
+
+static void PublishShm(_THIS, const SDL_Rect *bounds, int numrects, SDL_Rect *rects)
+{
+	SDL_DummyCaptureHeader *header;
+	SDL_DummyCaptureFrame *frame;
+	Uint32 seq = this->hidden->frame;
+	Uint32 nframes, i;
+	int x1, y1, x2, y2;
+	Uint8 *src, *dst;
+	int pitch, bpp, row;
+
+	header = (SDL_DummyCaptureHeader *)this->hidden->shm;
+	nframes = header->nframes;
+	frame = (SDL_DummyCaptureFrame *)(this->hidden->shm + header->frame_offset +
+	                                  (seq % nframes) * header->frame_size);
+
+	/* The slot holds the frame from nframes updates ago, so copy
+	   everything that changed since then: this update and the ones
+	   recorded for the other slots.  A slot that has never been
+	   written holds no frame at all and gets a full copy.
+	 */
+	this->hidden->damage[seq % nframes] = *bounds;
+	if ( this->hidden->shm_published < nframes ) {
+		++this->hidden->shm_published;
+		x1 = 0;
+		y1 = 0;
+		x2 = this->hidden->w;
+		y2 = this->hidden->h;
+	} else {
+		x1 = this->hidden->w;
+		y1 = this->hidden->h;
+		x2 = 0;
+		y2 = 0;
+	}
+	for ( i=0; i<nframes; ++i ) {
+		const SDL_Rect *r = &this->hidden->damage[i];
+		if ( r->w && r->h ) {
+			if ( r->x < x1 ) x1 = r->x;
+			if ( r->y < y1 ) y1 = r->y;
+			if ( r->x + r->w > x2 ) x2 = r->x + r->w;
+			if ( r->y + r->h > y2 ) y2 = r->y + r->h;
+		}
+	}
+
+	frame->sequence = 0;
+	SDL_MemoryBarrier();
+
+	if ( (x1 < x2) && (y1 < y2) ) {
+		pitch = header->pitch;
+		bpp = this->screen->format->BytesPerPixel;
+		src = (Uint8 *)this->hidden->buffer + y1 * pitch + x1 * bpp;
+		dst = (Uint8 *)(frame + 1) + y1 * pitch + x1 * bpp;
+		for ( row = y1; row < y2; ++row ) {
+			SDL_memcpy(dst, src, (x2 - x1) * bpp);
+			src += pitch;
+			dst += pitch;
+		}
+	}
+	frame->ticks = SDL_GetTicks();
+	if ( numrects > SDL_DUMMYCAPTURE_MAXRECTS ) {
+		frame->numrects = 0;
+	} else {
+		frame->numrects = numrects;
+		SDL_memcpy(frame->rects, rects, numrects * sizeof(*rects));
+	}
+
+	SDL_MemoryBarrier();
+	frame->sequence = seq;
+	header->sequence = seq;
+}
+
+#endif /* SDL_VIDEO_DRIVER_DUMMY_SHM */
+
+
+/* Image stream output */
+
+#ifdef HAVE_STDIO_H
+
+static int OpenOutput(_THIS, const char *path)
+{
+	const char *format;
+
+	format = SDL_getenv("SDL_VIDEO_DUMMY_FORMAT");
+	this->hidden->output_ppm = (!format || SDL_strcasecmp(format, "raw") != 0);
+
+	if ( SDL_strcmp(path, "-") == 0 ) {
+		this->hidden->output = stdout;
+#ifdef HAVE_POPEN
+	} else if ( *path == '|' ) {
+		this->hidden->output = popen(path+1, "w");
+		this->hidden->output_pipe = 1;
+#endif
+	} else {
+		this->hidden->output = fopen(path, "wb");
+	}
+	if ( this->hidden->output == NULL ) {
+		SDL_SetError("Couldn't open frame output %s", path);
+		return(-1);
+	}
+	return(0);
+}
+
+static void CloseOutput(_THIS)
+{
+	if ( this->hidden->output ) {
+#ifdef HAVE_POPEN
+		if ( this->hidden->output_pipe ) {
+			pclose(this->hidden->output);
+		} else
+#endif
+		if ( this->hidden->output != stdout ) {
+			fclose(this->hidden->output);
+		} else {
+			fflush(stdout);
+		}
+		this->hidden->output = NULL;
+		this->hidden->output_pipe = 0;
+	}
+	if ( this->hidden->rgbrow ) {
+		SDL_free(this->hidden->rgbrow);
+		this->hidden->rgbrow = NULL;
+	}
+}
+
+static void WriteFrame(_THIS)
+{
+	SDL_PixelFormat *fmt = this->screen->format;
+	FILE *output = this->hidden->output;
+	int w = this->hidden->w;
+	int h = this->hidden->h;
+	int pitch = this->screen->pitch;
+	Uint8 *row, *dst;
+	Uint32 pixel;
+	int x, y;
+
+	if ( ! this->hidden->output_ppm ) {
+		for ( y=0, row=(Uint8 *)this->hidden->buffer; y<h; ++y, row+=pitch ) {
+			fwrite(row, fmt->BytesPerPixel, w, output);
+		}
+		fflush(output);
+		return;
+	}
+
+	if ( ! this->hidden->rgbrow ) {
+		this->hidden->rgbrow = (Uint8 *)SDL_malloc(w * 3);
+		if ( ! this->hidden->rgbrow ) {
+			return;
+		}
+	}
+	fprintf(output, "P6\n%d %d\n255\n", w, h);
+	for ( y=0, row=(Uint8 *)this->hidden->buffer; y<h; ++y, row+=pitch ) {
+		dst = this->hidden->rgbrow;
+		for ( x=0; x<w; ++x ) {
+			switch (fmt->BytesPerPixel) {
+			    case 1: {
+				SDL_Color *c = &fmt->palette->colors[row[x]];
+				*dst++ = c->r;
+				*dst++ = c->g;
+				*dst++ = c->b;
+				continue;
+			    }
+			    case 2:
+				pixel = ((Uint16 *)row)[x];
+				break;
+			    case 3: {
+				Uint8 *p = row + x * 3;
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+				pixel = p[0] | (p[1] << 8) | (p[2] << 16);
+#else
+				pixel = (p[0] << 16) | (p[1] << 8) | p[2];
+#endif
+				break;
+			    }
+			    default:
+				pixel = ((Uint32 *)row)[x];
+				break;
+			}
+			*dst++ = (Uint8)(((pixel & fmt->Rmask) >> fmt->Rshift) << fmt->Rloss);
+			*dst++ = (Uint8)(((pixel & fmt->Gmask) >> fmt->Gshift) << fmt->Gloss);
+			*dst++ = (Uint8)(((pixel & fmt->Bmask) >> fmt->Bshift) << fmt->Bloss);
+		}
+		fwrite(this->hidden->rgbrow, 3, w, output);
+	}
+	fflush(output);
+}
+
+#endif /* HAVE_STDIO_H */
+
+
+int DUMMY_InitCapture(_THIS, SDL_Surface *current)
+{
+	const char *env;
+
+	this->hidden->fps = 0;
+	env = SDL_getenv("SDL_VIDEO_DUMMY_FPS");
+	if ( env && SDL_atoi(env) > 0 ) {
+		this->hidden->fps = SDL_atoi(env);
+	}
+	this->hidden->pace_start = SDL_GetTicks();
+	this->hidden->pace_frames = 0;
+
+#if SDL_VIDEO_DRIVER_DUMMY_SHM
+	/* The ring is laid out for the old mode, start a new one */
+	CloseShm(this);
+	env = SDL_getenv("SDL_VIDEO_DUMMY_SHM");
+	if ( env && *env ) {
+		if ( OpenShm(this, env, current) < 0 ) {
+			return(-1);
+		}
+	}
+#endif
+
+#ifdef HAVE_STDIO_H
+	/* The stream stays open across mode changes */
+	if ( this->hidden->rgbrow ) {
+		SDL_free(this->hidden->rgbrow);
+		this->hidden->rgbrow = NULL;
+	}
+	env = SDL_getenv("SDL_VIDEO_DUMMY_OUTPUT");
+	if ( env && *env && ! this->hidden->output ) {
+		if ( OpenOutput(this, env) < 0 ) {
+			return(-1);
+		}
+	}
+#endif
+	return(0);
+}
+
+void DUMMY_CaptureFrame(_THIS, int numrects, SDL_Rect *rects)
+{
+	SDL_Rect bounds;
+	int i, x2, y2;
+
+	PaceFrame(this);
+
+#if SDL_VIDEO_DRIVER_DUMMY_SHM
+	if ( ! this->hidden->shm )
+#endif
+#ifdef HAVE_STDIO_H
+	if ( ! this->hidden->output )
+#endif
+	{
+		return;
+	}
+
+	/* Frame 0 means "no frame" to readers, skip it on wraparound */
+	if ( ++this->hidden->frame == 0 ) {
+		this->hidden->frame = 1;
+	}
+
+	bounds.x = this->hidden->w;
+	bounds.y = this->hidden->h;
+	x2 = y2 = 0;
+	for ( i=0; i<numrects; ++i ) {
+		if ( rects[i].w && rects[i].h ) {
+			if ( rects[i].x < bounds.x ) bounds.x = rects[i].x;
+			if ( rects[i].y < bounds.y ) bounds.y = rects[i].y;
+			if ( rects[i].x + rects[i].w > x2 ) x2 = rects[i].x + rects[i].w;
+			if ( rects[i].y + rects[i].h > y2 ) y2 = rects[i].y + rects[i].h;
+		}
+	}
+	if ( (bounds.x < x2) && (bounds.y < y2) ) {
+		bounds.w = x2 - bounds.x;
+		bounds.h = y2 - bounds.y;
+	} else {
+		bounds.x = bounds.y = bounds.w = bounds.h = 0;
+	}
+
+#if SDL_VIDEO_DRIVER_DUMMY_SHM
+	if ( this->hidden->shm ) {
+		PublishShm(this, &bounds, numrects, rects);
+	}
+#endif
+#ifdef HAVE_STDIO_H
+	if ( this->hidden->output ) {
+		WriteFrame(this);
+	}
+#endif
+}
+
+void DUMMY_CapturePalette(_THIS, int firstcolor, int ncolors, SDL_Color *colors)
+{
+#if SDL_VIDEO_DRIVER_DUMMY_SHM
+	if ( this->hidden->shm ) {
+		SDL_DummyCaptureHeader *header;
+
+		header = (SDL_DummyCaptureHeader *)this->hidden->shm;
+		SDL_memcpy(&header->palette[firstcolor], colors,
+		           ncolors * sizeof(*colors));
+	}
+#endif
+}
+
+void DUMMY_QuitCapture(_THIS)
+{
+#if SDL_VIDEO_DRIVER_DUMMY_SHM
+	CloseShm(this);
+#endif
+#ifdef HAVE_STDIO_H
+	CloseOutput(this);
+#endif
+}
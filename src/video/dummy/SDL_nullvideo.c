@@ -45,6 +45,7 @@
 #include "SDL_nullvideo.h"
 #include "SDL_nullevents_c.h"
 #include "SDL_nullmouse_c.h"
+#include "SDL_nullcapture_c.h"
 
 #define DUMMYVID_DRIVER_NAME "dummy"
 
@@ -190,6 +191,11 @@ SDL_Surface *DUMMY_SetVideoMode(_THIS, SDL_Surface *current,
 	current->pitch = current->w * (bpp / 8);
 	current->pixels = this->hidden->buffer;
 
+	/* Start publishing frames, if that was asked for */
+	if ( DUMMY_InitCapture(this, current) < 0 ) {
+		return(NULL);
+	}
+
 	/* We're done */
 	return(current);
 }
@@ -217,12 +223,13 @@ static void DUMMY_UnlockHWSurface(_THIS, SDL_Surface *surface)
 
 static void DUMMY_UpdateRects(_THIS, int numrects, SDL_Rect *rects)
 {
-	/* do nothing. */
+	/* nothing to display, but the frame may be captured */
+	DUMMY_CaptureFrame(this, numrects, rects);
 }
 
 int DUMMY_SetColors(_THIS, int firstcolor, int ncolors, SDL_Color *colors)
 {
-	/* do nothing of note. */
+	DUMMY_CapturePalette(this, firstcolor, ncolors, colors);
 	return(1);
 }
 
@@ -231,6 +238,8 @@ int DUMMY_SetColors(_THIS, int firstcolor, int ncolors, SDL_Color *colors)
 */
 void DUMMY_VideoQuit(_THIS)
 {
+	DUMMY_QuitCapture(this);
+
 	if (this->screen->pixels != NULL)
 	{
 		SDL_free(this->screen->pixels);
@@ -35,6 +35,23 @@
 struct SDL_PrivateVideoData {
     int w, h;
     void *buffer;
+
+    /* Frame capture, see SDL_nullcapture.c */
+    Uint32 frame;		/* Sequence number of the last frame */
+    Uint32 fps;			/* Frame rate limit, or 0 */
+    Uint32 pace_start;		/* Ticks when pacing (re)started */
+    Uint32 pace_frames;		/* Frames published since pace_start */
+#ifdef HAVE_STDIO_H
+    FILE *output;		/* Stream receiving every frame, or NULL */
+    int output_pipe;		/* output was opened with popen() */
+    int output_ppm;		/* Write PPM images rather than raw pixels */
+    Uint8 *rgbrow;		/* Conversion buffer for one PPM row */
+#endif
+    char *shm_name;		/* Name of the shared frame ring, or NULL */
+    Uint8 *shm;			/* The mapped frame ring */
+    size_t shm_size;
+    SDL_Rect *damage;		/* Changed area of each of the last frames */
+    Uint32 shm_published;	/* Slots written so far, up to the ring size */
 };
 
 #endif /* _SDL_nullvideo_h */
@@ -38,6 +38,7 @@
 
 #include "SDL_video.h"
 #include "SDL_mouse.h"
+#include "SDL_timer.h"
 #include "../SDL_sysvideo.h"
 #include "../SDL_pixels_c.h"
 #include "../../events/SDL_events_c.h"
@@ -155,6 +156,8 @@ static void FB_FreeHWSurface(_THIS, SDL_Surface *surface);
 static void FB_WaitVBL(_THIS);
 static void FB_WaitIdle(_THIS);
 static int FB_FlipHWSurface(_THIS, SDL_Surface *surface);
+static int FB_Flip(_THIS, SDL_Surface *surface, int counted);
+static int FB_GetFlipStats(_THIS, SDL_FlipStats *stats);
 #if !SDL_THREADS_DISABLED
 static int FB_TripleBufferingThread(void *d);
 static void FB_TripleBufferInit(_THIS);
@@ -168,8 +171,14 @@ static void FB_SavePalette(_THIS, struct fb_fix_screeninfo *finfo,
 static void FB_RestorePalette(_THIS);
 
 /* Shadow buffer functions */
+static FB_bitBlit FB_blit8;
+static FB_bitBlit FB_blit8blocked;
 static FB_bitBlit FB_blit16;
 static FB_bitBlit FB_blit16blocked;
+static FB_bitBlit FB_blit24;
+static FB_bitBlit FB_blit24blocked;
+static FB_bitBlit FB_blit32;
+static FB_bitBlit FB_blit32blocked;
 
 static int SDL_getpagesize(void)
 {
@@ -267,6 +276,7 @@ static SDL_VideoDevice *FB_CreateDevice(int devindex)
 	this->LockHWSurface = FB_LockHWSurface;
 	this->UnlockHWSurface = FB_UnlockHWSurface;
 	this->FlipHWSurface = FB_FlipHWSurface;
+	this->GetFlipStats = FB_GetFlipStats;
 	this->FreeHWSurface = FB_FreeHWSurface;
 	this->SetCaption = NULL;
 	this->SetIcon = NULL;
@@ -1138,11 +1148,30 @@ static SDL_Surface *FB_SetVideoMode(_THIS, SDL_Surface *current,
 	FB_SavePalette(this, &finfo, &vinfo);
 
 	if (shadow_fb) {
-		if (vinfo.bits_per_pixel == 16) {
-			blitFunc = (rotate == FBCON_ROTATE_NONE ||
-					rotate == FBCON_ROTATE_UD) ?
-				FB_blit16 : FB_blit16blocked;
-		} else {
+		/* Rotating by 90 degrees reads the shadow a column at a
+		   time, so it is copied in blocks that stay in the cache.
+		 */
+		int blocked = (rotate == FBCON_ROTATE_CW ||
+		               rotate == FBCON_ROTATE_CCW);
+
+		switch (vinfo.bits_per_pixel) {
+		    case 8:
+			blitFunc = blocked ? FB_blit8blocked : FB_blit8;
+			break;
+		    case 16:
+			blitFunc = blocked ? FB_blit16blocked : FB_blit16;
+			break;
+		    case 24:
+			blitFunc = blocked ? FB_blit24blocked : FB_blit24;
+			break;
+		    case 32:
+			blitFunc = blocked ? FB_blit32blocked : FB_blit32;
+			break;
+		    default:
+			blitFunc = NULL;
+			break;
+		}
+		if (blitFunc == NULL) {
 #ifdef FBCON_DEBUG
 			fprintf(stderr, "Init vinfo:\n");
 			print_vinfo(&vinfo);
@@ -1190,6 +1219,7 @@ static SDL_Surface *FB_SetVideoMode(_THIS, SDL_Surface *current,
 		break;
 	}
 
+	SDL_memset(&flip_stats, 0, sizeof(flip_stats));
 #if !SDL_THREADS_DISABLED
 	if ( triplebuf_thread )
 		FB_TripleBufferStop(this);
@@ -1198,6 +1228,7 @@ static SDL_Surface *FB_SetVideoMode(_THIS, SDL_Surface *current,
 		current->flags |= SDL_TRIPLEBUF;
 		current_page = 0;
 		new_page = 2;
+		new_page_ready = 0;
 		triplebuf_thread_stop = 0;
 
 		SDL_LockMutex(triplebuf_mutex);
@@ -1225,8 +1256,9 @@ static SDL_Surface *FB_SetVideoMode(_THIS, SDL_Surface *current,
 				flip_page = 0;
 			}
 
+			/* Show the first page, without counting it */
 			this->screen = current;
-			FB_FlipHWSurface(this, current);
+			FB_Flip(this, current, 0);
 			this->screen = NULL;
 		}
 	}
@@ -1461,6 +1493,13 @@ static void FB_UnlockHWSurface(_THIS, SDL_Surface *surface)
 
 static void FB_WaitVBL(_THIS)
 {
+#ifdef FBIO_WAITFORVSYNC
+	__u32 crtc = 0;
+
+	if ( !no_vsync && (ioctl(console_fd, FBIO_WAITFORVSYNC, &crtc) < 0) ) {
+		no_vsync = 1;
+	}
+#endif
 }
 
 static void FB_WaitIdle(_THIS)
@@ -1469,6 +1508,10 @@ static void FB_WaitIdle(_THIS)
 }
 
 #if !SDL_THREADS_DISABLED
+/* Shows queued frames at vertical retrace.  The application renders
+   into flip_page, new_page holds the newest finished frame if
+   new_page_ready is set, and current_page is on the screen.
+ */
 static int FB_TripleBufferingThread(void *d)
 {
 	SDL_VideoDevice *this = d;
@@ -1478,24 +1521,35 @@ static int FB_TripleBufferingThread(void *d)
 
 	for (;;) {
 		unsigned int page;
+		Uint32 frame;
 
-		SDL_CondWait(triplebuf_cond, triplebuf_mutex);
+		while (!new_page_ready && !triplebuf_thread_stop) {
+			SDL_CondWait(triplebuf_cond, triplebuf_mutex);
+		}
 		if (triplebuf_thread_stop)
 			break;
 
+		/* Wait for the retrace without holding up SDL_Flip() */
+		SDL_UnlockMutex(triplebuf_mutex);
+		wait_vbl(this);
+		SDL_LockMutex(triplebuf_mutex);
+
 		/* Flip the most recent back buffer with the front buffer */
 		page = current_page;
 		current_page = new_page;
 		new_page = page;
+		new_page_ready = 0;
+		frame = new_page_frame;
 
 		/* flip display */
 		cache_vinfo.yoffset = current_page * cache_vinfo.yres;
 
-		wait_vbl(this);
-
 		if ( ioctl(console_fd, FBIOPAN_DISPLAY, &cache_vinfo) < 0 ) {
 			SDL_SetError("ioctl(FBIOPAN_DISPLAY) failed");
-			return(-1);
+		} else if ( frame ) {
+			++flip_stats.frames_shown;
+			flip_stats.last_frame = frame;
+			flip_stats.last_present = SDL_GetTicks();
 		}
 	}
 
@@ -1531,6 +1585,11 @@ static void FB_TripleBufferQuit(_THIS)
 #endif
 
 static int FB_FlipHWSurface(_THIS, SDL_Surface *surface)
+{
+	return FB_Flip(this, surface, 1);
+}
+
+static int FB_Flip(_THIS, SDL_Surface *surface, int counted)
 {
 	if ( switched_away ) {
 		return -2; /* no hardware access */
@@ -1546,11 +1605,18 @@ static int FB_FlipHWSurface(_THIS, SDL_Surface *surface)
 #if !SDL_THREADS_DISABLED
 		unsigned int page;
 
-		/* Flip the two back buffers */
+		/* Queue the frame by swapping the two back buffers.  If
+		   the last one queued hasn't been shown yet, it's dropped.
+		 */
 		SDL_LockMutex(triplebuf_mutex);
+		if ( new_page_ready && new_page_frame ) {
+			++flip_stats.frames_dropped;
+		}
 		page = new_page;
 		new_page = flip_page;
 		flip_page = page;
+		new_page_ready = 1;
+		new_page_frame = counted ? ++flip_stats.frames_queued : 0;
 
 		surface->pixels = flip_address[flip_page];
 		SDL_CondSignal(triplebuf_cond);
@@ -1566,6 +1632,12 @@ static int FB_FlipHWSurface(_THIS, SDL_Surface *surface)
 			SDL_SetError("ioctl(FBIOPAN_DISPLAY) failed");
 			return(-1);
 		}
+		if ( counted ) {
+			++flip_stats.frames_queued;
+			++flip_stats.frames_shown;
+			flip_stats.last_frame = flip_stats.frames_queued;
+			flip_stats.last_present = SDL_GetTicks();
+		}
 
 		flip_page = !flip_page;
 		surface->pixels = flip_address[flip_page];
@@ -1574,6 +1646,78 @@ static int FB_FlipHWSurface(_THIS, SDL_Surface *surface)
 	return(0);
 }
 
+static int FB_GetFlipStats(_THIS, SDL_FlipStats *stats)
+{
+	if ( !(this->screen->flags & SDL_DOUBLEBUF) ) {
+		SDL_SetError("Display surface isn't double buffered");
+		return(-1);
+	}
+#if !SDL_THREADS_DISABLED
+	if ( triplebuf_thread ) {
+		SDL_LockMutex(triplebuf_mutex);
+		*stats = flip_stats;
+		stats->frames_pending = (new_page_ready && new_page_frame) ? 1 : 0;
+		SDL_UnlockMutex(triplebuf_mutex);
+		return(0);
+	}
+#endif
+	*stats = flip_stats;
+	return(0);
+}
+
+/* The shadow copy writes each line of the framebuffer in order, so
+   that writes to uncached or write-combined video memory go out in
+   bursts.  Unrotated lines are copied whole, and otherwise 8 and 16
+   bit pixels are gathered into 32-bit writes where the line allows.
+ */
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+#define PACK2x16(a, b)		((Uint32)(a) | ((Uint32)(b) << 16))
+#define PACK4x8(a, b, c, d)	((Uint32)(a) | ((Uint32)(b) << 8) | \
+				 ((Uint32)(c) << 16) | ((Uint32)(d) << 24))
+#else
+#define PACK2x16(a, b)		(((Uint32)(a) << 16) | (Uint32)(b))
+#define PACK4x8(a, b, c, d)	(((Uint32)(a) << 24) | ((Uint32)(b) << 16) | \
+				 ((Uint32)(c) << 8) | (Uint32)(d))
+#endif
+
+static void FB_blit8(Uint8 *byte_src_pos, int src_right_delta, int src_down_delta,
+		Uint8 *byte_dst_pos, int dst_linebytes, int width, int height)
+{
+	int w;
+	Uint8 *src_pos = byte_src_pos;
+	Uint8 *dst_pos = byte_dst_pos;
+
+	while (height) {
+		Uint8 *src = src_pos;
+		Uint8 *dst = dst_pos;
+		if (src_right_delta == 1) {
+			SDL_memcpy(dst, src, width);
+		} else {
+			w = width;
+			while (w && ((uintptr_t)dst & 3)) {
+				*dst++ = *src;
+				src += src_right_delta;
+				w--;
+			}
+			for (; w >= 4; w -= 4) {
+				*(Uint32 *)dst = PACK4x8(src[0],
+				                         src[src_right_delta],
+				                         src[src_right_delta*2],
+				                         src[src_right_delta*3]);
+				src += src_right_delta * 4;
+				dst += 4;
+			}
+			for (; w != 0; w--) {
+				*dst++ = *src;
+				src += src_right_delta;
+			}
+		}
+		dst_pos += dst_linebytes;
+		src_pos += src_down_delta;
+		height--;
+	}
+}
+
 static void FB_blit16(Uint8 *byte_src_pos, int src_right_delta, int src_down_delta,
 		Uint8 *byte_dst_pos, int dst_linebytes, int width, int height)
 {
@@ -1584,10 +1728,23 @@ static void FB_blit16(Uint8 *byte_src_pos, int src_right_delta, int src_down_del
 	while (height) {
 		Uint16 *src = src_pos;
 		Uint16 *dst = dst_pos;
-		for (w = width; w != 0; w--) {
-			*dst = *src;
-			src += src_right_delta;
-			dst++;
+		if (src_right_delta == 1) {
+			SDL_memcpy(dst, src, width * 2);
+		} else {
+			w = width;
+			if (w && ((uintptr_t)dst & 2)) {
+				*dst++ = *src;
+				src += src_right_delta;
+				w--;
+			}
+			for (; w >= 2; w -= 2) {
+				*(Uint32 *)dst = PACK2x16(src[0], src[src_right_delta]);
+				src += src_right_delta * 2;
+				dst += 2;
+			}
+			if (w) {
+				*dst = *src;
+			}
 		}
 		dst_pos = (Uint16 *)((Uint8 *)dst_pos + dst_linebytes);
 		src_pos += src_down_delta;
@@ -1595,36 +1752,109 @@ static void FB_blit16(Uint8 *byte_src_pos, int src_right_delta, int src_down_del
 	}
 }
 
-#define BLOCKSIZE_W 32
-#define BLOCKSIZE_H 32
+static void FB_blit24(Uint8 *byte_src_pos, int src_right_delta, int src_down_delta,
+		Uint8 *byte_dst_pos, int dst_linebytes, int width, int height)
+{
+	int w;
+	Uint8 *src_pos = byte_src_pos;
+	Uint8 *dst_pos = byte_dst_pos;
 
-static void FB_blit16blocked(Uint8 *byte_src_pos, int src_right_delta, int src_down_delta, 
+	src_right_delta *= 3;
+	src_down_delta *= 3;
+	while (height) {
+		Uint8 *src = src_pos;
+		Uint8 *dst = dst_pos;
+		if (src_right_delta == 3) {
+			SDL_memcpy(dst, src, width * 3);
+		} else {
+			for (w = width; w != 0; w--) {
+				dst[0] = src[0];
+				dst[1] = src[1];
+				dst[2] = src[2];
+				src += src_right_delta;
+				dst += 3;
+			}
+		}
+		dst_pos += dst_linebytes;
+		src_pos += src_down_delta;
+		height--;
+	}
+}
+
+static void FB_blit32(Uint8 *byte_src_pos, int src_right_delta, int src_down_delta,
 		Uint8 *byte_dst_pos, int dst_linebytes, int width, int height)
 {
 	int w;
-	Uint16 *src_pos = (Uint16 *)byte_src_pos;
-	Uint16 *dst_pos = (Uint16 *)byte_dst_pos;
+	Uint32 *src_pos = (Uint32 *)byte_src_pos;
+	Uint32 *dst_pos = (Uint32 *)byte_dst_pos;
 
-	while (height > 0) {
-		Uint16 *src = src_pos;
-		Uint16 *dst = dst_pos;
-		for (w = width; w > 0; w -= BLOCKSIZE_W) {
-			FB_blit16((Uint8 *)src,
-					src_right_delta,
-					src_down_delta,
-					(Uint8 *)dst,
-					dst_linebytes,
-					min(w, BLOCKSIZE_W),
-					min(height, BLOCKSIZE_H));
-			src += src_right_delta * BLOCKSIZE_W;
-			dst += BLOCKSIZE_W;
-		}
-		dst_pos = (Uint16 *)((Uint8 *)dst_pos + dst_linebytes * BLOCKSIZE_H);
-		src_pos += src_down_delta * BLOCKSIZE_H;
-		height -= BLOCKSIZE_H;
+	while (height) {
+		Uint32 *src = src_pos;
+		Uint32 *dst = dst_pos;
+		if (src_right_delta == 1) {
+			SDL_memcpy(dst, src, width * 4);
+		} else {
+			for (w = width; w >= 4; w -= 4) {
+				Uint32 p0 = src[0];
+				Uint32 p1 = src[src_right_delta];
+				Uint32 p2 = src[src_right_delta*2];
+				Uint32 p3 = src[src_right_delta*3];
+				dst[0] = p0;
+				dst[1] = p1;
+				dst[2] = p2;
+				dst[3] = p3;
+				src += src_right_delta * 4;
+				dst += 4;
+			}
+			for (; w != 0; w--) {
+				*dst++ = *src;
+				src += src_right_delta;
+			}
+		}
+		dst_pos = (Uint32 *)((Uint8 *)dst_pos + dst_linebytes);
+		src_pos += src_down_delta;
+		height--;
 	}
 }
 
+/* For rotated copies the shadow is read down its columns, so the
+   copy is split into blocks that keep the source lines touched in
+   the cache.  Each block writes BLOCKSIZE_W pixels per line.
+ */
+#define BLOCKSIZE_W 32
+#define BLOCKSIZE_H 32
+
+#define FB_BLOCKED(name, blit, bpp) \
+static void name(Uint8 *src_pos, int src_right_delta, int src_down_delta, \
+		Uint8 *dst_pos, int dst_linebytes, int width, int height) \
+{ \
+	int w; \
+ \
+	while (height > 0) { \
+		Uint8 *src = src_pos; \
+		Uint8 *dst = dst_pos; \
+		for (w = width; w > 0; w -= BLOCKSIZE_W) { \
+			blit(src, \
+					src_right_delta, \
+					src_down_delta, \
+					dst, \
+					dst_linebytes, \
+					min(w, BLOCKSIZE_W), \
+					min(height, BLOCKSIZE_H)); \
+			src += src_right_delta * BLOCKSIZE_W * (bpp); \
+			dst += BLOCKSIZE_W * (bpp); \
+		} \
+		dst_pos += dst_linebytes * BLOCKSIZE_H; \
+		src_pos += src_down_delta * BLOCKSIZE_H * (bpp); \
+		height -= BLOCKSIZE_H; \
+	} \
+}
+
+FB_BLOCKED(FB_blit8blocked, FB_blit8, 1)
+FB_BLOCKED(FB_blit16blocked, FB_blit16, 2)
+FB_BLOCKED(FB_blit24blocked, FB_blit24, 3)
+FB_BLOCKED(FB_blit32blocked, FB_blit32, 4)
+
 static void FB_DirectUpdate(_THIS, int numrects, SDL_Rect *rects)
 {
 	int width = cache_vinfo.xres;
@@ -1637,8 +1867,8 @@ static void FB_DirectUpdate(_THIS, int numrects, SDL_Rect *rects)
 		return;
 	}
 
-	if (cache_vinfo.bits_per_pixel != 16) {
-		SDL_SetError("Shadow copy only implemented for 16 bpp");
+	if (blitFunc == NULL) {
+		SDL_SetError("No shadow copy for %d bpp", cache_vinfo.bits_per_pixel);
 		return;
 	}
 
@@ -85,9 +85,13 @@ struct SDL_PrivateVideoData {
 	long mapped_iolen;
 	int flip_page;
 	char *flip_address[3];
+	SDL_FlipStats flip_stats;
+	int no_vsync;				/* FBIO_WAITFORVSYNC isn't supported */
 #if !SDL_THREADS_DISABLED
 	int current_page;
 	int new_page;
+	int new_page_ready;			/* new_page holds a frame to show */
+	Uint32 new_page_frame;			/* Its number, or 0 if not counted */
 	SDL_mutex *triplebuf_mutex;
 	SDL_cond *triplebuf_cond;
 	SDL_Thread *triplebuf_thread;
@@ -139,9 +143,13 @@ struct SDL_PrivateVideoData {
 #define mapped_iolen		(this->hidden->mapped_iolen)
 #define flip_page		(this->hidden->flip_page)
 #define flip_address		(this->hidden->flip_address)
+#define flip_stats		(this->hidden->flip_stats)
+#define no_vsync		(this->hidden->no_vsync)
 #if !SDL_THREADS_DISABLED
 #define current_page		(this->hidden->current_page)
 #define new_page			(this->hidden->new_page)
+#define new_page_ready		(this->hidden->new_page_ready)
+#define new_page_frame		(this->hidden->new_page_frame)
 #define triplebuf_mutex		(this->hidden->triplebuf_mutex)
 #define triplebuf_cond		(this->hidden->triplebuf_cond)
 #define triplebuf_thread	(this->hidden->triplebuf_thread)
@@ -25,6 +25,7 @@
 #include <unistd.h>
 
 #include "SDL_endian.h"
+#include "SDL_cpuinfo.h"
 #include "../../events/SDL_events_c.h"
 #include "SDL_x11image_c.h"
 
@@ -42,6 +43,32 @@ static int shm_errhandler(Display *d, XErrorEvent *e)
 		return(X_handler(d,e));
 }
 
+/* Create a shared memory segment and attach it to the X server */
+static int shm_attach(_THIS, XShmSegmentInfo *info, int size)
+{
+	info->shmid = shmget(IPC_PRIVATE, size, IPC_CREAT | 0777);
+	if ( info->shmid < 0 ) {
+		return(-1);
+	}
+	info->shmaddr = (char *)shmat(info->shmid, 0, 0);
+	info->readOnly = False;
+	if ( info->shmaddr == (char *)-1 ) {
+		shmctl(info->shmid, IPC_RMID, NULL);
+		return(-1);
+	}
+	shm_error = False;
+	X_handler = XSetErrorHandler(shm_errhandler);
+	XShmAttach(SDL_Display, info);
+	XSync(SDL_Display, False);
+	XSetErrorHandler(X_handler);
+	shmctl(info->shmid, IPC_RMID, NULL);
+	if ( shm_error ) {
+		shmdt(info->shmaddr);
+		return(-1);
+	}
+	return(0);
+}
+
 static void try_mitshm(_THIS, SDL_Surface *screen)
 {
 	/* Dynamic X11 may not have SHM entry points on this box. */
@@ -50,37 +77,141 @@ static void try_mitshm(_THIS, SDL_Surface *screen)
 
 	if(!use_mitshm)
 		return;
-	shminfo.shmid = shmget(IPC_PRIVATE, screen->h*screen->pitch,
-			       IPC_CREAT | 0777);
-	if ( shminfo.shmid >= 0 ) {
-		shminfo.shmaddr = (char *)shmat(shminfo.shmid, 0, 0);
-		shminfo.readOnly = False;
-		if ( shminfo.shmaddr != (char *)-1 ) {
-			shm_error = False;
-			X_handler = XSetErrorHandler(shm_errhandler);
-			XShmAttach(SDL_Display, &shminfo);
-			XSync(SDL_Display, False);
-			XSetErrorHandler(X_handler);
-			if ( shm_error )
-				shmdt(shminfo.shmaddr);
-		} else {
-			shm_error = True;
-		}
-		shmctl(shminfo.shmid, IPC_RMID, NULL);
-	} else {
-		shm_error = True;
-	}
-	if ( shm_error )
+	if ( shm_attach(this, &shminfo, screen->h*screen->pitch) < 0 )
 		use_mitshm = 0;
 	if ( use_mitshm )
 		screen->pixels = shminfo.shmaddr;
 }
+
+/* Updates are copied into one of these segments before being sent to
+   the server, so the application can draw the next frame while the
+   server is still reading the last one.  A segment is reused once the
+   ShmCompletion event for its last XShmPutImage() has arrived.
+ */
+static void setup_shm_present(_THIS, SDL_Surface *screen)
+{
+	const char *env;
+	int i, wanted;
+	XImage *image;
+
+	shm_npresent = 0;
+	shm_next = 0;
+
+	wanted = 2;
+	env = SDL_getenv("SDL_VIDEO_X11_SHM_BUFFERS");
+	if ( env && *env ) {
+		wanted = SDL_atoi(env);
+	}
+	if ( wanted > (int)SDL_arraysize(shm_present) ) {
+		wanted = (int)SDL_arraysize(shm_present);
+	}
+
+	for ( i = 0; i < wanted; ++i ) {
+		XShmSegmentInfo *info = &shm_present[i].info;
+
+		if ( shm_attach(this, info,
+		                screen->h*SDL_Ximage->bytes_per_line) < 0 ) {
+			break;
+		}
+		image = XShmCreateImage(SDL_Display, SDL_Visual,
+					this->hidden->depth, ZPixmap,
+					info->shmaddr, info,
+					screen->w, screen->h);
+		if ( !image ||
+		     (image->bytes_per_line != SDL_Ximage->bytes_per_line) ) {
+			if ( image ) {
+				XDestroyImage(image);
+			}
+			XShmDetach(SDL_Display, info);
+			XSync(SDL_Display, False);
+			shmdt(info->shmaddr);
+			break;
+		}
+		shm_present[i].image = image;
+		shm_present[i].serial = 0;
+		shm_present[i].busy = 0;
+		++shm_npresent;
+	}
+	if ( shm_npresent ) {
+		shm_completion = XShmGetEventBase(GFX_Display) + ShmCompletion;
+	}
+}
+
+/* Mark the segments whose last XShmPutImage() has been completed */
+static void shm_check_completion(_THIS)
+{
+	XEvent event;
+	XShmCompletionEvent *done;
+	int i;
+
+	while ( XCheckTypedEvent(GFX_Display, shm_completion, &event) ) {
+		done = (XShmCompletionEvent *)&event;
+		for ( i = 0; i < shm_npresent; ++i ) {
+			if ( shm_present[i].busy &&
+			     (done->shmseg == shm_present[i].info.shmseg) &&
+			     ((long)(done->serial-shm_present[i].serial) >= 0) ) {
+				shm_present[i].busy = 0;
+			}
+		}
+	}
+}
+
+/* Wait until the server has finished reading the given segment */
+static void shm_wait_present(_THIS, int which)
+{
+	if ( shm_present[which].busy ) {
+		shm_check_completion(this);
+	}
+	if ( shm_present[which].busy ) {
+		/* Once the server has answered, it is done with every
+		   request we sent, whether or not the event got to us.
+		 */
+		XSync(GFX_Display, False);
+		shm_check_completion(this);
+		shm_present[which].busy = 0;
+	}
+}
+
+static void destroy_shm_present(_THIS)
+{
+	int i;
+
+	if ( !shm_npresent ) {
+		return;
+	}
+	XSync(GFX_Display, False);
+	shm_check_completion(this);
+	for ( i = 0; i < shm_npresent; ++i ) {
+		XDestroyImage(shm_present[i].image);
+		shm_present[i].image = NULL;
+		XShmDetach(SDL_Display, &shm_present[i].info);
+	}
+	XSync(SDL_Display, False);
+	for ( i = 0; i < shm_npresent; ++i ) {
+		shmdt(shm_present[i].info.shmaddr);
+	}
+	shm_npresent = 0;
+}
 #endif /* ! NO_SHARED_MEMORY */
 
 /* Various screen update functions available */
 static void X11_NormalUpdate(_THIS, int numrects, SDL_Rect *rects);
 static void X11_MITSHMUpdate(_THIS, int numrects, SDL_Rect *rects);
 
+/* Choose how many wasted pixels a saved request is worth.  Requests
+   through shared memory are cheap per pixel, so merge more eagerly.
+ */
+static void X11_SetMergeCost(_THIS, int cost)
+{
+	const char *env;
+
+	env = SDL_getenv("SDL_VIDEO_X11_MERGECOST");
+	if ( env && *env ) {
+		cost = SDL_atoi(env);
+	}
+	merge_cost = cost;
+}
+
 int X11_SetupImage(_THIS, SDL_Surface *screen)
 {
 #ifndef NO_SHARED_MEMORY
@@ -97,6 +228,8 @@ int X11_SetupImage(_THIS, SDL_Surface *screen)
 			screen->pixels = NULL;
 			goto error;
 		}
+		setup_shm_present(this, screen);
+		X11_SetMergeCost(this, 2048);
 		this->UpdateRects = X11_MITSHMUpdate;
 	}
 	if(!use_mitshm)
@@ -117,6 +250,7 @@ int X11_SetupImage(_THIS, SDL_Surface *screen)
 		/* XPutImage will convert byte sex automatically */
 		SDL_Ximage->byte_order = (SDL_BYTEORDER == SDL_BIG_ENDIAN)
 			                 ? MSBFirst : LSBFirst;
+		X11_SetMergeCost(this, 256);
 		this->UpdateRects = X11_NormalUpdate;
 	}
 	screen->pitch = SDL_Ximage->bytes_per_line;
@@ -133,6 +267,7 @@ void X11_DestroyImage(_THIS, SDL_Surface *screen)
 		XDestroyImage(SDL_Ximage);
 #ifndef NO_SHARED_MEMORY
 		if ( use_mitshm ) {
+			destroy_shm_present(this);
 			XShmDetach(SDL_Display, &shminfo);
 			XSync(SDL_Display, False);
 			shmdt(shminfo.shmaddr);
@@ -145,44 +280,12 @@ void X11_DestroyImage(_THIS, SDL_Surface *screen)
 	}
 }
 
-/* Determine the number of CPUs in the system */
-static int num_CPU(void)
-{
-       static int num_cpus = 0;
-
-       if(!num_cpus) {
-#if defined(__LINUX__)
-           char line[BUFSIZ];
-           FILE *pstat = fopen("/proc/stat", "r");
-           if ( pstat ) {
-               while ( fgets(line, sizeof(line), pstat) ) {
-                   if (SDL_memcmp(line, "cpu", 3) == 0 && line[3] != ' ') {
-                       ++num_cpus;
-                   }
-               }
-               fclose(pstat);
-           }
-#elif defined(__IRIX__)
-	   num_cpus = sysconf(_SC_NPROC_ONLN);
-#elif defined(_SC_NPROCESSORS_ONLN)
-	   /* number of processors online (SVR4.0MP compliant machines) */
-           num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
-#elif defined(_SC_NPROCESSORS_CONF)
-	   /* number of processors configured (SVR4.0MP compliant machines) */
-           num_cpus = sysconf(_SC_NPROCESSORS_CONF);
-#endif
-           if ( num_cpus <= 0 ) {
-               num_cpus = 1;
-           }
-       }
-       return num_cpus;
-}
-
 int X11_ResizeImage(_THIS, SDL_Surface *screen, Uint32 flags)
 {
 	int retval;
 
 	X11_DestroyImage(this, screen);
+	SDL_memset(&update_stats, 0, sizeof(update_stats));
         if ( flags & SDL_OPENGL ) {  /* No image when using GL */
         	retval = 0;
         } else {
@@ -194,7 +297,7 @@ int X11_ResizeImage(_THIS, SDL_Surface *screen, Uint32 flags)
 			   X server and the application.
 			   Note: Is this still true with XFree86 4.0?
 			*/
-			if ( num_CPU() > 1 ) {
+			if ( SDL_GetCPUCount() > 1 ) {
 				screen->flags |= SDL_ASYNCBLIT;
 			}
 		}
@@ -230,10 +333,133 @@ int X11_FlipHWSurface(_THIS, SDL_Surface *surface)
 	return(0);
 }
 
+int X11_GetUpdateStats(_THIS, SDL_UpdateStats *stats)
+{
+	if ( !SDL_Ximage ) {
+		SDL_SetError("No screen image to update");
+		return(-1);
+	}
+	*stats = update_stats;
+	return(0);
+}
+
+void X11_FreeUpdateRects(_THIS)
+{
+	if ( merge_rects ) {
+		SDL_free(merge_rects);
+		merge_rects = NULL;
+	}
+	if ( merge_covered ) {
+		SDL_free(merge_covered);
+		merge_covered = NULL;
+	}
+	merge_max = 0;
+}
+
+/* Each request costs the X server about the same no matter how small it
+   is, so send the union of two rectangles instead when that covers no
+   more than merge_cost pixels that weren't asked for.  The merged list
+   never contains empty rectangles, and every merged rectangle wastes at
+   most merge_cost pixels.
+ */
+static int X11_MergeRects(_THIS, int numrects, SDL_Rect *rects,
+                          SDL_Rect **merged)
+{
+	SDL_Rect *out;
+	int *covered;
+	int i, j, n;
+	int x1, y1, x2, y2, area;
+	int ux1, uy1, ux2, uy2, union_area;
+
+	++update_stats.updates;
+	for ( i=0; i<numrects; ++i ) {
+		if ( rects[i].w && rects[i].h ) {
+			++update_stats.rects;
+			update_stats.pixels_asked += rects[i].w*rects[i].h;
+		}
+	}
+
+	*merged = rects;
+	if ( (merge_cost <= 0) || (numrects < 2) ) {
+		return(numrects);
+	}
+	if ( numrects > merge_max ) {
+		out = (SDL_Rect *)SDL_realloc(merge_rects,
+		                              numrects*sizeof(*out));
+		if ( out ) {
+			merge_rects = out;
+		}
+		covered = (int *)SDL_realloc(merge_covered,
+		                             numrects*sizeof(*covered));
+		if ( covered ) {
+			merge_covered = covered;
+		}
+		if ( !out || !covered ) {
+			return(numrects);
+		}
+		merge_max = numrects;
+	}
+	out = merge_rects;
+	covered = merge_covered;
+
+	n = 0;
+	for ( i=0; i<numrects; ++i ) {
+		if ( rects[i].w == 0 || rects[i].h == 0 ) { /* Clipped? */
+			continue;
+		}
+		x1 = rects[i].x;
+		y1 = rects[i].y;
+		x2 = x1 + rects[i].w;
+		y2 = y1 + rects[i].h;
+		area = rects[i].w*rects[i].h;
+
+		/* The pixels two merged rectangles asked for can overlap, so
+		   count the overlap of their bounds only once.  That never
+		   exceeds the real overlap, so the waste is never understated.
+		   A moved rectangle takes the place of a merged one, so check
+		   that slot again rather than starting over.
+		 */
+		j = 0;
+		while ( j < n ) {
+			ux1 = SDL_min(x1, out[j].x);
+			uy1 = SDL_min(y1, out[j].y);
+			ux2 = SDL_max(x2, out[j].x + out[j].w);
+			uy2 = SDL_max(y2, out[j].y + out[j].h);
+			union_area = area + covered[j] -
+			    SDL_max(0, SDL_min(x2, out[j].x + out[j].w) -
+			               SDL_max(x1, out[j].x)) *
+			    SDL_max(0, SDL_min(y2, out[j].y + out[j].h) -
+			               SDL_max(y1, out[j].y));
+			union_area = SDL_max(union_area, SDL_max(area, covered[j]));
+			if ( (ux2-ux1)*(uy2-uy1) - union_area <= merge_cost ) {
+				x1 = ux1;
+				y1 = uy1;
+				x2 = ux2;
+				y2 = uy2;
+				area = union_area;
+				--n;
+				out[j] = out[n];
+				covered[j] = covered[n];
+			} else {
+				++j;
+			}
+		}
+		out[n].x = x1;
+		out[n].y = y1;
+		out[n].w = x2 - x1;
+		out[n].h = y2 - y1;
+		covered[n] = area;
+		++n;
+	}
+	*merged = out;
+	return(n);
+}
+
 static void X11_NormalUpdate(_THIS, int numrects, SDL_Rect *rects)
 {
 	int i;
 	
+	numrects = X11_MergeRects(this, numrects, rects, &rects);
 	for (i = 0; i < numrects; ++i) {
 		if ( rects[i].w == 0 || rects[i].h == 0 ) { /* Clipped? */
 			continue;
@@ -241,7 +467,10 @@ static void X11_NormalUpdate(_THIS, int numrects, SDL_Rect *rects)
 		XPutImage(GFX_Display, SDL_Window, SDL_GC, SDL_Ximage,
 			  rects[i].x, rects[i].y,
 			  rects[i].x, rects[i].y, rects[i].w, rects[i].h);
+		++update_stats.requests;
+		update_stats.pixels_sent += rects[i].w*rects[i].h;
 	}
+	++update_stats.flushes;
 	if ( SDL_VideoSurface->flags & SDL_ASYNCBLIT ) {
 		XFlush(GFX_Display);
 		blit_queued = 1;
@@ -250,11 +479,80 @@ static void X11_NormalUpdate(_THIS, int numrects, SDL_Rect *rects)
 	}
 }
 
+#ifndef NO_SHARED_MEMORY
+static void X11_MITSHMPresent(_THIS, int numrects, SDL_Rect *rects)
+{
+	int i, last, which, bpp, pitch;
+	Uint8 *src, *dst;
+	int row, len;
+	XImage *image;
+
+	last = -1;
+	for ( i=0; i<numrects; ++i ) {
+		if ( rects[i].w && rects[i].h ) {
+			last = i;
+		}
+	}
+	if ( last < 0 ) {
+		return;
+	}
+
+	which = shm_next;
+	shm_wait_present(this, which);
+	image = shm_present[which].image;
+
+	bpp = SDL_VideoSurface->format->BytesPerPixel;
+	pitch = SDL_Ximage->bytes_per_line;
+	for ( i=0; i<=last; ++i ) {
+		if ( rects[i].w == 0 || rects[i].h == 0 ) { /* Clipped? */
+			continue;
+		}
+		src = (Uint8 *)SDL_Ximage->data +
+		      rects[i].y*pitch + rects[i].x*bpp;
+		dst = (Uint8 *)image->data +
+		      rects[i].y*pitch + rects[i].x*bpp;
+		len = rects[i].w*bpp;
+		for ( row=rects[i].h; row; --row ) {
+			SDL_memcpy(dst, src, len);
+			src += pitch;
+			dst += pitch;
+		}
+	}
+
+	/* Only the last request needs to tell us when it's done */
+	for ( i=0; i<=last; ++i ) {
+		if ( rects[i].w == 0 || rects[i].h == 0 ) { /* Clipped? */
+			continue;
+		}
+		if ( i == last ) {
+			shm_present[which].serial = NextRequest(GFX_Display);
+		}
+		XShmPutImage(GFX_Display, SDL_Window, SDL_GC, image,
+				rects[i].x, rects[i].y,
+				rects[i].x, rects[i].y, rects[i].w, rects[i].h,
+				(i == last));
+		++update_stats.requests;
+		update_stats.pixels_sent += rects[i].w*rects[i].h;
+	}
+	shm_present[which].busy = 1;
+	++update_stats.flushes;
+	XFlush(GFX_Display);
+
+	shm_next = (which + 1) % shm_npresent;
+}
+#endif /* ! NO_SHARED_MEMORY */
+
 static void X11_MITSHMUpdate(_THIS, int numrects, SDL_Rect *rects)
 {
 #ifndef NO_SHARED_MEMORY
 	int i;
 
+	numrects = X11_MergeRects(this, numrects, rects, &rects);
+	if ( shm_npresent ) {
+		X11_MITSHMPresent(this, numrects, rects);
+		return;
+	}
+
 	for ( i=0; i<numrects; ++i ) {
 		if ( rects[i].w == 0 || rects[i].h == 0 ) { /* Clipped? */
 			continue;
@@ -263,7 +561,10 @@ static void X11_MITSHMUpdate(_THIS, int numrects, SDL_Rect *rects)
 				rects[i].x, rects[i].y,
 				rects[i].x, rects[i].y, rects[i].w, rects[i].h,
 									False);
+		++update_stats.requests;
+		update_stats.pixels_sent += rects[i].w*rects[i].h;
 	}
+	++update_stats.flushes;
 	if ( SDL_VideoSurface->flags & SDL_ASYNCBLIT ) {
 		XFlush(GFX_Display);
 		blit_queued = 1;
@@ -32,6 +32,8 @@ extern void X11_FreeHWSurface(_THIS, SDL_Surface *surface);
 extern int X11_LockHWSurface(_THIS, SDL_Surface *surface);
 extern void X11_UnlockHWSurface(_THIS, SDL_Surface *surface);
 extern int X11_FlipHWSurface(_THIS, SDL_Surface *surface);
+extern int X11_GetUpdateStats(_THIS, SDL_UpdateStats *stats);
+extern void X11_FreeUpdateRects(_THIS);
 
 extern void X11_DisableAutoRefresh(_THIS);
 extern void X11_EnableAutoRefresh(_THIS);
@@ -149,6 +149,7 @@ static SDL_VideoDevice *X11_CreateDevice(int devindex)
 		device->LockHWSurface = X11_LockHWSurface;
 		device->UnlockHWSurface = X11_UnlockHWSurface;
 		device->FlipHWSurface = X11_FlipHWSurface;
+		device->GetUpdateStats = X11_GetUpdateStats;
 		device->FreeHWSurface = X11_FreeHWSurface;
 		device->SetGamma = X11_SetVidModeGamma;
 		device->GetGamma = X11_GetVidModeGamma;
@@ -1523,6 +1524,7 @@ void X11_VideoQuit(_THIS)
 
 		/* Start shutting down the windows */
 		X11_DestroyImage(this, this->screen);
+		X11_FreeUpdateRects(this);
 		X11_DestroyWindow(this, this->screen);
 		X11_FreeVideoModes(this);
 		if ( SDL_XColorMap != SDL_DisplayColormap ) {
@@ -75,6 +75,17 @@ struct SDL_PrivateVideoData {
     /* MIT shared memory extension information */
     int use_mitshm;
     XShmSegmentInfo shminfo;
+
+    /* Segments the screen is copied into for asynchronous presents */
+    struct {
+        XShmSegmentInfo info;
+        XImage *image;
+        unsigned long serial;	/* request the server will complete */
+        int busy;		/* flag: waiting for ShmCompletion */
+    } shm_present[3];
+    int shm_npresent;
+    int shm_next;
+    int shm_completion;		/* ShmCompletion event type */
 #endif
 
     /* The variables used for displaying graphics */
@@ -143,6 +154,13 @@ struct SDL_PrivateVideoData {
     /* Prevent too many XSync() calls */
     int blit_queued;
 
+    /* Merging of small update rectangles into fewer requests */
+    int merge_cost;		/* pixels a saved request is worth */
+    SDL_Rect *merge_rects;
+    int *merge_covered;
+    int merge_max;
+    SDL_UpdateStats update_stats;
+
     /* Colormap handling */
     Colormap DisplayColormap;	/* The default display colormap */
     Colormap XColorMap;		/* The current window colormap */
@@ -174,6 +192,10 @@ struct SDL_PrivateVideoData {
 #define using_dga		(this->hidden->using_dga)
 #define use_mitshm		(this->hidden->use_mitshm)
 #define shminfo			(this->hidden->shminfo)
+#define shm_present		(this->hidden->shm_present)
+#define shm_npresent		(this->hidden->shm_npresent)
+#define shm_next		(this->hidden->shm_next)
+#define shm_completion		(this->hidden->shm_completion)
 #define SDL_Ximage		(this->hidden->Ximage)
 #define SDL_GC			(this->hidden->gc)
 #define window_w		(this->hidden->window_w)
@@ -197,6 +219,11 @@ struct SDL_PrivateVideoData {
 #define switch_waiting		(this->hidden->switch_waiting)
 #define switch_time		(this->hidden->switch_time)
 #define blit_queued		(this->hidden->blit_queued)
+#define merge_cost		(this->hidden->merge_cost)
+#define merge_rects		(this->hidden->merge_rects)
+#define merge_covered		(this->hidden->merge_covered)
+#define merge_max		(this->hidden->merge_max)
+#define update_stats		(this->hidden->update_stats)
 #define SDL_DisplayColormap	(this->hidden->DisplayColormap)
 #define SDL_PrivateColormap	(this->hidden->PrivateColormap)
 #define SDL_XColorMap		(this->hidden->XColorMap)
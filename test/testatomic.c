@@ -0,0 +1,135 @@
+/* Simple test of the SDL atomic operations and spinlocks */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "SDL_atomic.h"
+
+#define NUM_THREADS 8
+#define NUM_ITERATIONS 100000
+
+static SDL_AtomicInt counter;
+static SDL_SpinLock lock = SDL_SPINLOCK_INIT;
+static int locked_counter = 0;
+
+/* Hand-off slot checked with acquire/release ordering */
+static SDL_AtomicPointer slot;
+static int payload;
+
+int SDLCALL AddThread(void *data)
+{
+	int i;
+
+	for ( i = 0; i < NUM_ITERATIONS; ++i ) {
+		SDL_AtomicIncRef(&counter);
+	}
+	return 0;
+}
+
+int SDLCALL LockThread(void *data)
+{
+	int i;
+
+	for ( i = 0; i < NUM_ITERATIONS; ++i ) {
+		SDL_AtomicLock(&lock);
+		++locked_counter;
+		SDL_AtomicUnlock(&lock);
+	}
+	return 0;
+}
+
+int SDLCALL ProducerThread(void *data)
+{
+	payload = 42;
+	SDL_AtomicStorePtr(&slot, &payload);
+	return 0;
+}
+
+static int RunThreads(const char *name, int (SDLCALL *fn)(void *))
+{
+	SDL_Thread *threads[NUM_THREADS];
+	Uint32 start;
+	int i;
+
+	start = SDL_GetTicks();
+	for ( i = 0; i < NUM_THREADS; ++i ) {
+		threads[i] = SDL_CreateThread(fn, NULL);
+		if ( threads[i] == NULL ) {
+			fprintf(stderr, "Couldn't create thread: %s\n", SDL_GetError());
+			return -1;
+		}
+	}
+	for ( i = 0; i < NUM_THREADS; ++i ) {
+		SDL_WaitThread(threads[i], NULL);
+	}
+	printf("%s: %d threads x %d iterations in %d ms\n", name,
+	       NUM_THREADS, NUM_ITERATIONS, SDL_GetTicks() - start);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_Thread *producer;
+	int *value;
+	int failed = 0;
+
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	/* Single threaded sanity checks */
+	SDL_AtomicStore(&counter, 10);
+	if ( !SDL_AtomicCAS(&counter, 10, 20) || SDL_AtomicCAS(&counter, 10, 30) ) {
+		fprintf(stderr, "SDL_AtomicCAS() failed\n");
+		failed = 1;
+	}
+	if ( SDL_AtomicSwap(&counter, 1) != 20 || SDL_AtomicLoad(&counter) != 1 ) {
+		fprintf(stderr, "SDL_AtomicSwap() failed\n");
+		failed = 1;
+	}
+	if ( !SDL_AtomicDecRef(&counter) || SDL_AtomicLoad(&counter) != 0 ) {
+		fprintf(stderr, "SDL_AtomicDecRef() failed\n");
+		failed = 1;
+	}
+	if ( !SDL_AtomicTryLock(&lock) || SDL_AtomicTryLock(&lock) ) {
+		fprintf(stderr, "SDL_AtomicTryLock() failed\n");
+		failed = 1;
+	}
+	SDL_AtomicUnlock(&lock);
+
+	/* Contended counters */
+	if ( RunThreads("SDL_AtomicAdd", AddThread) < 0 ||
+	     RunThreads("SDL_SpinLock", LockThread) < 0 ) {
+		SDL_Quit();
+		return(1);
+	}
+	if ( SDL_AtomicLoad(&counter) != NUM_THREADS * NUM_ITERATIONS ) {
+		fprintf(stderr, "Atomic counter is %d, expected %d\n",
+		        SDL_AtomicLoad(&counter), NUM_THREADS * NUM_ITERATIONS);
+		failed = 1;
+	}
+	if ( locked_counter != NUM_THREADS * NUM_ITERATIONS ) {
+		fprintf(stderr, "Spinlocked counter is %d, expected %d\n",
+		        locked_counter, NUM_THREADS * NUM_ITERATIONS);
+		failed = 1;
+	}
+
+	/* Pointer hand-off */
+	SDL_AtomicStorePtr(&slot, NULL);
+	producer = SDL_CreateThread(ProducerThread, NULL);
+	while ( (value = (int *)SDL_AtomicLoadPtr(&slot)) == NULL ) {
+		SDL_Delay(0);
+	}
+	SDL_WaitThread(producer, NULL);
+	if ( *value != 42 || !SDL_AtomicCASPtr(&slot, value, NULL) ||
+	     SDL_AtomicSwapPtr(&slot, value) != NULL ) {
+		fprintf(stderr, "Atomic pointer hand-off failed\n");
+		failed = 1;
+	}
+
+	printf("%s\n", failed ? "FAILED" : "All tests passed");
+	SDL_Quit();
+	return(failed);
+}
@@ -0,0 +1,627 @@
+/* Benchmark of the audio conversion filters, the mixer and the timing of
+   the audio callback.
+   Times each of SDL's conversion filters on its own and a few complete
+   SDL_BuildAudioCVT() chains, SDL_MixAudio() mixing several streams in
+   each format, and the interval between callbacks on the dummy and disk
+   audio drivers (or the one given with --driver), and how fast the disk
+   driver renders in freewheel mode, and prints the results as a table or
+   as CSV.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "SDL.h"
+
+#define MAX_REPS	100
+#define MAX_STREAMS	32
+#define MAX_CALLBACKS	4096
+
+static const struct {
+	const char *name;
+	Uint16 format;
+	int channels;
+	double rate_incr;
+} filters[] = {
+	{ "SDL_ConvertEndian",     AUDIO_S16LSB, 2, 0.0 },
+	{ "SDL_ConvertSign",       AUDIO_S16LSB, 2, 0.0 },
+	{ "SDL_ConvertSign",       AUDIO_U8,     2, 0.0 },
+	{ "SDL_Convert8",          AUDIO_S16LSB, 2, 0.0 },
+	{ "SDL_Convert16LSB",      AUDIO_U8,     2, 0.0 },
+	{ "SDL_Convert16MSB",      AUDIO_U8,     2, 0.0 },
+	{ "SDL_ConvertMono",       AUDIO_S16LSB, 2, 0.0 },
+	{ "SDL_ConvertMono",       AUDIO_U8,     2, 0.0 },
+	{ "SDL_ConvertStereo",     AUDIO_S16LSB, 1, 0.0 },
+	{ "SDL_ConvertStereo",     AUDIO_U8,     1, 0.0 },
+	{ "SDL_ConvertSurround",   AUDIO_S16LSB, 2, 0.0 },
+	{ "SDL_ConvertSurround_4", AUDIO_S16LSB, 2, 0.0 },
+	{ "SDL_ConvertStrip",      AUDIO_S16LSB, 6, 0.0 },
+	{ "SDL_ConvertStrip_2",    AUDIO_S16LSB, 6, 0.0 },
+	{ "SDL_RateMUL2",          AUDIO_S16LSB, 1, 0.0 },
+	{ "SDL_RateMUL2_c2",       AUDIO_S16LSB, 2, 0.0 },
+	{ "SDL_RateMUL2_c2",       AUDIO_U8,     2, 0.0 },
+	{ "SDL_RateMUL2_c4",       AUDIO_S16LSB, 4, 0.0 },
+	{ "SDL_RateMUL2_c6",       AUDIO_S16LSB, 6, 0.0 },
+	{ "SDL_RateDIV2",          AUDIO_S16LSB, 1, 0.0 },
+	{ "SDL_RateDIV2_c2",       AUDIO_S16LSB, 2, 0.0 },
+	{ "SDL_RateDIV2_c2",       AUDIO_U8,     2, 0.0 },
+	{ "SDL_RateDIV2_c4",       AUDIO_S16LSB, 4, 0.0 },
+	{ "SDL_RateDIV2_c6",       AUDIO_S16LSB, 6, 0.0 },
+	{ "SDL_RateSLOW",          AUDIO_S16LSB, 2, 44100.0/48000.0 },
+	{ "SDL_RateSLOW",          AUDIO_S16LSB, 2, 48000.0/44100.0 }
+};
+
+static const struct {
+	Uint16 src_format;
+	Uint8 src_channels;
+	int src_rate;
+	Uint16 dst_format;
+	Uint8 dst_channels;
+	int dst_rate;
+} chains[] = {
+	{ AUDIO_U8,     1, 11025, AUDIO_S16LSB, 2, 44100 },
+	{ AUDIO_S16LSB, 1, 22050, AUDIO_S16LSB, 2, 44100 },
+	{ AUDIO_S16LSB, 2, 22050, AUDIO_S16LSB, 2, 44100 },
+	{ AUDIO_S16LSB, 2, 44100, AUDIO_S16LSB, 2, 22050 },
+	{ AUDIO_S16MSB, 2, 44100, AUDIO_S16LSB, 2, 44100 },
+	{ AUDIO_S16LSB, 2, 44100, AUDIO_U8,     1, 22050 },
+	{ AUDIO_S16LSB, 2, 44100, AUDIO_S16LSB, 6, 44100 },
+	{ AUDIO_S16LSB, 6, 48000, AUDIO_S16LSB, 2, 48000 }
+};
+
+static const Uint16 mix_formats[] = {
+	AUDIO_U8, AUDIO_S8, AUDIO_S16LSB, AUDIO_S16MSB
+};
+static const int mix_streams[] = { 1, 2, 4, 8, 16, 32 };
+
+static const char *drivers[] = { "dummy", "disk" };
+
+/* Options */
+static int reps = 5;
+static int mintime = 20;
+static int frames = 4096;
+static int duration = 2000;
+static int callback_samples = 1024;
+static const char *only = NULL;
+static int csv = 0;
+
+/* Callback times */
+static Uint32 stamps[MAX_CALLBACKS];
+static volatile int num_stamps = 0;
+static volatile int total_stamps = 0;
+
+static const char *FormatName(Uint16 format)
+{
+	switch (format) {
+	    case AUDIO_U8:     return "U8";
+	    case AUDIO_S8:     return "S8";
+	    case AUDIO_U16LSB: return "U16LSB";
+	    case AUDIO_S16LSB: return "S16LSB";
+	    case AUDIO_U16MSB: return "U16MSB";
+	    case AUDIO_S16MSB: return "S16MSB";
+	}
+	return "unknown";
+}
+
+/* Returns whether 'name' is in the comma separated list of tests to run */
+static int Wanted(const char *name)
+{
+	const char *list = only;
+	size_t len = strlen(name);
+
+	if ( list == NULL ) {
+		return 1;
+	}
+	while ( *list ) {
+		if ( strncmp(list, name, len) == 0 &&
+		     (list[len] == ',' || list[len] == '\0') ) {
+			return 1;
+		}
+		while ( *list && *list != ',' ) {
+			++list;
+		}
+		if ( *list == ',' ) {
+			++list;
+		}
+	}
+	return 0;
+}
+
+static void PrintHeader(void)
+{
+	if ( csv ) {
+		printf("kind,name,format,channels,detail,mean,stddev,min,unit\n");
+	} else {
+		printf("%-8s %-22s %-6s %3s %-40s %9s %8s %9s %s\n",
+		       "kind", "name", "format", "ch", "detail",
+		       "mean", "stddev", "min", "unit");
+	}
+}
+
+static void PrintResult(const char *kind, const char *name, Uint16 format,
+                        int channels, const char *detail,
+                        double mean, double stddev, double min,
+                        const char *unit)
+{
+	if ( csv ) {
+		printf("%s,%s,%s,%d,%s,%.3f,%.3f,%.3f,%s\n",
+		       kind, name, FormatName(format), channels, detail,
+		       mean, stddev, min, unit);
+	} else {
+		printf("%-8s %-22s %-6s %3d %-40s %9.2f %8.2f %9.2f %s\n",
+		       kind, name, FormatName(format), channels, detail,
+		       mean, stddev, min, unit);
+	}
+	fflush(stdout);
+}
+
+static void Statistics(const double *value, int count,
+                       double *mean, double *stddev, double *min)
+{
+	int i;
+
+	*mean = 0.0;
+	*min = value[0];
+	for ( i=0; i<count; ++i ) {
+		*mean += value[i];
+		if ( value[i] < *min ) {
+			*min = value[i];
+		}
+	}
+	*mean /= count;
+	*stddev = 0.0;
+	for ( i=0; i<count; ++i ) {
+		*stddev += (value[i] - *mean) * (value[i] - *mean);
+	}
+	if ( count > 1 ) {
+		*stddev = sqrt(*stddev / (count - 1));
+	}
+}
+
+/* Run the conversion in batches until 'ms' milliseconds have passed,
+   and return the number of conversions per millisecond.
+ */
+static double MeasureConvert(SDL_AudioCVT *cvt, int ms, int batch, int *count)
+{
+	Uint32 start, elapsed;
+	int i;
+
+	*count = 0;
+	start = SDL_GetTicks();
+	do {
+		for ( i=0; i<batch; ++i ) {
+			SDL_ConvertAudio(cvt);
+		}
+		*count += batch;
+		elapsed = SDL_GetTicks() - start;
+	} while ( elapsed < (Uint32)ms );
+
+	return (double)*count / elapsed;
+}
+
+/* Time a conversion, returning the speed in millions of sample frames
+   of input per second.
+ */
+static void TimeConvert(SDL_AudioCVT *cvt, double *mean, double *stddev, double *min)
+{
+	double speed[MAX_REPS];
+	int i, batch, count;
+
+	/* Warm up, and pick a batch that takes about a millisecond */
+	MeasureConvert(cvt, mintime, 1, &count);
+	batch = count / mintime;
+	if ( batch < 1 ) {
+		batch = 1;
+	}
+	for ( i=0; i<reps; ++i ) {
+		speed[i] = MeasureConvert(cvt, mintime, batch, &count) * frames / 1000.0;
+	}
+	Statistics(speed, reps, mean, stddev, min);
+}
+
+/* The audio data is noise; the filters don't care what it sounds like */
+static Uint8 *CreateBuffer(int len)
+{
+	Uint8 *buf;
+	int i;
+
+	buf = (Uint8 *)malloc(len);
+	if ( buf ) {
+		for ( i=0; i<len; ++i ) {
+			buf[i] = (Uint8)(rand() >> 4);
+		}
+	}
+	return buf;
+}
+
+static int BenchFilters(void)
+{
+	SDL_AudioCVT cvt;
+	char detail[64];
+	double mean, stddev, min;
+	int i, len;
+
+	for ( i=0; i<(int)SDL_arraysize(filters); ++i ) {
+		memset(&cvt, 0, sizeof(cvt));
+		cvt.filters[0] = SDL_GetAudioFilter(filters[i].name);
+		if ( cvt.filters[0] == NULL ) {
+			fprintf(stderr, "%s\n", SDL_GetError());
+			return -1;
+		}
+		cvt.needed = 1;
+		cvt.src_format = filters[i].format;
+		cvt.rate_incr = filters[i].rate_incr;
+		len = frames * filters[i].channels * ((filters[i].format & 0xFF) / 8);
+		cvt.len = len;
+		cvt.len_mult = 8;
+		cvt.buf = CreateBuffer(len * cvt.len_mult);
+		if ( cvt.buf == NULL ) {
+			fprintf(stderr, "Out of memory\n");
+			return -1;
+		}
+		TimeConvert(&cvt, &mean, &stddev, &min);
+		detail[0] = '\0';
+		if ( filters[i].rate_incr != 0.0 ) {
+			sprintf(detail, "rate_incr=%.4f", filters[i].rate_incr);
+		}
+		PrintResult("filter", filters[i].name, filters[i].format,
+		            filters[i].channels, detail,
+		            mean, stddev, min, "Mframes/s");
+		free(cvt.buf);
+	}
+	return 0;
+}
+
+static int BenchChains(void)
+{
+	SDL_AudioCVT cvt;
+	char name[64];
+	char detail[256];
+	const char *filter;
+	double mean, stddev, min;
+	int i, j, len;
+
+	for ( i=0; i<(int)SDL_arraysize(chains); ++i ) {
+		if ( SDL_BuildAudioCVT(&cvt,
+		                       chains[i].src_format,
+		                       chains[i].src_channels,
+		                       chains[i].src_rate,
+		                       chains[i].dst_format,
+		                       chains[i].dst_channels,
+		                       chains[i].dst_rate) < 0 ) {
+			fprintf(stderr, "Couldn't build audio conversion: %s\n",
+			        SDL_GetError());
+			return -1;
+		}
+		sprintf(name, "%d>%s/%d/%d", chains[i].src_rate,
+		        FormatName(chains[i].dst_format),
+		        chains[i].dst_channels, chains[i].dst_rate);
+		detail[0] = '\0';
+		for ( j=0; cvt.filters[j]; ++j ) {
+			filter = SDL_GetAudioFilterName(cvt.filters[j]);
+			if ( j > 0 ) {
+				strcat(detail, "+");
+			}
+			/* Leave out the common prefix, to keep the line short */
+			strcat(detail, filter ? filter + 4 : "custom");
+		}
+		if ( j == 0 ) {
+			strcpy(detail, "(none)");
+		}
+		len = frames * chains[i].src_channels *
+		      ((chains[i].src_format & 0xFF) / 8);
+		cvt.len = len;
+		cvt.buf = CreateBuffer(len * cvt.len_mult);
+		if ( cvt.buf == NULL ) {
+			fprintf(stderr, "Out of memory\n");
+			return -1;
+		}
+		TimeConvert(&cvt, &mean, &stddev, &min);
+		PrintResult("chain", name, chains[i].src_format,
+		            chains[i].src_channels, detail,
+		            mean, stddev, min, "Mframes/s");
+		free(cvt.buf);
+	}
+	return 0;
+}
+
+static void SDLCALL Silence(void *unused, Uint8 *stream, int len)
+{
+	/* The stream is already silent */
+}
+
+/* Returns the speed of mixing 'streams' buffers of stereo audio into
+   one, in millions of sample frames mixed per second.
+ */
+static double MeasureMix(Uint8 *dst, Uint8 **src, int streams, int len,
+                         int ms, int batch, int *count)
+{
+	Uint32 start, elapsed;
+	int i, j;
+
+	*count = 0;
+	start = SDL_GetTicks();
+	do {
+		for ( i=0; i<batch; ++i ) {
+			for ( j=0; j<streams; ++j ) {
+				SDL_MixAudio(dst, src[j], len, SDL_MIX_MAXVOLUME/2);
+			}
+		}
+		*count += batch;
+		elapsed = SDL_GetTicks() - start;
+	} while ( elapsed < (Uint32)ms );
+
+	return ((double)*count * streams * frames) / (elapsed * 1000.0);
+}
+
+static int BenchMixer(void)
+{
+	SDL_AudioSpec spec;
+	char detail[32];
+	Uint8 *dst, *src[MAX_STREAMS];
+	double speed[MAX_REPS];
+	double mean, stddev, min;
+	int i, j, k, n, len, batch, count;
+
+	SDL_putenv("SDL_AUDIODRIVER=dummy");
+	for ( i=0; i<(int)SDL_arraysize(mix_formats); ++i ) {
+		/* SDL_MixAudio() mixes in the format of the open device */
+		memset(&spec, 0, sizeof(spec));
+		spec.freq = 44100;
+		spec.format = mix_formats[i];
+		spec.channels = 2;
+		spec.samples = 1024;
+		spec.callback = Silence;
+		if ( SDL_OpenAudio(&spec, NULL) < 0 ) {
+			fprintf(stderr, "Couldn't open %s audio: %s\n",
+			        FormatName(mix_formats[i]), SDL_GetError());
+			return -1;
+		}
+		len = frames * 2 * ((mix_formats[i] & 0xFF) / 8);
+		dst = CreateBuffer(len);
+		for ( j=0; j<MAX_STREAMS; ++j ) {
+			src[j] = CreateBuffer(len);
+		}
+		for ( j=0; j<(int)SDL_arraysize(mix_streams); ++j ) {
+			n = mix_streams[j];
+			MeasureMix(dst, src, n, len, mintime, 1, &count);
+			batch = count / mintime;
+			if ( batch < 1 ) {
+				batch = 1;
+			}
+			for ( k=0; k<reps; ++k ) {
+				speed[k] = MeasureMix(dst, src, n, len, mintime, batch, &count);
+			}
+			Statistics(speed, reps, &mean, &stddev, &min);
+			sprintf(detail, "streams=%d", n);
+			PrintResult("mixer", "SDL_MixAudio", mix_formats[i], 2,
+			            detail, mean, stddev, min, "Mframes/s");
+		}
+		for ( j=0; j<MAX_STREAMS; ++j ) {
+			free(src[j]);
+		}
+		free(dst);
+		SDL_CloseAudio();
+	}
+	return 0;
+}
+
+static void SDLCALL Stamp(void *unused, Uint8 *stream, int len)
+{
+	if ( num_stamps < MAX_CALLBACKS ) {
+		stamps[num_stamps++] = SDL_GetTicks();
+	}
+	++total_stamps;
+}
+
+/* Play silence for a while and look at how evenly the callback is called */
+static int BenchCallback(const char *driver)
+{
+	/* putenv() keeps the strings, so they can't be on the stack */
+	static char driver_env[64];
+	SDL_AudioSpec spec, obtained;
+	char detail[64];
+	double *interval;
+	double period, mean, stddev, min, max;
+	int i, count, late;
+
+	memset(&spec, 0, sizeof(spec));
+	spec.freq = 44100;
+	spec.format = AUDIO_S16LSB;
+	spec.channels = 2;
+	spec.samples = (Uint16)callback_samples;
+	spec.callback = Stamp;
+	period = (1000.0 * spec.samples) / spec.freq;
+
+	SDL_snprintf(driver_env, sizeof(driver_env), "SDL_AUDIODRIVER=%s", driver);
+	SDL_putenv(driver_env);
+	if ( strcmp(driver, "disk") == 0 ) {
+		SDL_putenv("SDL_DISKAUDIOFILE=testaudiobench.raw");
+		/* Write at the rate the audio would play, not as fast as possible */
+		SDL_putenv("SDL_DISKAUDIOMODE=realtime");
+	}
+	if ( SDL_OpenAudio(&spec, &obtained) < 0 ) {
+		fprintf(stderr, "Couldn't open %s audio: %s\n", driver, SDL_GetError());
+		return -1;
+	}
+	/* The driver may have picked another buffer size */
+	period = (1000.0 * obtained.samples) / obtained.freq;
+	num_stamps = 0;
+	SDL_PauseAudio(0);
+	SDL_Delay(duration);
+	SDL_PauseAudio(1);
+	SDL_CloseAudio();
+	if ( strcmp(driver, "disk") == 0 ) {
+		remove("testaudiobench.raw");
+	}
+
+	/* Skip the first few callbacks, which fill the driver's buffers */
+	count = num_stamps - 3;
+	if ( count < 2 ) {
+		fprintf(stderr, "Only %d callbacks from %s audio\n", num_stamps, driver);
+		return -1;
+	}
+	interval = (double *)malloc(count * sizeof(*interval));
+	if ( interval == NULL ) {
+		return -1;
+	}
+	late = 0;
+	max = 0.0;
+	for ( i=0; i<count; ++i ) {
+		interval[i] = (double)(stamps[i+3] - stamps[i+2]);
+		if ( interval[i] > 1.5 * period ) {
+			++late;
+		}
+		if ( interval[i] > max ) {
+			max = interval[i];
+		}
+	}
+	Statistics(interval, count, &mean, &stddev, &min);
+	free(interval);
+
+	sprintf(detail, "period=%.1f max=%.1f", period, max);
+	PrintResult("callback", driver, spec.format, spec.channels, detail,
+	            mean, stddev, min, "ms");
+	sprintf(detail, "of %d callbacks", count);
+	PrintResult("late", driver, spec.format, spec.channels, detail,
+	            late, 0.0, late, "callbacks");
+	return 0;
+}
+
+/* Render silence to a WAVE file as fast as the disk driver can */
+static int BenchFreewheel(void)
+{
+	SDL_AudioSpec spec, obtained;
+	char detail[64];
+	double rate;
+	Uint32 start, elapsed;
+
+	memset(&spec, 0, sizeof(spec));
+	spec.freq = 44100;
+	spec.format = AUDIO_S16LSB;
+	spec.channels = 2;
+	spec.samples = (Uint16)callback_samples;
+	spec.callback = Stamp;
+
+	SDL_putenv("SDL_AUDIODRIVER=disk");
+	SDL_putenv("SDL_DISKAUDIOFILE=testaudiobench.wav");
+	SDL_putenv("SDL_DISKAUDIOMODE=freewheel");
+	if ( SDL_OpenAudio(&spec, &obtained) < 0 ) {
+		fprintf(stderr, "Couldn't open disk audio: %s\n", SDL_GetError());
+		return -1;
+	}
+	num_stamps = 0;
+	total_stamps = 0;
+	start = SDL_GetTicks();
+	SDL_PauseAudio(0);
+	SDL_Delay(duration);
+	SDL_PauseAudio(1);
+	elapsed = SDL_GetTicks() - start;
+	SDL_CloseAudio();
+	remove("testaudiobench.wav");
+
+	rate = ((double)total_stamps * obtained.samples) / (elapsed / 1000.0);
+	sprintf(detail, "%.0fx real time", rate / obtained.freq);
+	PrintResult("render", "disk freewheel", obtained.format, obtained.channels,
+	            detail, rate / 1000000.0, 0.0, rate / 1000000.0, "Mframes/s");
+	return 0;
+}
+
+static void PrintUsage(const char *argv0)
+{
+	fprintf(stderr,
+"Usage: %s [options]\n"
+"  --only LIST       filters,chains,mixer,callback,render\n"
+"  --frames N        sample frames converted or mixed at once (default %d)\n"
+"  --reps N          timed repetitions of each case (default %d)\n"
+"  --time MS         length of each repetition (default %d)\n"
+"  --samples N       audio buffer size for the callback test (default %d)\n"
+"  --duration MS     length of the callback test (default %d)\n"
+"  --driver NAME     time the callback on this driver instead of dummy and disk\n"
+"  --csv             print the results as CSV\n",
+	        argv0, frames, reps, mintime, callback_samples, duration);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *driver = NULL;
+	int i, failed = 0;
+
+	for ( i=1; i<argc; ++i ) {
+		const char *arg = argv[i];
+		const char *value = (i+1 < argc) ? argv[i+1] : NULL;
+
+		if ( strcmp(arg, "--only") == 0 && value ) {
+			only = value;
+			++i;
+		} else if ( strcmp(arg, "--frames") == 0 && value ) {
+			frames = atoi(value);
+			++i;
+		} else if ( strcmp(arg, "--reps") == 0 && value ) {
+			reps = atoi(value);
+			++i;
+		} else if ( strcmp(arg, "--time") == 0 && value ) {
+			mintime = atoi(value);
+			++i;
+		} else if ( strcmp(arg, "--samples") == 0 && value ) {
+			callback_samples = atoi(value);
+			++i;
+		} else if ( strcmp(arg, "--duration") == 0 && value ) {
+			duration = atoi(value);
+			++i;
+		} else if ( strcmp(arg, "--driver") == 0 && value ) {
+			driver = value;
+			++i;
+		} else if ( strcmp(arg, "--csv") == 0 ) {
+			csv = 1;
+		} else {
+			PrintUsage(argv[0]);
+			return(1);
+		}
+	}
+	if ( reps < 1 ) {
+		reps = 1;
+	} else if ( reps > MAX_REPS ) {
+		reps = MAX_REPS;
+	}
+	if ( mintime < 1 ) {
+		mintime = 1;
+	}
+	if ( frames < 16 ) {
+		frames = 16;
+	}
+	if ( callback_samples < 64 || callback_samples > 32768 ) {
+		callback_samples = 1024;
+	}
+
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	PrintHeader();
+	if ( Wanted("filters") ) {
+		failed |= (BenchFilters() < 0);
+	}
+	if ( Wanted("chains") ) {
+		failed |= (BenchChains() < 0);
+	}
+	if ( Wanted("mixer") ) {
+		failed |= (BenchMixer() < 0);
+	}
+	if ( Wanted("callback") && driver ) {
+		failed |= (BenchCallback(driver) < 0);
+	} else if ( Wanted("callback") ) {
+		for ( i=0; i<(int)SDL_arraysize(drivers); ++i ) {
+			failed |= (BenchCallback(drivers[i]) < 0);
+		}
+	}
+	if ( Wanted("render") ) {
+		failed |= (BenchFreewheel() < 0);
+	}
+
+	SDL_Quit();
+	return(failed);
+}
@@ -0,0 +1,647 @@
+/* Benchmark of the software blitters, fills and surface conversions.
+   Sweeps source and destination formats, blit modes, rectangle sizes
+   and aligned or misaligned offsets with the dummy video driver and
+   reports the speed of each blit routine in megapixels per second,
+   as a table, CSV or JSON.  Given the CSV of an earlier run with
+   --baseline it lists the cases that got slower and exits with 1.
+
+   The instruction sets the blitters use can be pinned with the
+   SDL_BLIT_FEATURES environment variable, for example "c" or "mmx".
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "SDL.h"
+
+#define MAX_REPS	100
+#define MAX_SIZES	16
+#define MAX_BASELINE	8192
+
+static const struct {
+	const char *name;
+	int bpp;
+	Uint32 Rmask, Gmask, Bmask, Amask;
+} formats[] = {
+	{ "INDEX8",   8, 0, 0, 0, 0 },
+	{ "RGB555",  15, 0x7C00, 0x03E0, 0x001F, 0 },
+	{ "RGB565",  16, 0xF800, 0x07E0, 0x001F, 0 },
+	{ "RGB24",   24, 0x00FF0000, 0x0000FF00, 0x000000FF, 0 },
+	{ "XRGB8888", 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0 },
+	{ "ARGB8888", 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 },
+	{ "ABGR8888", 32, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000 },
+	{ "RGBA8888", 32, 0xFF000000, 0x00FF0000, 0x0000FF00, 0x000000FF },
+	{ "BGRA8888", 32, 0x0000FF00, 0x00FF0000, 0xFF000000, 0x000000FF }
+};
+#define NUM_FORMATS	(int)(sizeof(formats)/sizeof(formats[0]))
+
+enum {
+	MODE_COPY,
+	MODE_COLORKEY,
+	MODE_COLORKEY_RLE,
+	MODE_ALPHA,
+	MODE_PIXELALPHA,
+	MODE_PIXELALPHA_RLE,
+	MODE_FILL,
+	MODE_CONVERT,
+	NUM_MODES
+};
+static const char *modes[NUM_MODES] = {
+	"copy", "colorkey", "colorkey-rle", "alpha",
+	"pixelalpha", "pixelalpha-rle", "fill", "convert"
+};
+
+static const SDL_Rect default_sizes[] = {
+	{ 0, 0, 8, 8 },
+	{ 0, 0, 64, 64 },
+	{ 0, 0, 256, 256 },
+	{ 0, 0, 1024, 768 },
+	{ 0, 0, 3840, 2160 }
+};
+
+/* Options */
+static const char *src_list = NULL;
+static const char *dst_list = NULL;
+static const char *mode_list = NULL;
+static SDL_Rect sizes[MAX_SIZES];
+static int num_sizes = 0;
+static int offsets = 3;		/* bit 0: aligned, bit 1: misaligned */
+static int reps = 5;
+static int mintime = 20;
+static enum { OUTPUT_TABLE, OUTPUT_CSV, OUTPUT_JSON } output = OUTPUT_TABLE;
+static double threshold = 10.0;
+
+/* The results of an earlier run to compare against */
+static struct {
+	char src[32], dst[32], mode[32];
+	int w, h, offset;
+	double mpix;
+} *baseline = NULL;
+static int num_baseline = 0;
+static int regressions = 0;
+
+/* Everything needed to run one case */
+typedef struct {
+	int mode;
+	SDL_Surface *src;
+	SDL_Surface *dst;
+	SDL_Rect srcrect;
+	SDL_Rect dstrect;
+	Uint32 color;
+	double pixels;
+} Bench;
+
+/* Returns whether 'name' is in the comma separated 'list', or 1 if
+   there is no list.
+ */
+static int InList(const char *list, const char *name)
+{
+	size_t len = strlen(name);
+
+	if ( list == NULL ) {
+		return 1;
+	}
+	while ( *list ) {
+		if ( SDL_strncasecmp(list, name, len) == 0 &&
+		     (list[len] == ',' || list[len] == '\0') ) {
+			return 1;
+		}
+		while ( *list && *list != ',' ) {
+			++list;
+		}
+		if ( *list == ',' ) {
+			++list;
+		}
+	}
+	return 0;
+}
+
+static int ParseSizes(const char *list)
+{
+	int w, h;
+
+	num_sizes = 0;
+	while ( *list ) {
+		if ( sscanf(list, "%dx%d", &w, &h) != 2 || w <= 0 || h <= 0 ) {
+			fprintf(stderr, "Bad size list: %s\n", list);
+			return -1;
+		}
+		if ( num_sizes < MAX_SIZES ) {
+			sizes[num_sizes].w = (Uint16)w;
+			sizes[num_sizes].h = (Uint16)h;
+			++num_sizes;
+		}
+		while ( *list && *list != ',' ) {
+			++list;
+		}
+		if ( *list == ',' ) {
+			++list;
+		}
+	}
+	return 0;
+}
+
+static int LoadBaseline(const char *file)
+{
+	FILE *fp;
+	char line[256];
+
+	fp = fopen(file, "r");
+	if ( fp == NULL ) {
+		fprintf(stderr, "Couldn't open %s\n", file);
+		return -1;
+	}
+	baseline = malloc(MAX_BASELINE * sizeof(*baseline));
+	if ( baseline == NULL ) {
+		fclose(fp);
+		return -1;
+	}
+	while ( num_baseline < MAX_BASELINE && fgets(line, sizeof(line), fp) ) {
+		if ( sscanf(line, "%31[^,],%31[^,],%31[^,],%dx%d,%d,%*[^,],%lf",
+		            baseline[num_baseline].src,
+		            baseline[num_baseline].dst,
+		            baseline[num_baseline].mode,
+		            &baseline[num_baseline].w,
+		            &baseline[num_baseline].h,
+		            &baseline[num_baseline].offset,
+		            &baseline[num_baseline].mpix) == 7 ) {
+			++num_baseline;
+		}
+	}
+	fclose(fp);
+	return 0;
+}
+
+/* Returns the speed of the case in the baseline, or 0 if it's not there */
+static double FindBaseline(const char *src, const char *dst, const char *mode,
+                           int w, int h, int offset)
+{
+	int i;
+
+	for ( i=0; i<num_baseline; ++i ) {
+		if ( baseline[i].w == w && baseline[i].h == h &&
+		     baseline[i].offset == offset &&
+		     strcmp(baseline[i].src, src) == 0 &&
+		     strcmp(baseline[i].dst, dst) == 0 &&
+		     strcmp(baseline[i].mode, mode) == 0 ) {
+			return baseline[i].mpix;
+		}
+	}
+	return 0.0;
+}
+
+static SDL_Surface *CreateSurface(int format, int w, int h)
+{
+	SDL_Surface *surface;
+	SDL_Color colors[256];
+	int i;
+
+	surface = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h,
+	                               formats[format].bpp,
+	                               formats[format].Rmask,
+	                               formats[format].Gmask,
+	                               formats[format].Bmask,
+	                               formats[format].Amask);
+	if ( surface && surface->format->palette ) {
+		/* A 3-3-2 palette, so magenta is exact */
+		for ( i=0; i<256; ++i ) {
+			colors[i].r = (Uint8)(((i >> 5) & 7) * 255 / 7);
+			colors[i].g = (Uint8)(((i >> 2) & 7) * 255 / 7);
+			colors[i].b = (Uint8)((i & 3) * 255 / 3);
+		}
+		SDL_SetColors(surface, colors, 0, 256);
+	}
+	return surface;
+}
+
+/* Fill the source with runs of transparent magenta, opaque, translucent
+   and graded pixels, so the colorkey, alpha and RLE blitters all have
+   work to do.
+ */
+static void FillSource(SDL_Surface *surface)
+{
+	SDL_PixelFormat *fmt = surface->format;
+	Uint32 pixel = 0;
+	Uint8 *p;
+	int x, y;
+
+	for ( y=0; y<surface->h; ++y ) {
+		p = (Uint8 *)surface->pixels + y*surface->pitch;
+		for ( x=0; x<surface->w; ++x ) {
+			switch (((x + y*7) / 16) % 4) {
+			    case 0:
+				pixel = SDL_MapRGBA(fmt, 255, 0, 255, 0);
+				break;
+			    case 1:
+				pixel = SDL_MapRGBA(fmt, (Uint8)(x*3), (Uint8)(y*5), (Uint8)(x+y), 255);
+				break;
+			    case 2:
+				pixel = SDL_MapRGBA(fmt, (Uint8)y, 128, (Uint8)x, 128);
+				break;
+			    case 3:
+				pixel = SDL_MapRGBA(fmt, 64, (Uint8)x, 192, (Uint8)x);
+				break;
+			}
+			switch (fmt->BytesPerPixel) {
+			    case 1:
+				*p = (Uint8)pixel;
+				break;
+			    case 2:
+				*(Uint16 *)p = (Uint16)pixel;
+				break;
+			    case 3:
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+				p[0] = (Uint8)pixel;
+				p[1] = (Uint8)(pixel >> 8);
+				p[2] = (Uint8)(pixel >> 16);
+#else
+				p[0] = (Uint8)(pixel >> 16);
+				p[1] = (Uint8)(pixel >> 8);
+				p[2] = (Uint8)pixel;
+#endif
+				break;
+			    case 4:
+				*(Uint32 *)p = pixel;
+				break;
+			}
+			p += fmt->BytesPerPixel;
+		}
+	}
+}
+
+/* Returns whether the mode makes sense for the source format */
+static int ModeValid(int mode, int format)
+{
+	switch (mode) {
+	    case MODE_ALPHA:
+		/* Surface alpha is ignored for sources with an alpha channel */
+		return (formats[format].Amask == 0);
+	    case MODE_PIXELALPHA:
+	    case MODE_PIXELALPHA_RLE:
+		return (formats[format].Amask != 0);
+	    default:
+		return 1;
+	}
+}
+
+/* Set up the source for the mode and return the name of the routine */
+static const char *SetMode(SDL_Surface *src, SDL_Surface *dst, int mode)
+{
+	Uint32 key = SDL_MapRGBA(src->format, 255, 0, 255, 0);
+
+	SDL_SetColorKey(src, 0, 0);
+	SDL_SetAlpha(src, 0, 255);
+	switch (mode) {
+	    case MODE_COLORKEY:
+		SDL_SetColorKey(src, SDL_SRCCOLORKEY, key);
+		break;
+	    case MODE_COLORKEY_RLE:
+		SDL_SetColorKey(src, SDL_SRCCOLORKEY|SDL_RLEACCEL, key);
+		break;
+	    case MODE_ALPHA:
+		SDL_SetAlpha(src, SDL_SRCALPHA, 128);
+		break;
+	    case MODE_PIXELALPHA:
+		SDL_SetAlpha(src, SDL_SRCALPHA, 255);
+		break;
+	    case MODE_PIXELALPHA_RLE:
+		SDL_SetAlpha(src, SDL_SRCALPHA|SDL_RLEACCEL, 255);
+		break;
+	    case MODE_FILL:
+		return "SDL_FillRect";
+	}
+	return SDL_GetBlitterName(src, dst);
+}
+
+static void RunOnce(Bench *bench)
+{
+	SDL_Surface *surface;
+	SDL_Rect rect;
+
+	switch (bench->mode) {
+	    case MODE_FILL:
+		rect = bench->dstrect;
+		SDL_FillRect(bench->dst, &rect, bench->color);
+		break;
+	    case MODE_CONVERT:
+		surface = SDL_ConvertSurface(bench->src, bench->dst->format, SDL_SWSURFACE);
+		SDL_FreeSurface(surface);
+		break;
+	    default:
+		rect = bench->dstrect;
+		SDL_BlitSurface(bench->src, &bench->srcrect, bench->dst, &rect);
+		break;
+	}
+}
+
+/* Run the case in batches until 'ms' milliseconds have passed,
+   and return the speed in megapixels per second.
+ */
+static double Measure(Bench *bench, int ms, int batch, int *count)
+{
+	Uint32 start, elapsed;
+	int i;
+
+	*count = 0;
+	start = SDL_GetTicks();
+	do {
+		for ( i=0; i<batch; ++i ) {
+			RunOnce(bench);
+		}
+		*count += batch;
+		elapsed = SDL_GetTicks() - start;
+	} while ( elapsed < (Uint32)ms );
+
+	return (*count * bench->pixels) / (elapsed * 1000.0);
+}
+
+static void PrintHeader(void)
+{
+	switch (output) {
+	    case OUTPUT_TABLE:
+		printf("%-8s %-8s %-14s %9s %3s %-24s %9s %7s %9s\n",
+		       "src", "dst", "mode", "size", "off", "routine",
+		       "Mpix/s", "stddev", "min");
+		break;
+	    case OUTPUT_CSV:
+		printf("src,dst,mode,size,offset,routine,mpix,stddev,min,reps\n");
+		break;
+	    case OUTPUT_JSON:
+		printf("{\n  \"features\": %u,\n  \"results\": [", (unsigned)SDL_GetBlitFeatures());
+		break;
+	}
+}
+
+static void PrintFooter(void)
+{
+	if ( output == OUTPUT_JSON ) {
+		printf("\n  ]\n}\n");
+	}
+}
+
+static void PrintResult(const char *src, const char *dst, const char *mode,
+                        int w, int h, int offset, const char *routine,
+                        double mean, double stddev, double min)
+{
+	static int first = 1;
+
+	switch (output) {
+	    case OUTPUT_TABLE:
+		printf("%-8s %-8s %-14s %4dx%-4d %3d %-24s %9.1f %7.1f %9.1f\n",
+		       src, dst, mode, w, h, offset, routine, mean, stddev, min);
+		break;
+	    case OUTPUT_CSV:
+		printf("%s,%s,%s,%dx%d,%d,%s,%.2f,%.2f,%.2f,%d\n",
+		       src, dst, mode, w, h, offset, routine, mean, stddev, min, reps);
+		break;
+	    case OUTPUT_JSON:
+		printf("%s\n    { \"src\": \"%s\", \"dst\": \"%s\", \"mode\": \"%s\", "
+		       "\"width\": %d, \"height\": %d, \"offset\": %d, "
+		       "\"routine\": \"%s\", \"mpix\": %.2f, \"stddev\": %.2f, "
+		       "\"min\": %.2f, \"reps\": %d }",
+		       first ? "" : ",", src, dst, mode, w, h, offset, routine,
+		       mean, stddev, min, reps);
+		break;
+	}
+	first = 0;
+	fflush(stdout);
+}
+
+static void RunCase(Bench *bench, const char *src, const char *dst, int w, int h, int offset)
+{
+	const char *routine;
+	const char *mode = modes[bench->mode];
+	double speed[MAX_REPS];
+	double mean, stddev, min, old;
+	int i, batch, count;
+
+	routine = SetMode(bench->src, bench->dst, bench->mode);
+	if ( routine == NULL ) {
+		fprintf(stderr, "%s to %s %s: %s\n", src, dst, mode, SDL_GetError());
+		return;
+	}
+	bench->srcrect.x = (Sint16)offset;
+	bench->srcrect.y = 0;
+	bench->srcrect.w = (Uint16)w;
+	bench->srcrect.h = (Uint16)h;
+	bench->dstrect = bench->srcrect;
+	bench->pixels = (double)w * h;
+
+	/* Warm up, and pick a batch that takes about a millisecond */
+	Measure(bench, mintime, 1, &count);
+	batch = count / mintime;
+	if ( batch < 1 ) {
+		batch = 1;
+	}
+
+	mean = 0.0;
+	min = 0.0;
+	for ( i=0; i<reps; ++i ) {
+		speed[i] = Measure(bench, mintime, batch, &count);
+		mean += speed[i];
+		if ( i == 0 || speed[i] < min ) {
+			min = speed[i];
+		}
+	}
+	mean /= reps;
+	stddev = 0.0;
+	for ( i=0; i<reps; ++i ) {
+		stddev += (speed[i] - mean) * (speed[i] - mean);
+	}
+	if ( reps > 1 ) {
+		stddev = sqrt(stddev / (reps - 1));
+	}
+	PrintResult(src, dst, mode, w, h, offset, routine, mean, stddev, min);
+
+	old = FindBaseline(src, dst, mode, w, h, offset);
+	if ( old > 0.0 && mean < old * (1.0 - threshold / 100.0) ) {
+		fprintf(stderr, "REGRESSION: %s to %s %s %dx%d+%d (%s): %.1f Mpix/s, was %.1f\n",
+		        src, dst, mode, w, h, offset, routine, mean, old);
+		++regressions;
+	}
+}
+
+static int RunSize(int w, int h)
+{
+	Bench bench;
+	int s, d, m, offset;
+	int filled = 0;
+
+	for ( s=0; s<NUM_FORMATS; ++s ) {
+		if ( !InList(src_list, formats[s].name) ) {
+			continue;
+		}
+		/* One pixel wider, for the misaligned cases */
+		bench.src = CreateSurface(s, w+1, h);
+		if ( bench.src == NULL ) {
+			fprintf(stderr, "Couldn't create %dx%d %s surface: %s\n",
+			        w+1, h, formats[s].name, SDL_GetError());
+			return -1;
+		}
+		FillSource(bench.src);
+
+		for ( d=0; d<NUM_FORMATS; ++d ) {
+			if ( !InList(dst_list, formats[d].name) ) {
+				continue;
+			}
+			bench.dst = CreateSurface(d, w+1, h);
+			if ( bench.dst == NULL ) {
+				fprintf(stderr, "Couldn't create %dx%d %s surface: %s\n",
+				        w+1, h, formats[d].name, SDL_GetError());
+				SDL_FreeSurface(bench.src);
+				return -1;
+			}
+			bench.color = SDL_MapRGB(bench.dst->format, 128, 128, 128);
+			SDL_FillRect(bench.dst, NULL, bench.color);
+
+			for ( m=0; m<NUM_MODES; ++m ) {
+				if ( !InList(mode_list, modes[m]) ||
+				     !ModeValid(m, s) ) {
+					continue;
+				}
+				/* Fills don't depend on the source */
+				if ( m == MODE_FILL && filled ) {
+					continue;
+				}
+				bench.mode = m;
+				for ( offset=0; offset<2; ++offset ) {
+					/* Conversions are always of the whole surface */
+					if ( !(offsets & (1 << offset)) ||
+					     (m == MODE_CONVERT && offset) ) {
+						continue;
+					}
+					RunCase(&bench,
+					        (m == MODE_FILL) ? "-" : formats[s].name,
+					        formats[d].name, w, h, offset);
+				}
+			}
+			SDL_FreeSurface(bench.dst);
+		}
+		filled = 1;
+		SDL_SetColorKey(bench.src, 0, 0);
+		SDL_SetAlpha(bench.src, 0, 255);
+		SDL_FreeSurface(bench.src);
+	}
+	return 0;
+}
+
+static void PrintUsage(const char *argv0)
+{
+	fprintf(stderr,
+"Usage: %s [options]\n"
+"  --src LIST        source formats, for example RGB565,ARGB8888\n"
+"  --dst LIST        destination formats\n"
+"  --mode LIST       copy,colorkey,colorkey-rle,alpha,pixelalpha,\n"
+"                    pixelalpha-rle,fill,convert\n"
+"  --size LIST       rectangle sizes, for example 64x64,1920x1080\n"
+"  --aligned         only blit to and from the start of a row\n"
+"  --misaligned      only blit with a one pixel offset\n"
+"  --reps N          timed repetitions of each case (default %d)\n"
+"  --time MS         length of each repetition (default %d)\n"
+"  --quick           a short sweep of the common formats\n"
+"  --csv, --json     output format\n"
+"  --baseline FILE   report cases slower than in this CSV output\n"
+"  --threshold PCT   slowdown to report (default %g)\n"
+"Formats:", argv0, reps, mintime, threshold);
+	{
+		int i;
+		for ( i=0; i<NUM_FORMATS; ++i ) {
+			fprintf(stderr, " %s", formats[i].name);
+		}
+	}
+	fprintf(stderr, "\n");
+}
+
+int main(int argc, char *argv[])
+{
+	int i;
+
+	for ( i=0; i<(int)(sizeof(default_sizes)/sizeof(default_sizes[0])); ++i ) {
+		sizes[i] = default_sizes[i];
+	}
+	num_sizes = i;
+
+	for ( i=1; i<argc; ++i ) {
+		const char *arg = argv[i];
+		const char *value = (i+1 < argc) ? argv[i+1] : NULL;
+
+		if ( strcmp(arg, "--src") == 0 && value ) {
+			src_list = value;
+			++i;
+		} else if ( strcmp(arg, "--dst") == 0 && value ) {
+			dst_list = value;
+			++i;
+		} else if ( strcmp(arg, "--mode") == 0 && value ) {
+			mode_list = value;
+			++i;
+		} else if ( strcmp(arg, "--size") == 0 && value ) {
+			if ( ParseSizes(value) < 0 ) {
+				return(1);
+			}
+			++i;
+		} else if ( strcmp(arg, "--aligned") == 0 ) {
+			offsets = 1;
+		} else if ( strcmp(arg, "--misaligned") == 0 ) {
+			offsets = 2;
+		} else if ( strcmp(arg, "--reps") == 0 && value ) {
+			reps = atoi(value);
+			++i;
+		} else if ( strcmp(arg, "--time") == 0 && value ) {
+			mintime = atoi(value);
+			++i;
+		} else if ( strcmp(arg, "--quick") == 0 ) {
+			src_list = "RGB565,XRGB8888,ARGB8888";
+			dst_list = "RGB565,XRGB8888";
+			ParseSizes("64x64,1024x768");
+			reps = 3;
+			mintime = 10;
+		} else if ( strcmp(arg, "--csv") == 0 ) {
+			output = OUTPUT_CSV;
+		} else if ( strcmp(arg, "--json") == 0 ) {
+			output = OUTPUT_JSON;
+		} else if ( strcmp(arg, "--baseline") == 0 && value ) {
+			if ( LoadBaseline(value) < 0 ) {
+				return(1);
+			}
+			++i;
+		} else if ( strcmp(arg, "--threshold") == 0 && value ) {
+			threshold = atof(value);
+			++i;
+		} else {
+			PrintUsage(argv[0]);
+			return(1);
+		}
+	}
+	if ( reps < 1 ) {
+		reps = 1;
+	} else if ( reps > MAX_REPS ) {
+		reps = MAX_REPS;
+	}
+	if ( mintime < 1 ) {
+		mintime = 1;
+	}
+
+	SDL_putenv("SDL_VIDEODRIVER=dummy");
+	if ( SDL_Init(SDL_INIT_VIDEO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	PrintHeader();
+	for ( i=0; i<num_sizes; ++i ) {
+		if ( RunSize(sizes[i].w, sizes[i].h) < 0 ) {
+			break;
+		}
+	}
+	PrintFooter();
+
+	if ( regressions ) {
+		fprintf(stderr, "%d cases are more than %g%% slower than the baseline\n",
+		        regressions, threshold);
+	}
+	free(baseline);
+	SDL_Quit();
+	return(regressions ? 1 : 0);
+}
@@ -0,0 +1,304 @@
+/* Test of the dummy video driver's frame capture.
+   Draws a few frames at a limited frame rate with the frames written
+   to a PPM stream, then reads the stream back and checks it.
+   Where POSIX shared memory is available, it then maps the shared frame
+   ring and checks every frame published by a series of partial updates.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#ifdef HAVE_SHM_OPEN
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "SDL_dummycapture.h"
+#endif
+
+#define WIDTH	64
+#define HEIGHT	48
+#define FRAMES	10
+#define FPS	20
+
+static const char *filename = "testcapture.ppm";
+
+/* Returns the number of frames in the file whose pixels are all the
+   color expected for their position in the sequence.
+ */
+static int CheckFrames(void)
+{
+	FILE *fp;
+	int w, h, max;
+	int frame, i, good;
+	Uint8 rgb[3];
+
+	fp = fopen(filename, "rb");
+	if ( fp == NULL ) {
+		fprintf(stderr, "Couldn't open %s\n", filename);
+		return(0);
+	}
+	good = 0;
+	for ( frame=0; fscanf(fp, "P6 %d %d %d", &w, &h, &max) == 3; ++frame ) {
+		int ok = 1;
+
+		fgetc(fp);	/* The newline after the header */
+		if ( (w != WIDTH) || (h != HEIGHT) || (max != 255) ) {
+			fprintf(stderr, "Frame %d: bad header %dx%d %d\n", frame, w, h, max);
+			break;
+		}
+		for ( i=0; i<w*h; ++i ) {
+			if ( fread(rgb, 3, 1, fp) != 1 ) {
+				fprintf(stderr, "Frame %d: truncated\n", frame);
+				ok = 0;
+				break;
+			}
+			if ( (rgb[0] != frame * 20) || (rgb[1] != 0) || (rgb[2] != 255 - frame * 20) ) {
+				ok = 0;
+			}
+		}
+		if ( ! ok ) {
+			fprintf(stderr, "Frame %d: wrong pixels\n", frame);
+		}
+		good += ok;
+	}
+	fclose(fp);
+	return(good);
+}
+
+#ifdef HAVE_SHM_OPEN
+
+#define SHM_FRAMES	3
+#define SHM_UPDATES	(SHM_FRAMES * 3)
+
+/* Check the latest frame in the ring against the display surface */
+static int CheckShmFrame(SDL_DummyCaptureHeader *header, SDL_Surface *screen,
+                         Uint32 seq, int numrects, SDL_Rect *rects)
+{
+	SDL_DummyCaptureFrame *frame;
+	Uint8 *src, *dst;
+	int i, y;
+
+	if ( header->sequence != seq ) {
+		fprintf(stderr, "Frame %u: the header says frame %u is the latest\n",
+		        seq, header->sequence);
+		return(-1);
+	}
+	frame = (SDL_DummyCaptureFrame *)((Uint8 *)header + header->frame_offset +
+	                                  (seq % header->nframes) * header->frame_size);
+	if ( frame->sequence != seq ) {
+		fprintf(stderr, "Frame %u: its slot holds frame %u\n",
+		        seq, frame->sequence);
+		return(-1);
+	}
+	if ( frame->numrects != (Uint32)numrects ) {
+		fprintf(stderr, "Frame %u: %u rectangles, expected %d\n",
+		        seq, frame->numrects, numrects);
+		return(-1);
+	}
+	for ( i=0; i<numrects; ++i ) {
+		if ( (frame->rects[i].x != rects[i].x) ||
+		     (frame->rects[i].y != rects[i].y) ||
+		     (frame->rects[i].w != rects[i].w) ||
+		     (frame->rects[i].h != rects[i].h) ) {
+			fprintf(stderr, "Frame %u: rectangle %d is wrong\n", seq, i);
+			return(-1);
+		}
+	}
+
+	/* Every pixel has to match, not just the ones updated */
+	src = (Uint8 *)screen->pixels;
+	dst = (Uint8 *)(frame + 1);
+	for ( y=0; y<screen->h; ++y ) {
+		if ( memcmp(dst, src, screen->w * screen->format->BytesPerPixel) != 0 ) {
+			fprintf(stderr, "Frame %u: row %d doesn't match the screen\n", seq, y);
+			return(-1);
+		}
+		src += screen->pitch;
+		dst += header->pitch;
+	}
+	return(0);
+}
+
+static int TestShm(void)
+{
+	SDL_Surface *screen;
+	SDL_DummyCaptureHeader *header;
+	SDL_Rect rects[2];
+	Uint32 seq;
+	size_t size;
+	/* putenv() keeps the string, so it can't be on the stack */
+	static char env[128];
+	char name[64];
+	int fd, i, numrects, status;
+
+	SDL_snprintf(name, sizeof(name), "/testcapture-%d", (int)getpid());
+	SDL_snprintf(env, sizeof(env), "SDL_VIDEO_DUMMY_SHM=%s", name);
+	SDL_putenv(env);
+	SDL_putenv("SDL_VIDEO_DUMMY_SHM_FRAMES=3");
+	SDL_putenv("SDL_VIDEO_DUMMY_OUTPUT=");
+	/* A negative rate means no limit */
+	SDL_putenv("SDL_VIDEO_DUMMY_FPS=-5");
+
+	if ( SDL_Init(SDL_INIT_VIDEO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(-1);
+	}
+	SDL_ShowCursor(SDL_DISABLE);
+	screen = SDL_SetVideoMode(WIDTH, HEIGHT, 32, SDL_SWSURFACE);
+	if ( screen == NULL ) {
+		fprintf(stderr, "Couldn't set video mode: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(-1);
+	}
+
+	fd = shm_open(name, O_RDONLY, 0);
+	if ( fd < 0 ) {
+		printf("No shared frame ring, SDL was built without it\n");
+		SDL_Quit();
+		return(0);
+	}
+	header = (SDL_DummyCaptureHeader *)mmap(NULL, sizeof(*header), PROT_READ,
+	                                        MAP_SHARED, fd, 0);
+	if ( (void *)header == MAP_FAILED ) {
+		fprintf(stderr, "Couldn't map %s\n", name);
+		close(fd);
+		SDL_Quit();
+		return(-1);
+	}
+	size = header->frame_offset + header->nframes * header->frame_size;
+	munmap(header, sizeof(*header));
+	header = (SDL_DummyCaptureHeader *)mmap(NULL, size, PROT_READ,
+	                                        MAP_SHARED, fd, 0);
+	close(fd);
+	if ( (void *)header == MAP_FAILED ) {
+		fprintf(stderr, "Couldn't map %s\n", name);
+		SDL_Quit();
+		return(-1);
+	}
+
+	status = -1;
+	if ( (header->magic != SDL_DUMMYCAPTURE_MAGIC) ||
+	     (header->version != SDL_DUMMYCAPTURE_VERSION) ) {
+		fprintf(stderr, "Bad shared memory header\n");
+	} else if ( (header->nframes != SHM_FRAMES) ||
+	            (header->w != WIDTH) || (header->h != HEIGHT) ||
+	            (header->pitch != screen->pitch) ||
+	            (header->BitsPerPixel != 32) ||
+	            (header->Rmask != screen->format->Rmask) ||
+	            (header->Gmask != screen->format->Gmask) ||
+	            (header->Bmask != screen->format->Bmask) ) {
+		fprintf(stderr, "The shared memory header doesn't match the screen\n");
+	} else if ( header->frame_size <
+	            sizeof(SDL_DummyCaptureFrame) + header->pitch * header->h ) {
+		fprintf(stderr, "The frame slots are too small\n");
+	} else if ( header->fps != 0 ) {
+		fprintf(stderr, "A negative frame rate was published as %u\n",
+		        header->fps);
+	} else {
+		status = 0;
+	}
+
+	/* Paint the whole screen, but only ever update small areas of it,
+	   so each slot has to start with a full copy to match the screen.
+	 */
+	SDL_FillRect(screen, NULL, SDL_MapRGB(screen->format, 40, 80, 120));
+	seq = header->sequence;
+	for ( i=0; (status == 0) && (i < SHM_UPDATES); ++i ) {
+		rects[0].x = (i * 7) % (WIDTH - 16);
+		rects[0].y = (i * 5) % (HEIGHT - 12);
+		rects[0].w = 16;
+		rects[0].h = 12;
+		rects[1].x = WIDTH - 8 - i;
+		rects[1].y = i;
+		rects[1].w = 8;
+		rects[1].h = 4;
+		numrects = 1 + (i & 1);
+		SDL_FillRect(screen, &rects[0],
+		             SDL_MapRGB(screen->format, i * 20, 255 - i * 20, 0));
+		if ( numrects > 1 ) {
+			SDL_FillRect(screen, &rects[1],
+			             SDL_MapRGB(screen->format, 0, i * 10, i * 20));
+		}
+		SDL_UpdateRects(screen, numrects, rects);
+		status = CheckShmFrame(header, screen, ++seq, numrects, rects);
+	}
+	SDL_Quit();
+
+	if ( (status == 0) && (header->magic != 0) ) {
+		fprintf(stderr, "The ring wasn't marked closed on quit\n");
+		status = -1;
+	}
+	munmap(header, size);
+	if ( status == 0 ) {
+		printf("%d frames published correctly through shared memory\n",
+		       SHM_UPDATES);
+	}
+	return(status);
+}
+
+#endif /* HAVE_SHM_OPEN */
+
+int main(int argc, char *argv[])
+{
+	SDL_Surface *screen;
+	Uint32 start, elapsed;
+	int frame, good;
+	char env[256];
+
+	if ( argv[1] ) {
+		filename = argv[1];
+	}
+	SDL_snprintf(env, sizeof(env), "SDL_VIDEO_DUMMY_OUTPUT=%s", filename);
+	SDL_putenv("SDL_VIDEODRIVER=dummy");
+	SDL_putenv("SDL_VIDEO_DUMMY_FORMAT=ppm");
+	SDL_putenv("SDL_VIDEO_DUMMY_FPS=20");
+	SDL_putenv(env);
+
+	if ( SDL_Init(SDL_INIT_VIDEO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+	/* Keep the software cursor out of the captured frames, so each
+	   SDL_Flip() below makes exactly one frame.
+	 */
+	SDL_ShowCursor(SDL_DISABLE);
+
+	screen = SDL_SetVideoMode(WIDTH, HEIGHT, 32, SDL_SWSURFACE);
+	if ( screen == NULL ) {
+		fprintf(stderr, "Couldn't set video mode: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(1);
+	}
+
+	start = SDL_GetTicks();
+	for ( frame=0; frame<FRAMES; ++frame ) {
+		SDL_FillRect(screen, NULL,
+		             SDL_MapRGB(screen->format, frame * 20, 0, 255 - frame * 20));
+		SDL_Flip(screen);
+	}
+	elapsed = SDL_GetTicks() - start;
+	SDL_Quit();
+
+	printf("%d frames took %u ms\n", FRAMES, elapsed);
+	good = CheckFrames();
+	printf("%d of %d frames captured correctly\n", good, FRAMES);
+	if ( good != FRAMES ) {
+		return(1);
+	}
+	/* The first frame goes out at once, the rest are paced */
+	if ( elapsed < ((FRAMES - 1) * 1000 / FPS) - 10 ) {
+		fprintf(stderr, "Frames weren't paced to %d FPS\n", FPS);
+		return(1);
+	}
+	remove(filename);
+
+#ifdef HAVE_SHM_OPEN
+	if ( TestShm() < 0 ) {
+		return(1);
+	}
+#endif
+	return(0);
+}
@@ -40,6 +40,7 @@ static void killed(int sig)
 int main(int argc, char *argv[])
 {
 	SDL_Thread *thread;
+	SDL_ThreadAttr attr;
 
 	/* Load the SDL library */
 	if ( SDL_Init(0) < 0 ) {
@@ -47,8 +48,14 @@ int main(int argc, char *argv[])
 		return(1);
 	}
 
+	/* The first thread is named, low priority and has a small stack */
+	SDL_InitThreadAttr(&attr);
+	attr.name = "testhread #1";
+	attr.stacksize = 256*1024;
+	attr.priority = SDL_THREAD_PRIORITY_LOW;
+
 	alive = 1;
-	thread = SDL_CreateThread(ThreadFunc, "#1");
+	thread = SDL_CreateThreadEx(ThreadFunc, "#1", &attr);
 	if ( thread == NULL ) {
 		fprintf(stderr, "Couldn't create thread: %s\n", SDL_GetError());
 		quit(1);
@@ -13,6 +13,172 @@ static size_t widelen(char *data)
 	return len;
 }
 
+/* Returns the size in bytes of a string, including its terminator */
+static size_t stringsize(const char *format, const char *data)
+{
+	size_t unit = 1;
+	size_t len = 0;
+	size_t i;
+
+	if ( SDL_strstr(format, "16") ) {
+		unit = 2;
+	} else if ( SDL_strstr(format, "32") || SDL_strstr(format, "4") ) {
+		unit = 4;
+	}
+	for ( ;; ) {
+		for ( i = 0; i < unit; ++i ) {
+			if ( data[len + i] ) {
+				break;
+			}
+		}
+		len += unit;
+		if ( i == unit ) {
+			return len;
+		}
+	}
+}
+
+/* Round trips a large UTF-8 string, long runs of ASCII broken up by
+   multibyte characters at every alignment, through each format.
+ */
+static int testbulk(const char *formats[], int numformats)
+{
+	const char *mixed[] = { "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9D\x84\x9E" };
+	size_t size = 256 * 1024;
+	char *utf8;
+	char *test[2];
+	size_t len = 0;
+	int run = 0;
+	int i;
+	int errors = 0;
+
+	utf8 = (char *)SDL_malloc(size + 1);
+	if ( !utf8 ) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	while ( len < size - 4 ) {
+		if ( run == 0 ) {
+			const char *ch = mixed[len % SDL_arraysize(mixed)];
+			SDL_strlcpy(utf8 + len, ch, size + 1 - len);
+			len += SDL_strlen(ch);
+			run = (int)(len % 67);
+		} else {
+			utf8[len] = 'a' + (char)(len % 26);
+			++len;
+			--run;
+		}
+	}
+	utf8[len] = '\0';
+
+	for ( i = 0; i < numformats; ++i ) {
+		test[0] = SDL_iconv_string(formats[i], "UTF-8", utf8, len+1);
+		test[1] = test[0] ? SDL_iconv_string("UTF-8", formats[i], test[0], stringsize(formats[i], test[0])) : NULL;
+		if ( !test[1] || SDL_strcmp(test[1], utf8) != 0 ) {
+			fprintf(stderr, "FAIL: bulk %s\n", formats[i]);
+			++errors;
+		}
+		if ( test[0] ) {
+			SDL_free(test[0]);
+		}
+		if ( test[1] ) {
+			SDL_free(test[1]);
+		}
+	}
+	SDL_free(utf8);
+	return errors;
+}
+
+/* Converts UTF-8 straight to UTF-16 and back, and compares that with
+   going through UCS-4.  The text is mostly two byte characters mixed
+   with ASCII, three and four byte characters and, for SDL's own
+   converter, malformed sequences.
+ */
+static int testtranscode(void)
+{
+	const char *pieces[] = {
+		"\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82",
+		"\xCE\xB1\xCE\xB2\xCE\xB3",
+		"\xC3\xA9",
+		" ",
+		"abc",
+		"\xE4\xB8\xAD\xE6\x96\x87",
+		"\xF0\x9F\x98\x80",
+#ifndef HAVE_ICONV
+		/* SDL's own converter replaces these the same way whether it
+		   converts directly or through UCS-4, but the C library's
+		   iconv() may not, so they're only checked without it.
+		 */
+		"\xC0\xAF",		/* Overlong */
+		"\xE0\x9F\xBF",
+		"\xF0\x8F\xBF\xBF",
+		"\xF4\x90\x80\x80",	/* Past U+10FFFF */
+		"\xED\xA0\x80",	/* Surrogate */
+		"\xEF\xBF\xBE",	/* Not a character */
+		"\x80",		/* Stray continuation byte */
+		"\xD0",		/* Missing continuation byte */
+#endif
+	};
+	const char *formats[] = { "UTF-16LE", "UTF-16BE" };
+	size_t size = 64 * 1024;
+	char *utf8;
+	char *ucs4;
+	char *test[4];
+	size_t len = 0;
+	Uint32 seed = 1;
+	int i, j;
+	int errors = 0;
+
+	utf8 = (char *)SDL_malloc(size + 1);
+	if ( !utf8 ) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	while ( len < size - 16 ) {
+		const char *piece;
+		seed = seed * 1103515245 + 12345;
+		j = (seed >> 16) % 64;
+		/* Mostly the Cyrillic and Greek pieces, in long runs */
+		piece = pieces[j < SDL_arraysize(pieces) ? j : (j & 1)];
+		SDL_strlcpy(utf8 + len, piece, size + 1 - len);
+		len += SDL_strlen(piece);
+	}
+	utf8[len] = '\0';
+
+	ucs4 = SDL_iconv_string("UCS-4", "UTF-8", utf8, len+1);
+	for ( i = 0; i < SDL_arraysize(formats); ++i ) {
+		test[0] = SDL_iconv_string(formats[i], "UTF-8", utf8, len+1);
+		test[1] = ucs4 ? SDL_iconv_string(formats[i], "UCS-4", ucs4, stringsize("UCS-4", ucs4)) : NULL;
+		test[2] = test[0] ? SDL_iconv_string("UTF-8", formats[i], test[0], stringsize(formats[i], test[0])) : NULL;
+		test[3] = test[1] ? SDL_iconv_string("UCS-4", formats[i], test[1], stringsize(formats[i], test[1])) : NULL;
+		if ( test[3] ) {
+			char *utf8again = SDL_iconv_string("UTF-8", "UCS-4", test[3], stringsize("UCS-4", test[3]));
+			SDL_free(test[3]);
+			test[3] = utf8again;
+		}
+		if ( !test[0] || !test[1] ||
+		     stringsize(formats[i], test[0]) != stringsize(formats[i], test[1]) ||
+		     SDL_memcmp(test[0], test[1], stringsize(formats[i], test[1])) != 0 ) {
+			fprintf(stderr, "FAIL: transcode UTF-8 to %s\n", formats[i]);
+			++errors;
+		}
+		if ( !test[2] || !test[3] || SDL_strcmp(test[2], test[3]) != 0 ) {
+			fprintf(stderr, "FAIL: transcode %s to UTF-8\n", formats[i]);
+			++errors;
+		}
+		for ( j = 0; j < SDL_arraysize(test); ++j ) {
+			if ( test[j] ) {
+				SDL_free(test[j]);
+			}
+		}
+	}
+	if ( ucs4 ) {
+		SDL_free(ucs4);
+	}
+	SDL_free(utf8);
+	return errors;
+}
+
 int main(int argc, char *argv[])
 {
 	const char * formats[] = {
@@ -70,6 +236,11 @@ int main(int argc, char *argv[])
 		SDL_free(test[0]);
 	}
 
+	fclose(file);
+
+	errors += testbulk(formats, SDL_arraysize(formats));
+	errors += testtranscode();
+
 	fprintf(stderr, "\nTotal errors: %d\n", errors);
 	return (errors ? errors + 1 : 0);
 }
@@ -135,11 +135,121 @@ int TestCPUInfo(SDL_bool verbose)
 		printf("3DNow Ext %s\n", SDL_Has3DNowExt() ? "detected" : "not detected");
 		printf("SSE %s\n", SDL_HasSSE() ? "detected" : "not detected");
 		printf("SSE2 %s\n", SDL_HasSSE2() ? "detected" : "not detected");
+		printf("SSE3 %s\n", SDL_HasSSE3() ? "detected" : "not detected");
+		printf("SSSE3 %s\n", SDL_HasSSSE3() ? "detected" : "not detected");
+		printf("SSE4.1 %s\n", SDL_HasSSE41() ? "detected" : "not detected");
+		printf("SSE4.2 %s\n", SDL_HasSSE42() ? "detected" : "not detected");
+		printf("AVX %s\n", SDL_HasAVX() ? "detected" : "not detected");
+		printf("AVX2 %s\n", SDL_HasAVX2() ? "detected" : "not detected");
+		printf("AVX-512F %s\n", SDL_HasAVX512F() ? "detected" : "not detected");
 		printf("AltiVec %s\n", SDL_HasAltiVec() ? "detected" : "not detected");
+		printf("ARM SIMD %s\n", SDL_HasARMSIMD() ? "detected" : "not detected");
+		printf("NEON %s\n", SDL_HasNEON() ? "detected" : "not detected");
+		printf("CPU count: %d\n", SDL_GetCPUCount());
+		printf("Cache line size: %d bytes\n", SDL_GetCPUCacheLineSize());
+		printf("L1 data cache: %d bytes\n", SDL_GetCPUCacheSize(1));
+		printf("L2 cache: %d bytes\n", SDL_GetCPUCacheSize(2));
+		printf("L3 cache: %d bytes\n", SDL_GetCPUCacheSize(3));
+	}
+	if ( SDL_GetCPUCount() < 1 || SDL_GetCPUCacheLineSize() < 1 ) {
+		if ( verbose )
+			printf("Bad CPU count or cache line size\n");
+		return(1);
+	}
+	if ( SDL_HasAVX2() && !SDL_HasAVX() ) {
+		if ( verbose )
+			printf("AVX2 detected without AVX\n");
+		return(1);
 	}
 	return(0);
 }
 
+/* Checks SDL_memcpy2D() and SDL_memset2D() on an odd sized rectangle,
+   leaving the bytes between the rows alone.
+ */
+static int TestMemory2D(int w, int h, int pitch, int offset)
+{
+	size_t size = (size_t)pitch * h + offset;
+	Uint8 *src = (Uint8 *)SDL_malloc(size);
+	Uint8 *dst = (Uint8 *)SDL_malloc(size);
+	Uint32 val = 0x11223344;
+	Uint8 pattern[4];
+	int error = 0;
+	size_t i;
+	int x, y;
+
+	if ( !src || !dst ) {
+		SDL_free(src);
+		SDL_free(dst);
+		return(0);
+	}
+	for ( i = 0; i < size; ++i ) {
+		src[i] = (Uint8)(i * 7 + (i >> 12));
+	}
+	SDL_memset(dst, 0xAA, size);
+	SDL_memcpy2D(dst + offset, pitch, src + offset, pitch, w, h);
+	for ( y = 0; y < h && !error; ++y ) {
+		const Uint8 *s = src + offset + y * pitch;
+		const Uint8 *d = dst + offset + y * pitch;
+		if ( SDL_memcmp(s, d, w) != 0 ||
+		     (y < h-1 && d[w] != 0xAA) ) {
+			++error;
+		}
+	}
+
+	SDL_memcpy(pattern, &val, sizeof(pattern));
+	SDL_memset2D(dst + offset, pitch, val, w, h);
+	for ( y = 0; y < h && !error; ++y ) {
+		const Uint8 *d = dst + offset + y * pitch;
+		for ( x = 0; x < w; ++x ) {
+			if ( d[x] != pattern[x & 3] ) {
+				++error;
+				break;
+			}
+		}
+		if ( y < h-1 && d[w] != 0xAA ) {
+			++error;
+		}
+	}
+	SDL_free(src);
+	SDL_free(dst);
+	return(error);
+}
+
+int TestMemory(SDL_bool verbose)
+{
+	/* Each of these rules out one more way of streaming */
+	static const Uint32 features[] = {
+		SDL_BLIT_ALL, SDL_BLIT_SSE2, SDL_BLIT_C
+	};
+	int cache = SDL_GetCPUCacheSize(3);
+	int rows;
+	int error = 0;
+	int offset;
+	int i;
+
+	if ( cache < SDL_GetCPUCacheSize(2) ) {
+		cache = SDL_GetCPUCacheSize(2);
+	}
+	if ( cache < 1024*1024 ) {
+		cache = 1024*1024;
+	}
+	/* The second size is big enough to use streaming stores */
+	rows = cache / 8000 + 1;
+	for ( i = 0; i < SDL_arraysize(features); ++i ) {
+		SDL_SetBlitFeatures(features[i]);
+		for ( offset = 0; offset < 4; ++offset ) {
+			error += TestMemory2D(37, 13, 45, offset);
+			error += TestMemory2D(4003, rows, 4096, offset);
+		}
+	}
+	SDL_SetBlitFeatures(SDL_BLIT_ALL);
+	if ( verbose ) {
+		printf("2D copy and fill %s\n", error ? "failed" : "passed");
+	}
+	return( error ? 1 : 0 );
+}
+
 int main(int argc, char *argv[])
 {
 	SDL_bool verbose = SDL_TRUE;
@@ -204,5 +314,6 @@ int main(int argc, char *argv[])
 	status += TestTypes(verbose);
 	status += TestEndian(verbose);
 	status += TestCPUInfo(verbose);
+	status += TestMemory(verbose);
 	return status;
 }
@@ -0,0 +1,216 @@
+/* Test of the audio queue.
+   Plays a tone pushed with SDL_QueueAudio() from a thread of its own,
+   keeping a quarter second of audio queued, and prints how much is
+   queued each second.  With --check it renders through the disk driver
+   instead and makes sure every queued byte reaches the file in order.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "SDL.h"
+
+#ifndef M_PI
+#define M_PI	3.14159265358979323846
+#endif
+
+#define FREQUENCY	22050
+
+static SDL_AudioSpec spec;
+static volatile int done = 0;
+static Uint32 total_queued = 0;
+
+/* Keep the queue topped up with a 440 Hz tone, in uneven pieces */
+static int SDLCALL Produce(void *unused)
+{
+	Sint16 samples[1000];
+	Uint32 target = spec.freq / 4 * sizeof(samples[0]);
+	double phase = 0.0;
+	int i;
+
+	while ( ! done ) {
+		if ( SDL_GetQueuedAudioSize() >= target ) {
+			SDL_Delay(5);
+			continue;
+		}
+		for ( i=0; i<SDL_arraysize(samples); ++i ) {
+			samples[i] = (Sint16)(8192.0 * sin(phase));
+			phase += 2.0 * M_PI * 440.0 / spec.freq;
+		}
+		if ( SDL_QueueAudio(samples, sizeof(samples)) < 0 ) {
+			fprintf(stderr, "Couldn't queue audio: %s\n", SDL_GetError());
+			break;
+		}
+		total_queued += sizeof(samples);
+	}
+	return(0);
+}
+
+static int Play(int seconds)
+{
+	SDL_Thread *thread;
+	int i;
+
+	thread = SDL_CreateThread(Produce, NULL);
+	if ( thread == NULL ) {
+		fprintf(stderr, "Couldn't create thread: %s\n", SDL_GetError());
+		return(-1);
+	}
+	SDL_PauseAudio(0);
+	for ( i=1; i<=seconds; ++i ) {
+		SDL_Delay(1000);
+		printf("%2d s: %6u bytes queued, %7u in all\n",
+		       i, SDL_GetQueuedAudioSize(), total_queued);
+	}
+	done = 1;
+	SDL_WaitThread(thread, NULL);
+
+	SDL_ClearQueuedAudio();
+	if ( SDL_GetQueuedAudioSize() != 0 ) {
+		fprintf(stderr, "The queue wasn't emptied by clearing it\n");
+		return(-1);
+	}
+	return(0);
+}
+
+/* Queue a second of numbered samples in odd sized pieces after some audio
+   that is cleared away, and compare what the disk driver wrote with them.
+ */
+static int Check(const char *file)
+{
+	Uint8 *data, *written;
+	Uint32 len, pos, piece;
+	FILE *fp;
+	int status;
+
+	len = spec.freq * sizeof(Sint16);
+	data = (Uint8 *)malloc(len);
+	written = (Uint8 *)malloc(len);
+	if ( data == NULL || written == NULL ) {
+		fprintf(stderr, "Out of memory\n");
+		return(-1);
+	}
+	for ( pos=0; pos<len/2; ++pos ) {
+		((Sint16 *)data)[pos] = (Sint16)(pos * 7);
+	}
+
+	/* The device is still paused, so none of this is played */
+	memset(written, 0x55, len);
+	SDL_QueueAudio(written, 3000);
+	SDL_ClearQueuedAudio();
+	if ( SDL_GetQueuedAudioSize() != 0 ) {
+		fprintf(stderr, "The queue wasn't emptied by clearing it\n");
+		return(-1);
+	}
+
+	for ( pos=0; pos<len; pos += piece ) {
+		piece = SDL_min(len - pos, 2 * (1 + pos % 5000));
+		if ( SDL_QueueAudio(data + pos, piece) < 0 ) {
+			fprintf(stderr, "Couldn't queue audio: %s\n", SDL_GetError());
+			return(-1);
+		}
+	}
+	if ( SDL_GetQueuedAudioSize() != len ) {
+		fprintf(stderr, "Queued %u bytes, but %u are waiting\n",
+		        len, SDL_GetQueuedAudioSize());
+		return(-1);
+	}
+
+	SDL_PauseAudio(0);
+	while ( SDL_GetQueuedAudioSize() > 0 ) {
+		SDL_Delay(1);
+	}
+	SDL_PauseAudio(1);
+	SDL_CloseAudio();
+
+	status = -1;
+	fp = fopen(file, "rb");
+	if ( fp == NULL ) {
+		fprintf(stderr, "Couldn't open %s\n", file);
+	} else if ( fread(written, 1, len, fp) != len ) {
+		fprintf(stderr, "%s is too short\n", file);
+	} else if ( memcmp(written, data, len) != 0 ) {
+		fprintf(stderr, "%s doesn't match the queued audio\n", file);
+	} else {
+		printf("All %u queued bytes were written in order\n", len);
+		status = 0;
+	}
+	if ( fp ) {
+		fclose(fp);
+	}
+	free(written);
+	free(data);
+	return(status);
+}
+
+static void Usage(const char *argv0)
+{
+	fprintf(stderr,
+"Usage: %s [options]\n"
+"  --driver NAME     play with this audio driver\n"
+"  --seconds N       play for this many seconds (default 3)\n"
+"  --check           render to testqueue.raw with the disk driver and check it\n",
+		argv0);
+}
+
+int main(int argc, char *argv[])
+{
+	/* putenv() keeps the strings, so they can't be on the stack */
+	static char driver_env[64];
+	int seconds = 3;
+	int check = 0;
+	int i, status;
+
+	for ( i=1; i<argc; ++i ) {
+		if ( strcmp(argv[i], "--driver") == 0 && argv[i+1] ) {
+			SDL_snprintf(driver_env, sizeof(driver_env),
+			             "SDL_AUDIODRIVER=%s", argv[++i]);
+			SDL_putenv(driver_env);
+		} else if ( strcmp(argv[i], "--seconds") == 0 && argv[i+1] ) {
+			seconds = atoi(argv[++i]);
+		} else if ( strcmp(argv[i], "--check") == 0 ) {
+			check = 1;
+		} else {
+			Usage(argv[0]);
+			return(1);
+		}
+	}
+	if ( check ) {
+		SDL_putenv("SDL_AUDIODRIVER=disk");
+		SDL_putenv("SDL_DISKAUDIOMODE=freewheel");
+		SDL_putenv("SDL_DISKAUDIOFILE=testqueue.raw");
+	}
+
+	if ( SDL_Init(SDL_INIT_AUDIO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	/* No callback: the audio is queued instead */
+	SDL_memset(&spec, 0, sizeof(spec));
+	spec.freq = FREQUENCY;
+	spec.format = AUDIO_S16SYS;
+	spec.channels = 1;
+	spec.samples = 1024;
+	spec.callback = NULL;
+	if ( SDL_OpenAudio(&spec, NULL) < 0 ) {
+		fprintf(stderr, "Couldn't open audio: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(1);
+	}
+
+	if ( check ) {
+		status = Check("testqueue.raw");
+	} else {
+		printf("Queueing %d Hz mono for %d seconds\n", spec.freq, seconds);
+		if ( SDL_GetAudioLatency() > 0 ) {
+			printf("The driver buffers %d sample frames\n",
+			       SDL_GetAudioLatency());
+		}
+		status = Play(seconds);
+	}
+	SDL_Quit();
+	return(status < 0 ? 1 : 0);
+}
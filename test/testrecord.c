@@ -0,0 +1,181 @@
+/* Test of audio capture.
+   Records for a few seconds, either through a callback or by polling with
+   SDL_ReadAudioCapture(), and prints how much audio arrived each second
+   and how loud it was.  With the disk driver it records from a file of
+   raw audio, writing a one second tone to testrecord.raw if no file is
+   given in SDL_DISKAUDIOINFILE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "SDL.h"
+
+#ifndef M_PI
+#define M_PI	3.14159265358979323846
+#endif
+
+#define FREQUENCY	22050
+
+static Uint32 total_bytes = 0;
+static Uint32 second_bytes = 0;
+static int second_peak = 0;
+
+/* Keep track of the recorded amount and the peak level, in S16 mono */
+static void Measure(Uint8 *stream, int len)
+{
+	Sint16 *samples = (Sint16 *)stream;
+	int i, level;
+
+	for ( i=0; i<len/2; ++i ) {
+		level = abs(samples[i]);
+		if ( level > second_peak ) {
+			second_peak = level;
+		}
+	}
+	total_bytes += len;
+	second_bytes += len;
+}
+
+static void SDLCALL record(void *unused, Uint8 *stream, int len)
+{
+	Measure(stream, len);
+}
+
+/* Write one second of a 440 Hz tone at half volume, in the format the
+   disk driver will be asked for before conversion
+ */
+static int MakeInputFile(const char *file)
+{
+	FILE *fp;
+	Sint16 samples[FREQUENCY];
+	int i;
+
+	for ( i=0; i<FREQUENCY; ++i ) {
+		samples[i] = (Sint16)(16384.0 * sin(2.0 * M_PI * 440.0 * i / FREQUENCY));
+	}
+	fp = fopen(file, "wb");
+	if ( fp == NULL ) {
+		return(-1);
+	}
+	fwrite(samples, sizeof(samples[0]), FREQUENCY, fp);
+	fclose(fp);
+	return(0);
+}
+
+static void Usage(const char *argv0)
+{
+	fprintf(stderr,
+"Usage: %s [options]\n"
+"  --driver NAME     record with this audio driver\n"
+"  --seconds N       record for this many seconds (default 3)\n"
+"  --read            poll with SDL_ReadAudioCapture() instead of a callback\n"
+"  --reopen          open and close the output device while recording\n",
+		argv0);
+}
+
+int main(int argc, char *argv[])
+{
+	/* putenv() keeps the strings, so they can't be on the stack */
+	static char driver_env[64];
+	SDL_AudioSpec spec;
+	Uint8 buf[4096];
+	Uint32 start, now, second;
+	int seconds = 3;
+	int polled = 0;
+	int reopen = 0;
+	int i, len;
+
+	for ( i=1; i<argc; ++i ) {
+		if ( strcmp(argv[i], "--driver") == 0 && argv[i+1] ) {
+			SDL_snprintf(driver_env, sizeof(driver_env),
+			             "SDL_AUDIODRIVER=%s", argv[++i]);
+			SDL_putenv(driver_env);
+		} else if ( strcmp(argv[i], "--seconds") == 0 && argv[i+1] ) {
+			seconds = atoi(argv[++i]);
+		} else if ( strcmp(argv[i], "--read") == 0 ) {
+			polled = 1;
+		} else if ( strcmp(argv[i], "--reopen") == 0 ) {
+			reopen = 1;
+		} else {
+			Usage(argv[0]);
+			return(1);
+		}
+	}
+
+	if ( getenv("SDL_AUDIODRIVER") &&
+	     strcmp(getenv("SDL_AUDIODRIVER"), "disk") == 0 &&
+	     !getenv("SDL_DISKAUDIOINFILE") ) {
+		if ( MakeInputFile("testrecord.raw") < 0 ) {
+			fprintf(stderr, "Couldn't write testrecord.raw\n");
+			return(1);
+		}
+		SDL_putenv("SDL_DISKAUDIOINFILE=testrecord.raw");
+	}
+
+	if ( SDL_Init(SDL_INIT_AUDIO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	/* Ask for mono so the level is easy to measure, SDL converts to it */
+	SDL_memset(&spec, 0, sizeof(spec));
+	spec.freq = FREQUENCY;
+	spec.format = AUDIO_S16SYS;
+	spec.channels = 1;
+	spec.samples = 1024;
+	spec.callback = polled ? NULL : record;
+	if ( SDL_OpenAudioCapture(&spec, NULL) < 0 ) {
+		fprintf(stderr, "Couldn't open audio capture: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(1);
+	}
+	printf("Recording %d Hz mono for %d seconds, %s\n", spec.freq, seconds,
+	       polled ? "polling" : "with a callback");
+
+	SDL_PauseAudioCapture(0);
+	start = SDL_GetTicks();
+	second = start + 1000;
+	while ( SDL_GetAudioCaptureStatus() == SDL_AUDIO_PLAYING ) {
+		if ( polled ) {
+			while ( (len = SDL_ReadAudioCapture(buf, sizeof(buf))) > 0 ) {
+				Measure(buf, len);
+			}
+		}
+		SDL_Delay(10);
+
+		now = SDL_GetTicks();
+		if ( (Sint32)(now - second) >= 0 ) {
+			printf("%2u s: %6u bytes, peak %5d\n",
+			       (second - start) / 1000, second_bytes, second_peak);
+			second_bytes = 0;
+			second_peak = 0;
+			second += 1000;
+
+			/* Closing the output device mustn't stop the recording */
+			if ( reopen ) {
+				SDL_AudioSpec output = spec;
+				output.callback = NULL;
+				if ( SDL_OpenAudio(&output, NULL) < 0 ) {
+					fprintf(stderr, "Couldn't open audio: %s\n",
+					        SDL_GetError());
+				}
+				SDL_CloseAudio();
+			}
+		}
+		if ( (now - start) >= (Uint32)seconds * 1000 ) {
+			break;
+		}
+	}
+	if ( SDL_GetAudioCaptureStatus() != SDL_AUDIO_PLAYING ) {
+		fprintf(stderr, "Recording stopped early: %s\n", SDL_GetError());
+	}
+	SDL_CloseAudioCapture();
+
+	printf("Recorded %u bytes, %.2f seconds of audio\n", total_bytes,
+	       (double)total_bytes / (spec.freq * 2));
+	SDL_Quit();
+	return(0);
+}
@@ -0,0 +1,191 @@
+/* Stress test of the SDL reader-writer lock functions */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "SDL_atomic.h"
+#include "SDL_mutex.h"
+#include "SDL_thread.h"
+
+#define NUM_READERS	6
+#define NUM_WRITERS	2
+#define TEST_SECONDS	5
+
+static SDL_RWLock *rwlock = NULL;
+static SDL_AtomicInt alive;
+static SDL_AtomicInt active_readers;
+static SDL_AtomicInt active_writers;
+static SDL_AtomicInt failures;
+
+/* Written only under the write lock, checked under the read lock */
+static int data[64];
+static int reads = 0;
+static int writes = 0;
+
+static void Fail(const char *message)
+{
+	fprintf(stderr, "%s\n", message);
+	SDL_AtomicIncRef(&failures);
+}
+
+int SDLCALL Reader(void *unused)
+{
+	int i, n = 0;
+
+	while ( SDL_AtomicLoad(&alive) ) {
+		if ( SDL_RWLockRead(rwlock) < 0 ) {
+			Fail(SDL_GetError());
+			break;
+		}
+		SDL_AtomicIncRef(&active_readers);
+		if ( SDL_AtomicLoad(&active_writers) != 0 ) {
+			Fail("Reader got in while a writer held the lock");
+		}
+		for ( i = 1; i < SDL_arraysize(data); ++i ) {
+			if ( data[i] != data[0] ) {
+				Fail("Reader saw a partial write");
+				break;
+			}
+		}
+		SDL_AtomicAdd(&active_readers, -1);
+		SDL_RWLockUnlock(rwlock);
+		++n;
+	}
+	return n;
+}
+
+int SDLCALL Writer(void *unused)
+{
+	int i, n = 0;
+
+	while ( SDL_AtomicLoad(&alive) ) {
+		if ( SDL_RWLockWrite(rwlock) < 0 ) {
+			Fail(SDL_GetError());
+			break;
+		}
+		if ( SDL_AtomicIncRef(&active_writers) != 0 ||
+		     SDL_AtomicLoad(&active_readers) != 0 ) {
+			Fail("Writer didn't get exclusive access");
+		}
+		for ( i = 0; i < SDL_arraysize(data); ++i ) {
+			++data[i];
+		}
+		SDL_AtomicAdd(&active_writers, -1);
+		SDL_RWLockUnlock(rwlock);
+		++n;
+		SDL_Delay(1);
+	}
+	return n;
+}
+
+/* The contended cases have to be checked from another thread,
+   since the locks are not recursive.
+ */
+int SDLCALL TryWhileReading(void *unused)
+{
+	Uint32 start_ticks;
+	Uint32 duration;
+
+	if ( SDL_RWLockTryRead(rwlock) != 0 ) {
+		Fail("Couldn't share the read lock");
+	} else {
+		SDL_RWLockUnlock(rwlock);
+	}
+	if ( SDL_RWLockTryWrite(rwlock) != SDL_MUTEX_TIMEDOUT ) {
+		Fail("SDL_RWLockTryWrite() succeeded with readers");
+	}
+	start_ticks = SDL_GetTicks();
+	if ( SDL_RWLockWriteTimeout(rwlock, 500) != SDL_MUTEX_TIMEDOUT ) {
+		Fail("SDL_RWLockWriteTimeout() succeeded with readers");
+	}
+	duration = SDL_GetTicks() - start_ticks;
+	if ( duration < 450 || duration > 700 ) {
+		fprintf(stderr, "Write timeout took %d milliseconds\n", duration);
+	}
+	return 0;
+}
+
+int SDLCALL TryWhileWriting(void *unused)
+{
+	if ( SDL_RWLockTryRead(rwlock) != SDL_MUTEX_TIMEDOUT ||
+	     SDL_RWLockReadTimeout(rwlock, 100) != SDL_MUTEX_TIMEDOUT ) {
+		Fail("Reader got in while a writer held the lock");
+	}
+	if ( SDL_RWLockTryWrite(rwlock) != SDL_MUTEX_TIMEDOUT ) {
+		Fail("Two writers held the lock");
+	}
+	return 0;
+}
+
+static void TestTryAndTimeout(void)
+{
+	if ( SDL_RWLockRead(rwlock) < 0 ) {
+		Fail(SDL_GetError());
+		return;
+	}
+	SDL_WaitThread(SDL_CreateThread(TryWhileReading, NULL), NULL);
+	SDL_RWLockUnlock(rwlock);
+
+	if ( SDL_RWLockTryWrite(rwlock) != 0 ) {
+		Fail("SDL_RWLockTryWrite() failed on a free lock");
+		return;
+	}
+	SDL_WaitThread(SDL_CreateThread(TryWhileWriting, NULL), NULL);
+	SDL_RWLockUnlock(rwlock);
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_Thread *readers[NUM_READERS];
+	SDL_Thread *writers[NUM_WRITERS];
+	int i, n;
+
+	/* Load the SDL library */
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	if ( (rwlock = SDL_CreateRWLock()) == NULL ) {
+		fprintf(stderr, "Couldn't create rwlock: %s\n", SDL_GetError());
+		SDL_Quit();
+		return(1);
+	}
+
+	printf("Checking try and timed locks\n");
+	TestTryAndTimeout();
+
+	printf("Running %d readers and %d writers for %d seconds\n",
+	       NUM_READERS, NUM_WRITERS, TEST_SECONDS);
+	SDL_AtomicStore(&alive, 1);
+	for ( i = 0; i < NUM_READERS; ++i ) {
+		readers[i] = SDL_CreateThread(Reader, NULL);
+	}
+	for ( i = 0; i < NUM_WRITERS; ++i ) {
+		writers[i] = SDL_CreateThread(Writer, NULL);
+	}
+	SDL_Delay(TEST_SECONDS * 1000);
+	SDL_AtomicStore(&alive, 0);
+	for ( i = 0; i < NUM_READERS; ++i ) {
+		SDL_WaitThread(readers[i], &n);
+		reads += n;
+	}
+	for ( i = 0; i < NUM_WRITERS; ++i ) {
+		SDL_WaitThread(writers[i], &n);
+		writes += n;
+	}
+	printf("%d reads, %d writes\n", reads, writes);
+	if ( writes == 0 ) {
+		Fail("Writers were starved");
+	}
+	if ( data[0] != writes ) {
+		Fail("Lost a write");
+	}
+
+	SDL_DestroyRWLock(rwlock);
+
+	printf("%s\n", SDL_AtomicLoad(&failures) ? "FAILED" : "All tests passed");
+	SDL_Quit();
+	return(SDL_AtomicLoad(&failures) ? 1 : 0);
+}
@@ -159,6 +159,8 @@ int main(int argc, char *argv[])
 	int    i, done;
 	SDL_Event event;
 	Uint32 then, now, frames;
+	SDL_FlipStats flipstats;
+	SDL_UpdateStats updatestats;
 
 	/* Initialize SDL */
 	if ( SDL_Init(SDL_INIT_VIDEO) < 0 ) {
@@ -196,6 +198,9 @@ int main(int argc, char *argv[])
 		if ( strcmp(argv[argc], "-flip") == 0 ) {
 			videoflags ^= SDL_DOUBLEBUF;
 		} else
+		if ( strcmp(argv[argc], "-triple") == 0 ) {
+			videoflags ^= SDL_TRIPLEBUF;
+		} else
 		if ( strcmp(argv[argc], "-debugflip") == 0 ) {
 			debug_flip ^= 1;
 		} else
@@ -209,7 +214,7 @@ int main(int argc, char *argv[])
 			numsprites = atoi(argv[argc]);
 		} else {
 			fprintf(stderr, 
-	"Usage: %s [-bpp N] [-hw] [-flip] [-fast] [-fullscreen] [numsprites]\n",
+	"Usage: %s [-bpp N] [-hw] [-flip] [-triple] [-fast] [-fullscreen] [numsprites]\n",
 								argv[0]);
 			quit(1);
 		}
@@ -321,6 +326,16 @@ int main(int argc, char *argv[])
 		printf("%2.2f frames per second\n",
 					((double)frames*1000)/(now-then));
 	}
+	if ( SDL_GetFlipStats(&flipstats) == 0 ) {
+		printf("%u frames flipped, %u shown, %u dropped\n",
+			flipstats.frames_queued, flipstats.frames_shown,
+			flipstats.frames_dropped);
+	}
+	if ( SDL_GetUpdateStats(&updatestats) == 0 ) {
+		printf("%u rects updated with %u requests, %u of %u pixels sent were asked for\n",
+			updatestats.rects, updatestats.requests,
+			updatestats.pixels_asked, updatestats.pixels_sent);
+	}
 	SDL_Quit();
 	return(0);
 }
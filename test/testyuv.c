@@ -0,0 +1,286 @@
+/* Test of the software YUV overlay conversion.
+   Converts random overlays of each format to 16, 24 and 32 bit
+   surfaces with the dummy video driver and checks the pixels against
+   the conversion formula, unscaled, clipped and scaled, on one and
+   on several threads, then times a large conversion.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define WIDTH	118
+#define HEIGHT	46
+
+static const struct {
+	const char *name;
+	int yoffset;
+	double yscale, rv, gu, gv, bu;
+} matrices[] = {
+	{ "jpeg",   0, 1.0,   1.402, -0.344, -0.714, 1.772 },
+	{ "bt601", 16, 1.164, 1.596, -0.392, -0.813, 2.017 },
+	{ "bt709", 16, 1.164, 1.793, -0.213, -0.533, 2.112 }
+};
+
+static const struct {
+	const char *name;
+	Uint32 format;
+} formats[] = {
+	{ "YV12", SDL_YV12_OVERLAY },
+	{ "IYUV", SDL_IYUV_OVERLAY },
+	{ "YUY2", SDL_YUY2_OVERLAY },
+	{ "UYVY", SDL_UYVY_OVERLAY },
+	{ "YVYU", SDL_YVYU_OVERLAY }
+};
+
+static int Clamp(double v)
+{
+	int i = (int)(v + 0.5);
+
+	if ( i < 0 ) {
+		return 0;
+	}
+	if ( i > 255 ) {
+		return 255;
+	}
+	return i;
+}
+
+/* Fill the overlay with random samples */
+static void FillOverlay(SDL_Overlay *overlay)
+{
+	int plane, i, size;
+
+	SDL_LockYUVOverlay(overlay);
+	for ( plane=0; plane<overlay->planes; ++plane ) {
+		size = overlay->pitches[plane] * overlay->h;
+		if ( plane > 0 ) {
+			size /= 2;
+		}
+		for ( i=0; i<size; ++i ) {
+			overlay->pixels[plane][i] = (Uint8)(rand() >> 4);
+		}
+	}
+	SDL_UnlockYUVOverlay(overlay);
+}
+
+/* Get the Y, U and V samples for a pixel of the overlay */
+static void GetYUV(SDL_Overlay *overlay, int x, int y, int *Y, int *U, int *V)
+{
+	Uint8 *p;
+
+	switch (overlay->format) {
+	    case SDL_YV12_OVERLAY:
+		*Y = overlay->pixels[0][y*overlay->pitches[0] + x];
+		*V = overlay->pixels[1][(y/2)*overlay->pitches[1] + x/2];
+		*U = overlay->pixels[2][(y/2)*overlay->pitches[2] + x/2];
+		break;
+	    case SDL_IYUV_OVERLAY:
+		*Y = overlay->pixels[0][y*overlay->pitches[0] + x];
+		*U = overlay->pixels[1][(y/2)*overlay->pitches[1] + x/2];
+		*V = overlay->pixels[2][(y/2)*overlay->pitches[2] + x/2];
+		break;
+	    case SDL_YUY2_OVERLAY:
+		p = overlay->pixels[0] + y*overlay->pitches[0] + (x/2)*4;
+		*Y = p[(x&1)*2];
+		*U = p[1];
+		*V = p[3];
+		break;
+	    case SDL_UYVY_OVERLAY:
+		p = overlay->pixels[0] + y*overlay->pitches[0] + (x/2)*4;
+		*Y = p[1+(x&1)*2];
+		*U = p[0];
+		*V = p[2];
+		break;
+	    case SDL_YVYU_OVERLAY:
+		p = overlay->pixels[0] + y*overlay->pitches[0] + (x/2)*4;
+		*Y = p[(x&1)*2];
+		*V = p[1];
+		*U = p[3];
+		break;
+	    default:
+		*Y = *U = *V = 0;
+		break;
+	}
+}
+
+static Uint32 GetPixel(SDL_Surface *surface, int x, int y)
+{
+	Uint8 *p = (Uint8 *)surface->pixels + y*surface->pitch +
+	           x*surface->format->BytesPerPixel;
+
+	switch (surface->format->BytesPerPixel) {
+	    case 2:
+		return *(Uint16 *)p;
+	    case 3:
+		if ( SDL_BYTEORDER == SDL_LIL_ENDIAN ) {
+			return p[0] | (p[1] << 8) | (p[2] << 16);
+		} else {
+			return (p[0] << 16) | (p[1] << 8) | p[2];
+		}
+	    default:
+		return *(Uint32 *)p;
+	}
+}
+
+/* Returns the number of pixels further off than the rounding allows.
+   The overlay columns from srcx are shown at dstw pixels wide on the
+   left of the screen, and its rows at dsth pixels high at the top,
+   with nearest neighbour sampling.
+ */
+static int CheckOverlay(SDL_Surface *screen, SDL_Overlay *overlay, int m,
+                        int srcx, int dstw, int dsth)
+{
+	SDL_PixelFormat *fmt = screen->format;
+	int srcw = overlay->w - srcx;
+	int xstep = (srcw << 16) / dstw;
+	int ystep = (overlay->h << 16) / dsth;
+	int x, y, sx, sy, Y, U, V;
+	int r, g, b;
+	Uint8 R, G, B;
+	double l;
+	int bad = 0;
+
+	for ( y=0; y<dsth; ++y ) {
+		sy = (y * ystep + ystep / 2) >> 16;
+		for ( x=0; x<dstw; ++x ) {
+			sx = ((srcx << 16) + x * xstep + xstep / 2) >> 16;
+			GetYUV(overlay, sx, sy, &Y, &U, &V);
+			l = matrices[m].yscale * (Y - matrices[m].yoffset);
+			r = Clamp(l + matrices[m].rv * (V - 128));
+			g = Clamp(l + matrices[m].gu * (U - 128) + matrices[m].gv * (V - 128));
+			b = Clamp(l + matrices[m].bu * (U - 128));
+			SDL_GetRGB(GetPixel(screen, x, y), fmt, &R, &G, &B);
+			if ( abs(R - r) > 2 + (1 << fmt->Rloss) ||
+			     abs(G - g) > 2 + (1 << fmt->Gloss) ||
+			     abs(B - b) > 2 + (1 << fmt->Bloss) ) {
+				if ( bad == 0 ) {
+					printf("  (%d,%d) YUV %d %d %d: got %d %d %d, expected %d %d %d\n",
+					       x, y, Y, U, V, R, G, B, r, g, b);
+				}
+				++bad;
+			}
+		}
+	}
+	return bad;
+}
+
+/* Display an overlay at the given position and size, and check it */
+static int TestDisplay(SDL_Surface *screen, SDL_Overlay *overlay, int m,
+                       int x, int w, int h)
+{
+	SDL_Rect rect;
+
+	SDL_FillRect(screen, NULL, 0);
+	rect.x = x;
+	rect.y = 0;
+	rect.w = w;
+	rect.h = h;
+	SDL_DisplayYUVOverlay(overlay, &rect);
+	if ( x < 0 ) {
+		/* Clipped on the left */
+		return CheckOverlay(screen, overlay, m, -x, w + x, h);
+	}
+	return CheckOverlay(screen, overlay, m, 0, w, h);
+}
+
+static int TestConversions(int w, int h, int bpp)
+{
+	SDL_Surface *screen;
+	SDL_Overlay *overlay;
+	char env[64];
+	int f, m, bad, failed = 0;
+
+	screen = SDL_SetVideoMode(w*2, h*2, bpp, SDL_SWSURFACE);
+	if ( screen == NULL ) {
+		fprintf(stderr, "Couldn't set %d bpp video mode: %s\n", bpp, SDL_GetError());
+		return 1;
+	}
+	for ( m=0; m<SDL_arraysize(matrices); ++m ) {
+		SDL_snprintf(env, sizeof(env), "SDL_VIDEO_YUV_MATRIX=%s", matrices[m].name);
+		SDL_putenv(env);
+		for ( f=0; f<SDL_arraysize(formats); ++f ) {
+			overlay = SDL_CreateYUVOverlay(w, h, formats[f].format, screen);
+			if ( overlay == NULL ) {
+				fprintf(stderr, "Couldn't create overlay: %s\n", SDL_GetError());
+				return 1;
+			}
+			FillOverlay(overlay);
+			bad = TestDisplay(screen, overlay, m, 0, w, h);
+			bad += TestDisplay(screen, overlay, m, -10, w, h);
+			bad += TestDisplay(screen, overlay, m, 0, w*2, h*2);
+			bad += TestDisplay(screen, overlay, m, 0, w*3/2, h*3/2);
+			bad += TestDisplay(screen, overlay, m, 0, w/2, h/3);
+			printf("%dx%d %s to %d bpp (%s): %s\n", w, h, formats[f].name,
+			       bpp, matrices[m].name, bad ? "FAILED" : "passed");
+			if ( bad ) {
+				failed = 1;
+			}
+			SDL_FreeYUVOverlay(overlay);
+		}
+	}
+	return failed;
+}
+
+static void TimeConversions(int w, int h, int dstw, int dsth, int bpp, int frames)
+{
+	SDL_Surface *screen;
+	SDL_Overlay *overlay;
+	SDL_Rect rect;
+	Uint32 start, elapsed;
+	int f, i;
+
+	screen = SDL_SetVideoMode(dstw, dsth, bpp, SDL_SWSURFACE);
+	if ( screen == NULL ) {
+		return;
+	}
+	rect.x = 0;
+	rect.y = 0;
+	rect.w = dstw;
+	rect.h = dsth;
+	for ( f=0; f<SDL_arraysize(formats); f += 2 ) {
+		overlay = SDL_CreateYUVOverlay(w, h, formats[f].format, screen);
+		if ( overlay == NULL ) {
+			continue;
+		}
+		FillOverlay(overlay);
+		start = SDL_GetTicks();
+		for ( i=0; i<frames; ++i ) {
+			SDL_DisplayYUVOverlay(overlay, &rect);
+		}
+		elapsed = SDL_GetTicks() - start;
+		printf("%dx%d %s to %dx%d at %d bpp: %.2f ms per frame\n", w, h,
+		       formats[f].name, dstw, dsth, bpp, (double)elapsed / frames);
+		SDL_FreeYUVOverlay(overlay);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int failed = 0;
+
+	SDL_putenv("SDL_VIDEODRIVER=dummy");
+	if ( SDL_Init(SDL_INIT_VIDEO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+	failed |= TestConversions(WIDTH, HEIGHT, 16);
+	failed |= TestConversions(WIDTH, HEIGHT, 24);
+	failed |= TestConversions(WIDTH, HEIGHT, 32);
+
+	/* Large enough to be split between several threads */
+	SDL_putenv("SDL_VIDEO_YUV_THREADS=3");
+	failed |= TestConversions(720, 576, 32);
+	SDL_putenv("SDL_VIDEO_YUV_THREADS=");
+
+	SDL_putenv("SDL_VIDEO_YUV_MATRIX=bt709");
+	TimeConversions(1280, 720, 1280, 720, 16, 100);
+	TimeConversions(1280, 720, 1280, 720, 32, 100);
+	TimeConversions(1280, 720, 1920, 1080, 32, 50);
+	SDL_putenv("SDL_VIDEO_YUV_FILTER=linear");
+	TimeConversions(1280, 720, 1920, 1080, 32, 50);
+
+	SDL_Quit();
+	return(failed);
+}